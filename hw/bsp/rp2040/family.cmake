@@ -51,6 +51,7 @@ add_library(tinyusb_common_base INTERFACE)
 target_sources(tinyusb_common_base INTERFACE
 	${TOP}/src/tusb.c
 	${TOP}/src/common/tusb_fifo.c
+	${TOP}/src/common/tusb_capture.c
 	)
 
 target_include_directories(tinyusb_common_base INTERFACE
@@ -343,6 +344,7 @@ function(suppress_tinyusb_warnings)
 			set(CONVERSION_WARNING_FILES
 				${PICO_TINYUSB_PATH}/src/tusb.c
 				${PICO_TINYUSB_PATH}/src/common/tusb_fifo.c
+				${PICO_TINYUSB_PATH}/src/common/tusb_capture.c
 				${PICO_TINYUSB_PATH}/src/device/usbd.c
 				${PICO_TINYUSB_PATH}/src/device/usbd_control.c
 				${PICO_TINYUSB_PATH}/src/host/usbh.c
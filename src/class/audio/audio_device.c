@@ -60,6 +60,12 @@
 #include "device/usbd_pvt.h"
 
 #include "audio_device.h"
+#include "audio_pcm.h"
+#include "audio_src.h"
+
+#if CFG_TUD_AUDIO_ENABLE_TELEMETRY
+  #include "tusb.h" // tusb_time_millis_api() as default CFG_TUSB_STATS_TIMESTAMP()
+#endif
 
 //--------------------------------------------------------------------+
 // MACRO CONSTANT TYPEDEF
@@ -100,6 +106,20 @@
   #define USE_LINEAR_BUFFER 1
 #endif
 
+// Asynchronous sample rate conversion for Type I coding, encoding needs nominal packet size from flow control
+#if CFG_TUD_AUDIO_ENABLE_SRC && CFG_TUD_AUDIO_ENABLE_EP_OUT && CFG_TUD_AUDIO_ENABLE_DECODING && CFG_TUD_AUDIO_ENABLE_TYPE_I_DECODING
+  #define AUDIOD_SRC_RX 1
+#else
+  #define AUDIOD_SRC_RX 0
+#endif
+
+#if CFG_TUD_AUDIO_ENABLE_SRC && CFG_TUD_AUDIO_ENABLE_EP_IN && CFG_TUD_AUDIO_ENABLE_ENCODING && \
+    CFG_TUD_AUDIO_ENABLE_TYPE_I_ENCODING && CFG_TUD_AUDIO_EP_IN_FLOW_CONTROL
+  #define AUDIOD_SRC_TX 1
+#else
+  #define AUDIOD_SRC_TX 0
+#endif
+
 // Declaration of buffers
 
 // Check for maximum supported numbers
@@ -152,13 +172,13 @@ tu_static IN_SW_BUF_MEM_ATTR struct {
 #if CFG_TUD_AUDIO_ENABLE_EP_IN && (USE_LINEAR_BUFFER || CFG_TUD_AUDIO_ENABLE_ENCODING)
 tu_static CFG_TUD_MEM_SECTION struct {
   #if CFG_TUD_AUDIO_FUNC_1_EP_IN_SZ_MAX > 0
-  TUD_EPBUF_DEF(buf_1, CFG_TUD_AUDIO_FUNC_1_EP_IN_SZ_MAX);
+  TUD_EPBUF_DEF(buf_1, CFG_TUD_AUDIO_FUNC_1_EP_IN_SZ_MAX * CFG_TUD_AUDIO_XFER_BATCH);
   #endif
   #if CFG_TUD_AUDIO > 1 && CFG_TUD_AUDIO_FUNC_2_EP_IN_SZ_MAX > 0
-  TUD_EPBUF_DEF(buf_2, CFG_TUD_AUDIO_FUNC_2_EP_IN_SZ_MAX);
+  TUD_EPBUF_DEF(buf_2, CFG_TUD_AUDIO_FUNC_2_EP_IN_SZ_MAX * CFG_TUD_AUDIO_XFER_BATCH);
   #endif
   #if CFG_TUD_AUDIO > 2 && CFG_TUD_AUDIO_FUNC_3_EP_IN_SZ_MAX > 0
-  TUD_EPBUF_DEF(buf_3, CFG_TUD_AUDIO_FUNC_3_EP_IN_SZ_MAX);
+  TUD_EPBUF_DEF(buf_3, CFG_TUD_AUDIO_FUNC_3_EP_IN_SZ_MAX * CFG_TUD_AUDIO_XFER_BATCH);
   #endif
 } lin_buf_in;
 #endif// CFG_TUD_AUDIO_ENABLE_EP_IN && (USE_LINEAR_BUFFER || CFG_TUD_AUDIO_ENABLE_DECODING)
@@ -196,17 +216,24 @@ tu_static OUT_SW_BUF_MEM_ATTR struct {
 #if CFG_TUD_AUDIO_ENABLE_EP_OUT && (USE_LINEAR_BUFFER || CFG_TUD_AUDIO_ENABLE_DECODING)
 tu_static CFG_TUD_MEM_SECTION struct {
   #if CFG_TUD_AUDIO_FUNC_1_EP_OUT_SZ_MAX > 0
-  TUD_EPBUF_DEF(buf_1, CFG_TUD_AUDIO_FUNC_1_EP_OUT_SZ_MAX);
+  TUD_EPBUF_DEF(buf_1, CFG_TUD_AUDIO_FUNC_1_EP_OUT_SZ_MAX * CFG_TUD_AUDIO_XFER_BATCH);
   #endif
   #if CFG_TUD_AUDIO > 1 && CFG_TUD_AUDIO_FUNC_2_EP_OUT_SZ_MAX > 0
-  TUD_EPBUF_DEF(buf_2, CFG_TUD_AUDIO_FUNC_2_EP_OUT_SZ_MAX);
+  TUD_EPBUF_DEF(buf_2, CFG_TUD_AUDIO_FUNC_2_EP_OUT_SZ_MAX * CFG_TUD_AUDIO_XFER_BATCH);
   #endif
   #if CFG_TUD_AUDIO > 2 && CFG_TUD_AUDIO_FUNC_3_EP_OUT_SZ_MAX > 0
-  TUD_EPBUF_DEF(buf_3, CFG_TUD_AUDIO_FUNC_3_EP_OUT_SZ_MAX);
+  TUD_EPBUF_DEF(buf_3, CFG_TUD_AUDIO_FUNC_3_EP_OUT_SZ_MAX * CFG_TUD_AUDIO_XFER_BATCH);
   #endif
 } lin_buf_out;
 #endif// CFG_TUD_AUDIO_ENABLE_EP_OUT && (USE_LINEAR_BUFFER || CFG_TUD_AUDIO_ENABLE_DECODING)
 
+#if CFG_TUD_AUDIO_ENABLE_TELEMETRY
+// Snapshot replied to telemetry vendor request, since live telemetry changes during data stage
+tu_static CFG_TUD_MEM_SECTION struct {
+  TUD_EPBUF_TYPE_DEF(audio_telemetry_t, buf);
+} telemetry_buf;
+#endif
+
 // Control buffers
 tu_static CFG_TUD_MEM_SECTION struct {
   TUD_EPBUF_DEF(buf1, CFG_TUD_AUDIO_FUNC_1_CTRL_BUF_SZ);
@@ -312,12 +339,14 @@ typedef struct
 #if CFG_TUD_AUDIO_ENABLE_EP_IN
   uint8_t ep_in;            // TX audio data EP.
   uint16_t ep_in_sz;        // Current size of TX EP
+  bool ep_in_bulk;          // Bulk EP: transfer is batched and only scheduled when there is data
   uint8_t ep_in_as_intf_num;// Corresponding Standard AS Interface Descriptor (4.9.1) belonging to output terminal to which this EP belongs - 0 is invalid (this fits to UAC2 specification since AS interfaces can not have interface number equal to zero)
 #endif
 
 #if CFG_TUD_AUDIO_ENABLE_EP_OUT
   uint8_t ep_out;            // Incoming (into uC) audio data EP.
   uint16_t ep_out_sz;        // Current size of RX EP
+  bool ep_out_bulk;          // Bulk EP: transfer is batched
   uint8_t ep_out_as_intf_num;// Corresponding Standard AS Interface Descriptor (4.9.1) belonging to input terminal to which this EP belongs - 0 is invalid (this fits to UAC2 specification since AS interfaces can not have interface number equal to zero)
 
   #if CFG_TUD_AUDIO_ENABLE_FEEDBACK_EP
@@ -395,6 +424,20 @@ typedef struct
   #endif
 #endif
 
+// Sample rate converter state, reset when alternate AS interface is set
+#if AUDIOD_SRC_RX
+  audio_src_t src_rx;
+#endif
+
+#if AUDIOD_SRC_TX
+  audio_src_t src_tx;
+  uint16_t src_tx_remainder;// Accumulated fractional part of nominal frames per packet
+#endif
+
+#if CFG_TUD_AUDIO_ENABLE_TELEMETRY
+  audio_telemetry_t telemetry;
+#endif
+
   /*------------- From this point, data is not cleared by bus reset -------------*/
 
   // Buffer for control requests
@@ -602,6 +645,11 @@ tu_static CFG_TUD_MEM_SECTION audiod_function_t _audiod_fct[CFG_TUD_AUDIO];
 
 #if CFG_TUD_AUDIO_ENABLE_EP_OUT
 static bool audiod_rx_done_cb(uint8_t rhport, audiod_function_t *audio, uint16_t n_bytes_received);
+
+// Size of RX transfer, bulk EP receives a batch of packets
+TU_ATTR_ALWAYS_INLINE static inline uint16_t audiod_rx_xfer_sz(audiod_function_t const *audio) {
+  return (uint16_t) (audio->ep_out_bulk ? audio->ep_out_sz * CFG_TUD_AUDIO_XFER_BATCH : audio->ep_out_sz);
+}
 #endif
 
 #if CFG_TUD_AUDIO_ENABLE_DECODING && CFG_TUD_AUDIO_ENABLE_EP_OUT
@@ -610,6 +658,12 @@ static bool audiod_decode_type_I_pcm(uint8_t rhport, audiod_function_t *audio, u
 
 #if CFG_TUD_AUDIO_ENABLE_EP_IN
 static bool audiod_tx_done_cb(uint8_t rhport, audiod_function_t *audio);
+static bool audiod_bulk_tx_kick(audiod_function_t *audio);
+
+// Max size of TX transfer, bulk EP sends a batch of packets
+TU_ATTR_ALWAYS_INLINE static inline uint16_t audiod_tx_xfer_sz(audiod_function_t const *audio) {
+  return (uint16_t) (audio->ep_in_bulk ? audio->ep_in_sz * CFG_TUD_AUDIO_XFER_BATCH : audio->ep_in_sz);
+}
 #endif
 
 #if CFG_TUD_AUDIO_ENABLE_ENCODING && CFG_TUD_AUDIO_ENABLE_EP_IN
@@ -640,6 +694,30 @@ static bool audiod_set_fb_params_freq(audiod_function_t *audio, uint32_t sample_
 static void audiod_fb_fifo_count_update(audiod_function_t *audio, uint16_t lvl_new);
 #endif
 
+#if CFG_TUD_AUDIO_ENABLE_TELEMETRY
+static void audiod_telemetry_update(audio_telemetry_stream_t *s, tu_fifo_t *ff, uint16_t level, bool overrun, bool underrun, uint32_t start);
+
+  #if CFG_TUD_AUDIO_ENABLE_EP_OUT
+TU_ATTR_ALWAYS_INLINE static inline tu_fifo_t *audiod_telemetry_rx_ff(audiod_function_t *audio) {
+    #if CFG_TUD_AUDIO_ENABLE_DECODING
+  return &audio->rx_supp_ff[0];
+    #else
+  return &audio->ep_out_ff;
+    #endif
+}
+  #endif
+
+  #if CFG_TUD_AUDIO_ENABLE_EP_IN
+TU_ATTR_ALWAYS_INLINE static inline tu_fifo_t *audiod_telemetry_tx_ff(audiod_function_t *audio) {
+    #if CFG_TUD_AUDIO_ENABLE_ENCODING
+  return &audio->tx_supp_ff[0];
+    #else
+  return &audio->ep_in_ff;
+    #endif
+}
+  #endif
+#endif
+
 bool tud_audio_n_mounted(uint8_t func_id) {
   TU_VERIFY(func_id < CFG_TUD_AUDIO);
   audiod_function_t *audio = &_audiod_fct[func_id];
@@ -711,6 +789,17 @@ static bool audiod_rx_done_cb(uint8_t rhport, audiod_function_t *audio, uint16_t
   idx_audio_fct = audiod_get_audio_fct_idx(audio);
   TU_VERIFY(audiod_get_AS_interface_index(audio->ep_out_as_intf_num, audio, &idxItf, &dummy2));
 
+  #if CFG_TUD_AUDIO_ENABLE_TELEMETRY
+  uint32_t const tele_start = CFG_TUSB_STATS_TIMESTAMP();
+  tu_fifo_t *tele_ff = audiod_telemetry_rx_ff(audio);
+    #if !CFG_TUD_AUDIO_ENABLE_DECODING && !USE_LINEAR_BUFFER_RX
+  // Data is already placed in EP FIFO
+  bool const tele_empty = tu_fifo_count(tele_ff) <= n_bytes_received;
+    #else
+  bool const tele_empty = tu_fifo_empty(tele_ff);
+    #endif
+  #endif
+
   // Call a weak callback here - a possibility for user to get informed an audio packet was received and data gets now loaded into EP FIFO (or decoded into support RX software FIFO)
   TU_VERIFY(tud_audio_rx_done_pre_read_cb(rhport, n_bytes_received, idx_audio_fct, audio->ep_out, audio->alt_setting[idxItf]));
 
@@ -746,7 +835,7 @@ static bool audiod_rx_done_cb(uint8_t rhport, audiod_function_t *audio, uint16_t
   }
 
   // Prepare for next transmission
-  TU_VERIFY(usbd_edpt_xfer(rhport, audio->ep_out, audio->lin_buf_out, audio->ep_out_sz), false);
+  TU_VERIFY(usbd_edpt_xfer(rhport, audio->ep_out, audio->lin_buf_out, audiod_rx_xfer_sz(audio)), false);
 
   #else
 
@@ -755,10 +844,10 @@ static bool audiod_rx_done_cb(uint8_t rhport, audiod_function_t *audio, uint16_t
   TU_VERIFY(tu_fifo_write_n(&audio->ep_out_ff, audio->lin_buf_out, n_bytes_received));
 
   // Schedule for next receive
-  TU_VERIFY(usbd_edpt_xfer(rhport, audio->ep_out, audio->lin_buf_out, audio->ep_out_sz), false);
+  TU_VERIFY(usbd_edpt_xfer(rhport, audio->ep_out, audio->lin_buf_out, audiod_rx_xfer_sz(audio)), false);
     #else
   // Data is already placed in EP FIFO, schedule for next receive
-  TU_VERIFY(usbd_edpt_xfer_fifo(rhport, audio->ep_out, &audio->ep_out_ff, audio->ep_out_sz), false);
+  TU_VERIFY(usbd_edpt_xfer_fifo(rhport, audio->ep_out, &audio->ep_out_ff, audiod_rx_xfer_sz(audio)), false);
     #endif
 
     #if CFG_TUD_AUDIO_ENABLE_FEEDBACK_EP
@@ -772,6 +861,10 @@ static bool audiod_rx_done_cb(uint8_t rhport, audiod_function_t *audio, uint16_t
   // Call a weak callback here - a possibility for user to get informed decoding was completed
   TU_VERIFY(tud_audio_rx_done_post_read_cb(rhport, n_bytes_received, idx_audio_fct, audio->ep_out, audio->alt_setting[idxItf]));
 
+  #if CFG_TUD_AUDIO_ENABLE_TELEMETRY
+  audiod_telemetry_update(&audio->telemetry.rx, tele_ff, tu_fifo_count(tele_ff), tu_fifo_overflowed(tele_ff), tele_empty, tele_start);
+  #endif
+
   return true;
 }
 
@@ -782,77 +875,86 @@ static bool audiod_rx_done_cb(uint8_t rhport, audiod_function_t *audio, uint16_t
 
 // Decoding according to 2.3.1.5 Audio Streams
 
-// Helper function
-static inline void *audiod_interleaved_copy_bytes_fast_decode(uint16_t const nBytesPerSample, void *dst, const void *dst_end, void *src, uint8_t const n_ff_used) {
-  // Due to one FIFO contains 2 channels, data always aligned to (nBytesPerSample * 2)
-  uint16_t *dst16 = dst;
-  uint16_t *src16 = src;
-  const uint16_t *dst_end16 = dst_end;
-  uint32_t *dst32 = dst;
-  uint32_t *src32 = src;
-  const uint32_t *dst_end32 = dst_end;
-
-  if (nBytesPerSample == 1) {
-    while (dst16 < dst_end16) {
-      *dst16++ = *src16++;
-      src16 += n_ff_used - 1;
-    }
-    return src16;
-  } else if (nBytesPerSample == 2) {
-    while (dst32 < dst_end32) {
-      *dst32++ = *src32++;
-      src32 += n_ff_used - 1;
-    }
-    return src32;
-  } else if (nBytesPerSample == 3) {
-    while (dst16 < dst_end16) {
-      *dst16++ = *src16++;
-      *dst16++ = *src16++;
-      *dst16++ = *src16++;
-      src16 += 3 * (n_ff_used - 1);
-    }
-    return src16;
-  } else// nBytesPerSample == 4
-  {
-    while (dst32 < dst_end32) {
-      *dst32++ = *src32++;
-      *dst32++ = *src32++;
-      src32 += 2 * (n_ff_used - 1);
-    }
-    return src32;
+#if AUDIOD_SRC_RX
+// Decode with sample rate conversion: each support FIFO receives its channels resampled to codec clock
+static void audiod_decode_type_I_pcm_src(audiod_function_t *audio, uint16_t n_bytes_received) {
+  uint8_t const n_ff_used = audio->n_ff_used_rx;
+  uint8_t const n_bytes = audio->n_bytes_per_sample_rx;
+  uint8_t const nSlotSize = (uint8_t) (audio->n_channels_per_ff_rx * n_bytes);
+  uint16_t const n_in = (uint16_t) (n_bytes_received / (n_ff_used * nSlotSize));
+  audio_src_t *src = &audio->src_rx;
+
+  uint16_t const ff_frames = tu_fifo_depth(&audio->rx_supp_ff[0]) / nSlotSize;
+  audio_src_update(src, tu_fifo_count(&audio->rx_supp_ff[0]) / nSlotSize, ff_frames / 2, n_in);
+
+  uint16_t const n_out = audio_src_out_count(src, n_in);
+
+  for (uint8_t cnt_ff = 0; cnt_ff < n_ff_used; cnt_ff++) {
+    tu_fifo_buffer_info_t info;
+    tu_fifo_write_reserve(&audio->rx_supp_ff[cnt_ff], &info);
+
+    audio_src_buf_t const in = {
+      .ptr = {&audio->lin_buf_out[cnt_ff * nSlotSize], NULL},
+      .n_lin = n_in,
+      .stride = (uint16_t) (n_ff_used * nSlotSize)
+    };
+    audio_src_buf_t const out = {
+      .ptr = {(uint8_t *) info.ptr_lin, (uint8_t *) info.ptr_wrap},
+      .n_lin = info.len_lin / nSlotSize,
+      .stride = nSlotSize
+    };
+
+    // Overflow: drop frames which do not fit
+    uint16_t const n_write = tu_min16(n_out, (uint16_t) ((info.len_lin + info.len_wrap) / nSlotSize));
+    audio_src_process(src, (uint8_t) (cnt_ff * audio->n_channels_per_ff_rx), audio->n_channels_per_ff_rx, n_bytes,
+                      &in, n_in, &out, n_write);
+    tu_fifo_write_commit(&audio->rx_supp_ff[cnt_ff], n_write * nSlotSize);
   }
+
+  audio_src_advance(src, n_in, n_out);
 }
+#endif
 
 static bool audiod_decode_type_I_pcm(uint8_t rhport, audiod_function_t *audio, uint16_t n_bytes_received) {
   (void) rhport;
 
+  #if AUDIOD_SRC_RX
+  if (audio->n_channels_rx <= CFG_TUD_AUDIO_SRC_MAX_CHANNELS) {
+    // FIFO level is kept by the converter: AUDIO_FEEDBACK_METHOD_FIFO_COUNT feedback is fixed at nominal value by
+    // audiod_set_interface(), FREQUENCY_* methods still report the measured codec clock
+    audiod_decode_type_I_pcm_src(audio, n_bytes_received);
+    return true;
+  }
+  #endif
+
   // Determine amount of samples
   uint8_t const n_ff_used = audio->n_ff_used_rx;
   uint16_t const nBytesPerFFToRead = n_bytes_received / n_ff_used;
+  uint8_t const nSlotSize = (uint8_t) (audio->n_channels_per_ff_rx * audio->n_bytes_per_sample_rx);
   uint8_t cnt_ff;
 
   // Decode
-  uint8_t *src;
+  uint8_t const *src;
   uint8_t *dst_end;
 
   tu_fifo_buffer_info_t info;
 
   for (cnt_ff = 0; cnt_ff < n_ff_used; cnt_ff++) {
-    tu_fifo_get_write_info(&audio->rx_supp_ff[cnt_ff], &info);
+    tu_fifo_write_reserve(&audio->rx_supp_ff[cnt_ff], &info);
 
     if (info.len_lin != 0) {
       info.len_lin = tu_min16(nBytesPerFFToRead, info.len_lin);
-      src = &audio->lin_buf_out[cnt_ff * audio->n_channels_per_ff_rx * audio->n_bytes_per_sample_rx];
+      src = &audio->lin_buf_out[cnt_ff * nSlotSize];
       dst_end = info.ptr_lin + info.len_lin;
-      src = audiod_interleaved_copy_bytes_fast_decode(audio->n_bytes_per_sample_rx, info.ptr_lin, dst_end, src, n_ff_used);
+      src = audio_pcm_deinterleave(info.ptr_lin, dst_end, src, nSlotSize, n_ff_used);
 
       // Handle wrapped part of FIFO
       info.len_wrap = tu_min16(nBytesPerFFToRead - info.len_lin, info.len_wrap);
       if (info.len_wrap != 0) {
         dst_end = info.ptr_wrap + info.len_wrap;
-        audiod_interleaved_copy_bytes_fast_decode(audio->n_bytes_per_sample_rx, info.ptr_wrap, dst_end, src, n_ff_used);
+        audio_pcm_deinterleave(info.ptr_wrap, dst_end, src, nSlotSize, n_ff_used);
       }
-      tu_fifo_advance_write_pointer(&audio->rx_supp_ff[cnt_ff], info.len_lin + info.len_wrap);
+      tu_fifo_write_commit(&audio->rx_supp_ff[cnt_ff], info.len_lin + info.len_wrap);
     }
   }
 
@@ -888,7 +990,14 @@ static bool audiod_decode_type_I_pcm(uint8_t rhport, audiod_function_t *audio, u
  */
 uint16_t tud_audio_n_write(uint8_t func_id, const void *data, uint16_t len) {
   TU_VERIFY(func_id < CFG_TUD_AUDIO && _audiod_fct[func_id].p_desc != NULL);
-  return tu_fifo_write_n(&_audiod_fct[func_id].ep_in_ff, data, len);
+  audiod_function_t *audio = &_audiod_fct[func_id];
+  uint16_t const count = tu_fifo_write_n(&audio->ep_in_ff, data, len);
+
+  if (audio->ep_in_bulk) {
+    (void) audiod_bulk_tx_kick(audio);
+  }
+
+  return count;
 }
 
 bool tud_audio_n_clear_ep_in_ff(uint8_t func_id)// Delete all content in the EP IN FIFO
@@ -913,7 +1022,7 @@ uint16_t tud_audio_n_flush_tx_support_ff(uint8_t func_id)// Force all content in
 
   uint16_t n_bytes_copied = tu_fifo_count(&audio->tx_supp_ff[0]);
 
-  TU_VERIFY(audiod_tx_done_cb(audio->rhport, audio));
+  TU_VERIFY(audio->ep_in_bulk ? audiod_bulk_tx_kick(audio) : audiod_tx_done_cb(audio->rhport, audio));
 
   n_bytes_copied -= tu_fifo_count(&audio->tx_supp_ff[0]);
   n_bytes_copied = n_bytes_copied * audio->tx_supp_ff[0].item_size;
@@ -928,7 +1037,14 @@ bool tud_audio_n_clear_tx_support_ff(uint8_t func_id, uint8_t ff_idx) {
 
 uint16_t tud_audio_n_write_support_ff(uint8_t func_id, uint8_t ff_idx, const void *data, uint16_t len) {
   TU_VERIFY(func_id < CFG_TUD_AUDIO && _audiod_fct[func_id].p_desc != NULL && ff_idx < _audiod_fct[func_id].n_tx_supp_ff);
-  return tu_fifo_write_n(&_audiod_fct[func_id].tx_supp_ff[ff_idx], data, len);
+  audiod_function_t *audio = &_audiod_fct[func_id];
+  uint16_t const count = tu_fifo_write_n(&audio->tx_supp_ff[ff_idx], data, len);
+
+  if (audio->ep_in_bulk) {
+    (void) audiod_bulk_tx_kick(audio);
+  }
+
+  return count;
 }
 
 tu_fifo_t *tud_audio_n_get_tx_support_ff(uint8_t func_id, uint8_t ff_idx) {
@@ -939,6 +1055,66 @@ tu_fifo_t *tud_audio_n_get_tx_support_ff(uint8_t func_id, uint8_t ff_idx) {
 #endif
 
 
+//--------------------------------------------------------------------+
+// TELEMETRY API
+//--------------------------------------------------------------------+
+#if CFG_TUD_AUDIO_ENABLE_TELEMETRY
+
+// Record a transfer with FIFO level and xrun condition, processing time is measured from start tick
+static void audiod_telemetry_update(audio_telemetry_stream_t *s, tu_fifo_t *ff, uint16_t level, bool overrun, bool underrun, uint32_t start) {
+  if (s->xfers == 0) {
+    s->fill_min = level;
+    s->fill_max = level;
+    s->fill_avg = (uint32_t) level << 16;
+  } else {
+    s->fill_min = tu_min16(s->fill_min, level);
+    s->fill_max = tu_max16(s->fill_max, level);
+    s->fill_avg = (uint32_t) (((uint64_t) s->fill_avg * 63 + ((uint32_t) level << 16)) >> 6);
+  }
+  s->depth = tu_fifo_depth(ff);
+  s->xfers++;
+
+  if (overrun) s->overruns++;
+  if (underrun) s->underruns++;
+
+  uint32_t const ticks = (uint32_t) CFG_TUSB_STATS_TIMESTAMP() - start;
+  s->proc_ticks += ticks;
+  s->proc_max = tu_max32(s->proc_max, ticks);
+}
+
+bool tud_audio_n_telemetry_get(uint8_t func_id, audio_telemetry_t *telemetry) {
+  TU_VERIFY(func_id < CFG_TUD_AUDIO && _audiod_fct[func_id].p_desc != NULL);
+  *telemetry = _audiod_fct[func_id].telemetry;
+  return true;
+}
+
+bool tud_audio_n_telemetry_clear(uint8_t func_id) {
+  TU_VERIFY(func_id < CFG_TUD_AUDIO && _audiod_fct[func_id].p_desc != NULL);
+  tu_memclr(&_audiod_fct[func_id].telemetry, sizeof(audio_telemetry_t));
+  return true;
+}
+
+bool tud_audio_telemetry_control_xfer_cb(uint8_t rhport, uint8_t stage, tusb_control_request_t const *request) {
+  TU_VERIFY(request->bmRequestType_bit.type == TUSB_REQ_TYPE_VENDOR &&
+            request->bmRequestType_bit.direction == TUSB_DIR_IN &&
+            request->bRequest == CFG_TUD_AUDIO_TELEMETRY_REQUEST);
+
+  // nothing to do in other stages
+  if (stage != CONTROL_STAGE_SETUP) return true;
+
+  TU_VERIFY(request->wIndex < CFG_TUD_AUDIO);
+  uint8_t const func_id = (uint8_t) request->wIndex;
+
+  TU_VERIFY(tud_audio_n_telemetry_get(func_id, &telemetry_buf.buf));
+  if (request->wValue == 1) {
+    tud_audio_n_telemetry_clear(func_id);
+  }
+
+  return tud_control_xfer(rhport, request, &telemetry_buf.buf, sizeof(audio_telemetry_t));
+}
+
+#endif
+
 #if CFG_TUD_AUDIO_ENABLE_INTERRUPT_EP
 // If no interrupt transmit is pending bytes get written into buffer and a transmit is scheduled - once transmit completed tud_audio_int_done_cb() is called in inform user
 bool tud_audio_int_n_write(uint8_t func_id, const audio_interrupt_data_t *data) {
@@ -977,6 +1153,13 @@ static bool audiod_tx_done_cb(uint8_t rhport, audiod_function_t *audio) {
   // Only send something if current alternate interface is not 0 as in this case nothing is to be sent due to UAC2 specifications
   if (audio->alt_setting[idxItf] == 0) return false;
 
+  #if CFG_TUD_AUDIO_ENABLE_TELEMETRY
+  uint32_t const tele_start = CFG_TUSB_STATS_TIMESTAMP();
+  tu_fifo_t *tele_ff = audiod_telemetry_tx_ff(audio);
+  uint16_t const tele_level = tu_fifo_count(tele_ff);
+  bool const tele_overflow = tu_fifo_overflowed(tele_ff);
+  #endif
+
   // Call a weak callback here - a possibility for user to get informed former TX was completed and data gets now loaded into EP in buffer (in case FIFOs are used) or
   // if no FIFOs are used the user may use this call back to load its data into the EP IN buffer by use of tud_audio_n_write_ep_in_buffer().
   TU_VERIFY(tud_audio_tx_done_pre_load_cb(rhport, idx_audio_fct, audio->ep_in, audio->alt_setting[idxItf]));
@@ -1019,29 +1202,64 @@ static bool audiod_tx_done_cb(uint8_t rhport, audiod_function_t *audio) {
       break;
   }
 
-  TU_VERIFY(usbd_edpt_xfer(rhport, audio->ep_in, audio->lin_buf_in, n_bytes_tx));
+  if (n_bytes_tx == 0 && audio->ep_in_bulk) {
+    // Bulk EP is not polled every (micro)frame, no ZLP needed. Transmit is restarted by tud_audio_n_write_support_ff()
+    usbd_edpt_release(rhport, audio->ep_in);
+  } else {
+    TU_VERIFY(usbd_edpt_xfer(rhport, audio->ep_in, audio->lin_buf_in, n_bytes_tx));
+  }
 
   #else
     // No support FIFOs, if no linear buffer required schedule transmit, else put data into linear buffer and schedule
     #if CFG_TUD_AUDIO_EP_IN_FLOW_CONTROL
   // packet_sz_tx is based on total packet size, here we want size for each support buffer.
-  n_bytes_tx = audiod_tx_packet_size(audio->packet_sz_tx, tu_fifo_count(&audio->ep_in_ff), audio->ep_in_ff.depth, audio->ep_in_sz);
-    #else
-  n_bytes_tx = tu_min16(tu_fifo_count(&audio->ep_in_ff), audio->ep_in_sz);// Limit up to max packet size, more can not be done for ISO
+  if (!audio->ep_in_bulk) {
+    n_bytes_tx = audiod_tx_packet_size(audio->packet_sz_tx, tu_fifo_count(&audio->ep_in_ff), audio->ep_in_ff.depth, audio->ep_in_sz);
+  } else
     #endif
+  {
+    n_bytes_tx = tu_min16(tu_fifo_count(&audio->ep_in_ff), audiod_tx_xfer_sz(audio));// Limit up to max packet size (batch for bulk), more can not be done for ISO
+  }
+
+  if (n_bytes_tx == 0 && audio->ep_in_bulk) {
+    // Bulk EP is not polled every (micro)frame, no ZLP needed. Transmit is restarted by tud_audio_n_write()
+    usbd_edpt_release(rhport, audio->ep_in);
+  } else {
     #if USE_LINEAR_BUFFER_TX
-  tu_fifo_read_n(&audio->ep_in_ff, audio->lin_buf_in, n_bytes_tx);
-  TU_VERIFY(usbd_edpt_xfer(rhport, audio->ep_in, audio->lin_buf_in, n_bytes_tx));
+    tu_fifo_read_n(&audio->ep_in_ff, audio->lin_buf_in, n_bytes_tx);
+    TU_VERIFY(usbd_edpt_xfer(rhport, audio->ep_in, audio->lin_buf_in, n_bytes_tx));
     #else
-  // Send everything in ISO EP FIFO
-  TU_VERIFY(usbd_edpt_xfer_fifo(rhport, audio->ep_in, &audio->ep_in_ff, n_bytes_tx));
+    // Send everything in ISO EP FIFO
+    TU_VERIFY(usbd_edpt_xfer_fifo(rhport, audio->ep_in, &audio->ep_in_ff, n_bytes_tx));
     #endif
+  }
 
   #endif
 
   // Call a weak callback here - a possibility for user to get informed former TX was completed and how many bytes were loaded for the next frame
   TU_VERIFY(tud_audio_tx_done_post_load_cb(rhport, n_bytes_tx, idx_audio_fct, audio->ep_in, audio->alt_setting[idxItf]));
 
+  #if CFG_TUD_AUDIO_ENABLE_TELEMETRY
+  // idle bulk EP is not a transfer
+  if (n_bytes_tx != 0 || !audio->ep_in_bulk) {
+    audiod_telemetry_update(&audio->telemetry.tx, tele_ff, tele_level, tele_overflow, n_bytes_tx == 0, tele_start);
+  }
+  #endif
+
+  return true;
+}
+
+// Bulk EP is idle when there was no data to send. Claim it before loading since this can be called from both
+// application (write API) and usbd task (transfer complete).
+static bool audiod_bulk_tx_kick(audiod_function_t *audio) {
+  TU_VERIFY(audio->ep_in_as_intf_num != 0);
+  TU_VERIFY(usbd_edpt_claim(audio->rhport, audio->ep_in));
+
+  if (!audiod_tx_done_cb(audio->rhport, audio)) {
+    usbd_edpt_release(audio->rhport, audio->ep_in);
+    return false;
+  }
+
   return true;
 }
 
@@ -1065,46 +1283,68 @@ range [-1, +1)
  * does not change the number of bytes per sample.
  * */
 
-// Helper function
-static inline void *audiod_interleaved_copy_bytes_fast_encode(uint16_t const nBytesPerSample, void *src, const void *src_end, void *dst, uint8_t const n_ff_used) {
-  // Due to one FIFO contains 2 channels, data always aligned to (nBytesPerSample * 2)
-  uint16_t *dst16 = dst;
-  uint16_t *src16 = src;
-  const uint16_t *src_end16 = src_end;
-  uint32_t *dst32 = dst;
-  uint32_t *src32 = src;
-  const uint32_t *src_end32 = src_end;
-
-  if (nBytesPerSample == 1) {
-    while (src16 < src_end16) {
-      *dst16++ = *src16++;
-      dst16 += n_ff_used - 1;
-    }
-    return dst16;
-  } else if (nBytesPerSample == 2) {
-    while (src32 < src_end32) {
-      *dst32++ = *src32++;
-      dst32 += n_ff_used - 1;
-    }
-    return dst32;
-  } else if (nBytesPerSample == 3) {
-    while (src16 < src_end16) {
-      *dst16++ = *src16++;
-      *dst16++ = *src16++;
-      *dst16++ = *src16++;
-      dst16 += 3 * (n_ff_used - 1);
-    }
-    return dst16;
-  } else// nBytesPerSample == 4
-  {
-    while (src32 < src_end32) {
-      *dst32++ = *src32++;
-      *dst32++ = *src32++;
-      dst32 += 2 * (n_ff_used - 1);
-    }
-    return dst32;
+#if AUDIOD_SRC_TX
+// Encode with sample rate conversion: packets carry nominal number of frames at USB clock, support FIFOs are
+// consumed at codec clock
+static uint16_t audiod_encode_type_I_pcm_src(audiod_function_t *audio) {
+  uint8_t const n_ff_used = audio->n_ff_used_tx;
+  uint8_t const n_bytes = audio->n_bytes_per_sample_tx;
+  uint8_t const nSlotSize = (uint8_t) (audio->n_channels_per_ff_tx * n_bytes);
+  audio_src_t *src = &audio->src_tx;
+
+  // Sample rate is set by host, otherwise send ZLP
+  if (audio->sample_rate_tx == 0 || audio->interval_tx == 0) return 0;
+
+  // Nominal frames of this packet, fractional part is carried over e.g 44.1 kHz: 9 x 44 + 1 x 45
+  uint16_t const frame_div = (tud_speed_get() == TUSB_SPEED_FULL) ? 1000 : 8000;
+  uint8_t const interval = (tud_speed_get() == TUSB_SPEED_FULL) ? audio->interval_tx : (uint8_t) (1 << (audio->interval_tx - 1));
+  uint32_t const rate = audio->sample_rate_tx * interval;
+  uint16_t n_out = (uint16_t) (rate / frame_div);
+  audio->src_tx_remainder = (uint16_t) (audio->src_tx_remainder + rate % frame_div);
+  if (audio->src_tx_remainder >= frame_div) {
+    audio->src_tx_remainder = (uint16_t) (audio->src_tx_remainder - frame_div);
+    n_out++;
+  }
+  n_out = tu_min16(n_out, (uint16_t) (audio->ep_in_sz / (n_ff_used * nSlotSize)));
+
+  uint16_t n_avail = tu_fifo_count(&audio->tx_supp_ff[0]);
+  for (uint8_t cnt_ff = 1; cnt_ff < n_ff_used; cnt_ff++) {
+    n_avail = tu_min16(n_avail, tu_fifo_count(&audio->tx_supp_ff[cnt_ff]));
   }
+  n_avail /= nSlotSize;
+
+  uint16_t const ff_frames = tu_fifo_depth(&audio->tx_supp_ff[0]) / nSlotSize;
+  audio_src_update(src, n_avail, ff_frames / 2, n_out);
+
+  // Underflow: send what is available
+  n_out = tu_min16(n_out, audio_src_out_count_max(src, n_avail));
+  uint16_t const n_in = audio_src_in_count(src, n_out);
+
+  for (uint8_t cnt_ff = 0; cnt_ff < n_ff_used; cnt_ff++) {
+    tu_fifo_buffer_info_t info;
+    tu_fifo_read_acquire(&audio->tx_supp_ff[cnt_ff], &info);
+
+    audio_src_buf_t const in = {
+      .ptr = {(uint8_t *) info.ptr_lin, (uint8_t *) info.ptr_wrap},
+      .n_lin = info.len_lin / nSlotSize,
+      .stride = nSlotSize
+    };
+    audio_src_buf_t const out = {
+      .ptr = {&audio->lin_buf_in[cnt_ff * nSlotSize], NULL},
+      .n_lin = n_out,
+      .stride = (uint16_t) (n_ff_used * nSlotSize)
+    };
+
+    audio_src_process(src, (uint8_t) (cnt_ff * audio->n_channels_per_ff_tx), audio->n_channels_per_ff_tx, n_bytes,
+                      &in, n_in, &out, n_out);
+    tu_fifo_read_release(&audio->tx_supp_ff[cnt_ff], n_in * nSlotSize);
+  }
+
+  audio_src_advance(src, n_in, n_out);
+
+  return (uint16_t) (n_out * n_ff_used * nSlotSize);
 }
+#endif
 
 static uint16_t audiod_encode_type_I_pcm(uint8_t rhport, audiod_function_t *audio) {
   // This function relies on the fact that the length of the support FIFOs was configured to be a multiple of the active sample size in bytes s.t. no sample is split within a wrap
@@ -1113,8 +1353,15 @@ static uint16_t audiod_encode_type_I_pcm(uint8_t rhport, audiod_function_t *audi
   // We encode directly into IN EP's linear buffer - abort if previous transfer not complete
   TU_VERIFY(!usbd_edpt_busy(rhport, audio->ep_in));
 
+  #if AUDIOD_SRC_TX
+  if (!audio->ep_in_bulk && audio->n_channels_tx <= CFG_TUD_AUDIO_SRC_MAX_CHANNELS) {
+    return audiod_encode_type_I_pcm_src(audio);
+  }
+  #endif
+
   // Determine amount of samples
   uint8_t const n_ff_used = audio->n_ff_used_tx;
+  uint8_t const nSlotSize = (uint8_t) (audio->n_channels_per_ff_tx * audio->n_bytes_per_sample_tx);
   uint16_t nBytesPerFFToSend = tu_fifo_count(&audio->tx_supp_ff[0]);
   uint8_t cnt_ff;
 
@@ -1126,22 +1373,24 @@ static uint16_t audiod_encode_type_I_pcm(uint8_t rhport, audiod_function_t *audi
   }
 
   #if CFG_TUD_AUDIO_EP_IN_FLOW_CONTROL
-  const uint16_t norm_packet_sz_tx[3] = {audio->packet_sz_tx[0] / n_ff_used,
-                                         audio->packet_sz_tx[1] / n_ff_used,
-                                         audio->packet_sz_tx[2] / n_ff_used};
-  // packet_sz_tx is based on total packet size, here we want size for each support buffer.
-  nBytesPerFFToSend = audiod_tx_packet_size(norm_packet_sz_tx, nBytesPerFFToSend, audio->tx_supp_ff[0].depth, audio->ep_in_sz / n_ff_used);
-  // Check if there is enough data
-  if (nBytesPerFFToSend == 0) return 0;
-  #else
-  // Check if there is enough data
-  if (nBytesPerFFToSend == 0) return 0;
-  // Limit to maximum sample number - THIS IS A POSSIBLE ERROR SOURCE IF TOO MANY SAMPLE WOULD NEED TO BE SENT BUT CAN NOT!
-  nBytesPerFFToSend = tu_min16(nBytesPerFFToSend, audio->ep_in_sz / n_ff_used);
-  // Round to full number of samples (flooring)
-  uint16_t const nSlotSize = audio->n_channels_per_ff_tx * audio->n_bytes_per_sample_tx;
-  nBytesPerFFToSend = (nBytesPerFFToSend / nSlotSize) * nSlotSize;
+  if (!audio->ep_in_bulk) {
+    const uint16_t norm_packet_sz_tx[3] = {audio->packet_sz_tx[0] / n_ff_used,
+                                           audio->packet_sz_tx[1] / n_ff_used,
+                                           audio->packet_sz_tx[2] / n_ff_used};
+    // packet_sz_tx is based on total packet size, here we want size for each support buffer.
+    nBytesPerFFToSend = audiod_tx_packet_size(norm_packet_sz_tx, nBytesPerFFToSend, audio->tx_supp_ff[0].depth, audio->ep_in_sz / n_ff_used);
+    // Check if there is enough data
+    if (nBytesPerFFToSend == 0) return 0;
+  } else
   #endif
+  {
+    // Check if there is enough data
+    if (nBytesPerFFToSend == 0) return 0;
+    // Limit to maximum sample number - THIS IS A POSSIBLE ERROR SOURCE IF TOO MANY SAMPLE WOULD NEED TO BE SENT BUT CAN NOT!
+    nBytesPerFFToSend = tu_min16(nBytesPerFFToSend, audiod_tx_xfer_sz(audio) / n_ff_used);
+    // Round to full number of samples (flooring)
+    nBytesPerFFToSend = (uint16_t) ((nBytesPerFFToSend / nSlotSize) * nSlotSize);
+  }
 
   // Encode
   uint8_t *dst;
@@ -1150,14 +1399,14 @@ static uint16_t audiod_encode_type_I_pcm(uint8_t rhport, audiod_function_t *audi
   tu_fifo_buffer_info_t info;
 
   for (cnt_ff = 0; cnt_ff < n_ff_used; cnt_ff++) {
-    dst = &audio->lin_buf_in[cnt_ff * audio->n_channels_per_ff_tx * audio->n_bytes_per_sample_tx];
+    dst = &audio->lin_buf_in[cnt_ff * nSlotSize];
 
-    tu_fifo_get_read_info(&audio->tx_supp_ff[cnt_ff], &info);
+    tu_fifo_read_acquire(&audio->tx_supp_ff[cnt_ff], &info);
 
     if (info.len_lin != 0) {
       info.len_lin = tu_min16(nBytesPerFFToSend, info.len_lin);// Limit up to desired length
       src_end = (uint8_t *) info.ptr_lin + info.len_lin;
-      dst = audiod_interleaved_copy_bytes_fast_encode(audio->n_bytes_per_sample_tx, info.ptr_lin, src_end, dst, n_ff_used);
+      dst = audio_pcm_interleave(info.ptr_lin, src_end, dst, nSlotSize, n_ff_used);
 
       // Limit up to desired length
       info.len_wrap = tu_min16(nBytesPerFFToSend - info.len_lin, info.len_wrap);
@@ -1165,10 +1414,10 @@ static uint16_t audiod_encode_type_I_pcm(uint8_t rhport, audiod_function_t *audi
       // Handle wrapped part of FIFO
       if (info.len_wrap != 0) {
         src_end = (uint8_t *) info.ptr_wrap + info.len_wrap;
-        audiod_interleaved_copy_bytes_fast_encode(audio->n_bytes_per_sample_tx, info.ptr_wrap, src_end, dst, n_ff_used);
+        audio_pcm_interleave(info.ptr_wrap, src_end, dst, nSlotSize, n_ff_used);
       }
 
-      tu_fifo_advance_read_pointer(&audio->tx_supp_ff[cnt_ff], info.len_lin + info.len_wrap);
+      tu_fifo_read_release(&audio->tx_supp_ff[cnt_ff], info.len_lin + info.len_wrap);
     }
   }
 
@@ -1181,6 +1430,11 @@ static uint16_t audiod_encode_type_I_pcm(uint8_t rhport, audiod_function_t *audi
 #if CFG_TUD_AUDIO_ENABLE_EP_OUT && CFG_TUD_AUDIO_ENABLE_FEEDBACK_EP
 static inline bool audiod_fb_send(audiod_function_t *audio) {
   bool apply_correction = (TUSB_SPEED_FULL == tud_speed_get()) && audio->feedback.format_correction;
+
+  #if CFG_TUD_AUDIO_ENABLE_TELEMETRY
+  audio->telemetry.fb_trace[audio->telemetry.fb_count % CFG_TUD_AUDIO_TELEMETRY_FB_TRACE] = audio->feedback.value;
+  audio->telemetry.fb_count++;
+  #endif
   // Format the feedback value
   if (apply_correction) {
     uint8_t *fb = (uint8_t *) audio->fb_buf;
@@ -1778,9 +2032,13 @@ static bool audiod_set_interface(uint8_t rhport, tusb_control_request_t const *p
 #if CFG_TUD_AUDIO_ENABLE_EP_IN
   if (audio->ep_in_as_intf_num == itf) {
     audio->ep_in_as_intf_num = 0;
-  #ifndef TUP_DCD_EDPT_ISO_ALLOC
-    usbd_edpt_close(rhport, audio->ep_in);
+  #ifdef TUP_DCD_EDPT_ISO_ALLOC
+    if (audio->ep_in_bulk)
   #endif
+    {
+      usbd_edpt_close(rhport, audio->ep_in);
+    }
+    audio->ep_in_bulk = false;
 
     // Clear FIFOs, since data is no longer valid
   #if !CFG_TUD_AUDIO_ENABLE_ENCODING
@@ -1807,9 +2065,13 @@ static bool audiod_set_interface(uint8_t rhport, tusb_control_request_t const *p
 #if CFG_TUD_AUDIO_ENABLE_EP_OUT
   if (audio->ep_out_as_intf_num == itf) {
     audio->ep_out_as_intf_num = 0;
-  #ifndef TUP_DCD_EDPT_ISO_ALLOC
-    usbd_edpt_close(rhport, audio->ep_out);
+  #ifdef TUP_DCD_EDPT_ISO_ALLOC
+    if (audio->ep_out_bulk)
   #endif
+    {
+      usbd_edpt_close(rhport, audio->ep_out);
+    }
+    audio->ep_out_bulk = false;
 
     // Clear FIFOs, since data is no longer valid
   #if !CFG_TUD_AUDIO_ENABLE_DECODING
@@ -1858,10 +2120,13 @@ static bool audiod_set_interface(uint8_t rhport, tusb_control_request_t const *p
         if (tu_desc_type(p_desc) == TUSB_DESC_ENDPOINT) {
           tusb_desc_endpoint_t const *desc_ep = (tusb_desc_endpoint_t const *) p_desc;
 #ifdef TUP_DCD_EDPT_ISO_ALLOC
-          TU_ASSERT(usbd_edpt_iso_activate(rhport, desc_ep));
-#else
-          TU_ASSERT(usbd_edpt_open(rhport, desc_ep));
+          if (desc_ep->bmAttributes.xfer == TUSB_XFER_ISOCHRONOUS) {
+            TU_ASSERT(usbd_edpt_iso_activate(rhport, desc_ep));
+          } else
 #endif
+          {
+            TU_ASSERT(usbd_edpt_open(rhport, desc_ep));
+          }
           uint8_t const ep_addr = desc_ep->bEndpointAddress;
 
           //TODO: We need to set EP non busy since this is not taken care of right now in ep_close() - THIS IS A WORKAROUND!
@@ -1874,6 +2139,7 @@ static bool audiod_set_interface(uint8_t rhport, tusb_control_request_t const *p
             audio->ep_in = ep_addr;
             audio->ep_in_as_intf_num = itf;
             audio->ep_in_sz = tu_edpt_packet_size(desc_ep);
+            audio->ep_in_bulk = (desc_ep->bmAttributes.xfer == TUSB_XFER_BULK);
 
             // If software encoding is enabled, parse for the corresponding parameters - doing this here means only AS interfaces with EPs get scanned for parameters
   #if CFG_TUD_AUDIO_ENABLE_ENCODING || CFG_TUD_AUDIO_EP_IN_FLOW_CONTROL
@@ -1887,12 +2153,20 @@ static bool audiod_set_interface(uint8_t rhport, tusb_control_request_t const *p
             }
             audio->n_ff_used_tx = audio->n_channels_tx / audio->n_channels_per_ff_tx;
             TU_ASSERT(audio->n_ff_used_tx <= audio->n_tx_supp_ff);
+      #if AUDIOD_SRC_TX
+            audio_src_init(&audio->src_tx);
+            audio->src_tx_remainder = 0;
+      #endif
     #endif
   #endif
 
             // Schedule first transmit if alternate interface is not zero i.e. streaming is disabled - in case no sample data is available a ZLP is loaded
             // It is necessary to trigger this here since the refill is done with an RX FIFO empty interrupt which can only trigger if something was in there
-            TU_VERIFY(audiod_tx_done_cb(rhport, &_audiod_fct[func_id]));
+            if (audio->ep_in_bulk) {
+              (void) audiod_bulk_tx_kick(audio);
+            } else {
+              TU_VERIFY(audiod_tx_done_cb(rhport, &_audiod_fct[func_id]));
+            }
           }
 #endif// CFG_TUD_AUDIO_ENABLE_EP_IN
 
@@ -1904,26 +2178,30 @@ static bool audiod_set_interface(uint8_t rhport, tusb_control_request_t const *p
             audio->ep_out = ep_addr;
             audio->ep_out_as_intf_num = itf;
             audio->ep_out_sz = tu_edpt_packet_size(desc_ep);
+            audio->ep_out_bulk = (desc_ep->bmAttributes.xfer == TUSB_XFER_BULK);
 
   #if CFG_TUD_AUDIO_ENABLE_DECODING
             audiod_parse_for_AS_params(audio, p_desc_parse_for_params, p_desc_end, itf);
 
               // Reconfigure size of support FIFOs - this is necessary to avoid samples to get split in case of a wrap
     #if CFG_TUD_AUDIO_ENABLE_TYPE_I_DECODING
-            const uint16_t active_fifo_depth = (audio->rx_supp_ff_sz_max / audio->n_bytes_per_sample_rx) * audio->n_bytes_per_sample_rx;
+            const uint16_t active_fifo_depth = (uint16_t) ((audio->rx_supp_ff_sz_max / (audio->n_channels_per_ff_rx * audio->n_bytes_per_sample_rx)) * (audio->n_channels_per_ff_rx * audio->n_bytes_per_sample_rx));
             for (uint8_t cnt = 0; cnt < audio->n_rx_supp_ff; cnt++) {
               tu_fifo_config(&audio->rx_supp_ff[cnt], audio->rx_supp_ff[cnt].buffer, active_fifo_depth, 1, true);
             }
             audio->n_ff_used_rx = audio->n_channels_rx / audio->n_channels_per_ff_rx;
             TU_ASSERT(audio->n_ff_used_rx <= audio->n_rx_supp_ff);
+      #if AUDIOD_SRC_RX
+            audio_src_init(&audio->src_rx);
+      #endif
     #endif
   #endif
 
             // Prepare for incoming data
   #if USE_LINEAR_BUFFER_RX
-            TU_VERIFY(usbd_edpt_xfer(rhport, audio->ep_out, audio->lin_buf_out, audio->ep_out_sz), false);
+            TU_VERIFY(usbd_edpt_xfer(rhport, audio->ep_out, audio->lin_buf_out, audiod_rx_xfer_sz(audio)), false);
   #else
-            TU_VERIFY(usbd_edpt_xfer_fifo(rhport, audio->ep_out, &audio->ep_out_ff, audio->ep_out_sz), false);
+            TU_VERIFY(usbd_edpt_xfer_fifo(rhport, audio->ep_out, &audio->ep_out_ff, audiod_rx_xfer_sz(audio)), false);
   #endif
           }
 
@@ -1989,6 +2267,17 @@ static bool audiod_set_interface(uint8_t rhport, tusb_control_request_t const *p
               audio->feedback.compute.fifo_count.rate_const[0] /= 8;
               audio->feedback.compute.fifo_count.rate_const[1] /= 8;
             }
+
+  #if AUDIOD_SRC_RX
+            // Converter keeps FIFO level and decoding does not update feedback: send nominal value, which is
+            // repeated after each feedback transfer
+            if (audio->n_channels_rx <= CFG_TUD_AUDIO_SRC_MAX_CHANNELS) {
+              audio->feedback.value = nominal;
+              if (usbd_edpt_claim(rhport, audio->ep_fb)) {
+                (void) audiod_fb_send(audio);
+              }
+            }
+  #endif
           } break;
 
           // nothing to do
@@ -2213,7 +2502,12 @@ bool audiod_xfer_cb(uint8_t rhport, uint8_t ep_addr, xfer_result_t result, uint3
       // This is the only place where we can fill something into the EPs buffer!
 
       // Load new data
-      TU_VERIFY(audiod_tx_done_cb(rhport, audio));
+      if (audio->ep_in_bulk) {
+        // may already be loaded by write API
+        (void) audiod_bulk_tx_kick(audio);
+      } else {
+        TU_VERIFY(audiod_tx_done_cb(rhport, audio));
+      }
 
       // Transmission of ZLP is done by audiod_tx_done_cb()
       return true;
@@ -2283,6 +2577,9 @@ static void audiod_fb_fifo_count_update(audiod_function_t *audio, uint16_t lvl_n
   uint32_t lvl = audio->feedback.compute.fifo_count.fifo_lvl_avg;
   lvl = (uint32_t) (((uint64_t) lvl * 63 + ((uint32_t) lvl_new << 16)) >> 6);
   audio->feedback.compute.fifo_count.fifo_lvl_avg = lvl;
+  #if CFG_TUD_AUDIO_ENABLE_TELEMETRY
+  audio->telemetry.fb_fifo_avg = lvl;
+  #endif
 
   uint32_t const ff_lvl = lvl >> 16;
   uint16_t const ff_thr = audio->feedback.compute.fifo_count.fifo_lvl_thr;
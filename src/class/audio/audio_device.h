@@ -125,6 +125,21 @@
 #endif
 #endif // CFG_TUD_AUDIO_ENABLE_EP_OUT
 
+// Number of packets per transfer of bulk audio data EPs (non standard bulk streaming AS interface). Received data is
+// decoded and the next transfer is scheduled once per batch instead of every packet, which reduces CPU load at
+// high-speed. Bulk IN sends all available data and no ZLP, bulk OUT completes early on a short packet so host should
+// send full packets.
+// Isochronous EPs are not batched: each (micro)frame packet has its own size, and TUD_AUDIO_EP_SIZE() includes a spare
+// sample so that every packet is short and would end a multi-packet transfer anyway. Linear buffers are sized to hold a
+// full batch, EP OUT software buffer must be large enough as well.
+// Note: with bulk IN EP, tud_audio_n_write(), tud_audio_n_write_support_ff() and tud_audio_n_flush_tx_support_ff()
+// start the transfer themselves (claim and submit the EP), they must not be called from an ISR.
+#ifndef CFG_TUD_AUDIO_XFER_BATCH
+#define CFG_TUD_AUDIO_XFER_BATCH                            1
+#endif
+
+TU_VERIFY_STATIC(CFG_TUD_AUDIO_XFER_BATCH >= 1 && CFG_TUD_AUDIO_XFER_BATCH <= 255, "CFG_TUD_AUDIO_XFER_BATCH must be 1 to 255");
+
 // Software EP FIFO buffer sizes - must be >= max EP SIZEs!
 #ifndef CFG_TUD_AUDIO_FUNC_1_EP_IN_SW_BUF_SZ
 #define CFG_TUD_AUDIO_FUNC_1_EP_IN_SW_BUF_SZ                0
@@ -150,35 +165,41 @@
 #if CFG_TUD_AUDIO_FUNC_1_EP_IN_SW_BUF_SZ < CFG_TUD_AUDIO_FUNC_1_EP_IN_SZ_MAX
 #error EP software buffer size MUST BE at least as big as maximum EP size
 #endif
+TU_VERIFY_STATIC(CFG_TUD_AUDIO_FUNC_1_EP_IN_SZ_MAX * CFG_TUD_AUDIO_XFER_BATCH <= UINT16_MAX, "EP IN batch exceeds 16-bit transfer size");
 
 #if CFG_TUD_AUDIO > 1
 #if CFG_TUD_AUDIO_FUNC_2_EP_IN_SW_BUF_SZ < CFG_TUD_AUDIO_FUNC_2_EP_IN_SZ_MAX
 #error EP software buffer size MUST BE at least as big as maximum EP size
 #endif
+TU_VERIFY_STATIC(CFG_TUD_AUDIO_FUNC_2_EP_IN_SZ_MAX * CFG_TUD_AUDIO_XFER_BATCH <= UINT16_MAX, "EP IN batch exceeds 16-bit transfer size");
 #endif
 
 #if CFG_TUD_AUDIO > 2
 #if CFG_TUD_AUDIO_FUNC_3_EP_IN_SW_BUF_SZ < CFG_TUD_AUDIO_FUNC_3_EP_IN_SZ_MAX
 #error EP software buffer size MUST BE at least as big as maximum EP size
 #endif
+TU_VERIFY_STATIC(CFG_TUD_AUDIO_FUNC_3_EP_IN_SZ_MAX * CFG_TUD_AUDIO_XFER_BATCH <= UINT16_MAX, "EP IN batch exceeds 16-bit transfer size");
 #endif
 #endif
 
 #if CFG_TUD_AUDIO_ENABLE_EP_OUT
-#if CFG_TUD_AUDIO_FUNC_1_EP_OUT_SW_BUF_SZ < CFG_TUD_AUDIO_FUNC_1_EP_OUT_SZ_MAX
-#error EP software buffer size MUST BE at least as big as maximum EP size
+#if CFG_TUD_AUDIO_FUNC_1_EP_OUT_SW_BUF_SZ < CFG_TUD_AUDIO_FUNC_1_EP_OUT_SZ_MAX * CFG_TUD_AUDIO_XFER_BATCH
+#error EP software buffer size MUST BE at least as big as maximum EP size times CFG_TUD_AUDIO_XFER_BATCH
 #endif
+TU_VERIFY_STATIC(CFG_TUD_AUDIO_FUNC_1_EP_OUT_SZ_MAX * CFG_TUD_AUDIO_XFER_BATCH <= UINT16_MAX, "EP OUT batch exceeds 16-bit transfer size");
 
 #if CFG_TUD_AUDIO > 1
-#if CFG_TUD_AUDIO_FUNC_2_EP_OUT_SW_BUF_SZ < CFG_TUD_AUDIO_FUNC_2_EP_OUT_SZ_MAX
-#error EP software buffer size MUST BE at least as big as maximum EP size
+#if CFG_TUD_AUDIO_FUNC_2_EP_OUT_SW_BUF_SZ < CFG_TUD_AUDIO_FUNC_2_EP_OUT_SZ_MAX * CFG_TUD_AUDIO_XFER_BATCH
+#error EP software buffer size MUST BE at least as big as maximum EP size times CFG_TUD_AUDIO_XFER_BATCH
 #endif
+TU_VERIFY_STATIC(CFG_TUD_AUDIO_FUNC_2_EP_OUT_SZ_MAX * CFG_TUD_AUDIO_XFER_BATCH <= UINT16_MAX, "EP OUT batch exceeds 16-bit transfer size");
 #endif
 
 #if CFG_TUD_AUDIO > 2
-#if CFG_TUD_AUDIO_FUNC_3_EP_OUT_SW_BUF_SZ < CFG_TUD_AUDIO_FUNC_3_EP_OUT_SZ_MAX
-#error EP software buffer size MUST BE at least as big as maximum EP size
+#if CFG_TUD_AUDIO_FUNC_3_EP_OUT_SW_BUF_SZ < CFG_TUD_AUDIO_FUNC_3_EP_OUT_SZ_MAX * CFG_TUD_AUDIO_XFER_BATCH
+#error EP software buffer size MUST BE at least as big as maximum EP size times CFG_TUD_AUDIO_XFER_BATCH
 #endif
+TU_VERIFY_STATIC(CFG_TUD_AUDIO_FUNC_3_EP_OUT_SZ_MAX * CFG_TUD_AUDIO_XFER_BATCH <= UINT16_MAX, "EP OUT batch exceeds 16-bit transfer size");
 #endif
 #endif
 
@@ -248,7 +269,7 @@
 // The actual coding parameters of active AS alternate interface is parsed from the descriptors
 
 // The item size of the FIFO is always fixed to one i.e. bytes! Furthermore, the actively used FIFO depth is reconfigured such that the depth is a multiple
-// of the current sample size in order to avoid samples to get split up in case of a wrap in the FIFO ring buffer (depth = (max_depth / sample_sz) * sample_sz)!
+// of the current slot size (channels per FIFO * bytes per sample) in order to avoid samples to get split up in case of a wrap in the FIFO ring buffer (depth = (max_depth / slot_sz) * slot_sz)!
 // This is important to remind in case you use DMAs! If the sample sizes changes, the DMA MUST BE RECONFIGURED just like the FIFOs for a different depth!!!
 
 // For PCM encoding/decoding
@@ -270,6 +291,31 @@
 #define CFG_TUD_AUDIO_ENABLE_TYPE_I_DECODING                0
 #endif
 
+// Asynchronous sample rate conversion between USB and codec clock for Type I coding (see audio_src.h). Samples are resampled
+// while being decoded into/encoded from the support FIFOs, such that the FIFO fill level stays at half depth regardless
+// of clock drift, without feedback EP and without dropping/inserting samples. Encoding additionally requires
+// CFG_TUD_AUDIO_EP_IN_FLOW_CONTROL: packets are sized after nominal sample rate instead of FIFO level.
+#ifndef CFG_TUD_AUDIO_ENABLE_SRC
+#define CFG_TUD_AUDIO_ENABLE_SRC                            0
+#endif
+
+// Per-stream telemetry to tune buffer depths: FIFO fill level (min/max/average), overrun/underrun counters, trace of
+// sent feedback values and time spent handling each transfer in CFG_TUSB_STATS_TIMESTAMP() ticks. Read with
+// tud_audio_n_telemetry_get() or by host with a vendor request, see tud_audio_telemetry_control_xfer_cb()
+#ifndef CFG_TUD_AUDIO_ENABLE_TELEMETRY
+#define CFG_TUD_AUDIO_ENABLE_TELEMETRY                      0
+#endif
+
+// Number of last feedback values kept in telemetry
+#ifndef CFG_TUD_AUDIO_TELEMETRY_FB_TRACE
+#define CFG_TUD_AUDIO_TELEMETRY_FB_TRACE                    16
+#endif
+
+// bRequest of vendor request reading telemetry
+#ifndef CFG_TUD_AUDIO_TELEMETRY_REQUEST
+#define CFG_TUD_AUDIO_TELEMETRY_REQUEST                     0x54
+#endif
+
 // Type I Coding parameters not given within UAC2 descriptors
 // It would be possible to allow for a more flexible setting and not fix this parameter as done below. However, this is most often not needed and kept for later if really necessary. The more flexible setting could be implemented within set_interface(), however, how the values are saved per alternate setting is to be determined!
 #if CFG_TUD_AUDIO_ENABLE_EP_IN && CFG_TUD_AUDIO_ENABLE_ENCODING && CFG_TUD_AUDIO_ENABLE_TYPE_I_ENCODING
@@ -399,6 +445,43 @@ tu_fifo_t* tud_audio_n_get_tx_support_ff          (uint8_t func_id, uint8_t ff_i
 bool    tud_audio_int_n_write                     (uint8_t func_id, const audio_interrupt_data_t * data);
 #endif
 
+#if CFG_TUD_AUDIO_ENABLE_TELEMETRY
+// Telemetry of one direction. FIFO is the first support FIFO if coding is enabled, EP FIFO otherwise. Level is taken
+// after a received packet is stored (RX) and before a packet is loaded for transmit (TX).
+typedef struct {
+  uint32_t xfers;      // handled transfers
+  uint32_t overruns;   // RX: packet received while FIFO overflowed, TX: FIFO overflowed by application writes
+  uint32_t underruns;  // RX: FIFO was empty when packet received, TX: ZLP sent since FIFO was empty
+  uint32_t fill_avg;   // moving average of FIFO level in bytes, 16.16 format, weight 1/64 per transfer
+  uint16_t fill_min;   // min FIFO level in bytes
+  uint16_t fill_max;   // max FIFO level in bytes
+  uint16_t depth;      // FIFO depth in bytes
+  uint16_t reserved;
+  uint32_t proc_ticks; // total time spent handling transfers including rx/tx done callbacks
+  uint32_t proc_max;   // max time spent handling a single transfer
+} audio_telemetry_stream_t;
+
+// Vendor request reply is this struct as is: little endian, no padding
+typedef struct {
+  audio_telemetry_stream_t rx;
+  audio_telemetry_stream_t tx;
+  uint32_t fb_fifo_avg; // FIFO level average in bytes (16.16) of AUDIO_FEEDBACK_METHOD_FIFO_COUNT
+  uint32_t fb_count;    // number of feedback values sent, latest is fb_trace[(fb_count - 1) % CFG_TUD_AUDIO_TELEMETRY_FB_TRACE]
+  uint32_t fb_trace[CFG_TUD_AUDIO_TELEMETRY_FB_TRACE]; // feedback values in 16.16 format
+} audio_telemetry_t;
+
+// Telemetry is updated by usbd task, feedback trace also by tud_audio_n_fb_set(). Get/clear is not atomic: call them
+// from the same context e.g within a tud_*_cb() callback, or from the loop that calls tud_task() with OPT_OS_NONE.
+// Called from another thread or while feedback is set from ISR, the copy may mix values of consecutive transfers.
+bool     tud_audio_n_telemetry_get                (uint8_t func_id, audio_telemetry_t* telemetry);
+bool     tud_audio_n_telemetry_clear              (uint8_t func_id);
+
+// Reply vendor request (IN, bRequest = CFG_TUD_AUDIO_TELEMETRY_REQUEST, wIndex = func_id) with audio_telemetry_t,
+// telemetry is cleared after read if wValue = 1. To be called from tud_vendor_control_xfer_cb(), return false if
+// request is not a telemetry request.
+bool     tud_audio_telemetry_control_xfer_cb      (uint8_t rhport, uint8_t stage, tusb_control_request_t const * request);
+#endif
+
 
 //--------------------------------------------------------------------+
 // Application API (Interface0)
@@ -443,6 +526,11 @@ static inline tu_fifo_t* tud_audio_get_tx_support_ff        (uint8_t ff_idx);
 static inline bool tud_audio_int_write                      (const audio_interrupt_data_t * data);
 #endif
 
+#if CFG_TUD_AUDIO_ENABLE_TELEMETRY
+static inline bool tud_audio_telemetry_get                  (audio_telemetry_t* telemetry);
+static inline bool tud_audio_telemetry_clear                (void);
+#endif
+
 // Buffer control EP data and schedule a transmit
 // This function is intended to be used if you do not have a persistent buffer or memory location available (e.g. non-local variables) and need to answer onto a
 // get request. This function buffers your answer request frame into the control buffer of the corresponding audio driver and schedules a transmit for sending it.
@@ -693,6 +781,18 @@ static inline bool tud_audio_int_write(const audio_interrupt_data_t * data)
 }
 #endif
 
+#if CFG_TUD_AUDIO_ENABLE_TELEMETRY
+static inline bool tud_audio_telemetry_get(audio_telemetry_t* telemetry)
+{
+  return tud_audio_n_telemetry_get(0, telemetry);
+}
+
+static inline bool tud_audio_telemetry_clear(void)
+{
+  return tud_audio_n_telemetry_clear(0);
+}
+#endif
+
 #if CFG_TUD_AUDIO_ENABLE_EP_OUT && CFG_TUD_AUDIO_ENABLE_FEEDBACK_EP
 
 static inline bool tud_audio_fb_set(uint32_t feedback)
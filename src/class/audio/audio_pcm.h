@@ -0,0 +1,170 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Ha Thach (tinyusb.org)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * This file is part of the TinyUSB stack.
+ */
+
+#ifndef TUSB_AUDIO_PCM_H_
+#define TUSB_AUDIO_PCM_H_
+
+#include "common/tusb_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Type I PCM (de)interleave kernels according to 2.3.1.5 Audio Streams. Stream carries n_ff slots per audio frame,
+// each slot holds all channels of one support FIFO i.e slot size = channels per FIFO * bytes per sample.
+// Slots are copied as whole 16/32-bit words, therefore FIFO and stream buffers must be aligned to the slot's word
+// size and FIFO depth must be a multiple of slot size (no slot is split by a wrap).
+//
+// Each (slot size, FIFO count) pair used by common PCM formats (8/16/24/32-bit stereo slot, 1/2/4 FIFOs i.e
+// 2/4/8 channels) gets its own loop with constant stride, unrolled by 4 frames. Other combinations use the generic
+// loop. Set CFG_TUD_AUDIO_PCM_SPECIALIZED = 0 to keep only the generic loop when code size matters more.
+// Note: Cortex-M DSP extension has no instruction that helps a pure permutation copy beyond the word load/store
+// generated here.
+
+#ifndef CFG_TUD_AUDIO_PCM_SPECIALIZED
+  #define CFG_TUD_AUDIO_PCM_SPECIALIZED 1
+#endif
+
+// Copy one slot, slot_size is a constant after inlining
+TU_ATTR_ALWAYS_INLINE static inline void audio_pcm_slot_copy(void* dst, void const* src, uint8_t slot_size) {
+  switch (slot_size) {
+    case 2:
+      ((uint16_t*) dst)[0] = ((uint16_t const*) src)[0];
+      break;
+
+    case 4:
+      ((uint32_t*) dst)[0] = ((uint32_t const*) src)[0];
+      break;
+
+    case 6:
+      ((uint16_t*) dst)[0] = ((uint16_t const*) src)[0];
+      ((uint16_t*) dst)[1] = ((uint16_t const*) src)[1];
+      ((uint16_t*) dst)[2] = ((uint16_t const*) src)[2];
+      break;
+
+    case 8:
+      ((uint32_t*) dst)[0] = ((uint32_t const*) src)[0];
+      ((uint32_t*) dst)[1] = ((uint32_t const*) src)[1];
+      break;
+
+    default:
+      memcpy(dst, src, slot_size);
+      break;
+  }
+}
+
+// Copy slots from a sparse (interleaved) to a dense (FIFO) buffer, or the other way around
+TU_ATTR_ALWAYS_INLINE static inline void audio_pcm_strided_copy(uint8_t* dst, uint16_t dst_stride,
+                                                                 uint8_t const* src, uint16_t src_stride,
+                                                                 uint16_t n_slots, uint8_t slot_size) {
+  // 4 frames per iteration
+  for (uint16_t n = n_slots / 4; n > 0; n--) {
+    audio_pcm_slot_copy(dst, src, slot_size);
+    audio_pcm_slot_copy(dst + dst_stride, src + src_stride, slot_size);
+    audio_pcm_slot_copy(dst + 2 * dst_stride, src + 2 * src_stride, slot_size);
+    audio_pcm_slot_copy(dst + 3 * dst_stride, src + 3 * src_stride, slot_size);
+    dst += 4 * dst_stride;
+    src += 4 * src_stride;
+  }
+
+  for (uint16_t n = n_slots % 4; n > 0; n--) {
+    audio_pcm_slot_copy(dst, src, slot_size);
+    dst += dst_stride;
+    src += src_stride;
+  }
+}
+
+// Stream -> FIFO
+TU_ATTR_ALWAYS_INLINE static inline void audio_pcm_gather(uint8_t* dst, uint8_t const* src, uint16_t n_slots,
+                                                           uint8_t slot_size, uint8_t n_ff) {
+  audio_pcm_strided_copy(dst, slot_size, src, (uint16_t) (slot_size * n_ff), n_slots, slot_size);
+}
+
+// FIFO -> Stream
+TU_ATTR_ALWAYS_INLINE static inline void audio_pcm_scatter(uint8_t* dst, uint8_t const* src, uint16_t n_slots,
+                                                            uint8_t slot_size, uint8_t n_ff) {
+  audio_pcm_strided_copy(dst, (uint16_t) (slot_size * n_ff), src, slot_size, n_slots, slot_size);
+}
+
+#if CFG_TUD_AUDIO_PCM_SPECIALIZED
+  #define _AUDIO_PCM_CASE(_func, _slot_size, _n_ff) \
+    case ((_slot_size) << 8 | (_n_ff)): _func(dst, src, n_slots, _slot_size, _n_ff); break
+
+  // expand loops with constant (slot size, fifo count)
+  #define _AUDIO_PCM_DISPATCH(_func)                                           \
+    switch ((uint16_t) (slot_size << 8 | n_ff)) {                              \
+      _AUDIO_PCM_CASE(_func, 2, 2); _AUDIO_PCM_CASE(_func, 2, 4);             \
+      _AUDIO_PCM_CASE(_func, 4, 2); _AUDIO_PCM_CASE(_func, 4, 4);             \
+      _AUDIO_PCM_CASE(_func, 6, 2); _AUDIO_PCM_CASE(_func, 6, 4);             \
+      _AUDIO_PCM_CASE(_func, 8, 2); _AUDIO_PCM_CASE(_func, 8, 4);             \
+      default: _func(dst, src, n_slots, slot_size, n_ff); break;              \
+    }
+#else
+  #define _AUDIO_PCM_DISPATCH(_func)  _func(dst, src, n_slots, slot_size, n_ff)
+#endif
+
+// Decode: copy slots of one FIFO out of the interleaved stream into [dst, dst_end).
+// Return src position after the last copied frame.
+static inline void const* audio_pcm_deinterleave(void* dst_buf, void const* dst_end, void const* src_buf,
+                                                 uint8_t slot_size, uint8_t n_ff) {
+  uint16_t const n_slots = (uint16_t) (((uint8_t const*) dst_end - (uint8_t*) dst_buf + slot_size - 1) / slot_size);
+  uint16_t const stride = (uint16_t) (slot_size * n_ff);
+
+  if (n_ff == 1) {
+    // single FIFO: stream is the FIFO content
+    memcpy(dst_buf, src_buf, (size_t) n_slots * slot_size);
+  } else {
+    uint8_t* dst = (uint8_t*) dst_buf;
+    uint8_t const* src = (uint8_t const*) src_buf;
+    _AUDIO_PCM_DISPATCH(audio_pcm_gather);
+  }
+
+  return (uint8_t const*) src_buf + (uint32_t) n_slots * stride;
+}
+
+// Encode: copy slots of one FIFO from [src, src_end) into the interleaved stream.
+// Return dst position after the last copied frame.
+static inline void* audio_pcm_interleave(void const* src_buf, void const* src_end, void* dst_buf, uint8_t slot_size,
+                                         uint8_t n_ff) {
+  uint16_t const n_slots = (uint16_t) (((uint8_t const*) src_end - (uint8_t const*) src_buf + slot_size - 1) / slot_size);
+  uint16_t const stride = (uint16_t) (slot_size * n_ff);
+
+  if (n_ff == 1) {
+    memcpy(dst_buf, src_buf, (size_t) n_slots * slot_size);
+  } else {
+    uint8_t* dst = (uint8_t*) dst_buf;
+    uint8_t const* src = (uint8_t const*) src_buf;
+    _AUDIO_PCM_DISPATCH(audio_pcm_scatter);
+  }
+
+  return (uint8_t*) dst_buf + (uint32_t) n_slots * stride;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
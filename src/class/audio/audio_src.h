@@ -0,0 +1,198 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Ha Thach (tinyusb.org)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * This file is part of the TinyUSB stack.
+ */
+
+#ifndef TUSB_AUDIO_SRC_H_
+#define TUSB_AUDIO_SRC_H_
+
+#include "common/tusb_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Asynchronous sample rate converter between USB clock and codec clock domain. Ratio is close to 1 and slowly
+// adjusted by a PI controller to keep the support FIFO (codec side) half filled. Samples are linear interpolated
+// in fixed-point: position is Q32.32 in unit of input frames, interpolation weight is Q16.
+//
+// Position 0 is the last input frame of previous block (kept in hist[]), position n is input frame n-1 of current
+// block. Output frame k of a block is at position pos + k * step, with step = 1 + delta (input frames per output frame).
+
+// Maximum number of channels (of all support FIFOs) of a stream
+#ifndef CFG_TUD_AUDIO_SRC_MAX_CHANNELS
+  #define CFG_TUD_AUDIO_SRC_MAX_CHANNELS  8
+#endif
+
+// Maximum deviation of conversion ratio in ppm, should cover tolerance of both USB and codec clock
+#ifndef CFG_TUD_AUDIO_SRC_MAX_PPM
+  #define CFG_TUD_AUDIO_SRC_MAX_PPM  1000
+#endif
+
+// Control loop: ratio changes by 2^-AUDIO_SRC_KP_SHIFT (~15 ppm) per frame of fill error, time constant is about
+// 2^AUDIO_SRC_KP_SHIFT / sample rate (1.4s at 48 kHz). Integral gain gives critical damping. Fill error is low-pass
+// filtered over 2^AUDIO_SRC_AVG_SHIFT blocks to hide burst read/write of the codec (DMA half buffers).
+#define AUDIO_SRC_KP_SHIFT   16
+#define AUDIO_SRC_KI_SHIFT   (2 * (AUDIO_SRC_KP_SHIFT + 1) - 32)
+#define AUDIO_SRC_AVG_SHIFT  5
+#define AUDIO_SRC_DELTA_MAX  ((int32_t) (CFG_TUD_AUDIO_SRC_MAX_PPM * 4295))
+
+typedef struct {
+  uint64_t pos;     // Q32.32 position of next output frame
+  int32_t delta;    // Q0.32 deviation of step from 1.0
+  int32_t err_avg;  // filtered fill error in 1/256 frames
+  int64_t integ;    // integral of fill error in frames x frames
+  int32_t hist[CFG_TUD_AUDIO_SRC_MAX_CHANNELS]; // last input frame of previous block
+} audio_src_t;
+
+// Frames in a FIFO (or linear) buffer, wrapped part starts at ptr[1]
+typedef struct {
+  uint8_t* ptr[2];
+  uint16_t n_lin;   // number of frames in linear part
+  uint16_t stride;  // bytes from one frame to next
+} audio_src_buf_t;
+
+TU_ATTR_ALWAYS_INLINE static inline void audio_src_init(audio_src_t* src) {
+  tu_memclr(src, sizeof(audio_src_t));
+}
+
+TU_ATTR_ALWAYS_INLINE static inline uint64_t audio_src_step(audio_src_t const* src) {
+  return (uint64_t) ((int64_t) (1ull << 32) + src->delta);
+}
+
+// Conversion ratio deviation in ppm (positive: more input frames consumed than output frames produced)
+TU_ATTR_ALWAYS_INLINE static inline int32_t audio_src_ppm(audio_src_t const* src) {
+  return (int32_t) (((int64_t) src->delta * 1000000) >> 32);
+}
+
+// Update ratio from fill level (frames) of codec side FIFO, called once per block of n_frames
+static inline void audio_src_update(audio_src_t* src, uint16_t fill, uint16_t target, uint16_t n_frames) {
+  int32_t const err = (int32_t) fill - (int32_t) target;
+  src->err_avg += ((err * 256) - src->err_avg) / (1 << AUDIO_SRC_AVG_SHIFT);
+
+  int64_t const p_term = (int64_t) src->err_avg * (1 << (32 - AUDIO_SRC_KP_SHIFT - 8));
+  int64_t const integ = src->integ + (int64_t) (src->err_avg / 256) * n_frames;
+  int64_t delta = p_term + integ / (1 << AUDIO_SRC_KI_SHIFT);
+
+  if (delta > AUDIO_SRC_DELTA_MAX) {
+    delta = AUDIO_SRC_DELTA_MAX;
+  } else if (delta < -AUDIO_SRC_DELTA_MAX) {
+    delta = -AUDIO_SRC_DELTA_MAX;
+  } else {
+    src->integ = integ; // only integrate while not saturated (anti wind-up)
+  }
+  src->delta = (int32_t) delta;
+}
+
+// Number of output frames of a block consuming n_in input frames (decoding)
+TU_ATTR_ALWAYS_INLINE static inline uint16_t audio_src_out_count(audio_src_t const* src, uint16_t n_in) {
+  uint64_t const limit = (uint64_t) n_in << 32;
+  if (limit <= src->pos) return 0;
+  return (uint16_t) ((limit - src->pos - 1) / audio_src_step(src) + 1);
+}
+
+// Max number of output frames when n_avail input frames are available (encoding). Input frame following the last
+// consumed one may be used for interpolation but is not consumed.
+TU_ATTR_ALWAYS_INLINE static inline uint16_t audio_src_out_count_max(audio_src_t const* src, uint16_t n_avail) {
+  uint64_t const step = audio_src_step(src);
+  uint64_t limit = (uint64_t) (n_avail + 1) << 32;
+  limit = tu_min64(limit > step ? limit - step : 0, (uint64_t) n_avail << 32);
+  if (limit <= src->pos) return 0;
+  return (uint16_t) ((limit - src->pos - 1) / step + 1);
+}
+
+// Number of input frames consumed by n_out output frames (encoding)
+TU_ATTR_ALWAYS_INLINE static inline uint16_t audio_src_in_count(audio_src_t const* src, uint16_t n_out) {
+  return (uint16_t) ((src->pos + n_out * audio_src_step(src)) >> 32);
+}
+
+// Advance position after all channels of a block are processed
+TU_ATTR_ALWAYS_INLINE static inline void audio_src_advance(audio_src_t* src, uint16_t n_in, uint16_t n_out) {
+  src->pos = src->pos + n_out * audio_src_step(src) - ((uint64_t) n_in << 32);
+}
+
+TU_ATTR_ALWAYS_INLINE static inline int32_t audio_src_load(uint8_t const* p, uint8_t n_bytes) {
+  switch (n_bytes) {
+    case 1: return (int8_t) p[0];
+    case 2: return (int16_t) tu_unaligned_read16(p);
+    case 3: return (int32_t) ((uint32_t) p[0] << 8 | (uint32_t) p[1] << 16 | (uint32_t) p[2] << 24) / 256;
+    default: return (int32_t) tu_unaligned_read32(p);
+  }
+}
+
+TU_ATTR_ALWAYS_INLINE static inline void audio_src_store(uint8_t* p, uint8_t n_bytes, int32_t value) {
+  switch (n_bytes) {
+    case 1: p[0] = (uint8_t) value; break;
+    case 2: tu_unaligned_write16(p, (uint16_t) value); break;
+    case 3:
+      p[0] = TU_U32_BYTE0(value);
+      p[1] = TU_U32_BYTE1(value);
+      p[2] = TU_U32_BYTE2(value);
+      break;
+    default: tu_unaligned_write32(p, (uint32_t) value); break;
+  }
+}
+
+TU_ATTR_ALWAYS_INLINE static inline uint8_t* audio_src_frame(audio_src_buf_t const* buf, uint16_t idx) {
+  return (idx < buf->n_lin) ? buf->ptr[0] + idx * buf->stride : buf->ptr[1] + (idx - buf->n_lin) * buf->stride;
+}
+
+// Convert a block for n_ch channels (starting at channel ch) whose samples are n_bytes each. First n_write output
+// frames are written, the rest (if any) is dropped. Last of n_in input frames becomes history of these channels.
+// Position is not changed, call audio_src_advance() once all channels are processed.
+static inline void audio_src_process(audio_src_t* src, uint8_t ch, uint8_t n_ch, uint8_t n_bytes,
+                                     audio_src_buf_t const* in, uint16_t n_in, audio_src_buf_t const* out,
+                                     uint16_t n_write) {
+  uint64_t const step = audio_src_step(src);
+  uint64_t pos = src->pos;
+  int32_t* hist = &src->hist[ch];
+
+  for (uint16_t k = 0; k < n_write; k++, pos += step) {
+    uint16_t const idx = (uint16_t) (pos >> 32);
+    int32_t const weight = (int32_t) ((uint32_t) pos >> 16);
+    uint8_t const* prev = (idx > 0) ? audio_src_frame(in, idx - 1) : NULL;
+    uint8_t const* next = audio_src_frame(in, idx);
+    uint8_t* dst = audio_src_frame(out, k);
+
+    for (uint8_t c = 0; c < n_ch; c++) {
+      int32_t const a = prev ? audio_src_load(prev + c * n_bytes, n_bytes) : hist[c];
+      int32_t const b = audio_src_load(next + c * n_bytes, n_bytes);
+      int32_t const y = a + (int32_t) ((((int64_t) b - a) * weight) >> 16);
+      audio_src_store(dst + c * n_bytes, n_bytes, y);
+    }
+  }
+
+  if (n_in > 0) {
+    uint8_t const* last = audio_src_frame(in, n_in - 1);
+    for (uint8_t c = 0; c < n_ch; c++) {
+      hist[c] = audio_src_load(last + c * n_bytes, n_bytes);
+    }
+  }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -252,7 +252,7 @@ void cdcd_init(void) {
     // Default: is overwritable
     tu_fifo_config(&p_cdc->tx_ff, p_cdc->tx_ff_buf, TU_ARRAY_SIZE(p_cdc->tx_ff_buf), 1, _cdcd_cfg.tx_overwritabe_if_not_connected);
 
-    #if OSAL_MUTEX_REQUIRED
+    #if CFG_FIFO_MUTEX
     osal_mutex_t mutex_rd = osal_mutex_create(&p_cdc->rx_ff_mutex);
     osal_mutex_t mutex_wr = osal_mutex_create(&p_cdc->tx_ff_mutex);
     TU_ASSERT(mutex_rd != NULL && mutex_wr != NULL, );
@@ -264,7 +264,7 @@ void cdcd_init(void) {
 }
 
 bool cdcd_deinit(void) {
-  #if OSAL_MUTEX_REQUIRED
+  #if CFG_FIFO_MUTEX
   for(uint8_t i=0; i<CFG_TUD_CDC; i++) {
     cdcd_interface_t* p_cdc = &_cdcd_itf[i];
     osal_mutex_t mutex_rd = p_cdc->rx_ff.mutex_rd;
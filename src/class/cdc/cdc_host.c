@@ -936,7 +936,7 @@ static bool acm_set_line_coding(cdch_interface_t* p_cdc, cdc_line_coding_t const
   };
 
   // use usbh enum buf to hold line coding since user line_coding variable does not live long enough
-  uint8_t* enum_buf = usbh_get_enum_buf();
+  uint8_t* enum_buf = usbh_get_enum_buf(p_cdc->daddr);
   memcpy(enum_buf, line_coding, sizeof(cdc_line_coding_t));
 
   p_cdc->user_control_cb = complete_cb;
@@ -1202,7 +1202,7 @@ static bool cp210x_set_request(cdch_interface_t* p_cdc, uint8_t command, uint16_
   uint8_t* enum_buf = NULL;
 
   if (buffer && length > 0) {
-    enum_buf = usbh_get_enum_buf();
+    enum_buf = usbh_get_enum_buf(p_cdc->daddr);
     tu_memcpy_s(enum_buf, CFG_TUH_ENUMERATION_BUFSIZE, buffer, length);
   }
 
@@ -1336,7 +1336,7 @@ static bool ch34x_set_request(cdch_interface_t* p_cdc, uint8_t direction, uint8_
   uint8_t* enum_buf = NULL;
 
   if (buffer && length > 0) {
-    enum_buf = usbh_get_enum_buf();
+    enum_buf = usbh_get_enum_buf(p_cdc->daddr);
     if (direction == TUSB_DIR_OUT) {
       tu_memcpy_s(enum_buf, CFG_TUH_ENUMERATION_BUFSIZE, buffer, length);
     }
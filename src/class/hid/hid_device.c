@@ -36,6 +36,11 @@
 
 #include "hid_device.h"
 
+// usbd_edpt_claim() takes a mutex that would block in ISR
+#if CFG_TUD_HID_XFER_ISR && OSAL_MUTEX_REQUIRED
+  #error "CFG_TUD_HID_XFER_ISR is only supported with CFG_TUSB_OS = OPT_OS_NONE on single core MCU"
+#endif
+
 //--------------------------------------------------------------------+
 // MACRO CONSTANT TYPEDEF
 //--------------------------------------------------------------------+
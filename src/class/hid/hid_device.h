@@ -47,6 +47,15 @@
   #define CFG_TUD_HID_EP_BUFSIZE     64
 #endif
 
+// Handle endpoint transfer complete in ISR context instead of usbd task to reduce report latency/jitter.
+// tud_hid_report_complete_cb(), tud_hid_report_failed_cb() and tud_hid_set_report_cb() for OUT endpoint
+// are then invoked in ISR context. Within these callbacks only tud_hid_n_ready() and the tud_hid_*report() API
+// may be used, no blocking or RTOS call. Endpoint claim is lock-free only without mutex i.e OS NONE on single core MCU,
+// other configurations are rejected at compile time.
+#ifndef CFG_TUD_HID_XFER_ISR
+  #define CFG_TUD_HID_XFER_ISR       0
+#endif
+
 //--------------------------------------------------------------------+
 // Application API (Multiple Instances) i.e. CFG_TUD_HID > 1
 //--------------------------------------------------------------------+
@@ -56,6 +56,7 @@ typedef struct {
   TU_ATTR_ALIGNED(4) msc_cbw_t cbw;
   TU_ATTR_ALIGNED(4) msc_csw_t csw;
 
+  uint8_t  rhport;
   uint8_t  itf_num;
   uint8_t  ep_in;
   uint8_t  ep_out;
@@ -66,6 +67,18 @@ typedef struct {
   uint32_t total_len;   // byte to be transferred, can be smaller than total_bytes in cbw
   uint32_t xferred_len; // numbered of bytes transferred so far in the Data Stage
 
+  // READ10/WRITE10 data stage buffering
+  uint32_t app_len;     // number of bytes read from (READ10) or written by (WRITE10) application so far
+  uint16_t app_offset;  // WRITE10: bytes of buf_app already consumed by application
+  uint8_t  buf_usb;     // index of buffer currently (or next to be) on the wire
+  uint8_t  buf_app;     // index of buffer next to be filled (READ10) or drained (WRITE10) by application
+  uint8_t  buf_count;   // number of buffers holding data, including the one on the wire
+  bool     xfer_busy;   // data transfer is queued on endpoint
+  bool     app_failed;  // READ10: application failed while a transfer is on going
+  bool     async_pending; // application is doing asynchronous I/O, waiting for tud_msc_async_io_done()
+  int32_t  async_bytes;   // result of asynchronous I/O
+  uint16_t buf_len[CFG_TUD_MSC_EP_BUFNUM];
+
   // Sense Response Data
   uint8_t sense_key;
   uint8_t add_sense_code;
@@ -74,9 +87,12 @@ typedef struct {
 
 static mscd_interface_t _mscd_itf;
 
-CFG_TUD_MEM_SECTION static struct {
+typedef struct {
   TUD_EPBUF_DEF(buf, CFG_TUD_MSC_EP_BUFSIZE);
-} _mscd_epbuf;
+} mscd_epbuf_t;
+
+// buffer 0 is also used for CBW, CSW and other SCSI commands
+CFG_TUD_MEM_SECTION static mscd_epbuf_t _mscd_epbuf[CFG_TUD_MSC_EP_BUFNUM];
 
 //--------------------------------------------------------------------+
 // INTERNAL OBJECT & FUNCTION DECLARATION
@@ -85,23 +101,44 @@ static int32_t proc_builtin_scsi(uint8_t lun, uint8_t const scsi_cmd[16], uint8_
 static void proc_read10_cmd(uint8_t rhport, mscd_interface_t* p_msc);
 
 static void proc_write10_cmd(uint8_t rhport, mscd_interface_t* p_msc);
-static void proc_write10_new_data(uint8_t rhport, mscd_interface_t* p_msc, uint32_t xferred_bytes);
+static void proc_write10_xfer(uint8_t rhport, mscd_interface_t* p_msc);
+static void proc_write10_new_data(uint8_t rhport, mscd_interface_t* p_msc);
+static bool proc_read10_result(uint8_t rhport, mscd_interface_t* p_msc, int32_t nbytes);
+static bool proc_write10_result(uint8_t rhport, mscd_interface_t* p_msc, int32_t nbytes);
+static void proc_async_io_done(void* param);
+static bool proc_stage_status(uint8_t rhport, mscd_interface_t* p_msc);
 
 TU_ATTR_ALWAYS_INLINE static inline bool is_data_in(uint8_t dir) {
   return tu_bit_test(dir, 7);
 }
 
+TU_ATTR_ALWAYS_INLINE static inline uint8_t buf_next_idx(uint8_t idx) {
+  return (uint8_t) ((idx + 1u) % CFG_TUD_MSC_EP_BUFNUM);
+}
+
+static inline void reset_data_stage(mscd_interface_t* p_msc) {
+  p_msc->xferred_len = 0;
+  p_msc->app_len     = 0;
+  p_msc->app_offset  = 0;
+  p_msc->buf_usb     = 0;
+  p_msc->buf_app     = 0;
+  p_msc->buf_count   = 0;
+  p_msc->xfer_busy   = false;
+  p_msc->app_failed  = false;
+  p_msc->async_pending = false;
+}
+
 static inline bool send_csw(uint8_t rhport, mscd_interface_t* p_msc) {
   // Data residue is always = host expect - actual transferred
   p_msc->csw.data_residue = p_msc->cbw.total_bytes - p_msc->xferred_len;
   p_msc->stage = MSC_STAGE_STATUS_SENT;
-  memcpy(_mscd_epbuf.buf, &p_msc->csw, sizeof(msc_csw_t));
-  return usbd_edpt_xfer(rhport, p_msc->ep_in , _mscd_epbuf.buf, sizeof(msc_csw_t));
+  memcpy(_mscd_epbuf[0].buf, &p_msc->csw, sizeof(msc_csw_t));
+  return usbd_edpt_xfer(rhport, p_msc->ep_in , _mscd_epbuf[0].buf, sizeof(msc_csw_t));
 }
 
 static inline bool prepare_cbw(uint8_t rhport, mscd_interface_t* p_msc) {
   p_msc->stage = MSC_STAGE_CMD;
-  return usbd_edpt_xfer(rhport, p_msc->ep_out,  _mscd_epbuf.buf, sizeof(msc_cbw_t));
+  return usbd_edpt_xfer(rhport, p_msc->ep_out,  _mscd_epbuf[0].buf, sizeof(msc_cbw_t));
 }
 
 static void fail_scsi_op(uint8_t rhport, mscd_interface_t* p_msc, uint8_t status) {
@@ -127,29 +164,49 @@ static void fail_scsi_op(uint8_t rhport, mscd_interface_t* p_msc, uint8_t status
   }
 }
 
-static inline uint32_t rdwr10_get_lba(uint8_t const command[]) {
+// READ10/WRITE10 and READ16/WRITE16 share the same data stage
+static inline bool is_read_cmd(uint8_t cmd_code) {
+  return (cmd_code == SCSI_CMD_READ_10) || (cmd_code == SCSI_CMD_READ_16);
+}
+
+static inline bool is_write_cmd(uint8_t cmd_code) {
+  return (cmd_code == SCSI_CMD_WRITE_10) || (cmd_code == SCSI_CMD_WRITE_16);
+}
+
+static inline uint64_t rdwr10_get_lba(uint8_t const command[]) {
   // use offsetof to avoid pointer to the odd/unaligned address
+  if (command[0] == SCSI_CMD_READ_16 || command[0] == SCSI_CMD_WRITE_16) {
+    uint32_t const lba_hi = tu_unaligned_read32(command + offsetof(scsi_write16_t, lba_hi));
+    uint32_t const lba_lo = tu_unaligned_read32(command + offsetof(scsi_write16_t, lba_lo));
+    return (((uint64_t) tu_ntohl(lba_hi)) << 32) | tu_ntohl(lba_lo); // lba is in Big Endian
+  }
+
   const uint32_t lba = tu_unaligned_read32(command + offsetof(scsi_write10_t, lba));
   return tu_ntohl(lba); // lba is in Big Endian
 }
 
-static inline uint16_t rdwr10_get_blockcount(msc_cbw_t const* cbw) {
+static inline uint32_t rdwr10_get_blockcount(msc_cbw_t const* cbw) {
+  if (cbw->command[0] == SCSI_CMD_READ_16 || cbw->command[0] == SCSI_CMD_WRITE_16) {
+    uint32_t const block_count = tu_unaligned_read32(cbw->command + offsetof(scsi_write16_t, block_count));
+    return tu_ntohl(block_count);
+  }
+
   uint16_t const block_count = tu_unaligned_read16(cbw->command + offsetof(scsi_write10_t, block_count));
   return tu_ntohs(block_count);
 }
 
-static inline uint16_t rdwr10_get_blocksize(msc_cbw_t const* cbw) {
+static inline uint32_t rdwr10_get_blocksize(msc_cbw_t const* cbw) {
   // first extract block count in the command
-  uint16_t const block_count = rdwr10_get_blockcount(cbw);
+  uint32_t const block_count = rdwr10_get_blockcount(cbw);
   if (block_count == 0) {
     return 0; // invalid block count
   }
-  return (uint16_t) (cbw->total_bytes / block_count);
+  return cbw->total_bytes / block_count;
 }
 
 static uint8_t rdwr10_validate_cmd(msc_cbw_t const* cbw) {
   uint8_t status = MSC_CSW_STATUS_PASSED;
-  uint16_t const block_count = rdwr10_get_blockcount(cbw);
+  uint32_t const block_count = rdwr10_get_blockcount(cbw);
 
   if (cbw->total_bytes == 0) {
     if (block_count) {
@@ -159,10 +216,10 @@ static uint8_t rdwr10_validate_cmd(msc_cbw_t const* cbw) {
       // no data transfer, only exist in complaint test suite
     }
   } else {
-    if (SCSI_CMD_READ_10 == cbw->command[0] && !is_data_in(cbw->dir)) {
+    if (is_read_cmd(cbw->command[0]) && !is_data_in(cbw->dir)) {
       TU_LOG_DRV("  SCSI case 10 (Ho <> Di)\r\n");
       status = MSC_CSW_STATUS_PHASE_ERROR;
-    } else if (SCSI_CMD_WRITE_10 == cbw->command[0] && is_data_in(cbw->dir)) {
+    } else if (is_write_cmd(cbw->command[0]) && is_data_in(cbw->dir)) {
       TU_LOG_DRV("  SCSI case 8 (Hi <> Do)\r\n");
       status = MSC_CSW_STATUS_PHASE_ERROR;
     } else if (0 == block_count) {
@@ -177,6 +234,18 @@ static uint8_t rdwr10_validate_cmd(msc_cbw_t const* cbw) {
   return status;
 }
 
+// READ16/WRITE16 beyond 32-bit LBA can only be served by tud_msc_read16_cb()/tud_msc_write16_cb()
+static bool rdwr10_lba_supported(msc_cbw_t const* cbw) {
+  uint8_t const cmd_code = cbw->command[0];
+  if ((cmd_code == SCSI_CMD_READ_16 && tud_msc_read16_cb) || (cmd_code == SCSI_CMD_WRITE_16 && tud_msc_write16_cb) ||
+      cmd_code == SCSI_CMD_READ_10 || cmd_code == SCSI_CMD_WRITE_10) {
+    return true;
+  }
+
+  uint64_t const lba_end = rdwr10_get_lba(cbw->command) + rdwr10_get_blockcount(cbw);
+  return lba_end <= ((uint64_t) UINT32_MAX) + 1;
+}
+
 //--------------------------------------------------------------------+
 // Debug
 //--------------------------------------------------------------------+
@@ -193,7 +262,10 @@ TU_ATTR_UNUSED tu_static tu_lookup_entry_t const _msc_scsi_cmd_lookup[] = {
   { .key = SCSI_CMD_REQUEST_SENSE                , .data = "Request Sense" },
   { .key = SCSI_CMD_READ_FORMAT_CAPACITY         , .data = "Read Format Capacity" },
   { .key = SCSI_CMD_READ_10                      , .data = "Read10" },
-  { .key = SCSI_CMD_WRITE_10                     , .data = "Write10" }
+  { .key = SCSI_CMD_WRITE_10                     , .data = "Write10" },
+  { .key = SCSI_CMD_READ_16                      , .data = "Read16" },
+  { .key = SCSI_CMD_WRITE_16                     , .data = "Write16" },
+  { .key = SCSI_CMD_SERVICE_ACTION_IN_16         , .data = "Service Action In16" }
 };
 
 TU_ATTR_UNUSED tu_static tu_lookup_table_t const _msc_scsi_cmd_table = {
@@ -214,6 +286,18 @@ bool tud_msc_set_sense(uint8_t lun, uint8_t sense_key, uint8_t add_sense_code, u
   return true;
 }
 
+bool tud_msc_async_io_done(uint8_t lun, int32_t bytes_io, bool in_isr) {
+  (void) lun;
+  mscd_interface_t* p_msc = &_mscd_itf;
+  TU_VERIFY(p_msc->async_pending);
+
+  // complete the I/O in usbd task
+  p_msc->async_bytes = bytes_io;
+  usbd_defer_func(proc_async_io_done, NULL, in_isr);
+
+  return true;
+}
+
 static inline void set_sense_medium_not_present(uint8_t lun) {
   // default sense is NOT READY, MEDIUM NOT PRESENT
   tud_msc_set_sense(lun, SCSI_SENSE_NOT_READY, 0x3A, 0x00);
@@ -244,6 +328,7 @@ uint16_t mscd_open(uint8_t rhport, tusb_desc_interface_t const * itf_desc, uint1
   TU_ASSERT(max_len >= drv_len, 0); // Max length must be at least 1 interface + 2 endpoints
 
   mscd_interface_t * p_msc = &_mscd_itf;
+  p_msc->rhport  = rhport;
   p_msc->itf_num = itf_desc->bInterfaceNumber;
 
   // Open endpoint pair
@@ -258,7 +343,7 @@ uint16_t mscd_open(uint8_t rhport, tusb_desc_interface_t const * itf_desc, uint1
 static void proc_bot_reset(mscd_interface_t* p_msc) {
   p_msc->stage       = MSC_STAGE_CMD;
   p_msc->total_len   = 0;
-  p_msc->xferred_len = 0;
+  reset_data_stage(p_msc);
   p_msc->sense_key           = 0;
   p_msc->add_sense_code      = 0;
   p_msc->add_sense_qualifier = 0;
@@ -351,7 +436,7 @@ bool mscd_xfer_cb(uint8_t rhport, uint8_t ep_addr, xfer_result_t event, uint32_t
         return true;
       }
 
-      const uint32_t signature = tu_le32toh(tu_unaligned_read32(_mscd_epbuf.buf));
+      const uint32_t signature = tu_le32toh(tu_unaligned_read32(_mscd_epbuf[0].buf));
 
       if (!(xferred_bytes == sizeof(msc_cbw_t) && signature == MSC_CBW_SIGNATURE)) {
         // BOT 6.6.1 If CBW is not valid stall both endpoints until reset recovery
@@ -362,7 +447,7 @@ bool mscd_xfer_cb(uint8_t rhport, uint8_t ep_addr, xfer_result_t event, uint32_t
         return false;
       }
 
-      memcpy(p_cbw, _mscd_epbuf.buf, sizeof(msc_cbw_t));
+      memcpy(p_cbw, _mscd_epbuf[0].buf, sizeof(msc_cbw_t));
 
       TU_LOG_DRV("  SCSI Command [Lun%u]: %s\r\n", p_cbw->lun, tu_lookup_find(&_msc_scsi_cmd_table, p_cbw->command[0]));
       // TU_LOG_MEM(CFG_TUD_MSC_LOG_LEVEL, p_cbw, xferred_bytes, 2);
@@ -375,16 +460,20 @@ bool mscd_xfer_cb(uint8_t rhport, uint8_t ep_addr, xfer_result_t event, uint32_t
       /*------------- Parse command and prepare DATA -------------*/
       p_msc->stage = MSC_STAGE_DATA;
       p_msc->total_len = p_cbw->total_bytes;
-      p_msc->xferred_len = 0;
+      reset_data_stage(p_msc);
 
-      // Read10 or Write10
-      if ((SCSI_CMD_READ_10 == p_cbw->command[0]) || (SCSI_CMD_WRITE_10 == p_cbw->command[0])) {
+      // Read10/16 or Write10/16
+      if (is_read_cmd(p_cbw->command[0]) || is_write_cmd(p_cbw->command[0])) {
         uint8_t const status = rdwr10_validate_cmd(p_cbw);
 
         if (status != MSC_CSW_STATUS_PASSED) {
           fail_scsi_op(rhport, p_msc, status);
+        } else if (!rdwr10_lba_supported(p_cbw)) {
+          TU_LOG_DRV("  SCSI LBA beyond 32-bit without read16/write16 callback\r\n");
+          tud_msc_set_sense(p_cbw->lun, SCSI_SENSE_ILLEGAL_REQUEST, 0x21, 0x00); // LBA out of range
+          fail_scsi_op(rhport, p_msc, MSC_CSW_STATUS_FAILED);
         } else if (p_cbw->total_bytes) {
-          if (SCSI_CMD_READ_10 == p_cbw->command[0]) {
+          if (is_read_cmd(p_cbw->command[0])) {
             proc_read10_cmd(rhport, p_msc);
           } else {
             proc_write10_cmd(rhport, p_msc);
@@ -404,15 +493,15 @@ bool mscd_xfer_cb(uint8_t rhport, uint8_t ep_addr, xfer_result_t event, uint32_t
           } else {
             // Didn't check for case 9 (Ho > Dn), which requires examining scsi command first
             // but it is OK to just receive data then responded with failed status
-            TU_ASSERT(usbd_edpt_xfer(rhport, p_msc->ep_out, _mscd_epbuf.buf, (uint16_t) p_msc->total_len));
+            TU_ASSERT(usbd_edpt_xfer(rhport, p_msc->ep_out, _mscd_epbuf[0].buf, (uint16_t) p_msc->total_len));
           }
         } else {
           // First process if it is a built-in commands
-          int32_t resplen = proc_builtin_scsi(p_cbw->lun, p_cbw->command, _mscd_epbuf.buf, CFG_TUD_MSC_EP_BUFSIZE);
+          int32_t resplen = proc_builtin_scsi(p_cbw->lun, p_cbw->command, _mscd_epbuf[0].buf, CFG_TUD_MSC_EP_BUFSIZE);
 
           // Invoke user callback if not built-in
           if ((resplen < 0) && (p_msc->sense_key == 0)) {
-            resplen = tud_msc_scsi_cb(p_cbw->lun, p_cbw->command, _mscd_epbuf.buf, (uint16_t)p_msc->total_len);
+            resplen = tud_msc_scsi_cb(p_cbw->lun, p_cbw->command, _mscd_epbuf[0].buf, (uint16_t)p_msc->total_len);
           }
 
           if (resplen < 0) {
@@ -436,7 +525,7 @@ bool mscd_xfer_cb(uint8_t rhport, uint8_t ep_addr, xfer_result_t event, uint32_t
             } else {
               // cannot return more than host expect
               p_msc->total_len = tu_min32((uint32_t)resplen, p_cbw->total_bytes);
-              TU_ASSERT(usbd_edpt_xfer(rhport, p_msc->ep_in, _mscd_epbuf.buf, (uint16_t) p_msc->total_len));
+              TU_ASSERT(usbd_edpt_xfer(rhport, p_msc->ep_in, _mscd_epbuf[0].buf, (uint16_t) p_msc->total_len));
             }
           }
         }
@@ -446,10 +535,16 @@ bool mscd_xfer_cb(uint8_t rhport, uint8_t ep_addr, xfer_result_t event, uint32_t
     case MSC_STAGE_DATA:
       TU_LOG_DRV("  SCSI Data [Lun%u]\r\n", p_cbw->lun);
       TU_ASSERT(xferred_bytes <= CFG_TUD_MSC_EP_BUFSIZE); // sanity check to avoid buffer overflow
-      // TU_LOG_MEM(CFG_TUD_MSC_LOG_LEVEL, _mscd_epbuf.buf, xferred_bytes, 2);
-
-      if (SCSI_CMD_READ_10 == p_cbw->command[0]) {
-        p_msc->xferred_len += xferred_bytes;
+      // TU_LOG_MEM(CFG_TUD_MSC_LOG_LEVEL, _mscd_epbuf[0].buf, xferred_bytes, 2);
+
+      if (is_read_cmd(p_cbw->command[0])) {
+        // xfer_busy is false if this is a simulated transfer complete to retry application
+        if (p_msc->xfer_busy) {
+          p_msc->xfer_busy = false;
+          p_msc->xferred_len += xferred_bytes;
+          p_msc->buf_usb = buf_next_idx(p_msc->buf_usb);
+          p_msc->buf_count--;
+        }
 
         if ( p_msc->xferred_len >= p_msc->total_len ) {
           // Data Stage is complete
@@ -457,14 +552,24 @@ bool mscd_xfer_cb(uint8_t rhport, uint8_t ep_addr, xfer_result_t event, uint32_t
         }else {
           proc_read10_cmd(rhport, p_msc);
         }
-      } else if (SCSI_CMD_WRITE_10 == p_cbw->command[0]) {
-        proc_write10_new_data(rhport, p_msc, xferred_bytes);
+      } else if (is_write_cmd(p_cbw->command[0])) {
+        if (p_msc->xfer_busy) {
+          p_msc->xfer_busy = false;
+          p_msc->xferred_len += xferred_bytes;
+          p_msc->buf_len[p_msc->buf_usb] = (uint16_t) xferred_bytes;
+          p_msc->buf_usb = buf_next_idx(p_msc->buf_usb);
+          p_msc->buf_count++;
+
+          // queue next OUT transfer (if there is free buffer) before passing data to application
+          proc_write10_xfer(rhport, p_msc);
+        }
+        proc_write10_new_data(rhport, p_msc);
       } else {
         p_msc->xferred_len += xferred_bytes;
 
         // OUT transfer, invoke callback if needed
         if ( !is_data_in(p_cbw->dir) ) {
-          int32_t cb_result = tud_msc_scsi_cb(p_cbw->lun, p_cbw->command, _mscd_epbuf.buf, (uint16_t) p_msc->total_len);
+          int32_t cb_result = tud_msc_scsi_cb(p_cbw->lun, p_cbw->command, _mscd_epbuf[0].buf, (uint16_t) p_msc->total_len);
 
           if ( cb_result < 0 ) {
             // unsupported command
@@ -500,12 +605,14 @@ bool mscd_xfer_cb(uint8_t rhport, uint8_t ep_addr, xfer_result_t event, uint32_t
         // if complete_cb() is invoked after queuing the status.
         switch (p_cbw->command[0]) {
           case SCSI_CMD_READ_10:
+          case SCSI_CMD_READ_16:
             if (tud_msc_read10_complete_cb) {
               tud_msc_read10_complete_cb(p_cbw->lun);
             }
             break;
 
           case SCSI_CMD_WRITE_10:
+          case SCSI_CMD_WRITE_16:
             if (tud_msc_write10_complete_cb) {
               tud_msc_write10_complete_cb(p_cbw->lun);
             }
@@ -528,6 +635,13 @@ bool mscd_xfer_cb(uint8_t rhport, uint8_t ep_addr, xfer_result_t event, uint32_t
     default: break;
   }
 
+  return proc_stage_status(rhport, p_msc);
+}
+
+// Send CSW if data stage is complete (or failed)
+static bool proc_stage_status(uint8_t rhport, mscd_interface_t* p_msc) {
+  msc_cbw_t const* p_cbw = &p_msc->cbw;
+
   if (p_msc->stage == MSC_STAGE_STATUS) {
     // skip status if epin is currently stalled, will do it when received Clear Stall request
     if (!usbd_edpt_stalled(rhport, p_msc->ep_in)) {
@@ -558,6 +672,19 @@ bool mscd_xfer_cb(uint8_t rhport, uint8_t ep_addr, xfer_result_t event, uint32_t
 /* SCSI Command Process
  *------------------------------------------------------------------*/
 
+// Get disk size, tud_msc_capacity16_cb() is preferred if implemented
+static void get_capacity(uint8_t lun, uint64_t* block_count, uint32_t* block_size) {
+  if (tud_msc_capacity16_cb) {
+    tud_msc_capacity16_cb(lun, block_count, block_size);
+  } else {
+    uint32_t block_count_u32;
+    uint16_t block_size_u16;
+    tud_msc_capacity_cb(lun, &block_count_u32, &block_size_u16);
+    *block_count = block_count_u32;
+    *block_size = block_size_u16;
+  }
+}
+
 // return response's length (copied to buffer). Negative if it is not an built-in command or indicate Failed status (CSW)
 // In case of a failed status, sense key must be set for reason of failure
 static int32_t proc_builtin_scsi(uint8_t lun, uint8_t const scsi_cmd[16], uint8_t* buffer, uint32_t bufsize) {
@@ -616,12 +743,10 @@ static int32_t proc_builtin_scsi(uint8_t lun, uint8_t const scsi_cmd[16], uint8_
 
 
     case SCSI_CMD_READ_CAPACITY_10: {
-      uint32_t block_count;
+      uint64_t block_count;
       uint32_t block_size;
-      uint16_t block_size_u16;
 
-      tud_msc_capacity_cb(lun, &block_count, &block_size_u16);
-      block_size = (uint32_t)block_size_u16;
+      get_capacity(lun, &block_count, &block_size);
 
       // Invalid block size/count from callback, possibly unit is not ready
       // stall this request, set sense key to NOT READY
@@ -635,7 +760,8 @@ static int32_t proc_builtin_scsi(uint8_t lun, uint8_t const scsi_cmd[16], uint8_
       } else {
         scsi_read_capacity10_resp_t read_capa10;
 
-        read_capa10.last_lba = tu_htonl(block_count-1);
+        // last lba 0xFFFFFFFF tells host to use READ CAPACITY (16)
+        read_capa10.last_lba = tu_htonl((uint32_t) tu_min64(block_count - 1, UINT32_MAX));
         read_capa10.block_size = tu_htonl(block_size);
 
         resplen = sizeof(read_capa10);
@@ -644,6 +770,43 @@ static int32_t proc_builtin_scsi(uint8_t lun, uint8_t const scsi_cmd[16], uint8_
     }
     break;
 
+    case SCSI_CMD_SERVICE_ACTION_IN_16: {
+      if ((scsi_cmd[1] & 0x1Fu) != SCSI_SERVICE_ACTION_READ_CAPACITY_16) {
+        resplen = -1; // other service actions are handled by application
+        break;
+      }
+
+      uint64_t block_count;
+      uint32_t block_size;
+
+      get_capacity(lun, &block_count, &block_size);
+
+      // Invalid block size/count from callback, possibly unit is not ready
+      // stall this request, set sense key to NOT READY
+      if (block_count == 0 || block_size == 0) {
+        resplen = -1;
+
+        // set default sense if not set by callback
+        if (p_msc->sense_key == 0) {
+          set_sense_medium_not_present(lun);
+        }
+      } else {
+        scsi_read_capacity16_resp_t read_capa16;
+        tu_memclr(&read_capa16, sizeof(read_capa16));
+
+        uint64_t const last_lba = block_count - 1;
+        read_capa16.last_lba_hi = tu_htonl((uint32_t) (last_lba >> 32));
+        read_capa16.last_lba_lo = tu_htonl((uint32_t) last_lba);
+        read_capa16.block_size  = tu_htonl(block_size);
+
+        // cannot return more than allocation length
+        uint32_t const alloc_len = tu_ntohl(tu_unaligned_read32(scsi_cmd + offsetof(scsi_read_capacity16_t, alloc_length)));
+        resplen = (int32_t) tu_min32(sizeof(read_capa16), alloc_len);
+        TU_VERIFY(0 == tu_memcpy_s(buffer, bufsize, &read_capa16, (size_t) resplen));
+      }
+    }
+    break;
+
     case SCSI_CMD_READ_FORMAT_CAPACITY: {
       scsi_read_format_capacity_data_t read_fmt_capa =
       {
@@ -653,10 +816,10 @@ static int32_t proc_builtin_scsi(uint8_t lun, uint8_t const scsi_cmd[16], uint8_
         .block_size_u16 = 0
       };
 
-      uint32_t block_count;
-      uint16_t block_size;
+      uint64_t block_count;
+      uint32_t block_size;
 
-      tud_msc_capacity_cb(lun, &block_count, &block_size);
+      get_capacity(lun, &block_count, &block_size);
 
       // Invalid block size/count from callback, possibly unit is not ready
       // stall this request, set sense key to NOT READY
@@ -668,8 +831,8 @@ static int32_t proc_builtin_scsi(uint8_t lun, uint8_t const scsi_cmd[16], uint8_
           set_sense_medium_not_present(lun);
         }
       } else {
-        read_fmt_capa.block_num = tu_htonl(block_count);
-        read_fmt_capa.block_size_u16 = tu_htons(block_size);
+        read_fmt_capa.block_num = tu_htonl((uint32_t) tu_min64(block_count, UINT32_MAX));
+        read_fmt_capa.block_size_u16 = tu_htons((uint16_t) block_size);
 
         resplen = sizeof(read_fmt_capa);
         TU_VERIFY(0 == tu_memcpy_s(buffer, bufsize, &read_fmt_capa, (size_t) resplen));
@@ -752,36 +915,89 @@ static int32_t proc_builtin_scsi(uint8_t lun, uint8_t const scsi_cmd[16], uint8_
   return resplen;
 }
 
+// Queue buffered data to host and read ahead from application into free buffers
 static void proc_read10_cmd(uint8_t rhport, mscd_interface_t* p_msc) {
   msc_cbw_t const* p_cbw = &p_msc->cbw;
 
   // block size already verified not zero
-  uint16_t const block_sz = rdwr10_get_blocksize(p_cbw);
+  uint32_t const block_sz = rdwr10_get_blocksize(p_cbw);
+  uint64_t const lba_start = rdwr10_get_lba(p_cbw->command);
+
+  while (1) {
+    if (!p_msc->xfer_busy) {
+      if (p_msc->buf_count) {
+        uint8_t const idx = p_msc->buf_usb;
+        TU_ASSERT(usbd_edpt_xfer(rhport, p_msc->ep_in, _mscd_epbuf[idx].buf, p_msc->buf_len[idx]),);
+        p_msc->xfer_busy = true;
+      } else if (p_msc->app_failed) {
+        // all data read before the failure is sent
+        fail_scsi_op(rhport, p_msc, MSC_CSW_STATUS_FAILED);
+        return;
+      }
+    }
+
+    // application failed or is busy with async I/O, all buffers are in use or all data is read
+    if (p_msc->app_failed || p_msc->async_pending || p_msc->buf_count == CFG_TUD_MSC_EP_BUFNUM ||
+        p_msc->app_len >= p_cbw->total_bytes) {
+      return;
+    }
 
-  // Adjust lba with transferred bytes
-  uint32_t const lba = rdwr10_get_lba(p_cbw->command) + (p_msc->xferred_len / block_sz);
+    // Adjust lba with bytes read so far
+    uint64_t const lba = lba_start + (p_msc->app_len / block_sz);
 
-  // remaining bytes capped at class buffer
-  int32_t nbytes = (int32_t)tu_min32(CFG_TUD_MSC_EP_BUFSIZE, p_cbw->total_bytes - p_msc->xferred_len);
+    // remaining bytes capped at class buffer
+    int32_t nbytes = (int32_t)tu_min32(CFG_TUD_MSC_EP_BUFSIZE, p_cbw->total_bytes - p_msc->app_len);
+
+    // Application can consume smaller bytes
+    uint32_t const offset = p_msc->app_len % block_sz;
+
+    // Armed before invoking callback, since application can complete the I/O before callback returns
+    p_msc->async_pending = true;
+    if (SCSI_CMD_READ_16 == p_cbw->command[0] && tud_msc_read16_cb) {
+      nbytes = tud_msc_read16_cb(p_cbw->lun, lba, offset, _mscd_epbuf[p_msc->buf_app].buf, (uint32_t)nbytes);
+    } else {
+      nbytes = tud_msc_read10_cb(p_cbw->lun, (uint32_t) lba, offset, _mscd_epbuf[p_msc->buf_app].buf, (uint32_t)nbytes);
+    }
 
-  // Application can consume smaller bytes
-  uint32_t const offset = p_msc->xferred_len % block_sz;
-  nbytes = tud_msc_read10_cb(p_cbw->lun, lba, offset, _mscd_epbuf.buf, (uint32_t)nbytes);
+    if (nbytes == TUD_MSC_RET_ASYNC) {
+      // result is reported later with tud_msc_async_io_done()
+      return;
+    }
+    p_msc->async_pending = false;
+
+    if (!proc_read10_result(rhport, p_msc, nbytes)) {
+      return;
+    }
+  }
+}
 
+// Process result of tud_msc_read10_cb(), return false if application is not ready
+static bool proc_read10_result(uint8_t rhport, mscd_interface_t* p_msc, int32_t nbytes) {
   if (nbytes < 0) {
     // negative means error -> endpoint is stalled & status in CSW set to failed
     TU_LOG_DRV("  tud_msc_read10_cb() return -1\r\n");
 
     // set sense
-    set_sense_medium_not_present(p_cbw->lun);
+    set_sense_medium_not_present(p_msc->cbw.lun);
 
-    fail_scsi_op(rhport, p_msc, MSC_CSW_STATUS_FAILED);
+    // data already read is still sent, op is failed afterwards
+    p_msc->app_failed = true;
   } else if (nbytes == 0) {
-    // zero means not ready -> simulate an transfer complete so that this driver callback will fired again
-    dcd_event_xfer_complete(rhport, p_msc->ep_in, 0, XFER_RESULT_SUCCESS, false);
+    // zero means not ready -> simulate an transfer complete so that this driver callback will fired again.
+    // Skip if a transfer is on going, its completion will do the same.
+    if (!p_msc->xfer_busy) {
+      dcd_event_xfer_complete(rhport, p_msc->ep_in, 0, XFER_RESULT_SUCCESS, false);
+    }
+    return false;
   } else {
-    TU_ASSERT(usbd_edpt_xfer(rhport, p_msc->ep_in, _mscd_epbuf.buf, (uint16_t) nbytes),);
+    uint8_t const idx = p_msc->buf_app;
+    p_msc->buf_len[idx] = (uint16_t) nbytes;
+    p_msc->buf_app = buf_next_idx(idx);
+    p_msc->buf_count++;
+    p_msc->app_len += (uint32_t) nbytes;
   }
+
+  return true;
 }
 
 static void proc_write10_cmd(uint8_t rhport, mscd_interface_t* p_msc) {
@@ -800,60 +1016,132 @@ static void proc_write10_cmd(uint8_t rhport, mscd_interface_t* p_msc) {
     return;
   }
 
+  // Write10 callback will be called later when usb transfer complete
+  proc_write10_xfer(rhport, p_msc);
+}
+
+// queue OUT transfer into a free buffer if host has more data to send
+static void proc_write10_xfer(uint8_t rhport, mscd_interface_t* p_msc) {
+  msc_cbw_t const* p_cbw = &p_msc->cbw;
+
+  if (p_msc->xfer_busy || p_msc->buf_count == CFG_TUD_MSC_EP_BUFNUM || p_msc->xferred_len >= p_cbw->total_bytes) {
+    return;
+  }
+
   // remaining bytes capped at class buffer
   uint16_t nbytes = (uint16_t)tu_min32(CFG_TUD_MSC_EP_BUFSIZE, p_cbw->total_bytes - p_msc->xferred_len);
 
-  // Write10 callback will be called later when usb transfer complete
-  TU_ASSERT(usbd_edpt_xfer(rhport, p_msc->ep_out, _mscd_epbuf.buf, nbytes),);
+  TU_ASSERT(usbd_edpt_xfer(rhport, p_msc->ep_out, _mscd_epbuf[p_msc->buf_usb].buf, nbytes),);
+  p_msc->xfer_busy = true;
 }
 
-// process new data arrived from WRITE10
-static void proc_write10_new_data(uint8_t rhport, mscd_interface_t* p_msc, uint32_t xferred_bytes) {
+// pass data arrived from WRITE10 to application
+static void proc_write10_new_data(uint8_t rhport, mscd_interface_t* p_msc) {
   msc_cbw_t const* p_cbw = &p_msc->cbw;
 
   // block size already verified not zero
-  uint16_t const block_sz = rdwr10_get_blocksize(p_cbw);
+  uint32_t const block_sz = rdwr10_get_blocksize(p_cbw);
+  uint64_t const lba_start = rdwr10_get_lba(p_cbw->command);
+
+  while (p_msc->buf_count && !p_msc->async_pending) {
+    uint8_t const idx = p_msc->buf_app;
+    uint32_t const buf_remain = (uint32_t) (p_msc->buf_len[idx] - p_msc->app_offset);
+
+    // Adjust lba with bytes written so far
+    uint64_t const lba = lba_start + (p_msc->app_len / block_sz);
+
+    // Invoke callback to consume new data
+    uint32_t const offset = p_msc->app_len % block_sz;
+    uint8_t* const buf = _mscd_epbuf[idx].buf + p_msc->app_offset;
+    int32_t nbytes;
+
+    // Armed before invoking callback, since application can complete the I/O before callback returns
+    p_msc->async_pending = true;
+    if (SCSI_CMD_WRITE_16 == p_cbw->command[0] && tud_msc_write16_cb) {
+      nbytes = tud_msc_write16_cb(p_cbw->lun, lba, offset, buf, buf_remain);
+    } else {
+      nbytes = tud_msc_write10_cb(p_cbw->lun, (uint32_t) lba, offset, buf, buf_remain);
+    }
+
+    if (nbytes == TUD_MSC_RET_ASYNC) {
+      // result is reported later with tud_msc_async_io_done()
+      return;
+    }
+    p_msc->async_pending = false;
 
-  // Adjust lba with transferred bytes
-  uint32_t const lba = rdwr10_get_lba(p_cbw->command) + (p_msc->xferred_len / block_sz);
+    if (!proc_write10_result(rhport, p_msc, nbytes)) {
+      return;
+    }
+  }
 
-  // Invoke callback to consume new data
-  uint32_t const offset = p_msc->xferred_len % block_sz;
-  int32_t nbytes = tud_msc_write10_cb(p_cbw->lun, lba, offset, _mscd_epbuf.buf, xferred_bytes);
+  if (p_msc->app_len >= p_msc->total_len) {
+    // Data Stage is complete
+    p_msc->stage = MSC_STAGE_STATUS;
+  }
+}
 
+// Process result of tud_msc_write10_cb(), return false if application failed or did not consume the whole buffer
+static bool proc_write10_result(uint8_t rhport, mscd_interface_t* p_msc, int32_t nbytes) {
   if (nbytes < 0) {
     // negative means error -> failed this scsi op
     TU_LOG_DRV("  tud_msc_write10_cb() return -1\r\n");
 
-    // update actual byte before failed
-    p_msc->xferred_len += xferred_bytes;
-
-    set_sense_medium_not_present(p_cbw->lun);
+    set_sense_medium_not_present(p_msc->cbw.lun);
     fail_scsi_op(rhport, p_msc, MSC_CSW_STATUS_FAILED);
-  } else {
-    if ((uint32_t)nbytes < xferred_bytes) {
-      // Application consume less than what we got (including zero)
-      const uint32_t left_over = xferred_bytes - (uint32_t)nbytes;
-      if (nbytes > 0) {
-        p_msc->xferred_len += (uint16_t)nbytes;
-        memmove(_mscd_epbuf.buf, _mscd_epbuf.buf + nbytes, left_over);
-      }
+    return false;
+  }
 
-      // simulate a transfer complete with adjusted parameters --> callback will be invoked with adjusted parameter
-      dcd_event_xfer_complete(rhport, p_msc->ep_out, left_over, XFER_RESULT_SUCCESS, false);
-    } else {
-      // Application consume all bytes in our buffer
-      p_msc->xferred_len += xferred_bytes;
+  uint8_t const idx = p_msc->buf_app;
+  uint32_t const buf_remain = (uint32_t) (p_msc->buf_len[idx] - p_msc->app_offset);
 
-      if (p_msc->xferred_len >= p_msc->total_len) {
-        // Data Stage is complete
-        p_msc->stage = MSC_STAGE_STATUS;
-      } else {
-        // prepare to receive more data from host
-        proc_write10_cmd(rhport, p_msc);
-      }
+  p_msc->app_len += (uint32_t) nbytes;
+
+  if ((uint32_t)nbytes < buf_remain) {
+    // Application consume less than what we got (including zero)
+    p_msc->app_offset = (uint16_t) (p_msc->app_offset + nbytes);
+
+    // simulate a transfer complete so that callback will be invoked with the rest of buffer.
+    // Skip if a transfer is on going, its completion will do the same.
+    if (!p_msc->xfer_busy) {
+      dcd_event_xfer_complete(rhport, p_msc->ep_out, 0, XFER_RESULT_SUCCESS, false);
     }
+    return false;
   }
+
+  // Application consume all bytes in this buffer
+  p_msc->app_offset = 0;
+  p_msc->buf_app = buf_next_idx(idx);
+  p_msc->buf_count--;
+
+  // prepare to receive more data from host
+  proc_write10_xfer(rhport, p_msc);
+
+  return true;
+}
+
+// Asynchronous I/O started by read10/write10 callback is complete
+static void proc_async_io_done(void* param) {
+  (void) param;
+  mscd_interface_t* p_msc = &_mscd_itf;
+  uint8_t const rhport = p_msc->rhport;
+
+  // skip if op is aborted by reset meanwhile
+  TU_VERIFY(p_msc->async_pending && p_msc->stage == MSC_STAGE_DATA,);
+  p_msc->async_pending = false;
+
+  int32_t const nbytes = p_msc->async_bytes;
+
+  if (is_read_cmd(p_msc->cbw.command[0])) {
+    if (proc_read10_result(rhport, p_msc, nbytes)) {
+      proc_read10_cmd(rhport, p_msc);
+    }
+  } else {
+    if (proc_write10_result(rhport, p_msc, nbytes)) {
+      proc_write10_new_data(rhport, p_msc);
+    }
+  }
+
+  proc_stage_status(rhport, p_msc);
 }
 
 #endif
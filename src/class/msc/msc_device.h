@@ -50,6 +50,22 @@
 
 TU_VERIFY_STATIC(CFG_TUD_MSC_EP_BUFSIZE < UINT16_MAX, "Size is not correct");
 
+// Number of CFG_TUD_MSC_EP_BUFSIZE buffers used for READ10/WRITE10 data stage. With 2 or more buffers:
+// - READ10 : next chunk is read from application while the previous one is on the wire (read-ahead)
+// - WRITE10: next OUT transfer is queued before received data is passed to application (write-behind)
+#ifndef CFG_TUD_MSC_EP_BUFNUM
+  #define CFG_TUD_MSC_EP_BUFNUM  1
+#endif
+
+TU_VERIFY_STATIC(CFG_TUD_MSC_EP_BUFNUM >= 1 && CFG_TUD_MSC_EP_BUFNUM <= 255, "Number of buffer is not correct");
+
+// Return value of read10/write10 callbacks
+enum {
+  TUD_MSC_RET_BUSY  = 0,   // not ready yet e.g disk I/O busy, callback is invoked again later
+  TUD_MSC_RET_ERROR = -1,  // error e.g invalid address
+  TUD_MSC_RET_ASYNC = -16, // I/O is started asynchronously, application calls tud_msc_async_io_done() when complete
+};
+
 //--------------------------------------------------------------------+
 // Application API
 //--------------------------------------------------------------------+
@@ -57,6 +73,12 @@ TU_VERIFY_STATIC(CFG_TUD_MSC_EP_BUFSIZE < UINT16_MAX, "Size is not correct");
 // Set SCSI sense response
 bool tud_msc_set_sense(uint8_t lun, uint8_t sense_key, uint8_t add_sense_code, uint8_t add_sense_qualifier);
 
+// Complete an asynchronous I/O started by tud_msc_read10_cb() or tud_msc_write10_cb() returning TUD_MSC_RET_ASYNC.
+// bytes_io has the same meaning as the callback's synchronous return value: number of read/written bytes,
+// 0 if not ready (callback is invoked again) or negative for error. Can be called from ISR or other thread, and
+// even from within the callback itself before it returns TUD_MSC_RET_ASYNC.
+bool tud_msc_async_io_done(uint8_t lun, int32_t bytes_io, bool in_isr);
+
 //--------------------------------------------------------------------+
 // Application Callbacks (WEAK is optional)
 //--------------------------------------------------------------------+
@@ -64,6 +86,7 @@ bool tud_msc_set_sense(uint8_t lun, uint8_t sense_key, uint8_t add_sense_code, u
 // Invoked when received SCSI READ10 command
 // - Address = lba * BLOCK_SIZE + offset
 //   - offset is only needed if CFG_TUD_MSC_EP_BUFSIZE is smaller than BLOCK_SIZE.
+// - If CFG_TUD_MSC_EP_BUFNUM > 1, this can be invoked for the next chunk while previous one is still being transferred.
 //
 // - Application fill the buffer (up to bufsize) with address contents and return number of read byte. If
 //   - read < bufsize : These bytes are transferred first and callback invoked again for remaining data.
@@ -73,11 +96,15 @@ bool tud_msc_set_sense(uint8_t lun, uint8_t sense_key, uint8_t add_sense_code, u
 //
 //   - read < 0       : Indicate application error e.g invalid address. This request will be STALLed
 //                      and return failed status in command status wrapper phase.
+//
+//   - TUD_MSC_RET_ASYNC : Read is started asynchronously (e.g DMA), buffer must be filled before application
+//                      calls tud_msc_async_io_done() with the number of read byte.
 int32_t tud_msc_read10_cb (uint8_t lun, uint32_t lba, uint32_t offset, void* buffer, uint32_t bufsize);
 
 // Invoked when received SCSI WRITE10 command
 // - Address = lba * BLOCK_SIZE + offset
 //   - offset is only needed if CFG_TUD_MSC_EP_BUFSIZE is smaller than BLOCK_SIZE.
+// - If CFG_TUD_MSC_EP_BUFNUM > 1, host can already be sending the next chunk while this is invoked.
 //
 // - Application write data from buffer to address contents (up to bufsize) and return number of written byte. If
 //   - write < bufsize : callback invoked again with remaining data later on.
@@ -88,6 +115,9 @@ int32_t tud_msc_read10_cb (uint8_t lun, uint32_t lba, uint32_t offset, void* buf
 //   - write < 0       : Indicate application error e.g invalid address. This request will be STALLed
 //                       and return failed status in command status wrapper phase.
 //
+//   - TUD_MSC_RET_ASYNC : Write is started asynchronously (e.g DMA), buffer must be kept intact until application
+//                       calls tud_msc_async_io_done() with the number of written byte.
+//
 // TODO change buffer to const uint8_t*
 int32_t tud_msc_write10_cb (uint8_t lun, uint32_t lba, uint32_t offset, uint8_t* buffer, uint32_t bufsize);
 
@@ -100,13 +130,13 @@ void tud_msc_inquiry_cb(uint8_t lun, uint8_t vendor_id[8], uint8_t product_id[16
 bool tud_msc_test_unit_ready_cb(uint8_t lun);
 
 // Invoked when received SCSI_CMD_READ_CAPACITY_10 and SCSI_CMD_READ_FORMAT_CAPACITY to determine the disk size
-// Application update block count and block size
+// Application update block count and block size. Not used if tud_msc_capacity16_cb() is implemented.
 void tud_msc_capacity_cb(uint8_t lun, uint32_t* block_count, uint16_t* block_size);
 
 /**
  * Invoked when received an SCSI command not in built-in list below.
- * - READ_CAPACITY10, READ_FORMAT_CAPACITY, INQUIRY, TEST_UNIT_READY, START_STOP_UNIT, MODE_SENSE6, REQUEST_SENSE
- * - READ10 and WRITE10 has their own callbacks
+ * - READ_CAPACITY10, READ_CAPACITY16, READ_FORMAT_CAPACITY, INQUIRY, TEST_UNIT_READY, START_STOP_UNIT, MODE_SENSE6, REQUEST_SENSE
+ * - READ10/READ16 and WRITE10/WRITE16 has their own callbacks
  *
  * \param[in]   lun         Logical unit number
  * \param[in]   scsi_cmd    SCSI command contents which application must examine to response accordingly
@@ -137,10 +167,22 @@ TU_ATTR_WEAK bool tud_msc_prevent_allow_medium_removal_cb(uint8_t lun, uint8_t p
 // Invoked when received REQUEST_SENSE
 TU_ATTR_WEAK int32_t tud_msc_request_sense_cb(uint8_t lun, void* buffer, uint16_t bufsize);
 
-// Invoked when Read10 command is complete
+// Invoked when received SCSI READ16 command, same as tud_msc_read10_cb() but with 64-bit lba.
+// If not implemented, READ16 within the first 2^32 blocks is passed to tud_msc_read10_cb() and failed otherwise.
+TU_ATTR_WEAK int32_t tud_msc_read16_cb(uint8_t lun, uint64_t lba, uint32_t offset, void* buffer, uint32_t bufsize);
+
+// Invoked when received SCSI WRITE16 command, same as tud_msc_write10_cb() but with 64-bit lba.
+// If not implemented, WRITE16 within the first 2^32 blocks is passed to tud_msc_write10_cb() and failed otherwise.
+TU_ATTR_WEAK int32_t tud_msc_write16_cb(uint8_t lun, uint64_t lba, uint32_t offset, uint8_t* buffer, uint32_t bufsize);
+
+// Invoked to determine the disk size for disk with more than 2^32 blocks or block size larger than 64KB.
+// Replace tud_msc_capacity_cb() for READ_CAPACITY_10, READ_CAPACITY_16 and READ_FORMAT_CAPACITY if implemented.
+TU_ATTR_WEAK void tud_msc_capacity16_cb(uint8_t lun, uint64_t* block_count, uint32_t* block_size);
+
+// Invoked when Read10/Read16 command is complete
 TU_ATTR_WEAK void tud_msc_read10_complete_cb(uint8_t lun);
 
-// Invoke when Write10 command is complete, can be used to flush flash caching
+// Invoke when Write10/Write16 command is complete, can be used to flush flash caching
 TU_ATTR_WEAK void tud_msc_write10_complete_cb(uint8_t lun);
 
 // Invoked when command in tud_msc_scsi_cb is complete
@@ -50,6 +50,18 @@ enum {
   MSC_STAGE_STATUS,
 };
 
+// Queued SCSI command
+typedef struct {
+  msc_cbw_t cbw;
+  void* buffer;
+#if CFG_TUH_API_EDPT_XFER_SG
+  tusb_xfer_sg_t const* data_sg; // application data list, NULL if buffer is used
+  uint8_t data_sg_count;
+#endif
+  tuh_msc_complete_cb_t complete_cb;
+  uintptr_t complete_arg;
+} msch_cmd_t;
+
 typedef struct {
   uint8_t itf_num;
   uint8_t ep_in;
@@ -59,15 +71,20 @@ typedef struct {
   volatile bool configured; // Receive SET_CONFIGURE
   volatile bool mounted;    // Enumeration is complete
 
-  // SCSI command data
+  // SCSI command queue, command at cmd_rd is in progress if cmd_count > 0
   uint8_t stage;
-  void* buffer;
-  tuh_msc_complete_cb_t complete_cb;
-  uintptr_t complete_arg;
+  uint8_t cmd_rd;
+  uint8_t cmd_count;
+  msch_cmd_t cmd[CFG_TUH_MSC_CMD_QUEUE_SIZE];
+#if CFG_TUH_API_EDPT_XFER_SG
+  tusb_xfer_sg_t data_seg; // single segment for command with buffer
+#else
+  uint32_t data_offset; // start of data chunk in progress
+#endif
 
   struct {
     uint32_t block_size;
-    uint32_t block_count;
+    uint64_t block_count;
   } capacity[CFG_TUH_MSC_MAXLUN];
 } msch_interface_t;
 
@@ -79,6 +96,14 @@ typedef struct {
 static msch_interface_t _msch_itf[CFG_TUH_DEVICE_MAX];
 CFG_TUH_MEM_SECTION static msch_epbuf_t _msch_epbuf[CFG_TUH_DEVICE_MAX];
 
+// command queue can be filled from multiple application threads
+#if OSAL_MUTEX_REQUIRED
+  static osal_mutex_def_t _msch_mutexdef;
+  static osal_mutex_t _msch_mutex;
+#else
+  #define _msch_mutex   NULL
+#endif
+
 TU_ATTR_ALWAYS_INLINE static inline msch_interface_t* get_itf(uint8_t daddr) {
   return &_msch_itf[daddr - 1];
 }
@@ -96,6 +121,11 @@ uint8_t tuh_msc_get_maxlun(uint8_t dev_addr) {
 }
 
 uint32_t tuh_msc_get_block_count(uint8_t dev_addr, uint8_t lun) {
+  msch_interface_t* p_msc = get_itf(dev_addr);
+  return (uint32_t) tu_min64(p_msc->capacity[lun].block_count, UINT32_MAX);
+}
+
+uint64_t tuh_msc_get_block_count64(uint8_t dev_addr, uint8_t lun) {
   msch_interface_t* p_msc = get_itf(dev_addr);
   return p_msc->capacity[lun].block_count;
 }
@@ -112,7 +142,12 @@ bool tuh_msc_mounted(uint8_t dev_addr) {
 
 bool tuh_msc_ready(uint8_t dev_addr) {
   msch_interface_t* p_msc = get_itf(dev_addr);
-  return p_msc->mounted && !usbh_edpt_busy(dev_addr, p_msc->ep_in) && !usbh_edpt_busy(dev_addr, p_msc->ep_out);
+  return p_msc->mounted && (p_msc->cmd_count < CFG_TUH_MSC_CMD_QUEUE_SIZE);
+}
+
+uint8_t tuh_msc_cmd_pending(uint8_t dev_addr) {
+  msch_interface_t* p_msc = get_itf(dev_addr);
+  return p_msc->cmd_count;
 }
 
 //--------------------------------------------------------------------+
@@ -125,22 +160,24 @@ static inline void cbw_init(msc_cbw_t* cbw, uint8_t lun) {
   cbw->lun       = lun;
 }
 
-bool tuh_msc_scsi_command(uint8_t daddr, msc_cbw_t const* cbw, void* data,
-                          tuh_msc_complete_cb_t complete_cb, uintptr_t arg) {
+// Send CBW of the command at head of queue
+static bool cmd_start(uint8_t daddr) {
   msch_interface_t* p_msc = get_itf(daddr);
-  TU_VERIFY(p_msc->configured);
+  msch_cmd_t const* cmd = &p_msc->cmd[p_msc->cmd_rd];
 
   // claim endpoint
   TU_VERIFY(usbh_edpt_claim(daddr, p_msc->ep_out));
   msch_epbuf_t* epbuf = get_epbuf(daddr);
 
-  epbuf->cbw = *cbw;
-  p_msc->buffer = data;
-  p_msc->complete_cb = complete_cb;
-  p_msc->complete_arg = arg;
+  epbuf->cbw = cmd->cbw;
+#if CFG_TUH_API_EDPT_XFER_SG
+  p_msc->data_seg.buffer = (uint8_t*) cmd->buffer;
+  p_msc->data_seg.len    = cmd->cbw.total_bytes;
+#endif
   p_msc->stage = MSC_STAGE_CMD;
 
   if (!usbh_edpt_xfer(daddr, p_msc->ep_out, (uint8_t*) &epbuf->cbw, sizeof(msc_cbw_t))) {
+    p_msc->stage = MSC_STAGE_IDLE;
     usbh_edpt_release(daddr, p_msc->ep_out);
     return false;
   }
@@ -148,6 +185,121 @@ bool tuh_msc_scsi_command(uint8_t daddr, msc_cbw_t const* cbw, void* data,
   return true;
 }
 
+#if !CFG_TUH_API_EDPT_XFER_SG
+// usbh_edpt_xfer() length is 16-bit: larger data stage is split into chunks, sized as a multiple of any bulk packet
+// size so that only the last chunk can end with a short packet
+#define MSCH_DATA_CHUNK_MAX   0xFC00u
+
+static bool data_chunk_xfer(uint8_t daddr) {
+  msch_interface_t* p_msc = get_itf(daddr);
+  msch_cmd_t const* cmd = &p_msc->cmd[p_msc->cmd_rd];
+  uint8_t const ep_data = (cmd->cbw.dir & TUSB_DIR_IN_MASK) ? p_msc->ep_in : p_msc->ep_out;
+  uint16_t const len = (uint16_t) tu_min32(cmd->cbw.total_bytes - p_msc->data_offset, MSCH_DATA_CHUNK_MAX);
+  return usbh_edpt_xfer(daddr, ep_data, (uint8_t*) cmd->buffer + p_msc->data_offset, len);
+}
+#endif
+
+// Remove command at head of queue, return true if there is next command to start
+static bool cmd_pop(msch_interface_t* p_msc) {
+  (void) osal_mutex_lock(_msch_mutex, OSAL_TIMEOUT_WAIT_FOREVER);
+  p_msc->cmd_rd = (uint8_t) ((p_msc->cmd_rd + 1) % CFG_TUH_MSC_CMD_QUEUE_SIZE);
+  p_msc->cmd_count--;
+  bool const has_next = (p_msc->cmd_count > 0);
+  (void) osal_mutex_unlock(_msch_mutex);
+  return has_next;
+}
+
+static void cmd_complete(uint8_t daddr, msch_cmd_t const* cmd, msc_csw_t const* csw) {
+  if (cmd->complete_cb) {
+    tuh_msc_complete_data_t const cb_data = {
+        .cbw = &cmd->cbw,
+        .csw = csw,
+        .scsi_data = cmd->buffer,
+        .user_arg = cmd->complete_arg
+    };
+    cmd->complete_cb(daddr, &cb_data);
+  }
+}
+
+// Remove command at head of queue and complete it with failed status without sending it to device.
+// Return true if there is next command to start
+static bool cmd_pop_failed(uint8_t daddr, msch_interface_t* p_msc) {
+  msch_cmd_t const failed = p_msc->cmd[p_msc->cmd_rd];
+  bool const has_next = cmd_pop(p_msc);
+
+  msc_csw_t const csw = {
+      .signature = MSC_CSW_SIGNATURE,
+      .tag = failed.cbw.tag,
+      .data_residue = failed.cbw.total_bytes,
+      .status = MSC_CSW_STATUS_FAILED
+  };
+  cmd_complete(daddr, &failed, &csw);
+
+  return has_next;
+}
+
+// Start command at head of queue, commands that cannot be started are failed until one is started or queue is empty
+static void cmd_start_next(uint8_t daddr) {
+  msch_interface_t* p_msc = get_itf(daddr);
+  while (!cmd_start(daddr)) {
+    if (!cmd_pop_failed(daddr, p_msc)) {
+      break;
+    }
+  }
+}
+
+static bool scsi_command_submit(uint8_t daddr, msc_cbw_t const* cbw, void* data, tusb_xfer_sg_t const* sg,
+                                uint8_t sg_count, tuh_msc_complete_cb_t complete_cb, uintptr_t arg) {
+  msch_interface_t* p_msc = get_itf(daddr);
+  TU_VERIFY(p_msc->configured);
+
+  (void) osal_mutex_lock(_msch_mutex, OSAL_TIMEOUT_WAIT_FOREVER);
+  if (p_msc->cmd_count >= CFG_TUH_MSC_CMD_QUEUE_SIZE) {
+    (void) osal_mutex_unlock(_msch_mutex);
+    return false;
+  }
+
+  msch_cmd_t* cmd = &p_msc->cmd[(p_msc->cmd_rd + p_msc->cmd_count) % CFG_TUH_MSC_CMD_QUEUE_SIZE];
+  cmd->cbw = *cbw;
+  cmd->buffer = data;
+#if CFG_TUH_API_EDPT_XFER_SG
+  cmd->data_sg = sg;
+  cmd->data_sg_count = sg_count;
+#else
+  (void) sg; (void) sg_count;
+#endif
+  cmd->complete_cb = complete_cb;
+  cmd->complete_arg = arg;
+
+  // start right away if queue was empty, otherwise it is started when previous command completes
+  bool const is_idle = (p_msc->cmd_count == 0);
+  p_msc->cmd_count++;
+  (void) osal_mutex_unlock(_msch_mutex);
+
+  if (is_idle && !cmd_start(daddr)) {
+    // our command is reported failed by return value, commands queued meanwhile by other threads still need a start
+    if (cmd_pop(p_msc)) {
+      cmd_start_next(daddr);
+    }
+    return false;
+  }
+
+  return true;
+}
+
+bool tuh_msc_scsi_command(uint8_t daddr, msc_cbw_t const* cbw, void* data,
+                          tuh_msc_complete_cb_t complete_cb, uintptr_t arg) {
+  return scsi_command_submit(daddr, cbw, data, NULL, 0, complete_cb, arg);
+}
+
+#if CFG_TUH_API_EDPT_XFER_SG
+bool tuh_msc_scsi_command_sg(uint8_t daddr, msc_cbw_t const* cbw, tusb_xfer_sg_t const* sg, uint8_t sg_count,
+                             tuh_msc_complete_cb_t complete_cb, uintptr_t arg) {
+  TU_VERIFY(sg != NULL && sg_count > 0);
+  return scsi_command_submit(daddr, cbw, NULL, sg, sg_count, complete_cb, arg);
+}
+#endif
+
 bool tuh_msc_read_capacity(uint8_t dev_addr, uint8_t lun, scsi_read_capacity10_resp_t* response,
                            tuh_msc_complete_cb_t complete_cb, uintptr_t arg) {
   msch_interface_t* p_msc = get_itf(dev_addr);
@@ -164,6 +316,28 @@ bool tuh_msc_read_capacity(uint8_t dev_addr, uint8_t lun, scsi_read_capacity10_r
   return tuh_msc_scsi_command(dev_addr, &cbw, response, complete_cb, arg);
 }
 
+bool tuh_msc_read_capacity16(uint8_t dev_addr, uint8_t lun, scsi_read_capacity16_resp_t* response,
+                             tuh_msc_complete_cb_t complete_cb, uintptr_t arg) {
+  msch_interface_t* p_msc = get_itf(dev_addr);
+  TU_VERIFY(p_msc->configured);
+
+  msc_cbw_t cbw;
+  cbw_init(&cbw, lun);
+
+  cbw.total_bytes = sizeof(scsi_read_capacity16_resp_t);
+  cbw.dir         = TUSB_DIR_IN_MASK;
+  cbw.cmd_len     = sizeof(scsi_read_capacity16_t);
+
+  scsi_read_capacity16_t const cmd_read_capa16 = {
+      .cmd_code       = SCSI_CMD_SERVICE_ACTION_IN_16,
+      .service_action = SCSI_SERVICE_ACTION_READ_CAPACITY_16,
+      .alloc_length   = tu_htonl(sizeof(scsi_read_capacity16_resp_t))
+  };
+  memcpy(cbw.command, &cmd_read_capa16, cbw.cmd_len);
+
+  return tuh_msc_scsi_command(dev_addr, &cbw, response, complete_cb, arg);
+}
+
 bool tuh_msc_inquiry(uint8_t dev_addr, uint8_t lun, scsi_inquiry_resp_t* response,
                      tuh_msc_complete_cb_t complete_cb, uintptr_t arg) {
   msch_interface_t* p_msc = get_itf(dev_addr);
@@ -219,24 +393,66 @@ bool tuh_msc_request_sense(uint8_t dev_addr, uint8_t lun, void* response,
   return tuh_msc_scsi_command(dev_addr, &cbw, response, complete_cb, arg);
 }
 
-bool tuh_msc_read10(uint8_t dev_addr, uint8_t lun, void* buffer, uint32_t lba, uint16_t block_count,
-                    tuh_msc_complete_cb_t complete_cb, uintptr_t arg) {
-  msch_interface_t* p_msc = get_itf(dev_addr);
-  TU_VERIFY(p_msc->mounted);
-
-  msc_cbw_t cbw;
-  cbw_init(&cbw, lun);
+static void cbw_read10_init(msc_cbw_t* cbw, uint8_t lun, uint32_t block_size, uint32_t lba, uint16_t block_count) {
+  cbw_init(cbw, lun);
 
-  cbw.total_bytes = block_count * p_msc->capacity[lun].block_size;
-  cbw.dir = TUSB_DIR_IN_MASK;
-  cbw.cmd_len = sizeof(scsi_read10_t);
+  cbw->total_bytes = block_count * block_size;
+  cbw->dir = TUSB_DIR_IN_MASK;
+  cbw->cmd_len = sizeof(scsi_read10_t);
 
   scsi_read10_t const cmd_read10 = {
       .cmd_code    = SCSI_CMD_READ_10,
       .lba         = tu_htonl(lba),
       .block_count = tu_htons(block_count)
   };
-  memcpy(cbw.command, &cmd_read10, cbw.cmd_len);
+  memcpy(cbw->command, &cmd_read10, cbw->cmd_len);
+}
+
+static void cbw_write10_init(msc_cbw_t* cbw, uint8_t lun, uint32_t block_size, uint32_t lba, uint16_t block_count) {
+  cbw_init(cbw, lun);
+
+  cbw->total_bytes = block_count * block_size;
+  cbw->dir         = TUSB_DIR_OUT;
+  cbw->cmd_len     = sizeof(scsi_write10_t);
+
+  scsi_write10_t const cmd_write10 = {
+      .cmd_code    = SCSI_CMD_WRITE_10,
+      .lba         = tu_htonl(lba),
+      .block_count = tu_htons(block_count)
+  };
+  memcpy(cbw->command, &cmd_write10, cbw->cmd_len);
+}
+
+// READ16/WRITE16: transfer length of a single command is limited by 32-bit dCBWDataTransferLength
+static bool cbw_rdwr16_init(msc_cbw_t* cbw, uint8_t lun, uint32_t block_size, uint8_t cmd_code, uint64_t lba,
+                            uint32_t block_count) {
+  uint64_t const total_bytes = (uint64_t) block_count * block_size;
+  TU_VERIFY(total_bytes <= UINT32_MAX);
+
+  cbw_init(cbw, lun);
+
+  cbw->total_bytes = (uint32_t) total_bytes;
+  cbw->dir         = (cmd_code == SCSI_CMD_READ_16) ? TUSB_DIR_IN_MASK : TUSB_DIR_OUT;
+  cbw->cmd_len     = sizeof(scsi_read16_t);
+
+  scsi_read16_t const cmd_rdwr16 = {
+      .cmd_code    = cmd_code,
+      .lba_hi      = tu_htonl((uint32_t) (lba >> 32)),
+      .lba_lo      = tu_htonl((uint32_t) lba),
+      .block_count = tu_htonl(block_count)
+  };
+  memcpy(cbw->command, &cmd_rdwr16, cbw->cmd_len);
+
+  return true;
+}
+
+bool tuh_msc_read10(uint8_t dev_addr, uint8_t lun, void* buffer, uint32_t lba, uint16_t block_count,
+                    tuh_msc_complete_cb_t complete_cb, uintptr_t arg) {
+  msch_interface_t* p_msc = get_itf(dev_addr);
+  TU_VERIFY(p_msc->mounted);
+
+  msc_cbw_t cbw;
+  cbw_read10_init(&cbw, lun, p_msc->capacity[lun].block_size, lba, block_count);
 
   return tuh_msc_scsi_command(dev_addr, &cbw, buffer, complete_cb, arg);
 }
@@ -247,22 +463,79 @@ bool tuh_msc_write10(uint8_t dev_addr, uint8_t lun, void const* buffer, uint32_t
   TU_VERIFY(p_msc->mounted);
 
   msc_cbw_t cbw;
-  cbw_init(&cbw, lun);
+  cbw_write10_init(&cbw, lun, p_msc->capacity[lun].block_size, lba, block_count);
 
-  cbw.total_bytes = block_count * p_msc->capacity[lun].block_size;
-  cbw.dir         = TUSB_DIR_OUT;
-  cbw.cmd_len     = sizeof(scsi_write10_t);
+  return tuh_msc_scsi_command(dev_addr, &cbw, (void*) (uintptr_t) buffer, complete_cb, arg);
+}
 
-  scsi_write10_t const cmd_write10 = {
-      .cmd_code    = SCSI_CMD_WRITE_10,
-      .lba         = tu_htonl(lba),
-      .block_count = tu_htons(block_count)
-  };
-  memcpy(cbw.command, &cmd_write10, cbw.cmd_len);
+bool tuh_msc_read16(uint8_t dev_addr, uint8_t lun, void* buffer, uint64_t lba, uint32_t block_count,
+                    tuh_msc_complete_cb_t complete_cb, uintptr_t arg) {
+  msch_interface_t* p_msc = get_itf(dev_addr);
+  TU_VERIFY(p_msc->mounted);
+
+  msc_cbw_t cbw;
+  TU_VERIFY(cbw_rdwr16_init(&cbw, lun, p_msc->capacity[lun].block_size, SCSI_CMD_READ_16, lba, block_count));
+
+  return tuh_msc_scsi_command(dev_addr, &cbw, buffer, complete_cb, arg);
+}
+
+bool tuh_msc_write16(uint8_t dev_addr, uint8_t lun, void const* buffer, uint64_t lba, uint32_t block_count,
+                     tuh_msc_complete_cb_t complete_cb, uintptr_t arg) {
+  msch_interface_t* p_msc = get_itf(dev_addr);
+  TU_VERIFY(p_msc->mounted);
+
+  msc_cbw_t cbw;
+  TU_VERIFY(cbw_rdwr16_init(&cbw, lun, p_msc->capacity[lun].block_size, SCSI_CMD_WRITE_16, lba, block_count));
 
   return tuh_msc_scsi_command(dev_addr, &cbw, (void*) (uintptr_t) buffer, complete_cb, arg);
 }
 
+#if CFG_TUH_API_EDPT_XFER_SG
+bool tuh_msc_read10_sg(uint8_t dev_addr, uint8_t lun, tusb_xfer_sg_t const* sg, uint8_t sg_count, uint32_t lba,
+                       uint16_t block_count, tuh_msc_complete_cb_t complete_cb, uintptr_t arg) {
+  msch_interface_t* p_msc = get_itf(dev_addr);
+  TU_VERIFY(p_msc->mounted);
+
+  msc_cbw_t cbw;
+  cbw_read10_init(&cbw, lun, p_msc->capacity[lun].block_size, lba, block_count);
+
+  return tuh_msc_scsi_command_sg(dev_addr, &cbw, sg, sg_count, complete_cb, arg);
+}
+
+bool tuh_msc_write10_sg(uint8_t dev_addr, uint8_t lun, tusb_xfer_sg_t const* sg, uint8_t sg_count, uint32_t lba,
+                        uint16_t block_count, tuh_msc_complete_cb_t complete_cb, uintptr_t arg) {
+  msch_interface_t* p_msc = get_itf(dev_addr);
+  TU_VERIFY(p_msc->mounted);
+
+  msc_cbw_t cbw;
+  cbw_write10_init(&cbw, lun, p_msc->capacity[lun].block_size, lba, block_count);
+
+  return tuh_msc_scsi_command_sg(dev_addr, &cbw, sg, sg_count, complete_cb, arg);
+}
+
+bool tuh_msc_read16_sg(uint8_t dev_addr, uint8_t lun, tusb_xfer_sg_t const* sg, uint8_t sg_count, uint64_t lba,
+                       uint32_t block_count, tuh_msc_complete_cb_t complete_cb, uintptr_t arg) {
+  msch_interface_t* p_msc = get_itf(dev_addr);
+  TU_VERIFY(p_msc->mounted);
+
+  msc_cbw_t cbw;
+  TU_VERIFY(cbw_rdwr16_init(&cbw, lun, p_msc->capacity[lun].block_size, SCSI_CMD_READ_16, lba, block_count));
+
+  return tuh_msc_scsi_command_sg(dev_addr, &cbw, sg, sg_count, complete_cb, arg);
+}
+
+bool tuh_msc_write16_sg(uint8_t dev_addr, uint8_t lun, tusb_xfer_sg_t const* sg, uint8_t sg_count, uint64_t lba,
+                        uint32_t block_count, tuh_msc_complete_cb_t complete_cb, uintptr_t arg) {
+  msch_interface_t* p_msc = get_itf(dev_addr);
+  TU_VERIFY(p_msc->mounted);
+
+  msc_cbw_t cbw;
+  TU_VERIFY(cbw_rdwr16_init(&cbw, lun, p_msc->capacity[lun].block_size, SCSI_CMD_WRITE_16, lba, block_count));
+
+  return tuh_msc_scsi_command_sg(dev_addr, &cbw, sg, sg_count, complete_cb, arg);
+}
+#endif
+
 #if 0
 // MSC interface Reset (not used now)
 bool tuh_msc_reset(uint8_t dev_addr) {
@@ -288,10 +561,23 @@ bool msch_init(void) {
   TU_LOG_DRV("sizeof(msch_interface_t) = %u\r\n", sizeof(msch_interface_t));
   TU_LOG_DRV("sizeof(msch_epbuf_t) = %u\r\n", sizeof(msch_epbuf_t));
   tu_memclr(_msch_itf, sizeof(_msch_itf));
+
+#if OSAL_MUTEX_REQUIRED
+  _msch_mutex = osal_mutex_create(&_msch_mutexdef);
+  TU_ASSERT(_msch_mutex);
+#endif
+
   return true;
 }
 
 bool msch_deinit(void) {
+#if OSAL_MUTEX_REQUIRED
+  if (_msch_mutex) {
+    osal_mutex_delete(_msch_mutex);
+    _msch_mutex = NULL;
+  }
+#endif
+
   return true;
 }
 
@@ -302,6 +588,13 @@ void msch_close(uint8_t dev_addr) {
 
   TU_LOG_DRV("  MSCh close addr = %d\r\n", dev_addr);
 
+  // reject new commands, then fail queued ones including the one in progress whose transfer is aborted
+  p_msc->configured = false;
+  p_msc->stage = MSC_STAGE_IDLE;
+  while (p_msc->cmd_count > 0) {
+    (void) cmd_pop_failed(dev_addr, p_msc);
+  }
+
   // invoke Application Callback
   if (p_msc->mounted) {
     if (tuh_msc_umount_cb) {
@@ -315,50 +608,100 @@ void msch_close(uint8_t dev_addr) {
 bool msch_xfer_cb(uint8_t dev_addr, uint8_t ep_addr, xfer_result_t event, uint32_t xferred_bytes) {
   msch_interface_t* p_msc = get_itf(dev_addr);
   msch_epbuf_t* epbuf = get_epbuf(dev_addr);
+  msch_cmd_t const* cmd = &p_msc->cmd[p_msc->cmd_rd];
   msc_cbw_t const * cbw = &epbuf->cbw;
   msc_csw_t       * csw = &epbuf->csw;
+  bool ok = true;
 
   switch (p_msc->stage) {
     case MSC_STAGE_CMD:
       // Must be Command Block
-      TU_ASSERT(ep_addr == p_msc->ep_out && event == XFER_RESULT_SUCCESS && xferred_bytes == sizeof(msc_cbw_t));
-      if (cbw->total_bytes && p_msc->buffer) {
-        // Data stage if any
+      ok = (ep_addr == p_msc->ep_out && event == XFER_RESULT_SUCCESS && xferred_bytes == sizeof(msc_cbw_t));
+      if (!ok) {
+        break;
+      }
+#if CFG_TUH_API_EDPT_XFER_SG
+      if (cbw->total_bytes && (cmd->buffer || cmd->data_sg)) {
+        // Data stage if any: submitted as a single transfer regardless of its length
         p_msc->stage = MSC_STAGE_DATA;
         uint8_t const ep_data = (cbw->dir & TUSB_DIR_IN_MASK) ? p_msc->ep_in : p_msc->ep_out;
-        TU_ASSERT(usbh_edpt_xfer(dev_addr, ep_data, p_msc->buffer, (uint16_t) cbw->total_bytes));
+        if (cmd->data_sg) {
+          ok = usbh_edpt_xfer_sg(dev_addr, ep_data, cmd->data_sg, cmd->data_sg_count);
+        } else {
+          ok = usbh_edpt_xfer_sg(dev_addr, ep_data, &p_msc->data_seg, 1);
+        }
         break;
       }
+#else
+      if (cbw->total_bytes && cmd->buffer) {
+        // Data stage if any
+        p_msc->stage = MSC_STAGE_DATA;
+        p_msc->data_offset = 0;
+        ok = data_chunk_xfer(dev_addr);
+        break;
+      }
+#endif
 
       TU_ATTR_FALLTHROUGH; // fallthrough to status stage
 
     case MSC_STAGE_DATA:
+      if (p_msc->stage == MSC_STAGE_DATA) {
+        // e.g stalled data stage
+        ok = (event == XFER_RESULT_SUCCESS);
+        if (!ok) {
+          break;
+        }
+#if !CFG_TUH_API_EDPT_XFER_SG
+        // next chunk unless this one is the last or ended early with a short packet
+        uint32_t const chunk_len = tu_min32(cbw->total_bytes - p_msc->data_offset, MSCH_DATA_CHUNK_MAX);
+        p_msc->data_offset += xferred_bytes;
+        if (xferred_bytes == chunk_len && p_msc->data_offset < cbw->total_bytes) {
+          ok = data_chunk_xfer(dev_addr);
+          break;
+        }
+#endif
+      }
+
       // Status stage
       p_msc->stage = MSC_STAGE_STATUS;
-      TU_ASSERT(usbh_edpt_xfer(dev_addr, p_msc->ep_in, (uint8_t*) csw, (uint16_t) sizeof(msc_csw_t)));
+      ok = usbh_edpt_xfer(dev_addr, p_msc->ep_in, (uint8_t*) csw, (uint16_t) sizeof(msc_csw_t));
       break;
 
-    case MSC_STAGE_STATUS:
-      // SCSI op is complete
+    case MSC_STAGE_STATUS: {
+      ok = (event == XFER_RESULT_SUCCESS && xferred_bytes == sizeof(msc_csw_t));
+      if (!ok) {
+        break;
+      }
+
+      // SCSI op is complete: keep a copy since its slot is freed for callback to submit new command
       p_msc->stage = MSC_STAGE_IDLE;
+      msch_cmd_t const done = *cmd;
+      bool const has_next = cmd_pop(p_msc);
 
-      if (p_msc->complete_cb) {
-        tuh_msc_complete_data_t const cb_data = {
-            .cbw = cbw,
-            .csw = csw,
-            .scsi_data = p_msc->buffer,
-            .user_arg = p_msc->complete_arg
-        };
-        p_msc->complete_cb(dev_addr, &cb_data);
+      // complete before starting next command: callback sees its own csw and may queue more commands
+      cmd_complete(dev_addr, &done, csw);
+
+      if (has_next) {
+        cmd_start_next(dev_addr);
       }
       break;
+    }
 
       // unknown state
     default:
       break;
   }
 
-  return true;
+  if (!ok) {
+    // transfer failed or could not be submitted: fail the command so that the ones queued behind it still run
+    TU_LOG_DRV("  MSCh stage %u failed\r\n", p_msc->stage);
+    p_msc->stage = MSC_STAGE_IDLE;
+    if (cmd_pop_failed(dev_addr, p_msc)) {
+      cmd_start_next(dev_addr);
+    }
+  }
+
+  return ok;
 }
 
 //--------------------------------------------------------------------+
@@ -368,6 +711,8 @@ static void config_get_maxlun_complete(tuh_xfer_t* xfer);
 static bool config_test_unit_ready_complete(uint8_t dev_addr, tuh_msc_complete_data_t const* cb_data);
 static bool config_request_sense_complete(uint8_t dev_addr, tuh_msc_complete_data_t const* cb_data);
 static bool config_read_capacity_complete(uint8_t dev_addr, tuh_msc_complete_data_t const* cb_data);
+static bool config_read_capacity16_complete(uint8_t dev_addr, tuh_msc_complete_data_t const* cb_data);
+static void config_complete(uint8_t dev_addr);
 
 bool msch_open(uint8_t rhport, uint8_t dev_addr, tusb_desc_interface_t const* desc_itf, uint16_t max_len) {
   (void) rhport;
@@ -419,7 +764,7 @@ bool msch_set_config(uint8_t daddr, uint8_t itf_num) {
       .wLength  = 1
   };
 
-  uint8_t* enum_buf = usbh_get_enum_buf();
+  uint8_t* enum_buf = usbh_get_enum_buf(daddr);
   tuh_xfer_t xfer = {
       .daddr       = daddr,
       .ep_addr     = 0,
@@ -439,7 +784,7 @@ static void config_get_maxlun_complete(tuh_xfer_t* xfer) {
 
   // MAXLUN's response is minus 1 by specs, STALL means 1
   if (XFER_RESULT_SUCCESS == xfer->result) {
-    uint8_t* enum_buf = usbh_get_enum_buf();
+    uint8_t* enum_buf = usbh_get_enum_buf(daddr);
     p_msc->max_lun = enum_buf[0] + 1;
   } else {
     p_msc->max_lun = 1;
@@ -454,9 +799,10 @@ static void config_get_maxlun_complete(tuh_xfer_t* xfer) {
 }
 
 static bool config_test_unit_ready_complete(uint8_t dev_addr, tuh_msc_complete_data_t const* cb_data) {
+  TU_VERIFY(get_itf(dev_addr)->configured); // command failed by msch_close()
   msc_cbw_t const* cbw = cb_data->cbw;
   msc_csw_t const* csw = cb_data->csw;
-  uint8_t* enum_buf = usbh_get_enum_buf();
+  uint8_t* enum_buf = usbh_get_enum_buf(dev_addr);
 
   if (csw->status == 0) {
     // Unit is ready, read its capacity
@@ -475,6 +821,7 @@ static bool config_test_unit_ready_complete(uint8_t dev_addr, tuh_msc_complete_d
 }
 
 static bool config_request_sense_complete(uint8_t dev_addr, tuh_msc_complete_data_t const* cb_data) {
+  TU_VERIFY(get_itf(dev_addr)->configured); // command failed by msch_close()
   msc_cbw_t const* cbw = cb_data->cbw;
   msc_csw_t const* csw = cb_data->csw;
 
@@ -484,17 +831,53 @@ static bool config_request_sense_complete(uint8_t dev_addr, tuh_msc_complete_dat
 }
 
 static bool config_read_capacity_complete(uint8_t dev_addr, tuh_msc_complete_data_t const* cb_data) {
+  TU_VERIFY(get_itf(dev_addr)->configured); // command failed by msch_close()
   msc_cbw_t const* cbw = cb_data->cbw;
   msc_csw_t const* csw = cb_data->csw;
   TU_ASSERT(csw->status == 0);
   msch_interface_t* p_msc = get_itf(dev_addr);
-  uint8_t* enum_buf = usbh_get_enum_buf();
+  uint8_t* enum_buf = usbh_get_enum_buf(dev_addr);
 
   // Capacity response field: Block size and Last LBA are both Big-Endian
   scsi_read_capacity10_resp_t* resp = (scsi_read_capacity10_resp_t*) (uintptr_t) enum_buf;
-  p_msc->capacity[cbw->lun].block_count = tu_ntohl(resp->last_lba) + 1;
+  uint32_t const last_lba = tu_ntohl(resp->last_lba);
+  p_msc->capacity[cbw->lun].block_count = ((uint64_t) last_lba) + 1;
   p_msc->capacity[cbw->lun].block_size  = tu_ntohl(resp->block_size);
 
+  if (last_lba == UINT32_MAX) {
+    // Disk has more than 2^32 blocks, its capacity is only reported by READ CAPACITY (16)
+    TU_LOG_DRV("SCSI Read Capacity 16\r\n");
+    TU_ASSERT(tuh_msc_read_capacity16(dev_addr, cbw->lun, (scsi_read_capacity16_resp_t*) (uintptr_t) enum_buf,
+                                      config_read_capacity16_complete, 0));
+    return true;
+  }
+
+  config_complete(dev_addr);
+  return true;
+}
+
+static bool config_read_capacity16_complete(uint8_t dev_addr, tuh_msc_complete_data_t const* cb_data) {
+  TU_VERIFY(get_itf(dev_addr)->configured); // command failed by msch_close()
+  msc_cbw_t const* cbw = cb_data->cbw;
+  msc_csw_t const* csw = cb_data->csw;
+  msch_interface_t* p_msc = get_itf(dev_addr);
+  uint8_t* enum_buf = usbh_get_enum_buf(dev_addr);
+
+  // Keep capacity from READ CAPACITY (10) if device does not support READ CAPACITY (16)
+  if (csw->status == 0) {
+    scsi_read_capacity16_resp_t* resp = (scsi_read_capacity16_resp_t*) (uintptr_t) enum_buf;
+    uint64_t const last_lba = (((uint64_t) tu_ntohl(resp->last_lba_hi)) << 32) | tu_ntohl(resp->last_lba_lo);
+    p_msc->capacity[cbw->lun].block_count = last_lba + 1;
+    p_msc->capacity[cbw->lun].block_size  = tu_ntohl(resp->block_size);
+  }
+
+  config_complete(dev_addr);
+  return true;
+}
+
+static void config_complete(uint8_t dev_addr) {
+  msch_interface_t* p_msc = get_itf(dev_addr);
+
   // Mark enumeration is complete
   p_msc->mounted = true;
   if (tuh_msc_mount_cb) {
@@ -503,8 +886,6 @@ static bool config_read_capacity_complete(uint8_t dev_addr, tuh_msc_complete_dat
 
   // notify usbh that driver enumeration is complete
   usbh_driver_set_config_complete(dev_addr, p_msc->itf_num);
-
-  return true;
 }
 
 #endif
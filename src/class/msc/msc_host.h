@@ -41,6 +41,14 @@
 #define CFG_TUH_MSC_MAXLUN  4
 #endif
 
+// Number of SCSI commands that can be queued per device. Commands are executed one after another in submission order,
+// next CBW is sent as soon as previous CSW is received. Each entry costs about 48 bytes.
+#ifndef CFG_TUH_MSC_CMD_QUEUE_SIZE
+#define CFG_TUH_MSC_CMD_QUEUE_SIZE  1
+#endif
+
+TU_VERIFY_STATIC(CFG_TUH_MSC_CMD_QUEUE_SIZE > 0 && CFG_TUH_MSC_CMD_QUEUE_SIZE <= 255, "invalid command queue size");
+
 typedef struct {
   msc_cbw_t const* cbw; // SCSI command
   msc_csw_t const* csw; // SCSI status
@@ -58,24 +66,38 @@ typedef bool (*tuh_msc_complete_cb_t)(uint8_t dev_addr, tuh_msc_complete_data_t
 // This function true after tuh_msc_mounted_cb() and false after tuh_msc_unmounted_cb()
 bool tuh_msc_mounted(uint8_t dev_addr);
 
-// Check if the interface is currently ready or busy transferring data
+// Check if the interface can accept a new command i.e mounted and command queue is not full
 bool tuh_msc_ready(uint8_t dev_addr);
 
+// Get number of commands queued including the one in progress
+uint8_t tuh_msc_cmd_pending(uint8_t dev_addr);
+
 // Get Max Lun
 uint8_t tuh_msc_get_maxlun(uint8_t dev_addr);
 
-// Get number of block
+// Get number of block, saturated at UINT32_MAX for disk with more than 2^32 blocks
 uint32_t tuh_msc_get_block_count(uint8_t dev_addr, uint8_t lun);
 
+// Get number of block of disk with 64-bit LBA
+uint64_t tuh_msc_get_block_count64(uint8_t dev_addr, uint8_t lun);
+
 // Get block size in bytes
 uint32_t tuh_msc_get_block_size(uint8_t dev_addr, uint8_t lun);
 
 // Perform a full SCSI command (cbw, data, csw) in non-blocking manner.
-// Complete callback is invoked when SCSI op is complete.
-// return true if success, false if there is already pending operation.
+// Command is queued and executed after previously submitted ones, complete callbacks are invoked in submission order.
+// return true if success, false if command queue is full.
 // NOTE: buffer must be accessible by USB/DMA controller, aligned correctly and multiple of cache line if enabled
 bool tuh_msc_scsi_command(uint8_t daddr, msc_cbw_t const* cbw, void* data, tuh_msc_complete_cb_t complete_cb, uintptr_t arg);
 
+#if CFG_TUH_API_EDPT_XFER_SG
+// Perform a full SCSI command with data stage scattered/gathered across a list of buffers. Data stage is submitted
+// as a single transfer, complete callback is invoked once (scsi_data is NULL).
+// NOTE: sg list must stay valid until complete, all segments except the last one must be multiple of endpoint packet size
+bool tuh_msc_scsi_command_sg(uint8_t daddr, msc_cbw_t const* cbw, tusb_xfer_sg_t const* sg, uint8_t sg_count,
+                             tuh_msc_complete_cb_t complete_cb, uintptr_t arg);
+#endif
+
 // Perform SCSI Inquiry command
 // Complete callback is invoked when SCSI op is complete.
 // NOTE: response must be accessible by USB/DMA controller, aligned correctly and multiple of cache line if enabled
@@ -100,12 +122,32 @@ bool tuh_msc_read10(uint8_t dev_addr, uint8_t lun, void * buffer, uint32_t lba,
 // NOTE: buffer must be accessible by USB/DMA controller, aligned correctly and multiple of cache line if enabled
 bool tuh_msc_write10(uint8_t dev_addr, uint8_t lun, void const * buffer, uint32_t lba, uint16_t block_count, tuh_msc_complete_cb_t complete_cb, uintptr_t arg);
 
+// Perform SCSI Read 16/Write 16 command: 64-bit LBA and 32-bit block count, required to access blocks beyond 2^32
+// and allow large transfer in a single command (block_count * block_size must not exceed 4GB).
+// Complete callback is invoked when SCSI op is complete.
+// NOTE: buffer must be accessible by USB/DMA controller, aligned correctly and multiple of cache line if enabled
+bool tuh_msc_read16(uint8_t dev_addr, uint8_t lun, void * buffer, uint64_t lba, uint32_t block_count, tuh_msc_complete_cb_t complete_cb, uintptr_t arg);
+bool tuh_msc_write16(uint8_t dev_addr, uint8_t lun, void const * buffer, uint64_t lba, uint32_t block_count, tuh_msc_complete_cb_t complete_cb, uintptr_t arg);
+
+#if CFG_TUH_API_EDPT_XFER_SG
+// Perform SCSI Read 10/Write 10 command with blocks scattered/gathered across a list of buffers e.g a file system cache
+// Complete callback is invoked when SCSI op is complete.
+bool tuh_msc_read10_sg(uint8_t dev_addr, uint8_t lun, tusb_xfer_sg_t const* sg, uint8_t sg_count, uint32_t lba, uint16_t block_count, tuh_msc_complete_cb_t complete_cb, uintptr_t arg);
+bool tuh_msc_write10_sg(uint8_t dev_addr, uint8_t lun, tusb_xfer_sg_t const* sg, uint8_t sg_count, uint32_t lba, uint16_t block_count, tuh_msc_complete_cb_t complete_cb, uintptr_t arg);
+bool tuh_msc_read16_sg(uint8_t dev_addr, uint8_t lun, tusb_xfer_sg_t const* sg, uint8_t sg_count, uint64_t lba, uint32_t block_count, tuh_msc_complete_cb_t complete_cb, uintptr_t arg);
+bool tuh_msc_write16_sg(uint8_t dev_addr, uint8_t lun, tusb_xfer_sg_t const* sg, uint8_t sg_count, uint64_t lba, uint32_t block_count, tuh_msc_complete_cb_t complete_cb, uintptr_t arg);
+#endif
+
 // Perform SCSI Read Capacity 10 command
 // Complete callback is invoked when SCSI op is complete.
 // Note: during enumeration, host stack already carried out this request. Application can retrieve capacity by
 // simply call tuh_msc_get_block_count() and tuh_msc_get_block_size()
 bool tuh_msc_read_capacity(uint8_t dev_addr, uint8_t lun, scsi_read_capacity10_resp_t* response, tuh_msc_complete_cb_t complete_cb, uintptr_t arg);
 
+// Perform SCSI Read Capacity 16 command, carried out during enumeration if disk has more than 2^32 blocks
+// Complete callback is invoked when SCSI op is complete.
+bool tuh_msc_read_capacity16(uint8_t dev_addr, uint8_t lun, scsi_read_capacity16_resp_t* response, tuh_msc_complete_cb_t complete_cb, uintptr_t arg);
+
 //------------- Application Callback -------------//
 
 // Invoked when a device with MassStorage interface is mounted
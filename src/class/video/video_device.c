@@ -112,6 +112,10 @@ typedef struct TU_ATTR_PACKED {
   uint32_t bufsize;  /* frame buffer size */
   uint32_t offset;   /* offset for the next payload transfer */
   uint32_t max_payload_transfer_size;
+#if CFG_TUD_VIDEO_STREAMING_BULK_ZERO_COPY
+  uint32_t payload_remaining; /* bytes of the current payload to be sent from frame buffer */
+  bool     payload_zlp;       /* the current payload is terminated by a zero length packet */
+#endif
   uint8_t  error_code;/* error code */
   uint8_t  state;    /* 0:probing 1:committed 2:streaming */
 
@@ -422,6 +426,18 @@ static inline void const *_find_desc_frame(void const *beg, void const *end, uin
   return end;
 }
 
+#if CFG_TUD_VIDEO_STREAMING_BULK_ZERO_COPY
+/** Return the max packet size of the bulk streaming endpoint, 0 if streaming via isochronous endpoint */
+static uint16_t _bulk_packet_size(videod_streaming_interface_t const *stm)
+{
+  uint_fast16_t ofs_ep = stm->desc.ep[0];
+  if (!ofs_ep) return 0;
+  tusb_desc_endpoint_t const *ep = (tusb_desc_endpoint_t const*)(_videod_itf[stm->index_vc].beg + ofs_ep);
+  if (TUSB_XFER_BULK != ep->bmAttributes.xfer) return 0;
+  return tu_edpt_packet_size(ep);
+}
+#endif
+
 /** Set uniquely determined values to variables that have not been set
  *
  * @param[in,out] param       Target */
@@ -512,6 +528,13 @@ static bool _update_streaming_parameters(videod_streaming_interface_t const *stm
   uint_fast32_t interval_ms = interval / 10000;
   TU_ASSERT(interval_ms);
   uint_fast32_t payload_size = (frame_size + interval_ms - 1) / interval_ms + 2;
+#if CFG_TUD_VIDEO_STREAMING_BULK_ZERO_COPY
+  if (_bulk_packet_size(stm)) {
+    /* a whole frame per payload, which is sent from the frame buffer */
+    param->dwMaxPayloadTransferSize = (uint32_t) (frame_size + 2);
+    return true;
+  }
+#endif
   if (CFG_TUD_VIDEO_STREAMING_EP_BUFSIZE < payload_size) {
     payload_size = CFG_TUD_VIDEO_STREAMING_EP_BUFSIZE;
   }
@@ -674,6 +697,11 @@ static bool _negotiate_streaming_parameters(videod_streaming_interface_t const *
       } else {
         payload_size = (frame_size + interval_ms - 1) / interval_ms + 2;
       }
+#if CFG_TUD_VIDEO_STREAMING_BULK_ZERO_COPY
+      if (_bulk_packet_size(stm)) {
+        payload_size = frame_size + 2;
+      } else
+#endif
       if (CFG_TUD_VIDEO_STREAMING_EP_BUFSIZE < payload_size) {
         payload_size = CFG_TUD_VIDEO_STREAMING_EP_BUFSIZE;
       }
@@ -787,6 +815,10 @@ static bool _open_vs_itf(uint8_t rhport, videod_streaming_interface_t *stm, uint
   stm->buffer  = NULL;
   stm->bufsize = 0;
   stm->offset  = 0;
+#if CFG_TUD_VIDEO_STREAMING_BULK_ZERO_COPY
+  stm->payload_remaining = 0;
+  stm->payload_zlp       = false;
+#endif
 
   /* Find a alternate interface */
   uint8_t const *beg = desc + stm->desc.beg;
@@ -816,6 +848,13 @@ static bool _open_vs_itf(uint8_t rhport, videod_streaming_interface_t *stm, uint
 #endif
     } else {
       TU_VERIFY(TUSB_XFER_BULK == ep->bmAttributes.xfer);
+#if CFG_TUD_VIDEO_STREAMING_BULK_ZERO_COPY
+      /* The first packet of a payload is sent from the endpoint buffer, an unaligned rest is copied behind header */
+      TU_ASSERT(tu_edpt_packet_size(ep) <= CFG_TUD_VIDEO_STREAMING_EP_BUFSIZE);
+      uint32_t const hdr_ofs = tu_round_up(sizeof(tusb_video_payload_header_t), CFG_TUD_VIDEO_STREAMING_ZERO_COPY_ALIGN);
+      TU_ASSERT(CFG_TUD_VIDEO_STREAMING_ZERO_COPY_ALIGN == 1 ||
+                tu_edpt_packet_size(ep) + hdr_ofs <= CFG_TUD_VIDEO_STREAMING_EP_BUFSIZE);
+#endif
       TU_ASSERT(usbd_edpt_open(rhport, ep));
     }
     stm->desc.ep[i] = (uint16_t) (cur - desc);
@@ -828,24 +867,37 @@ static bool _open_vs_itf(uint8_t rhport, videod_streaming_interface_t *stm, uint
   return true;
 }
 
-/** Prepare the next packet payload. */
+/** Prepare the next packet payload.
+ *
+ * @return Byte length to be sent from the endpoint buffer */
 static uint_fast16_t _prepare_in_payload(videod_streaming_interface_t *stm, uint8_t* ep_buf) {
-  uint_fast16_t remaining = stm->bufsize - stm->offset;
+  uint_fast32_t remaining = stm->bufsize - stm->offset;
   uint_fast16_t hdr_len   = ep_buf[0];
-  uint_fast16_t pkt_len   = stm->max_payload_transfer_size;
+  uint_fast32_t pkt_len   = stm->max_payload_transfer_size;
   if (hdr_len + remaining < pkt_len) {
     pkt_len = hdr_len + remaining;
   }
   TU_ASSERT(pkt_len >= hdr_len);
-  uint_fast16_t data_len = pkt_len - hdr_len;
-  memcpy(&ep_buf[hdr_len], stm->buffer + stm->offset, data_len);
-  stm->offset += data_len;
-  remaining -= data_len;
-  if (!remaining) {
+  uint_fast32_t data_len = pkt_len - hdr_len;
+  if (data_len == remaining) {
     tusb_video_payload_header_t *hdr = (tusb_video_payload_header_t*) ep_buf;
     hdr->EndOfFrame = 1;
   }
-  return hdr_len + data_len;
+#if CFG_TUD_VIDEO_STREAMING_BULK_ZERO_COPY
+  uint_fast16_t const mps = _bulk_packet_size(stm);
+  if (mps) {
+    /* Host ends a payload by a short packet, unless it is of the negotiated size */
+    stm->payload_zlp = (0 == pkt_len % mps) && (pkt_len < stm->max_payload_transfer_size);
+    if (pkt_len > mps) {
+      /* Copy the first packet only, the rest is sent from the frame buffer by videod_xfer_cb() */
+      stm->payload_remaining = (uint32_t) (pkt_len - mps);
+      data_len = mps - hdr_len;
+    }
+  }
+#endif
+  memcpy(&ep_buf[hdr_len], stm->buffer + stm->offset, data_len);
+  stm->offset += (uint32_t) data_len;
+  return (uint_fast16_t) (hdr_len + data_len);
 }
 
 /** Handle a standard request to the video control interface. */
@@ -1113,6 +1165,10 @@ static int handle_video_stm_cs_req(uint8_t rhport, uint8_t stage,
               stm->buffer  = NULL;
               stm->bufsize = 0;
               stm->offset  = 0;
+#if CFG_TUD_VIDEO_STREAMING_BULK_ZERO_COPY
+              stm->payload_remaining = 0;
+              stm->payload_zlp       = false;
+#endif
               /* initialize payload header */
               tusb_video_payload_header_t *hdr = (tusb_video_payload_header_t*)stm_epbuf->buf;
               hdr->bHeaderLength = sizeof(*hdr);
@@ -1410,6 +1466,36 @@ bool videod_xfer_cb(uint8_t rhport, uint8_t ep_addr, xfer_result_t result, uint3
   TU_ASSERT(itf < CFG_TUD_VIDEO_STREAMING);
   videod_streaming_epbuf_t *stm_epbuf = &_videod_streaming_epbuf[itf];
 
+#if CFG_TUD_VIDEO_STREAMING_BULK_ZERO_COPY
+  if (stm->payload_remaining) {
+    /* Send the rest of the payload straight from the frame buffer as one transfer */
+    uint8_t *data = stm->buffer + stm->offset;
+    uint32_t len  = stm->payload_remaining;
+    if ((uintptr_t) data % CFG_TUD_VIDEO_STREAMING_ZERO_COPY_ALIGN) {
+      /* DMA can not start at this address: copy whole packets through the endpoint buffer behind the payload header,
+       * which is kept for the next payload */
+      uint_fast16_t const mps = _bulk_packet_size(stm);
+      uint32_t const ofs   = tu_round_up(stm_epbuf->buf[0], CFG_TUD_VIDEO_STREAMING_ZERO_COPY_ALIGN);
+      uint32_t const chunk = (CFG_TUD_VIDEO_STREAMING_EP_BUFSIZE - ofs) / mps * mps;
+      TU_ASSERT(chunk);
+      if (len > chunk) len = chunk;
+      memcpy(stm_epbuf->buf + ofs, data, len);
+      data = stm_epbuf->buf + ofs;
+    }
+    stm->offset += len;
+    stm->payload_remaining -= len;
+    TU_VERIFY( usbd_edpt_claim(rhport, ep_addr), 0);
+    TU_ASSERT( usbd_edpt_xfer32(rhport, ep_addr, data, len), 0);
+    return true;
+  }
+  if (stm->payload_zlp) {
+    stm->payload_zlp = false;
+    TU_VERIFY( usbd_edpt_claim(rhport, ep_addr), 0);
+    TU_ASSERT( usbd_edpt_xfer(rhport, ep_addr, NULL, 0), 0);
+    return true;
+  }
+#endif
+
   if (stm->offset < stm->bufsize) {
     /* Claim the endpoint */
     TU_VERIFY( usbd_edpt_claim(rhport, ep_addr), 0);
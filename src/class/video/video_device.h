@@ -35,6 +35,32 @@
 extern "C" {
 #endif
 
+//--------------------------------------------------------------------+
+// Class Driver Configuration
+//--------------------------------------------------------------------+
+
+// Bulk streaming sends a whole frame as one payload straight from the frame buffer: only the first packet (header and
+// the leading data) is copied into the endpoint buffer, the rest is transferred by DMA as one long transfer. The frame
+// buffer must be accessible by the USB controller. Isochronous streaming always copies, since every packet starts with
+// its own header.
+#ifndef CFG_TUD_VIDEO_STREAMING_BULK_ZERO_COPY
+  #define CFG_TUD_VIDEO_STREAMING_BULK_ZERO_COPY 0
+#endif
+
+// Address alignment that DMA of the port (and DCache maintenance) needs to send from the frame buffer. The rest of a
+// payload starts at frame offset "max packet size - header length" e.g 510, if that address is not aligned it is copied
+// through the endpoint buffer packet by packet instead. To keep zero-copy place the frame buffer 2 bytes (the payload
+// header length) past an aligned address.
+#ifndef CFG_TUD_VIDEO_STREAMING_ZERO_COPY_ALIGN
+  #if CFG_TUD_MEM_DCACHE_ENABLE
+    #define CFG_TUD_VIDEO_STREAMING_ZERO_COPY_ALIGN CFG_TUD_MEM_DCACHE_LINE_SIZE
+  #elif defined(TUP_USBIP_DWC2) && CFG_TUD_DWC2_DMA_ENABLE
+    #define CFG_TUD_VIDEO_STREAMING_ZERO_COPY_ALIGN 4
+  #else
+    #define CFG_TUD_VIDEO_STREAMING_ZERO_COPY_ALIGN 1
+  #endif
+#endif
+
 //--------------------------------------------------------------------+
 // Application API (Multiple Ports)
 // CFG_TUD_VIDEO > 1
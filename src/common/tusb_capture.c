@@ -0,0 +1,294 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025, Ha Thach (tinyusb.org)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * This file is part of the TinyUSB stack.
+ */
+
+#include "tusb_option.h"
+
+#if (CFG_TUD_ENABLED || CFG_TUH_ENABLED) && CFG_TUSB_CAPTURE
+
+#include "tusb.h"
+#include "common/tusb_private.h"
+
+//--------------------------------------------------------------------+
+// MACRO CONSTANT TYPEDEF
+//--------------------------------------------------------------------+
+#define CAPTURE_DEPTH   (CFG_TUSB_CAPTURE_BUFSIZE / 4)
+TU_VERIFY_STATIC((CAPTURE_DEPTH & (CAPTURE_DEPTH - 1)) == 0, "CFG_TUSB_CAPTURE_BUFSIZE must be power of 2");
+TU_VERIFY_STATIC(CFG_TUSB_CAPTURE_PAYLOAD_MAX <= 960, "record length must fit in ring header");
+
+// Record in capture ring after header:
+// timestamp, type | xfer_type << 8 | ep_addr << 16 | daddr << 24, rhport | flags << 8 | result << 16,
+// length, caplen, [setup 8 bytes], payload
+enum {
+  CAPTURE_FLAG_HOST  = 0x01,
+  CAPTURE_FLAG_SETUP = 0x02,
+};
+
+enum {
+  CAPTURE_HEADER_WORDS = 5,
+  CAPTURE_SETUP_WORDS  = 2,
+};
+
+// pcapng
+enum {
+  PCAPNG_BLOCK_SHB = 0x0A0D0D0Au,
+  PCAPNG_BLOCK_IDB = 0x00000001u,
+  PCAPNG_BLOCK_EPB = 0x00000006u,
+  PCAPNG_BOM       = 0x1A2B3C4Du,
+  PCAPNG_SHB_LEN   = 28,
+  PCAPNG_IDB_LEN   = 32,
+  PCAPNG_EPB_LEN   = 32, // without packet data
+
+  LINKTYPE_USB_LINUX_MMAPPED = 220,
+};
+
+// Linux usbmon packet header (struct usbmon_packet), in host byte order
+typedef struct {
+  uint64_t id;
+  uint8_t  type;        // 'S' submit, 'C' complete
+  uint8_t  xfer_type;   // 0 iso, 1 interrupt, 2 control, 3 bulk
+  uint8_t  epnum;       // with direction bit
+  uint8_t  devnum;
+  uint16_t busnum;
+  int8_t   flag_setup;  // 0 if setup is present
+  int8_t   flag_data;   // 0 if data is present
+  int64_t  ts_sec;
+  int32_t  ts_usec;
+  int32_t  status;
+  uint32_t length;
+  uint32_t len_cap;
+  uint8_t  setup[8];
+  int32_t  interval;
+  int32_t  start_frame;
+  uint32_t xfer_flags;
+  uint32_t ndesc;
+} usbmon_header_t;
+
+TU_VERIFY_STATIC(sizeof(usbmon_header_t) == 64, "size is not correct");
+
+static uint32_t _capture_buf[CAPTURE_DEPTH];
+static tu_ring_t _capture = { .buf = _capture_buf, .depth = CAPTURE_DEPTH };
+
+// reader state
+static struct {
+  bool header_sent;
+  uint32_t ts_high; // extend 32-bit microsecond timestamp
+  uint32_t ts_last;
+} _capture_rd;
+
+//--------------------------------------------------------------------+
+// Capture
+//--------------------------------------------------------------------+
+static void capture_write(uint8_t type, bool is_host, uint8_t rhport, uint8_t daddr, uint8_t ep_addr, uint8_t xfer_type,
+                          uint8_t result, uint32_t len, tusb_control_request_t const* request, uint8_t const* data,
+                          uint32_t datalen) {
+  uint32_t const timestamp = CFG_TUSB_CAPTURE_TIMESTAMP_US();
+  uint16_t const caplen = (uint16_t) (data ? tu_min32(datalen, CFG_TUSB_CAPTURE_PAYLOAD_MAX) : 0);
+  uint8_t const flags = (uint8_t) ((is_host ? CAPTURE_FLAG_HOST : 0) | (request ? CAPTURE_FLAG_SETUP : 0));
+  uint8_t const nwords = (uint8_t) (CAPTURE_HEADER_WORDS + (request ? CAPTURE_SETUP_WORDS : 0) + (caplen + 3u) / 4u);
+
+  tu_ring_wr_t w;
+  TU_VERIFY(tu_ring_reserve(&_capture, nwords, &w),);
+
+  tu_ring_put(&_capture, &w, timestamp);
+  tu_ring_put(&_capture, &w, type | ((uint32_t) xfer_type << 8) | ((uint32_t) ep_addr << 16) | ((uint32_t) daddr << 24));
+  tu_ring_put(&_capture, &w, rhport | ((uint32_t) flags << 8) | ((uint32_t) result << 16));
+  tu_ring_put(&_capture, &w, len);
+  tu_ring_put(&_capture, &w, caplen);
+  if (request) {
+    tu_ring_put_bytes(&_capture, &w, request, 8);
+  }
+  tu_ring_put_bytes(&_capture, &w, data, caplen);
+  tu_ring_commit(&_capture, &w);
+}
+
+void tu_capture_setup(bool is_host, uint8_t rhport, uint8_t daddr, tusb_control_request_t const* request,
+                      uint8_t const* data) {
+  uint8_t const ep_addr = (request->bmRequestType_bit.direction == TUSB_DIR_IN) ? TUSB_DIR_IN_MASK : 0;
+  bool const has_data = is_host && (ep_addr == 0);
+  capture_write('S', is_host, rhport, daddr, ep_addr, TUSB_XFER_CONTROL, XFER_RESULT_INVALID, request->wLength,
+                request, has_data ? data : NULL, request->wLength);
+}
+
+void tu_capture_submit(tu_capture_edpt_t* ep, bool is_host, uint8_t rhport, uint8_t daddr, uint8_t ep_addr,
+                       uint8_t* buffer, uint32_t len) {
+  ep->buffer = buffer;
+  bool const has_data = is_host && (tu_edpt_dir(ep_addr) == TUSB_DIR_OUT);
+  capture_write('S', is_host, rhport, daddr, ep_addr, ep->xfer_type, XFER_RESULT_INVALID, len, NULL,
+                has_data ? buffer : NULL, len);
+}
+
+void tu_capture_complete(tu_capture_edpt_t const* ep, bool is_host, uint8_t rhport, uint8_t daddr, uint8_t ep_addr,
+                         uint8_t result, uint32_t len) {
+  bool const has_data = !(is_host && (tu_edpt_dir(ep_addr) == TUSB_DIR_OUT));
+  capture_write('C', is_host, rhport, daddr, ep_addr, ep->xfer_type, result, len, NULL,
+                has_data ? ep->buffer : NULL, len);
+}
+
+//--------------------------------------------------------------------+
+// pcapng stream
+//--------------------------------------------------------------------+
+static uint8_t* put_u32(uint8_t* p, uint32_t value) {
+  memcpy(p, &value, 4);
+  return p + 4;
+}
+
+static uint32_t write_headers(uint8_t* buf) {
+  uint8_t* p = buf;
+
+  // Section Header Block
+  p = put_u32(p, PCAPNG_BLOCK_SHB);
+  p = put_u32(p, PCAPNG_SHB_LEN);
+  p = put_u32(p, PCAPNG_BOM);
+  p = put_u32(p, 1); // version 1.0
+  p = put_u32(p, UINT32_MAX); // section length: unspecified
+  p = put_u32(p, UINT32_MAX);
+  p = put_u32(p, PCAPNG_SHB_LEN);
+
+  // Interface Description Block with if_tsresol = 6 (microsecond)
+  p = put_u32(p, PCAPNG_BLOCK_IDB);
+  p = put_u32(p, PCAPNG_IDB_LEN);
+  p = put_u32(p, LINKTYPE_USB_LINUX_MMAPPED);
+  p = put_u32(p, sizeof(usbmon_header_t) + CFG_TUSB_CAPTURE_PAYLOAD_MAX); // snap length
+  p = put_u32(p, 9 | (1u << 16)); // option code 9, length 1
+  p = put_u32(p, 6);
+  p = put_u32(p, 0); // end of options
+  p = put_u32(p, PCAPNG_IDB_LEN);
+
+  return (uint32_t) (p - buf);
+}
+
+static int32_t usbmon_status(uint8_t type, uint8_t result) {
+  if (type == 'S') {
+    return -115; // -EINPROGRESS
+  }
+  switch (result) {
+    case XFER_RESULT_SUCCESS: return 0;
+    case XFER_RESULT_STALLED: return -32;  // -EPIPE
+    case XFER_RESULT_TIMEOUT: return -110; // -ETIMEDOUT
+    default:                  return -71;  // -EPROTO
+  }
+}
+
+// Convert a capture record to an Enhanced Packet Block
+static uint32_t write_epb(uint8_t* buf, uint32_t const* record) {
+  static uint8_t const usbmon_xfer_type[] = { 2, 0, 3, 1 }; // indexed by tusb_xfer_type_t
+
+  uint32_t const timestamp = record[1];
+  uint8_t const type = (uint8_t) record[2];
+  uint8_t const xfer_type = (uint8_t) (record[2] >> 8);
+  uint8_t const ep_addr = (uint8_t) (record[2] >> 16);
+  uint8_t const daddr = (uint8_t) (record[2] >> 24);
+  uint8_t const rhport = (uint8_t) record[3];
+  uint8_t const flags = (uint8_t) (record[3] >> 8);
+  uint8_t const result = (uint8_t) (record[3] >> 16);
+  uint32_t const caplen = record[5];
+  uint8_t const* payload = (uint8_t const*) &record[1 + CAPTURE_HEADER_WORDS];
+
+  if (timestamp < _capture_rd.ts_last) {
+    _capture_rd.ts_high++;
+  }
+  _capture_rd.ts_last = timestamp;
+  uint64_t const ts = ((uint64_t) _capture_rd.ts_high << 32) | timestamp;
+
+  usbmon_header_t hdr = {
+    // URB id: pair submit and complete of the same endpoint, host and device stack are on different bus
+    .id          = ((uint32_t) (flags & CAPTURE_FLAG_HOST) << 24) | ((uint32_t) rhport << 16) | ((uint32_t) daddr << 8) | ep_addr,
+    .type        = type,
+    .xfer_type   = usbmon_xfer_type[xfer_type & 0x03],
+    .epnum       = ep_addr,
+    .devnum      = daddr,
+    .busnum      = (uint16_t) (((flags & CAPTURE_FLAG_HOST) ? 1 : 0x81) + rhport),
+    .flag_setup  = '-',
+    .flag_data   = (int8_t) (caplen ? 0 : (tu_edpt_dir(ep_addr) ? '<' : '>')),
+    .ts_sec      = (int64_t) (ts / 1000000u),
+    .ts_usec     = (int32_t) (ts % 1000000u),
+    .status      = usbmon_status(type, result),
+    .length      = record[4],
+    .len_cap     = caplen,
+  };
+
+  if (flags & CAPTURE_FLAG_SETUP) {
+    hdr.flag_setup = 0;
+    memcpy(hdr.setup, payload, 8);
+    payload += 4 * CAPTURE_SETUP_WORDS;
+  }
+
+  uint32_t const pkt_len = sizeof(usbmon_header_t) + caplen;
+  uint32_t const pad = (4 - (pkt_len & 3)) & 3;
+  uint32_t const block_len = PCAPNG_EPB_LEN + pkt_len + pad;
+  uint8_t* p = buf;
+
+  p = put_u32(p, PCAPNG_BLOCK_EPB);
+  p = put_u32(p, block_len);
+  p = put_u32(p, 0); // interface id
+  p = put_u32(p, (uint32_t) (ts >> 32));
+  p = put_u32(p, (uint32_t) ts);
+  p = put_u32(p, pkt_len);
+  p = put_u32(p, sizeof(usbmon_header_t) + record[4]); // original length
+  memcpy(p, &hdr, sizeof(hdr));
+  p += sizeof(hdr);
+  memcpy(p, payload, caplen);
+  p += caplen;
+  memset(p, 0, pad);
+  p += pad;
+  p = put_u32(p, block_len);
+
+  return (uint32_t) (p - buf);
+}
+
+uint32_t tusb_capture_read(void* buffer, uint32_t bufsize) {
+  uint8_t* buf8 = (uint8_t*) buffer;
+  uint32_t count = 0;
+
+  if (!_capture_rd.header_sent) {
+    TU_VERIFY(bufsize >= PCAPNG_SHB_LEN + PCAPNG_IDB_LEN, 0);
+    count = write_headers(buf8);
+    _capture_rd.header_sent = true;
+  }
+
+  uint32_t record[1 + CAPTURE_HEADER_WORDS + CAPTURE_SETUP_WORDS + (CFG_TUSB_CAPTURE_PAYLOAD_MAX + 3) / 4];
+  uint32_t nwords;
+  while ((nwords = tu_ring_peek(&_capture)) != 0) {
+    // upper bound of block size
+    if (count + PCAPNG_EPB_LEN + sizeof(usbmon_header_t) + 4 * nwords > bufsize) {
+      break;
+    }
+    (void) tu_ring_read(&_capture, record, 4 * nwords);
+    count += write_epb(buf8 + count, record);
+  }
+
+  return count;
+}
+
+void tusb_capture_restart(void) {
+  _capture_rd.header_sent = false;
+}
+
+uint32_t tusb_capture_dropped(void) {
+  return atomic_load_explicit(&_capture.dropped, memory_order_relaxed);
+}
+
+#endif
@@ -63,12 +63,53 @@ static inline void tu_print_buf(uint8_t const* buf, uint32_t bufsize) {
   tu_printf("\r\n");
 }
 
+#if CFG_TUSB_DEBUG_TRACE
+// Binary trace record in 32-bit words: ring header (see tu_ring_t), timestamp, format string address then arguments.
+// Memory dump record has format address TU_TRACE_FMT_BUF or TU_TRACE_FMT_MEM, followed by (count | indent << 16)
+// and the bytes. Log with more than 7 arguments is not supported.
+// On 64-bit host (e.g simulation) format address and each argument take TU_TRACE_ARG_WORDS = 2 words, low half first,
+// so that pointers are not truncated. Decoder picks the width from ELF class.
+#define TU_TRACE_FMT_BUF   0u
+#define TU_TRACE_FMT_MEM   1u
+
+void tu_trace_log(uint8_t count, uint32_t const* words);
+void tu_trace_mem(void const* buf, uint32_t count, uint8_t indent);
+void tu_trace_buf(void const* buf, uint32_t count);
+
+// Copy complete records to buffer and free them from ring. Must be called from a single context. Return number of bytes
+uint32_t tu_trace_read(void* buffer, uint32_t bufsize);
+
+// Number of records dropped since ring buffer is full
+uint32_t tu_trace_dropped(void);
+
+#if UINTPTR_MAX > UINT32_MAX
+#define TU_TRACE_ARG_WORDS   2
+#define _TU_TRACE_WORD(_x)   (uint32_t) (uintptr_t) (_x), (uint32_t) ((uint64_t) (uintptr_t) (_x) >> 32),
+#else
+#define TU_TRACE_ARG_WORDS   1
+#define _TU_TRACE_WORD(_x)   (uint32_t) (uintptr_t) (_x),
+#endif
+#define tu_trace(...)        tu_trace_log((uint8_t) (TU_ARGS_NUM(__VA_ARGS__) * TU_TRACE_ARG_WORDS), \
+                                          (uint32_t const[]) { TU_ARGS_APPLY(_TU_TRACE_WORD, , __VA_ARGS__) })
+#endif
+
 // Log with Level
 #define TU_LOG(n, ...)        TU_XSTRCAT(TU_LOG, n)(__VA_ARGS__)
 #define TU_LOG_MEM(n, ...)    TU_XSTRCAT3(TU_LOG, n, _MEM)(__VA_ARGS__)
 #define TU_LOG_BUF(n, ...)    TU_XSTRCAT3(TU_LOG, n, _BUF)(__VA_ARGS__)
 #define TU_LOG_INT(n, ...)    TU_XSTRCAT3(TU_LOG, n, _INT)(__VA_ARGS__)
 #define TU_LOG_HEX(n, ...)    TU_XSTRCAT3(TU_LOG, n, _HEX)(__VA_ARGS__)
+#if CFG_TUSB_DEBUG_TRACE
+#define TU_LOG_LOCATION()     tu_trace("%s: %d:\r\n", __PRETTY_FUNCTION__, __LINE__)
+#define TU_LOG_FAILED()       tu_trace("%s: %d: Failed\r\n", __PRETTY_FUNCTION__, __LINE__)
+
+// Log Level 1: Error
+#define TU_LOG1               tu_trace
+#define TU_LOG1_MEM           tu_trace_mem
+#define TU_LOG1_BUF(_x, _n)   tu_trace_buf(_x, _n)
+#define TU_LOG1_INT(_x)       tu_trace(#_x " = %ld\r\n", (unsigned long) (_x) )
+#define TU_LOG1_HEX(_x)       tu_trace(#_x " = 0x%lX\r\n", (unsigned long) (_x) )
+#else
 #define TU_LOG_LOCATION()     tu_printf("%s: %d:\r\n", __PRETTY_FUNCTION__, __LINE__)
 #define TU_LOG_FAILED()       tu_printf("%s: %d: Failed\r\n", __PRETTY_FUNCTION__, __LINE__)
 
@@ -78,6 +119,7 @@ static inline void tu_print_buf(uint8_t const* buf, uint32_t bufsize) {
 #define TU_LOG1_BUF(_x, _n)   tu_print_buf((uint8_t const*)(_x), _n)
 #define TU_LOG1_INT(_x)       tu_printf(#_x " = %ld\r\n", (unsigned long) (_x) )
 #define TU_LOG1_HEX(_x)       tu_printf(#_x " = 0x%lX\r\n", (unsigned long) (_x) )
+#endif
 
 // Log Level 2: Warn
 #if CFG_TUSB_DEBUG >= 2
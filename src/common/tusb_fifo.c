@@ -36,7 +36,7 @@
 #pragma diag_suppress = Pa082
 #endif
 
-#if OSAL_MUTEX_REQUIRED
+#if CFG_FIFO_MUTEX
 
 TU_ATTR_ALWAYS_INLINE static inline void _ff_lock(osal_mutex_t mutex)
 {
@@ -48,10 +48,65 @@ TU_ATTR_ALWAYS_INLINE static inline void _ff_unlock(osal_mutex_t mutex)
   if (mutex) osal_mutex_unlock(mutex);
 }
 
+#if CFG_TUSB_FIFO_SPSC
+// Reader and writer are lock-free, except for overwritable fifo since its writer can overwrite data being read:
+// both sides then take both mutexes (usually only one is configured) to exclude each other.
+// Return whether fifo is locked, since overwritable mode can be changed by tu_fifo_set_overwritable() meanwhile
+TU_ATTR_ALWAYS_INLINE static inline bool _ff_lock_rw(tu_fifo_t* f, osal_mutex_t mutex)
+{
+  (void) mutex;
+  if (!f->overwritable) return false;
+
+  _ff_lock(f->mutex_wr);
+  if (f->mutex_rd != f->mutex_wr) _ff_lock(f->mutex_rd);
+  return true;
+}
+
+TU_ATTR_ALWAYS_INLINE static inline void _ff_unlock_rw(tu_fifo_t* f, osal_mutex_t mutex, bool locked)
+{
+  (void) mutex;
+  if (!locked) return;
+
+  if (f->mutex_rd != f->mutex_wr) _ff_unlock(f->mutex_rd);
+  _ff_unlock(f->mutex_wr);
+}
+#else
+// Lock one side of fifo for a read or write operation
+TU_ATTR_ALWAYS_INLINE static inline bool _ff_lock_rw(tu_fifo_t* f, osal_mutex_t mutex)
+{
+  (void) f;
+  _ff_lock(mutex);
+  return true;
+}
+
+TU_ATTR_ALWAYS_INLINE static inline void _ff_unlock_rw(tu_fifo_t* f, osal_mutex_t mutex, bool locked)
+{
+  (void) f; (void) locked;
+  _ff_unlock(mutex);
+}
+#endif
+
 #else
 
 #define _ff_lock(_mutex)
 #define _ff_unlock(_mutex)
+#define _ff_lock_rw(_f, _mutex)             false
+#define _ff_unlock_rw(_f, _mutex, _locked)  (void) (_locked)
+
+#endif
+
+#if CFG_TUSB_FIFO_SPSC
+#include <stdatomic.h>
+
+// Writer publishes wr_idx after data is copied, reader publishes rd_idx after data is consumed.
+// _ff_acquire() is used after loading index of the other side, _ff_release() before storing our own.
+#define _ff_acquire()   atomic_thread_fence(memory_order_acquire)
+#define _ff_release()   atomic_thread_fence(memory_order_release)
+
+#else
+
+#define _ff_acquire()
+#define _ff_release()
 
 #endif
 
@@ -79,8 +134,9 @@ bool tu_fifo_config(tu_fifo_t *f, void* buffer, uint16_t depth, uint16_t item_si
 
   f->buffer       = (uint8_t*) buffer;
   f->depth        = depth;
-  f->item_size    = (uint16_t) (item_size & 0x7FFF);
+  f->item_size    = (uint16_t) (item_size & 0x3FFF);
   f->overwritable = overwritable;
+  f->pow2         = tu_is_power_of_two(depth);
   f->rd_idx       = 0;
   f->wr_idx       = 0;
 
@@ -94,7 +150,15 @@ bool tu_fifo_config(tu_fifo_t *f, void* buffer, uint16_t depth, uint16_t item_si
 // Pull & Push
 //--------------------------------------------------------------------+
 
+// Copy between application and fifo buffer, can be re-directed to e.g a DMA assisted memcpy
+#define _ff_memcpy   CFG_TUSB_FIFO_MEMCPY
+
 #ifdef TUP_MEM_CONST_ADDR
+TU_ATTR_ALWAYS_INLINE static inline bool _ff_word_aligned(void const* addr)
+{
+  return (((uintptr_t) addr) & 0x03u) == 0;
+}
+
 // Intended to be used to read from hardware USB FIFO in e.g. STM32 where all data is read from a constant address
 // Code adapted from dcd_synopsys.c
 // TODO generalize with configurable 1 byte or 4 byte each read
@@ -104,10 +168,30 @@ static void _ff_push_const_addr(uint8_t * ff_buf, const void * app_buf, uint16_t
 
   // Reading full available 32 bit words from const app address
   uint16_t full_words = len >> 2;
-  while(full_words--)
+
+  if ( _ff_word_aligned(ff_buf) )
   {
-    tu_unaligned_write32(ff_buf, *reg_rx);
-    ff_buf += 4;
+    // fifo buffer is word aligned: plain word store, unrolled to keep the bus busy
+    uint32_t* ff_buf32 = (uint32_t*) (uintptr_t) ff_buf;
+    while ( full_words >= 4 )
+    {
+      ff_buf32[0] = *reg_rx;
+      ff_buf32[1] = *reg_rx;
+      ff_buf32[2] = *reg_rx;
+      ff_buf32[3] = *reg_rx;
+      ff_buf32 += 4;
+      full_words -= 4;
+    }
+    while ( full_words-- ) *ff_buf32++ = *reg_rx;
+    ff_buf = (uint8_t*) ff_buf32;
+  }
+  else
+  {
+    while(full_words--)
+    {
+      tu_unaligned_write32(ff_buf, *reg_rx);
+      ff_buf += 4;
+    }
   }
 
   // Read the remaining 1-3 bytes from const app address
@@ -127,10 +211,30 @@ static void _ff_pull_const_addr(void * app_buf, const uint8_t * ff_buf, uint16_t
 
   // Write full available 32 bit words to const address
   uint16_t full_words = len >> 2;
-  while(full_words--)
+
+  if ( _ff_word_aligned(ff_buf) )
   {
-    *reg_tx = tu_unaligned_read32(ff_buf);
-    ff_buf += 4;
+    // fifo buffer is word aligned: plain word load, unrolled to keep the bus busy
+    uint32_t const* ff_buf32 = (uint32_t const*) (uintptr_t) ff_buf;
+    while ( full_words >= 4 )
+    {
+      *reg_tx = ff_buf32[0];
+      *reg_tx = ff_buf32[1];
+      *reg_tx = ff_buf32[2];
+      *reg_tx = ff_buf32[3];
+      ff_buf32 += 4;
+      full_words -= 4;
+    }
+    while ( full_words-- ) *reg_tx = *ff_buf32++;
+    ff_buf = (uint8_t const*) ff_buf32;
+  }
+  else
+  {
+    while(full_words--)
+    {
+      *reg_tx = tu_unaligned_read32(ff_buf);
+      ff_buf += 4;
+    }
   }
 
   // Write the remaining 1-3 bytes into const address
@@ -169,18 +273,18 @@ static void _ff_push_n(tu_fifo_t* f, void const * app_buf, uint16_t n, uint16_t
       if(n <= lin_count)
       {
         // Linear only
-        memcpy(ff_buf, app_buf, n*f->item_size);
+        _ff_memcpy(ff_buf, app_buf, n*f->item_size);
       }
       else
       {
         // Wrap around
 
         // Write data to linear part of buffer
-        memcpy(ff_buf, app_buf, lin_bytes);
+        _ff_memcpy(ff_buf, app_buf, lin_bytes);
 
         // Write data wrapped around
         // TU_ASSERT(nWrap_bytes <= f->depth, );
-        memcpy(f->buffer, ((uint8_t const*) app_buf) + lin_bytes, wrap_bytes);
+        _ff_memcpy(f->buffer, ((uint8_t const*) app_buf) + lin_bytes, wrap_bytes);
       }
       break;
 #ifdef TUP_MEM_CONST_ADDR
@@ -257,17 +361,17 @@ static void _ff_pull_n(tu_fifo_t* f, void* app_buf, uint16_t n, uint16_t rd_ptr,
       if ( n <= lin_count )
       {
         // Linear only
-        memcpy(app_buf, ff_buf, n*f->item_size);
+        _ff_memcpy(app_buf, ff_buf, n*f->item_size);
       }
       else
       {
         // Wrap around
 
         // Read data from linear part of buffer
-        memcpy(app_buf, ff_buf, lin_bytes);
+        _ff_memcpy(app_buf, ff_buf, lin_bytes);
 
         // Read data wrapped part
-        memcpy((uint8_t*) app_buf + lin_bytes, f->buffer, wrap_bytes);
+        _ff_memcpy((uint8_t*) app_buf + lin_bytes, f->buffer, wrap_bytes);
       }
     break;
 #ifdef TUP_MEM_CONST_ADDR
@@ -325,26 +429,38 @@ static void _ff_pull_n(tu_fifo_t* f, void* app_buf, uint16_t n, uint16_t rd_ptr,
 // Helper
 //--------------------------------------------------------------------+
 
+// Power-of-two depth: index space [0..2*depth) is a power of two as well, all index math is a mask
+TU_ATTR_ALWAYS_INLINE static inline
+uint16_t _ff_idx_mask(tu_fifo_t const* f)
+{
+  return (uint16_t) (2u*f->depth - 1u);
+}
+
 // return only the index difference and as such can be used to determine an overflow i.e overflowable count
 TU_ATTR_ALWAYS_INLINE static inline
-uint16_t _ff_count(uint16_t depth, uint16_t wr_idx, uint16_t rd_idx)
+uint16_t _ff_count(tu_fifo_t const* f, uint16_t wr_idx, uint16_t rd_idx)
 {
+  if (f->pow2)
+  {
+    return (uint16_t) (wr_idx - rd_idx) & _ff_idx_mask(f);
+  }
+
   // In case we have non-power of two depth we need a further modification
   if (wr_idx >= rd_idx)
   {
     return (uint16_t) (wr_idx - rd_idx);
   } else
   {
-    return (uint16_t) (2*depth - (rd_idx - wr_idx));
+    return (uint16_t) (2*f->depth - (rd_idx - wr_idx));
   }
 }
 
 // return remaining slot in fifo
 TU_ATTR_ALWAYS_INLINE static inline
-uint16_t _ff_remaining(uint16_t depth, uint16_t wr_idx, uint16_t rd_idx)
+uint16_t _ff_remaining(tu_fifo_t const* f, uint16_t wr_idx, uint16_t rd_idx)
 {
-  uint16_t const count = _ff_count(depth, wr_idx, rd_idx);
-  return (depth > count) ? (depth - count) : 0;
+  uint16_t const count = _ff_count(f, wr_idx, rd_idx);
+  return (f->depth > count) ? (f->depth - count) : 0;
 }
 
 //--------------------------------------------------------------------+
@@ -353,15 +469,20 @@ uint16_t _ff_remaining(uint16_t depth, uint16_t wr_idx, uint16_t rd_idx)
 
 // Advance an absolute index
 // "absolute" index is only in the range of [0..2*depth)
-static uint16_t advance_index(uint16_t depth, uint16_t idx, uint16_t offset)
+static uint16_t advance_index(tu_fifo_t const* f, uint16_t idx, uint16_t offset)
 {
+  if (f->pow2)
+  {
+    return (uint16_t) (idx + offset) & _ff_idx_mask(f);
+  }
+
   // We limit the index space of p such that a correct wrap around happens
   // Check for a wrap around or if we are in unused index space - This has to be checked first!!
   // We are exploiting the wrap around to the correct index
   uint16_t new_idx = (uint16_t) (idx + offset);
-  if ( (idx > new_idx) || (new_idx >= 2*depth) )
+  if ( (idx > new_idx) || (new_idx >= 2*f->depth) )
   {
-    uint16_t const non_used_index_space = (uint16_t) (UINT16_MAX - (2*depth-1));
+    uint16_t const non_used_index_space = (uint16_t) (UINT16_MAX - (2*f->depth-1));
     new_idx = (uint16_t) (new_idx + non_used_index_space);
   }
 
@@ -370,15 +491,20 @@ static uint16_t advance_index(uint16_t depth, uint16_t idx, uint16_t offset)
 
 #if 0 // not used but
 // Backward an absolute index
-static uint16_t backward_index(uint16_t depth, uint16_t idx, uint16_t offset)
+static uint16_t backward_index(tu_fifo_t const* f, uint16_t idx, uint16_t offset)
 {
+  if (f->pow2)
+  {
+    return (uint16_t) (idx - offset) & _ff_idx_mask(f);
+  }
+
   // We limit the index space of p such that a correct wrap around happens
   // Check for a wrap around or if we are in unused index space - This has to be checked first!!
   // We are exploiting the wrap around to the correct index
   uint16_t new_idx = (uint16_t) (idx - offset);
-  if ( (idx < new_idx) || (new_idx >= 2*depth) )
+  if ( (idx < new_idx) || (new_idx >= 2*f->depth) )
   {
-    uint16_t const non_used_index_space = (uint16_t) (UINT16_MAX - (2*depth-1));
+    uint16_t const non_used_index_space = (uint16_t) (UINT16_MAX - (2*f->depth-1));
     new_idx = (uint16_t) (new_idx - non_used_index_space);
   }
 
@@ -388,9 +514,15 @@ static uint16_t backward_index(uint16_t depth, uint16_t idx, uint16_t offset)
 
 // index to pointer, simply an modulo with minus.
 TU_ATTR_ALWAYS_INLINE static inline
-uint16_t idx2ptr(uint16_t depth, uint16_t idx)
+uint16_t idx2ptr(tu_fifo_t const* f, uint16_t idx)
 {
+  if (f->pow2)
+  {
+    return idx & (uint16_t) (f->depth - 1u);
+  }
+
   // Only run at most 3 times since index is limit in the range of [0..2*depth)
+  uint16_t const depth = f->depth;
   while ( idx >= depth ) idx -= depth;
   return idx;
 }
@@ -419,7 +551,7 @@ uint16_t _ff_correct_read_index(tu_fifo_t* f, uint16_t wr_idx)
 // Must be protected by mutexes since in case of an overflow read pointer gets modified
 static bool _tu_fifo_peek(tu_fifo_t* f, void * p_buffer, uint16_t wr_idx, uint16_t rd_idx)
 {
-  uint16_t cnt = _ff_count(f->depth, wr_idx, rd_idx);
+  uint16_t cnt = _ff_count(f, wr_idx, rd_idx);
 
   // nothing to peek
   if ( cnt == 0 ) return false;
@@ -431,7 +563,7 @@ static bool _tu_fifo_peek(tu_fifo_t* f, void * p_buffer, uint16_t wr_idx, uint16
     cnt = f->depth;
   }
 
-  uint16_t rd_ptr = idx2ptr(f->depth, rd_idx);
+  uint16_t rd_ptr = idx2ptr(f, rd_idx);
 
   // Peek data
   _ff_pull(f, p_buffer, rd_ptr);
@@ -443,7 +575,7 @@ static bool _tu_fifo_peek(tu_fifo_t* f, void * p_buffer, uint16_t wr_idx, uint16
 // Must be protected by mutexes since in case of an overflow read pointer gets modified
 static uint16_t _tu_fifo_peek_n(tu_fifo_t* f, void * p_buffer, uint16_t n, uint16_t wr_idx, uint16_t rd_idx, tu_fifo_copy_mode_t copy_mode)
 {
-  uint16_t cnt = _ff_count(f->depth, wr_idx, rd_idx);
+  uint16_t cnt = _ff_count(f, wr_idx, rd_idx);
 
   // nothing to peek
   if ( cnt == 0 ) return 0;
@@ -458,7 +590,7 @@ static uint16_t _tu_fifo_peek_n(tu_fifo_t* f, void * p_buffer, uint16_t n, uint1
   // Check if we can read something at and after offset - if too less is available we read what remains
   if ( cnt < n ) n = cnt;
 
-  uint16_t rd_ptr = idx2ptr(f->depth, rd_idx);
+  uint16_t rd_ptr = idx2ptr(f, rd_idx);
 
   // Peek data
   _ff_pull_n(f, p_buffer, n, rd_ptr, copy_mode);
@@ -470,20 +602,21 @@ static uint16_t _tu_fifo_write_n(tu_fifo_t* f, const void * data, uint16_t n, tu
 {
   if ( n == 0 ) return 0;
 
-  _ff_lock(f->mutex_wr);
+  bool const locked = _ff_lock_rw(f, f->mutex_wr);
 
   uint16_t wr_idx = f->wr_idx;
   uint16_t rd_idx = f->rd_idx;
+  _ff_acquire();
 
   uint8_t const* buf8 = (uint8_t const*) data;
 
   TU_LOG(TU_FIFO_DBG, "rd = %3u, wr = %3u, count = %3u, remain = %3u, n = %3u:  ",
-                       rd_idx, wr_idx, _ff_count(f->depth, wr_idx, rd_idx), _ff_remaining(f->depth, wr_idx, rd_idx), n);
+                       rd_idx, wr_idx, _ff_count(f, wr_idx, rd_idx), _ff_remaining(f, wr_idx, rd_idx), n);
 
   if ( !f->overwritable )
   {
     // limit up to full
-    uint16_t const remain = _ff_remaining(f->depth, wr_idx, rd_idx);
+    uint16_t const remain = _ff_remaining(f, wr_idx, rd_idx);
     n = tu_min16(n, remain);
   }
   else
@@ -511,13 +644,13 @@ static uint16_t _tu_fifo_write_n(tu_fifo_t* f, const void * data, uint16_t n, tu
     }
     else
     {
-      uint16_t const overflowable_count = _ff_count(f->depth, wr_idx, rd_idx);
+      uint16_t const overflowable_count = _ff_count(f, wr_idx, rd_idx);
       if (overflowable_count + n >= 2*f->depth)
       {
         // Double overflowed
         // Index is bigger than the allowed range [0,2*depth)
         // re-position write index to have a full fifo after pushed
-        wr_idx = advance_index(f->depth, rd_idx, f->depth - n);
+        wr_idx = advance_index(f, rd_idx, f->depth - n);
 
         // TODO we should also shift out n bytes from read index since we avoid changing rd index !!
         // However memmove() is expensive due to actual copying + wrapping consideration.
@@ -535,7 +668,7 @@ static uint16_t _tu_fifo_write_n(tu_fifo_t* f, const void * data, uint16_t n, tu
 
   if (n)
   {
-    uint16_t wr_ptr = idx2ptr(f->depth, wr_idx);
+    uint16_t wr_ptr = idx2ptr(f, wr_idx);
 
     TU_LOG(TU_FIFO_DBG, "actual_n = %u, wr_ptr = %u", n, wr_ptr);
 
@@ -543,28 +676,33 @@ static uint16_t _tu_fifo_write_n(tu_fifo_t* f, const void * data, uint16_t n, tu
     _ff_push_n(f, buf8, n, wr_ptr, copy_mode);
 
     // Advance index
-    f->wr_idx = advance_index(f->depth, wr_idx, n);
+    _ff_release();
+    f->wr_idx = advance_index(f, wr_idx, n);
 
     TU_LOG(TU_FIFO_DBG, "\tnew_wr = %u\r\n", f->wr_idx);
   }
 
-  _ff_unlock(f->mutex_wr);
+  _ff_unlock_rw(f, f->mutex_wr, locked);
 
   return n;
 }
 
 static uint16_t _tu_fifo_read_n(tu_fifo_t* f, void * buffer, uint16_t n, tu_fifo_copy_mode_t copy_mode)
 {
-  _ff_lock(f->mutex_rd);
+  bool const locked = _ff_lock_rw(f, f->mutex_rd);
+
+  uint16_t const wr_idx = f->wr_idx;
+  _ff_acquire();
 
   // Peek the data
   // f->rd_idx might get modified in case of an overflow so we can not use a local variable
-  n = _tu_fifo_peek_n(f, buffer, n, f->wr_idx, f->rd_idx, copy_mode);
+  n = _tu_fifo_peek_n(f, buffer, n, wr_idx, f->rd_idx, copy_mode);
 
   // Advance read pointer
-  f->rd_idx = advance_index(f->depth, f->rd_idx, n);
+  _ff_release();
+  f->rd_idx = advance_index(f, f->rd_idx, n);
 
-  _ff_unlock(f->mutex_rd);
+  _ff_unlock_rw(f, f->mutex_rd, locked);
   return n;
 }
 
@@ -589,7 +727,7 @@ static uint16_t _tu_fifo_read_n(tu_fifo_t* f, void * buffer, uint16_t n, tu_fifo
 /******************************************************************************/
 uint16_t tu_fifo_count(tu_fifo_t* f)
 {
-  return tu_min16(_ff_count(f->depth, f->wr_idx, f->rd_idx), f->depth);
+  return tu_min16(_ff_count(f, f->wr_idx, f->rd_idx), f->depth);
 }
 
 /******************************************************************************/
@@ -625,7 +763,7 @@ bool tu_fifo_empty(tu_fifo_t* f)
 /******************************************************************************/
 bool tu_fifo_full(tu_fifo_t* f)
 {
-  return _ff_count(f->depth, f->wr_idx, f->rd_idx) >= f->depth;
+  return _ff_count(f, f->wr_idx, f->rd_idx) >= f->depth;
 }
 
 /******************************************************************************/
@@ -643,7 +781,7 @@ bool tu_fifo_full(tu_fifo_t* f)
 /******************************************************************************/
 uint16_t tu_fifo_remaining(tu_fifo_t* f)
 {
-  return _ff_remaining(f->depth, f->wr_idx, f->rd_idx);
+  return _ff_remaining(f, f->wr_idx, f->rd_idx);
 }
 
 /******************************************************************************/
@@ -669,15 +807,15 @@ uint16_t tu_fifo_remaining(tu_fifo_t* f)
 /******************************************************************************/
 bool tu_fifo_overflowed(tu_fifo_t* f)
 {
-  return _ff_count(f->depth, f->wr_idx, f->rd_idx) > f->depth;
+  return _ff_count(f, f->wr_idx, f->rd_idx) > f->depth;
 }
 
 // Only use in case tu_fifo_overflow() returned true!
 void tu_fifo_correct_read_pointer(tu_fifo_t* f)
 {
-  _ff_lock(f->mutex_rd);
+  bool const locked = _ff_lock_rw(f, f->mutex_rd);
   _ff_correct_read_index(f, f->wr_idx);
-  _ff_unlock(f->mutex_rd);
+  _ff_unlock_rw(f, f->mutex_rd, locked);
 }
 
 /******************************************************************************/
@@ -698,16 +836,20 @@ void tu_fifo_correct_read_pointer(tu_fifo_t* f)
 /******************************************************************************/
 bool tu_fifo_read(tu_fifo_t* f, void * buffer)
 {
-  _ff_lock(f->mutex_rd);
+  bool const locked = _ff_lock_rw(f, f->mutex_rd);
+
+  uint16_t const wr_idx = f->wr_idx;
+  _ff_acquire();
 
   // Peek the data
   // f->rd_idx might get modified in case of an overflow so we can not use a local variable
-  bool ret = _tu_fifo_peek(f, buffer, f->wr_idx, f->rd_idx);
+  bool ret = _tu_fifo_peek(f, buffer, wr_idx, f->rd_idx);
 
   // Advance pointer
-  f->rd_idx = advance_index(f->depth, f->rd_idx, ret);
+  _ff_release();
+  f->rd_idx = advance_index(f, f->rd_idx, ret);
 
-  _ff_unlock(f->mutex_rd);
+  _ff_unlock_rw(f, f->mutex_rd, locked);
   return ret;
 }
 
@@ -771,9 +913,11 @@ uint16_t tu_fifo_read_n_const_addr_full_words(tu_fifo_t* f, void * buffer, uint1
 /******************************************************************************/
 bool tu_fifo_peek(tu_fifo_t* f, void * p_buffer)
 {
-  _ff_lock(f->mutex_rd);
-  bool ret = _tu_fifo_peek(f, p_buffer, f->wr_idx, f->rd_idx);
-  _ff_unlock(f->mutex_rd);
+  bool const locked = _ff_lock_rw(f, f->mutex_rd);
+  uint16_t const wr_idx = f->wr_idx;
+  _ff_acquire();
+  bool ret = _tu_fifo_peek(f, p_buffer, wr_idx, f->rd_idx);
+  _ff_unlock_rw(f, f->mutex_rd, locked);
   return ret;
 }
 
@@ -794,9 +938,11 @@ bool tu_fifo_peek(tu_fifo_t* f, void * p_buffer)
 /******************************************************************************/
 uint16_t tu_fifo_peek_n(tu_fifo_t* f, void * p_buffer, uint16_t n)
 {
-  _ff_lock(f->mutex_rd);
-  uint16_t ret = _tu_fifo_peek_n(f, p_buffer, n, f->wr_idx, f->rd_idx, TU_FIFO_COPY_INC);
-  _ff_unlock(f->mutex_rd);
+  bool const locked = _ff_lock_rw(f, f->mutex_rd);
+  uint16_t const wr_idx = f->wr_idx;
+  _ff_acquire();
+  uint16_t ret = _tu_fifo_peek_n(f, p_buffer, n, wr_idx, f->rd_idx, TU_FIFO_COPY_INC);
+  _ff_unlock_rw(f, f->mutex_rd, locked);
   return ret;
 }
 
@@ -818,28 +964,31 @@ uint16_t tu_fifo_peek_n(tu_fifo_t* f, void * p_buffer, uint16_t n)
 /******************************************************************************/
 bool tu_fifo_write(tu_fifo_t* f, const void * data)
 {
-  _ff_lock(f->mutex_wr);
+  bool const locked = _ff_lock_rw(f, f->mutex_wr);
 
   bool ret;
   uint16_t const wr_idx = f->wr_idx;
+  uint16_t const rd_idx = f->rd_idx;
+  _ff_acquire();
 
-  if ( tu_fifo_full(f) && !f->overwritable )
+  if ( _ff_count(f, wr_idx, rd_idx) >= f->depth && !f->overwritable )
   {
     ret = false;
   }else
   {
-    uint16_t wr_ptr = idx2ptr(f->depth, wr_idx);
+    uint16_t wr_ptr = idx2ptr(f, wr_idx);
 
     // Write data
     _ff_push(f, data, wr_ptr);
 
     // Advance pointer
-    f->wr_idx = advance_index(f->depth, wr_idx, 1);
+    _ff_release();
+    f->wr_idx = advance_index(f, wr_idx, 1);
 
     ret = true;
   }
 
-  _ff_unlock(f->mutex_wr);
+  _ff_unlock_rw(f, f->mutex_wr, locked);
 
   return ret;
 }
@@ -950,7 +1099,8 @@ bool tu_fifo_set_overwritable(tu_fifo_t *f, bool overwritable) {
 /******************************************************************************/
 void tu_fifo_advance_write_pointer(tu_fifo_t *f, uint16_t n)
 {
-  f->wr_idx = advance_index(f->depth, f->wr_idx, n);
+  _ff_release();
+  f->wr_idx = advance_index(f, f->wr_idx, n);
 }
 
 /******************************************************************************/
@@ -971,7 +1121,8 @@ void tu_fifo_advance_write_pointer(tu_fifo_t *f, uint16_t n)
 /******************************************************************************/
 void tu_fifo_advance_read_pointer(tu_fifo_t *f, uint16_t n)
 {
-  f->rd_idx = advance_index(f->depth, f->rd_idx, n);
+  _ff_release();
+  f->rd_idx = advance_index(f, f->rd_idx, n);
 }
 
 /******************************************************************************/
@@ -994,15 +1145,16 @@ void tu_fifo_get_read_info(tu_fifo_t *f, tu_fifo_buffer_info_t *info)
   // Operate on temporary values in case they change in between
   uint16_t wr_idx = f->wr_idx;
   uint16_t rd_idx = f->rd_idx;
+  _ff_acquire();
 
-  uint16_t cnt = _ff_count(f->depth, wr_idx, rd_idx);
+  uint16_t cnt = _ff_count(f, wr_idx, rd_idx);
 
   // Check overflow and correct if required - may happen in case a DMA wrote too fast
   if (cnt > f->depth)
   {
-    _ff_lock(f->mutex_rd);
+    bool const locked = _ff_lock_rw(f, f->mutex_rd);
     rd_idx = _ff_correct_read_index(f, wr_idx);
-    _ff_unlock(f->mutex_rd);
+    _ff_unlock_rw(f, f->mutex_rd, locked);
 
     cnt = f->depth;
   }
@@ -1018,8 +1170,8 @@ void tu_fifo_get_read_info(tu_fifo_t *f, tu_fifo_buffer_info_t *info)
   }
 
   // Get relative pointers
-  uint16_t wr_ptr = idx2ptr(f->depth, wr_idx);
-  uint16_t rd_ptr = idx2ptr(f->depth, rd_idx);
+  uint16_t wr_ptr = idx2ptr(f, wr_idx);
+  uint16_t rd_ptr = idx2ptr(f, rd_idx);
 
   // Copy pointer to buffer to start reading from
   info->ptr_lin = &f->buffer[rd_ptr];
@@ -1061,7 +1213,8 @@ void tu_fifo_get_write_info(tu_fifo_t *f, tu_fifo_buffer_info_t *info)
 {
   uint16_t wr_idx = f->wr_idx;
   uint16_t rd_idx = f->rd_idx;
-  uint16_t remain = _ff_remaining(f->depth, wr_idx, rd_idx);
+  _ff_acquire();
+  uint16_t remain = _ff_remaining(f, wr_idx, rd_idx);
 
   if (remain == 0)
   {
@@ -1073,8 +1226,8 @@ void tu_fifo_get_write_info(tu_fifo_t *f, tu_fifo_buffer_info_t *info)
   }
 
   // Get relative pointers
-  uint16_t wr_ptr = idx2ptr(f->depth, wr_idx);
-  uint16_t rd_ptr = idx2ptr(f->depth, rd_idx);
+  uint16_t wr_ptr = idx2ptr(f, wr_idx);
+  uint16_t rd_ptr = idx2ptr(f, rd_idx);
 
   // Copy pointer to buffer to start writing to
   info->ptr_lin = &f->buffer[wr_ptr];
@@ -1093,3 +1246,147 @@ void tu_fifo_get_write_info(tu_fifo_t *f, tu_fifo_buffer_info_t *info)
     info->ptr_wrap = f->buffer;              // Always start of buffer
   }
 }
+
+// Describe n items starting at slot ptr as linear and wrapped spans
+static void _ff_get_spans(tu_fifo_t *f, uint16_t ptr, uint16_t n, tu_fifo_buffer_info_t *info)
+{
+  if (n == 0)
+  {
+    info->len_lin  = 0;
+    info->len_wrap = 0;
+    info->ptr_lin  = NULL;
+    info->ptr_wrap = NULL;
+    return;
+  }
+
+  uint16_t const lin_count = f->depth - ptr;
+
+  info->ptr_lin = f->buffer + (ptr * f->item_size);
+
+  if (n <= lin_count)
+  {
+    info->len_lin  = n;
+    info->len_wrap = 0;
+    info->ptr_wrap = NULL;
+  }
+  else
+  {
+    info->len_lin  = lin_count;
+    info->len_wrap = n - lin_count;
+    info->ptr_wrap = f->buffer;
+  }
+}
+
+/******************************************************************************/
+/*!
+   @brief Reserve free space for zero-copy write
+
+   Returns up to two linear spans of free space at the write pointer where data
+   can be written directly e.g by memcpy() or DMA. Data becomes visible to the
+   reader when tu_fifo_write_commit() is called. No data is overwritten even if
+   FIFO is overwritable.
+
+   @param[in]       f
+                    Pointer to FIFO
+   @param[out]      *info
+                    Linear and wrapped spans, lengths are in items
+   @returns Total number of items reserved (len_lin + len_wrap)
+ */
+/******************************************************************************/
+uint16_t tu_fifo_write_reserve(tu_fifo_t *f, tu_fifo_buffer_info_t *info)
+{
+  bool const locked = _ff_lock_rw(f, f->mutex_wr);
+
+  uint16_t const wr_idx = f->wr_idx;
+  uint16_t const rd_idx = f->rd_idx;
+  _ff_acquire();
+  uint16_t const remain = _ff_remaining(f, wr_idx, rd_idx);
+
+  _ff_get_spans(f, idx2ptr(f, wr_idx), remain, info);
+
+  _ff_unlock_rw(f, f->mutex_wr, locked);
+
+  return remain;
+}
+
+/******************************************************************************/
+/*!
+   @brief Commit items written into space obtained by tu_fifo_write_reserve()
+
+   @param[in]       f
+                    Pointer to FIFO
+   @param[in]       n
+                    Number of items written, limited to remaining space
+ */
+/******************************************************************************/
+void tu_fifo_write_commit(tu_fifo_t *f, uint16_t n)
+{
+  bool const locked = _ff_lock_rw(f, f->mutex_wr);
+
+  uint16_t const wr_idx = f->wr_idx;
+  n = tu_min16(n, _ff_remaining(f, wr_idx, f->rd_idx));
+  _ff_release();
+  f->wr_idx = advance_index(f, wr_idx, n);
+
+  _ff_unlock_rw(f, f->mutex_wr, locked);
+}
+
+/******************************************************************************/
+/*!
+   @brief Acquire available data for zero-copy read
+
+   Returns up to two linear spans of data at the read pointer which can be
+   consumed directly from FIFO buffer. Space is given back to the writer when
+   tu_fifo_read_release() is called. Overflow is corrected if required.
+
+   @param[in]       f
+                    Pointer to FIFO
+   @param[out]      *info
+                    Linear and wrapped spans, lengths are in items
+   @returns Total number of items available (len_lin + len_wrap)
+ */
+/******************************************************************************/
+uint16_t tu_fifo_read_acquire(tu_fifo_t *f, tu_fifo_buffer_info_t *info)
+{
+  bool const locked = _ff_lock_rw(f, f->mutex_rd);
+
+  uint16_t const wr_idx = f->wr_idx;
+  uint16_t rd_idx = f->rd_idx;
+  _ff_acquire();
+  uint16_t cnt = _ff_count(f, wr_idx, rd_idx);
+
+  // Check overflow and correct if required
+  if (cnt > f->depth)
+  {
+    rd_idx = _ff_correct_read_index(f, wr_idx);
+    cnt = f->depth;
+  }
+
+  _ff_get_spans(f, idx2ptr(f, rd_idx), cnt, info);
+
+  _ff_unlock_rw(f, f->mutex_rd, locked);
+
+  return cnt;
+}
+
+/******************************************************************************/
+/*!
+   @brief Release items consumed from data obtained by tu_fifo_read_acquire()
+
+   @param[in]       f
+                    Pointer to FIFO
+   @param[in]       n
+                    Number of items consumed, limited to available data
+ */
+/******************************************************************************/
+void tu_fifo_read_release(tu_fifo_t *f, uint16_t n)
+{
+  bool const locked = _ff_lock_rw(f, f->mutex_rd);
+
+  uint16_t const rd_idx = f->rd_idx;
+  n = tu_min16(n, _ff_count(f, f->wr_idx, rd_idx));
+  _ff_release();
+  f->rd_idx = advance_index(f, rd_idx, n);
+
+  _ff_unlock_rw(f, f->mutex_rd, locked);
+}
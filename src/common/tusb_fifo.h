@@ -46,6 +46,8 @@ extern "C" {
 
 // mutex is only needed for RTOS
 // for OS None, we don't get preempted
+// for CFG_TUSB_FIFO_SPSC, reader and writer are synchronized by memory ordering of indices, mutex is only taken
+// for overwritable fifo
 #define CFG_FIFO_MUTEX      OSAL_MUTEX_REQUIRED
 
 /* Write/Read index is always in the range of:
@@ -108,14 +110,15 @@ typedef struct {
   uint16_t depth           ; // max items
 
   struct TU_ATTR_PACKED {
-    uint16_t item_size : 15; // size of each item
+    uint16_t item_size : 14; // size of each item
     bool overwritable  : 1 ; // ovwerwritable when full
+    bool pow2          : 1 ; // depth is power of two, index math is done with masks
   };
 
   volatile uint16_t wr_idx ; // write index
   volatile uint16_t rd_idx ; // read index
 
-#if OSAL_MUTEX_REQUIRED
+#if CFG_FIFO_MUTEX
   osal_mutex_t mutex_wr;
   osal_mutex_t mutex_rd;
 #endif
@@ -129,11 +132,14 @@ typedef struct {
   void * ptr_wrap   ; ///< wrapped part start pointer
 } tu_fifo_buffer_info_t;
 
+#define TU_FIFO_DEPTH_IS_POW2(_depth)  ( ((_depth) != 0) && (((_depth) & ((_depth) - 1)) == 0) )
+
 #define TU_FIFO_INIT(_buffer, _depth, _type, _overwritable){\
   .buffer               = _buffer,                          \
   .depth                = _depth,                           \
   .item_size            = sizeof(_type),                    \
   .overwritable         = _overwritable,                    \
+  .pow2                 = TU_FIFO_DEPTH_IS_POW2(_depth),    \
 }
 
 #define TU_FIFO_DEF(_name, _depth, _type, _overwritable)                      \
@@ -144,7 +150,7 @@ bool tu_fifo_set_overwritable(tu_fifo_t *f, bool overwritable);
 bool tu_fifo_clear(tu_fifo_t *f);
 bool tu_fifo_config(tu_fifo_t *f, void* buffer, uint16_t depth, uint16_t item_size, bool overwritable);
 
-#if OSAL_MUTEX_REQUIRED
+#if CFG_FIFO_MUTEX
 TU_ATTR_ALWAYS_INLINE static inline
 void tu_fifo_config_mutex(tu_fifo_t *f, osal_mutex_t wr_mutex, osal_mutex_t rd_mutex) {
   f->mutex_wr = wr_mutex;
@@ -192,6 +198,16 @@ void tu_fifo_advance_read_pointer (tu_fifo_t *f, uint16_t n);
 void tu_fifo_get_read_info (tu_fifo_t *f, tu_fifo_buffer_info_t *info);
 void tu_fifo_get_write_info(tu_fifo_t *f, tu_fifo_buffer_info_t *info);
 
+// Zero-copy access: reserve free space (or acquire available data) as up to two linear spans in the
+// fifo buffer, fill (or consume) it in place, then commit (or release) the number of items actually used.
+// Lengths are in items, pointers already account for item size. Index update is mutex protected,
+// but spans are only valid as long as this is the only writer (or reader) between the two calls.
+// Overwritable fifo does not overwrite old data when reserving.
+uint16_t tu_fifo_write_reserve(tu_fifo_t *f, tu_fifo_buffer_info_t *info);
+void     tu_fifo_write_commit (tu_fifo_t *f, uint16_t n);
+uint16_t tu_fifo_read_acquire (tu_fifo_t *f, tu_fifo_buffer_info_t *info);
+void     tu_fifo_read_release (tu_fifo_t *f, uint16_t n);
+
 #ifdef __cplusplus
 }
 #endif
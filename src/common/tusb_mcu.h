@@ -537,6 +537,13 @@
   #define TUP_RHPORT_HIGHSPEED    1
   #define TUD_ENDPOINT_ONE_DIRECTION_ONLY
 
+//--------------------------------------------------------------------+
+// Simulation
+//--------------------------------------------------------------------+
+#elif TU_CHECK_MCU(OPT_MCU_SIM, OPT_MCU_USBIP)
+  #define TUP_DCD_ENDPOINT_MAX    16
+  #define TUP_RHPORT_HIGHSPEED    1
+
 #endif
 
 //--------------------------------------------------------------------+
@@ -582,4 +589,10 @@
   #define TUP_MEM_CONST_ADDR
 #endif
 
+// USBIP that can transfer multiple packets on control endpoint with one dcd_edpt_xfer() using DMA.
+// Simulated controller moves any transfer packet by packet
+#if defined(TUP_USBIP_CHIPIDEA_HS) || TU_CHECK_MCU(OPT_MCU_SIM)
+  #define TUP_DCD_EDPT0_MULTI_PACKET
+#endif
+
 #endif
@@ -62,6 +62,138 @@ typedef struct {
 
 }tu_edpt_stream_t;
 
+//--------------------------------------------------------------------+
+// Event Queue Statistics
+//--------------------------------------------------------------------+
+
+// queued is incremented by producer (mostly ISR) and received by the task, each has single writer in the common case.
+// Counters are best effort when events are also queued from task context e.g usbd_defer_func()
+typedef struct {
+  volatile uint32_t queued;
+  volatile uint32_t received;
+  volatile uint32_t coalesced;
+  volatile uint32_t overflow;
+  volatile uint16_t high_water;
+} tu_evq_stats_t;
+
+TU_ATTR_ALWAYS_INLINE static inline void tu_evq_stats_send(tu_evq_stats_t* s, bool success) {
+  if (success) {
+    s->queued++;
+    uint16_t const count = (uint16_t) (s->queued - s->received);
+    if (count > s->high_water) {
+      s->high_water = count;
+    }
+  } else {
+    s->overflow++;
+  }
+}
+
+TU_ATTR_ALWAYS_INLINE static inline void tu_evq_stats_get(tu_evq_stats_t const* s, uint16_t depth, tusb_queue_stats_t* stats) {
+  stats->depth      = depth;
+  stats->count      = (uint16_t) (s->queued - s->received);
+  stats->high_water = s->high_water;
+  stats->queued     = s->queued;
+  stats->coalesced  = s->coalesced;
+  stats->overflow   = s->overflow;
+}
+
+//--------------------------------------------------------------------+
+// Endpoint Statistics
+//--------------------------------------------------------------------+
+#if CFG_TUSB_STATS
+typedef struct {
+  tusb_edpt_stats_t stats;
+  uint32_t submit_tick; // timestamp of last submitted transfer
+  uint32_t submit_len;  // requested length of last submitted transfer
+} tu_edpt_stats_t;
+
+// Record submission of a transfer with len bytes
+void tu_edpt_stats_submit(tu_edpt_stats_t* s, uint32_t len);
+
+// Record transfer completion: latency, bytes, short and failed transfers
+void tu_edpt_stats_complete(tu_edpt_stats_t* s, uint8_t result, uint32_t xferred);
+
+// Account time spent in class driver callback started at start_tick
+void tu_edpt_stats_cb(tu_edpt_stats_t* s, uint32_t start_tick);
+#endif
+
+//--------------------------------------------------------------------+
+// Record Ring (binary trace and capture)
+//--------------------------------------------------------------------+
+#if CFG_TUSB_DEBUG_TRACE || CFG_TUSB_CAPTURE
+#include <stdatomic.h>
+
+// Lock-free multi-producer single-consumer ring of variable length records in 32-bit words. Producers (task and ISRs)
+// reserve space by advancing wr with compare-and-swap, write the payload then commit the header last. Consumer stops
+// at the first uncommitted header and zeroes consumed words so that a reserved slot is never mistaken for a record.
+// Header is [31:24] TU_RING_MAGIC, [23:16] number of words after header, [15:0] sequence number (include dropped).
+#define TU_RING_MAGIC  0xA5u
+
+// Compare-and-swap is only lock-free with exclusive load/store. Without it (ARMv6-M, RISC-V without A extension) the
+// compiler emits libatomic calls, therefore space is reserved with interrupts masked on the current core instead.
+// Multiple core MCU of this kind (e.g RP2040) must then produce records from a single core only.
+#ifndef TU_RING_LOCK_FREE
+  #if (defined(__ARM_ARCH) && !defined(__ARM_FEATURE_LDREX)) || (defined(__riscv) && !defined(__riscv_atomic))
+    #define TU_RING_LOCK_FREE  0
+  #else
+    #define TU_RING_LOCK_FREE  1
+  #endif
+#endif
+
+typedef struct {
+  volatile uint32_t* buf;
+  uint32_t depth; // number of words, must be power of 2
+  atomic_uint_least32_t wr;
+  atomic_uint_least32_t rd;
+  atomic_uint_least32_t seq;
+  atomic_uint_least32_t dropped;
+} tu_ring_t;
+
+typedef struct {
+  uint32_t start;
+  uint32_t idx;
+  uint32_t header;
+} tu_ring_wr_t;
+
+// Reserve a record of nwords (not including header). Return false and count as dropped if ring is full
+bool tu_ring_reserve(tu_ring_t* r, uint8_t nwords, tu_ring_wr_t* w);
+
+// Write next word(s) of a reserved record
+void tu_ring_put(tu_ring_t* r, tu_ring_wr_t* w, uint32_t value);
+void tu_ring_put_bytes(tu_ring_t* r, tu_ring_wr_t* w, void const* data, uint16_t len);
+
+// Publish a reserved record to consumer
+void tu_ring_commit(tu_ring_t* r, tu_ring_wr_t const* w);
+
+// Number of words (including header) of next committed record, 0 if none
+uint32_t tu_ring_peek(tu_ring_t const* r);
+
+// Copy complete records to buffer and free them. Return number of bytes
+uint32_t tu_ring_read(tu_ring_t* r, void* buffer, uint32_t bufsize);
+#endif
+
+//--------------------------------------------------------------------+
+// Traffic Capture
+//--------------------------------------------------------------------+
+#if CFG_TUSB_CAPTURE
+typedef struct {
+  uint8_t* buffer;   // buffer of on-going transfer, NULL if not available (fifo or scatter-gather)
+  uint8_t xfer_type; // tusb_xfer_type_t
+} tu_capture_edpt_t;
+
+// Record a SETUP packet. Host also captures data of OUT control transfer
+void tu_capture_setup(bool is_host, uint8_t rhport, uint8_t daddr, tusb_control_request_t const* request,
+                      uint8_t const* data);
+
+// Record a submitted transfer. Host OUT data is captured at submit, other data is captured on completion
+void tu_capture_submit(tu_capture_edpt_t* ep, bool is_host, uint8_t rhport, uint8_t daddr, uint8_t ep_addr,
+                       uint8_t* buffer, uint32_t len);
+
+// Record a completed transfer
+void tu_capture_complete(tu_capture_edpt_t const* ep, bool is_host, uint8_t rhport, uint8_t daddr, uint8_t ep_addr,
+                         uint8_t result, uint32_t len);
+#endif
+
 //--------------------------------------------------------------------+
 // Endpoint
 //--------------------------------------------------------------------+
@@ -278,6 +278,12 @@ typedef enum {
   XFER_RESULT_INVALID
 } xfer_result_t;
 
+// Scatter-gather list entry, a transfer can be composed of multiple buffers
+typedef struct {
+  uint8_t* buffer;
+  uint32_t len;
+} tusb_xfer_sg_t;
+
 // TODO remove
 enum {
   DESC_OFFSET_LEN  = 0,
@@ -320,6 +326,29 @@ typedef struct {
   tusb_speed_t speed;
 } tusb_rhport_init_t;
 
+// Statistics of usbd/usbh task event queue
+typedef struct {
+  uint16_t depth;      // queue capacity
+  uint16_t count;      // events currently waiting in queue
+  uint16_t high_water; // maximum number of events waiting in queue
+  uint32_t queued;     // total events queued
+  uint32_t coalesced;  // events merged into an already queued one instead of being queued
+  uint32_t overflow;   // events lost since queue was full
+} tusb_queue_stats_t;
+
+// Statistics of an endpoint, collected when CFG_TUSB_STATS is enabled. Ticks are CFG_TUSB_STATS_TIMESTAMP() unit
+typedef struct {
+  uint32_t bytes;       // total bytes transferred
+  uint32_t xfers;       // completed transfers
+  uint32_t short_xfers; // transfers completed with fewer bytes than requested
+  uint32_t failed;      // transfers completed with failed or stalled result
+  uint32_t stalls;      // device: endpoint stalled by stack, host: STALL handshake received
+  uint32_t latency_max; // max submit-to-complete latency
+  uint32_t latency_hist[CFG_TUSB_STATS_HIST_BUCKETS]; // submit-to-complete latency in log2 buckets
+  uint32_t cb_ticks;    // total time spent in class driver xfer_cb()
+  uint32_t cb_max;      // max time spent in a single xfer_cb()
+} tusb_edpt_stats_t;
+
 //--------------------------------------------------------------------+
 // USB Descriptors
 //--------------------------------------------------------------------+
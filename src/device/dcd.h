@@ -160,6 +160,11 @@ void dcd_edpt_close_all       (uint8_t rhport);
 // Submit a transfer, When complete dcd_event_xfer_complete() is invoked to notify the stack
 bool dcd_edpt_xfer            (uint8_t rhport, uint8_t ep_addr, uint8_t * buffer, uint16_t total_bytes);
 
+// Submit a transfer with 32-bit length, When complete dcd_event_xfer_complete() is invoked to notify the stack.
+// DCD splits it into as many hardware transfers as needed (e.g chained in ISR) without notifying the stack in between.
+// This API is optional, usbd splits large transfers into multiple dcd_edpt_xfer() if not implemented.
+bool dcd_edpt_xfer32          (uint8_t rhport, uint8_t ep_addr, uint8_t * buffer, uint32_t total_bytes) TU_ATTR_WEAK;
+
 // Submit an transfer using fifo, When complete dcd_event_xfer_complete() is invoked to notify the stack
 // This API is optional, may be useful for register-based for transferring data.
 bool dcd_edpt_xfer_fifo       (uint8_t rhport, uint8_t ep_addr, tu_fifo_t * ff, uint16_t total_bytes) TU_ATTR_WEAK;
@@ -138,11 +138,48 @@ typedef struct {
 
   tu_edpt_state_t ep_status[CFG_TUD_ENDPPOINT_MAX][2];
 
+  // usbd_edpt_xfer32() split into chunks when DCD does not implement dcd_edpt_xfer32()
+  struct {
+    uint8_t* buffer;    // start of next chunk
+    uint32_t remaining; // bytes not yet queued
+    uint32_t xferred;   // bytes transferred by previous chunks
+  } xfer32[CFG_TUD_ENDPPOINT_MAX][2];
+
 }usbd_device_t;
 
+// Chunk size used to split usbd_edpt_xfer32(), multiple of all power-of-2 packet sizes up to 1024
+#define USBD_XFER32_CHUNK_SIZE  (UINT16_MAX & ~1023u)
+
 tu_static usbd_device_t _usbd_dev;
 static volatile uint8_t _usbd_queued_setup;
 
+// Number of bus reset/unplugged events in queue: transfer events queued before them are stale and skipped
+static volatile uint8_t _usbd_queued_reset;
+
+// Only one SOF event is queued for tud_sof_cb() at a time, later SOFs just update the frame count
+static volatile bool _usbd_sof_queued;
+static volatile uint32_t _usbd_sof_frame;
+
+static tu_evq_stats_t _usbd_qstats;
+
+#if CFG_TUSB_STATS
+static tu_edpt_stats_t _usbd_edpt_stats[CFG_TUD_ENDPPOINT_MAX][2];
+  #define EDPT_STATS_SUBMIT(_epnum, _dir, _len)   tu_edpt_stats_submit(&_usbd_edpt_stats[_epnum][_dir], _len)
+#else
+  #define EDPT_STATS_SUBMIT(_epnum, _dir, _len)
+#endif
+
+#if CFG_TUSB_CAPTURE
+static tu_capture_edpt_t _usbd_capture[CFG_TUD_ENDPPOINT_MAX][2];
+  #define CAPTURE_SUBMIT(_ep_addr, _buffer, _len) \
+    tu_capture_submit(&_usbd_capture[tu_edpt_number(_ep_addr)][tu_edpt_dir(_ep_addr)], false, _usbd_rhport, 0, _ep_addr, _buffer, _len)
+  #define CAPTURE_COMPLETE(_rhport, _ep_addr, _result, _len) \
+    tu_capture_complete(&_usbd_capture[tu_edpt_number(_ep_addr)][tu_edpt_dir(_ep_addr)], false, _rhport, 0, _ep_addr, _result, _len)
+#else
+  #define CAPTURE_SUBMIT(_ep_addr, _buffer, _len)
+  #define CAPTURE_COMPLETE(_rhport, _ep_addr, _result, _len)
+#endif
+
 //--------------------------------------------------------------------+
 // Class Driver
 //--------------------------------------------------------------------+
@@ -163,7 +200,8 @@ tu_static usbd_class_driver_t const _usbd_driver[] = {
         .open             = cdcd_open,
         .control_xfer_cb  = cdcd_control_xfer_cb,
         .xfer_cb          = cdcd_xfer_cb,
-        .sof              = NULL
+        .sof              = NULL,
+        .xfer_isr         = NULL
     },
     #endif
 
@@ -176,7 +214,8 @@ tu_static usbd_class_driver_t const _usbd_driver[] = {
         .open             = mscd_open,
         .control_xfer_cb  = mscd_control_xfer_cb,
         .xfer_cb          = mscd_xfer_cb,
-        .sof              = NULL
+        .sof              = NULL,
+        .xfer_isr         = NULL
     },
     #endif
 
@@ -189,7 +228,8 @@ tu_static usbd_class_driver_t const _usbd_driver[] = {
         .open             = hidd_open,
         .control_xfer_cb  = hidd_control_xfer_cb,
         .xfer_cb          = hidd_xfer_cb,
-        .sof              = NULL
+        .sof              = NULL,
+        .xfer_isr         = CFG_TUD_HID_XFER_ISR ? hidd_xfer_cb : NULL
     },
     #endif
 
@@ -202,7 +242,8 @@ tu_static usbd_class_driver_t const _usbd_driver[] = {
         .open             = audiod_open,
         .control_xfer_cb  = audiod_control_xfer_cb,
         .xfer_cb          = audiod_xfer_cb,
-        .sof              = audiod_sof_isr
+        .sof              = audiod_sof_isr,
+        .xfer_isr         = NULL
     },
     #endif
 
@@ -215,7 +256,8 @@ tu_static usbd_class_driver_t const _usbd_driver[] = {
         .open             = videod_open,
         .control_xfer_cb  = videod_control_xfer_cb,
         .xfer_cb          = videod_xfer_cb,
-        .sof              = NULL
+        .sof              = NULL,
+        .xfer_isr         = NULL
     },
     #endif
 
@@ -228,7 +270,8 @@ tu_static usbd_class_driver_t const _usbd_driver[] = {
         .reset            = midid_reset,
         .control_xfer_cb  = midid_control_xfer_cb,
         .xfer_cb          = midid_xfer_cb,
-        .sof              = NULL
+        .sof              = NULL,
+        .xfer_isr         = NULL
     },
     #endif
 
@@ -241,7 +284,8 @@ tu_static usbd_class_driver_t const _usbd_driver[] = {
         .open             = vendord_open,
         .control_xfer_cb  = tud_vendor_control_xfer_cb,
         .xfer_cb          = vendord_xfer_cb,
-        .sof              = NULL
+        .sof              = NULL,
+        .xfer_isr         = NULL
     },
     #endif
 
@@ -254,7 +298,8 @@ tu_static usbd_class_driver_t const _usbd_driver[] = {
         .open             = usbtmcd_open_cb,
         .control_xfer_cb  = usbtmcd_control_xfer_cb,
         .xfer_cb          = usbtmcd_xfer_cb,
-        .sof              = NULL
+        .sof              = NULL,
+        .xfer_isr         = NULL
     },
     #endif
 
@@ -267,7 +312,8 @@ tu_static usbd_class_driver_t const _usbd_driver[] = {
         .open             = dfu_rtd_open,
         .control_xfer_cb  = dfu_rtd_control_xfer_cb,
         .xfer_cb          = NULL,
-        .sof              = NULL
+        .sof              = NULL,
+        .xfer_isr         = NULL
     },
     #endif
 
@@ -280,7 +326,8 @@ tu_static usbd_class_driver_t const _usbd_driver[] = {
         .open             = dfu_moded_open,
         .control_xfer_cb  = dfu_moded_control_xfer_cb,
         .xfer_cb          = NULL,
-        .sof              = NULL
+        .sof              = NULL,
+        .xfer_isr         = NULL
     },
     #endif
 
@@ -294,6 +341,7 @@ tu_static usbd_class_driver_t const _usbd_driver[] = {
         .control_xfer_cb  = netd_control_xfer_cb,
         .xfer_cb          = netd_xfer_cb,
         .sof                  = NULL,
+        .xfer_isr             = NULL
     },
     #endif
 
@@ -306,7 +354,8 @@ tu_static usbd_class_driver_t const _usbd_driver[] = {
         .open             = btd_open,
         .control_xfer_cb  = btd_control_xfer_cb,
         .xfer_cb          = btd_xfer_cb,
-        .sof              = NULL
+        .sof              = NULL,
+        .xfer_isr         = NULL
     },
     #endif
 };
@@ -354,7 +403,9 @@ tu_static osal_queue_t _usbd_q;
 #endif
 
 TU_ATTR_ALWAYS_INLINE static inline bool queue_event(dcd_event_t const * event, bool in_isr) {
-  TU_ASSERT(osal_queue_send(_usbd_q, event, in_isr));
+  bool const success = osal_queue_send(_usbd_q, event, in_isr);
+  tu_evq_stats_send(&_usbd_qstats, success);
+  TU_ASSERT(success);
   tud_event_hook_cb(event->rhport, event->event_id, in_isr);
   return true;
 }
@@ -473,7 +524,16 @@ bool tud_rhport_init(uint8_t rhport, const tusb_rhport_init_t* rh_init) {
   TU_LOG_INT(CFG_TUD_LOG_LEVEL, sizeof(tu_edpt_stream_t));
 
   tu_varclr(&_usbd_dev);
+  tu_varclr(&_usbd_qstats);
+#if CFG_TUSB_STATS
+  tu_varclr(&_usbd_edpt_stats);
+#endif
+#if CFG_TUSB_CAPTURE
+  tu_varclr(&_usbd_capture);
+#endif
   _usbd_queued_setup = 0;
+  _usbd_queued_reset = 0;
+  _usbd_sof_queued = false;
 
 #if OSAL_MUTEX_REQUIRED
   // Init device mutex
@@ -560,6 +620,60 @@ static void usbd_reset(uint8_t rhport) {
   usbd_control_reset();
 }
 
+// Queue next chunk of an usbd_edpt_xfer32() split into multiple transfers.
+// Return false if transfer is still on going, otherwise true with len updated to xferred bytes of all chunks.
+static bool edpt_xfer32_continue(uint8_t rhport, uint8_t ep_addr, uint8_t* result, uint32_t* len) {
+  uint8_t const epnum = tu_edpt_number(ep_addr);
+  uint8_t const dir = tu_edpt_dir(ep_addr);
+  TU_VERIFY(epnum < CFG_TUD_ENDPPOINT_MAX, true);
+
+  if (_usbd_dev.xfer32[epnum][dir].remaining == 0 && _usbd_dev.xfer32[epnum][dir].xferred == 0) {
+    return true; // not a split transfer
+  }
+
+  _usbd_dev.xfer32[epnum][dir].xferred += *len;
+
+  // continue unless failed, short packet or all queued
+  uint32_t const remaining = _usbd_dev.xfer32[epnum][dir].remaining;
+  if (*result == XFER_RESULT_SUCCESS && *len == USBD_XFER32_CHUNK_SIZE && remaining) {
+    uint16_t const chunk = (uint16_t) tu_min32(remaining, USBD_XFER32_CHUNK_SIZE);
+    uint8_t* buffer = _usbd_dev.xfer32[epnum][dir].buffer;
+
+    _usbd_dev.xfer32[epnum][dir].buffer    = buffer + chunk;
+    _usbd_dev.xfer32[epnum][dir].remaining = remaining - chunk;
+
+    if (dcd_edpt_xfer(rhport, ep_addr, buffer, chunk)) {
+      return false;
+    }
+    *result = XFER_RESULT_FAILED;
+  }
+
+  *len = _usbd_dev.xfer32[epnum][dir].xferred;
+  tu_varclr(&_usbd_dev.xfer32[epnum][dir]);
+
+  return true;
+}
+
+void tud_queue_stats_get(tusb_queue_stats_t* stats) {
+  tu_evq_stats_get(&_usbd_qstats, CFG_TUD_TASK_QUEUE_SZ, stats);
+}
+
+#if CFG_TUSB_STATS
+bool tud_stats_get(uint8_t ep_addr, tusb_edpt_stats_t* stats) {
+  uint8_t const epnum = tu_edpt_number(ep_addr);
+  TU_VERIFY(epnum < CFG_TUD_ENDPPOINT_MAX && stats);
+  *stats = _usbd_edpt_stats[epnum][tu_edpt_dir(ep_addr)].stats;
+  return true;
+}
+
+void tud_stats_clear(void) {
+  for (uint8_t epnum = 0; epnum < CFG_TUD_ENDPPOINT_MAX; epnum++) {
+    tu_varclr(&_usbd_edpt_stats[epnum][0].stats);
+    tu_varclr(&_usbd_edpt_stats[epnum][1].stats);
+  }
+}
+#endif
+
 bool tud_task_event_ready(void) {
   TU_VERIFY(tud_inited()); // Skip if stack is not initialized
   return !osal_queue_empty(_usbd_q);
@@ -589,6 +703,7 @@ void tud_task_ext(uint32_t timeout_ms, bool in_isr) {
   while (1) {
     dcd_event_t event;
     if (!osal_queue_receive(_usbd_q, &event, timeout_ms)) return;
+    _usbd_qstats.received++;
 
 #if CFG_TUSB_DEBUG >= CFG_TUD_LOG_LEVEL
     if (event.event_id == DCD_EVENT_SETUP_RECEIVED) TU_LOG_USBD("\r\n"); // extra line for setup
@@ -598,12 +713,14 @@ void tud_task_ext(uint32_t timeout_ms, bool in_isr) {
     switch (event.event_id) {
       case DCD_EVENT_BUS_RESET:
         TU_LOG_USBD(": %s Speed\r\n", tu_str_speed[event.bus_reset.speed]);
+        if (_usbd_queued_reset) _usbd_queued_reset--;
         usbd_reset(event.rhport);
         _usbd_dev.speed = event.bus_reset.speed;
         break;
 
       case DCD_EVENT_UNPLUGGED:
         TU_LOG_USBD("\r\n");
+        if (_usbd_queued_reset) _usbd_queued_reset--;
         usbd_reset(event.rhport);
         tud_umount_cb();
         break;
@@ -612,6 +729,9 @@ void tud_task_ext(uint32_t timeout_ms, bool in_isr) {
         TU_ASSERT(_usbd_queued_setup > 0,);
         _usbd_queued_setup--;
         TU_LOG_BUF(CFG_TUD_LOG_LEVEL, &event.setup_received, 8);
+        #if CFG_TUSB_CAPTURE
+        tu_capture_setup(false, event.rhport, 0, &event.setup_received, NULL);
+        #endif
         if (_usbd_queued_setup) {
           TU_LOG_USBD("  Skipped since there is other SETUP in queue\r\n");
           break;
@@ -644,9 +764,31 @@ void tud_task_ext(uint32_t timeout_ms, bool in_isr) {
 
         TU_LOG_USBD("on EP %02X with %u bytes\r\n", ep_addr, (unsigned int) event.xfer_complete.len);
 
+        if (_usbd_queued_reset) {
+          TU_LOG_USBD("  Skipped since there is bus reset in queue\r\n");
+          break;
+        }
+
+        if (!edpt_xfer32_continue(event.rhport, ep_addr, &event.xfer_complete.result, &event.xfer_complete.len)) {
+          break; // next chunk is queued, endpoint is still busy
+        }
+
+#if CFG_TUSB_CAPTURE
+        // class driver may fake a completion (e.g msc) to resume its state machine, there is no transfer on the bus
+        if (_usbd_dev.ep_status[epnum][ep_dir].busy) {
+          CAPTURE_COMPLETE(event.rhport, ep_addr, event.xfer_complete.result, event.xfer_complete.len);
+        }
+#endif
+
         _usbd_dev.ep_status[epnum][ep_dir].busy = 0;
         _usbd_dev.ep_status[epnum][ep_dir].claimed = 0;
 
+#if CFG_TUSB_STATS
+        tu_edpt_stats_t* ep_stats = &_usbd_edpt_stats[epnum][ep_dir];
+        tu_edpt_stats_complete(ep_stats, event.xfer_complete.result, event.xfer_complete.len);
+        uint32_t const cb_start = CFG_TUSB_STATS_TIMESTAMP();
+#endif
+
         if (0 == epnum) {
           usbd_control_xfer_cb(event.rhport, ep_addr, (xfer_result_t) event.xfer_complete.result,
                                event.xfer_complete.len);
@@ -657,6 +799,10 @@ void tud_task_ext(uint32_t timeout_ms, bool in_isr) {
           TU_LOG_USBD("  %s xfer callback\r\n", driver->name);
           driver->xfer_cb(event.rhport, ep_addr, (xfer_result_t) event.xfer_complete.result, event.xfer_complete.len);
         }
+
+#if CFG_TUSB_STATS
+        tu_edpt_stats_cb(ep_stats, cb_start);
+#endif
         break;
       }
 
@@ -689,9 +835,10 @@ void tud_task_ext(uint32_t timeout_ms, bool in_isr) {
         break;
 
       case DCD_EVENT_SOF:
-        if (tu_bit_test(_usbd_dev.sof_consumer, SOF_CONSUMER_USER)) {
+        _usbd_sof_queued = false;
+        if (tu_bit_test(_usbd_dev.sof_consumer, SOF_CONSUMER_USER) && !_usbd_queued_reset) {
           TU_LOG_USBD("\r\n");
-          tud_sof_cb(event.sof.frame_count);
+          tud_sof_cb(_usbd_sof_frame);
         }
       break;
 
@@ -1169,6 +1316,40 @@ static bool process_get_descriptor(uint8_t rhport, tusb_control_request_t const
 //--------------------------------------------------------------------+
 // DCD Event Handler
 //--------------------------------------------------------------------+
+// Invoke driver's optional xfer_isr() for non-control endpoint in ISR context.
+// Return true if event is handled, otherwise it is queued for xfer_cb() in usbd task.
+TU_ATTR_FAST_FUNC static bool xfer_complete_isr(dcd_event_t const* event) {
+  uint8_t const ep_addr = event->xfer_complete.ep_addr;
+  uint8_t const epnum = tu_edpt_number(ep_addr);
+  uint8_t const ep_dir = tu_edpt_dir(ep_addr);
+
+  TU_VERIFY(epnum > 0 && epnum < CFG_TUD_ENDPPOINT_MAX);
+
+  // next chunk of usbd_edpt_xfer32() is queued by usbd task
+  TU_VERIFY(_usbd_dev.xfer32[epnum][ep_dir].remaining == 0 && _usbd_dev.xfer32[epnum][ep_dir].xferred == 0);
+
+  usbd_class_driver_t const* driver = get_driver(_usbd_dev.ep2drv[epnum][ep_dir]);
+  TU_VERIFY(driver && driver->xfer_isr);
+
+  _usbd_dev.ep_status[epnum][ep_dir].busy = 0;
+  _usbd_dev.ep_status[epnum][ep_dir].claimed = 0;
+
+#if CFG_TUSB_STATS
+  tu_edpt_stats_t* ep_stats = &_usbd_edpt_stats[epnum][ep_dir];
+  tu_edpt_stats_complete(ep_stats, event->xfer_complete.result, event->xfer_complete.len);
+  uint32_t const cb_start = CFG_TUSB_STATS_TIMESTAMP();
+#endif
+  CAPTURE_COMPLETE(event->rhport, ep_addr, event->xfer_complete.result, event->xfer_complete.len);
+
+  driver->xfer_isr(event->rhport, ep_addr, (xfer_result_t) event->xfer_complete.result, event->xfer_complete.len);
+
+#if CFG_TUSB_STATS
+  tu_edpt_stats_cb(ep_stats, cb_start);
+#endif
+
+  return true;
+}
+
 TU_ATTR_FAST_FUNC void dcd_event_handler(dcd_event_t const* event, bool in_isr) {
   bool send = false;
   switch (event->event_id) {
@@ -1177,7 +1358,14 @@ TU_ATTR_FAST_FUNC void dcd_event_handler(dcd_event_t const* event, bool in_isr)
       _usbd_dev.addressed = 0;
       _usbd_dev.cfg_num = 0;
       _usbd_dev.suspended = 0;
-      send = true;
+      TU_ATTR_FALLTHROUGH;
+
+    case DCD_EVENT_BUS_RESET:
+      // transfer events already in queue are stale once this is processed
+      _usbd_queued_reset++;
+      if (!queue_event(event, in_isr)) {
+        _usbd_queued_reset--;
+      }
       break;
 
     case DCD_EVENT_SUSPEND:
@@ -1218,8 +1406,17 @@ TU_ATTR_FAST_FUNC void dcd_event_handler(dcd_event_t const* event, bool in_isr)
       }
 
       if (tu_bit_test(_usbd_dev.sof_consumer, SOF_CONSUMER_USER)) {
-        dcd_event_t const event_sof = {.rhport = event->rhport, .event_id = DCD_EVENT_SOF, .sof.frame_count = event->sof.frame_count};
-        queue_event(&event_sof, in_isr);
+        // coalesce: usbd task reports the latest frame count, which could skip some frames if it is busy
+        _usbd_sof_frame = event->sof.frame_count;
+        if (_usbd_sof_queued) {
+          _usbd_qstats.coalesced++;
+        } else {
+          _usbd_sof_queued = true;
+          dcd_event_t const event_sof = {.rhport = event->rhport, .event_id = DCD_EVENT_SOF, .sof.frame_count = event->sof.frame_count};
+          if (!queue_event(&event_sof, in_isr)) {
+            _usbd_sof_queued = false;
+          }
+        }
       }
       break;
 
@@ -1228,6 +1425,10 @@ TU_ATTR_FAST_FUNC void dcd_event_handler(dcd_event_t const* event, bool in_isr)
       send = true;
       break;
 
+    case DCD_EVENT_XFER_COMPLETE:
+      send = !xfer_complete_isr(event);
+      break;
+
     default:
       send = true;
       break;
@@ -1299,6 +1500,11 @@ bool usbd_edpt_open(uint8_t rhport, tusb_desc_endpoint_t const* desc_ep) {
   TU_ASSERT(tu_edpt_number(desc_ep->bEndpointAddress) < CFG_TUD_ENDPPOINT_MAX);
   TU_ASSERT(tu_edpt_validate(desc_ep, (tusb_speed_t) _usbd_dev.speed, false));
 
+#if CFG_TUSB_CAPTURE
+  _usbd_capture[tu_edpt_number(desc_ep->bEndpointAddress)][tu_edpt_dir(desc_ep->bEndpointAddress)].xfer_type =
+      desc_ep->bmAttributes.xfer;
+#endif
+
   return dcd_edpt_open(rhport, desc_ep);
 }
 
@@ -1325,6 +1531,51 @@ bool usbd_edpt_release(uint8_t rhport, uint8_t ep_addr) {
   return tu_edpt_release(ep_state, _usbd_mutex);
 }
 
+bool usbd_edpt_xfer32(uint8_t rhport, uint8_t ep_addr, uint8_t* buffer, uint32_t total_bytes) {
+  if (total_bytes <= UINT16_MAX) {
+    return usbd_edpt_xfer(rhport, ep_addr, buffer, (uint16_t) total_bytes);
+  }
+
+  rhport = _usbd_rhport;
+
+  uint8_t const epnum = tu_edpt_number(ep_addr);
+  uint8_t const dir = tu_edpt_dir(ep_addr);
+
+  TU_LOG_USBD("  Queue EP %02X with %lu bytes ...\r\n", ep_addr, (unsigned long) total_bytes);
+
+  // Attempt to transfer on a busy endpoint, sound like an race condition !
+  TU_ASSERT(_usbd_dev.ep_status[epnum][dir].busy == 0);
+
+  // Set busy first since the actual transfer can be complete before dcd_edpt_xfer() could return
+  // and USBD task can preempt and clear the busy
+  _usbd_dev.ep_status[epnum][dir].busy = 1;
+  EDPT_STATS_SUBMIT(epnum, dir, total_bytes);
+  CAPTURE_SUBMIT(ep_addr, buffer, total_bytes);
+
+  bool ret;
+  if (dcd_edpt_xfer32) {
+    ret = dcd_edpt_xfer32(rhport, ep_addr, buffer, total_bytes);
+  } else {
+    // DCD is limited to 16-bit, queue first chunk, the rest is queued by usbd task on completion
+    _usbd_dev.xfer32[epnum][dir].buffer    = buffer + USBD_XFER32_CHUNK_SIZE;
+    _usbd_dev.xfer32[epnum][dir].remaining = total_bytes - USBD_XFER32_CHUNK_SIZE;
+    _usbd_dev.xfer32[epnum][dir].xferred   = 0;
+    ret = dcd_edpt_xfer(rhport, ep_addr, buffer, USBD_XFER32_CHUNK_SIZE);
+  }
+
+  if (ret) {
+    return true;
+  } else {
+    // DCD error, mark endpoint as ready to allow next transfer
+    tu_varclr(&_usbd_dev.xfer32[epnum][dir]);
+    _usbd_dev.ep_status[epnum][dir].busy = 0;
+    _usbd_dev.ep_status[epnum][dir].claimed = 0;
+    TU_LOG_USBD("FAILED\r\n");
+    TU_BREAKPOINT();
+    return false;
+  }
+}
+
 bool usbd_edpt_xfer(uint8_t rhport, uint8_t ep_addr, uint8_t* buffer, uint16_t total_bytes) {
   rhport = _usbd_rhport;
 
@@ -1347,6 +1598,8 @@ bool usbd_edpt_xfer(uint8_t rhport, uint8_t ep_addr, uint8_t* buffer, uint16_t t
   // Set busy first since the actual transfer can be complete before dcd_edpt_xfer()
   // could return and USBD task can preempt and clear the busy
   _usbd_dev.ep_status[epnum][dir].busy = 1;
+  EDPT_STATS_SUBMIT(epnum, dir, total_bytes);
+  CAPTURE_SUBMIT(ep_addr, buffer, total_bytes);
 
   if (dcd_edpt_xfer(rhport, ep_addr, buffer, total_bytes)) {
     return true;
@@ -1378,6 +1631,8 @@ bool usbd_edpt_xfer_fifo(uint8_t rhport, uint8_t ep_addr, tu_fifo_t* ff, uint16_
   // Set busy first since the actual transfer can be complete before dcd_edpt_xfer() could return
   // and usbd task can preempt and clear the busy
   _usbd_dev.ep_status[epnum][dir].busy = 1;
+  EDPT_STATS_SUBMIT(epnum, dir, total_bytes);
+  CAPTURE_SUBMIT(ep_addr, NULL, total_bytes);
 
   if (dcd_edpt_xfer_fifo(rhport, ep_addr, ff, total_bytes)) {
     TU_LOG_USBD("OK\r\n");
@@ -1411,7 +1666,11 @@ void usbd_edpt_stall(uint8_t rhport, uint8_t ep_addr) {
   TU_LOG_USBD("    Stall EP %02X\r\n", ep_addr);
   dcd_edpt_stall(rhport, ep_addr);
   _usbd_dev.ep_status[epnum][dir].stalled = 1;
+#if CFG_TUSB_STATS
+  _usbd_edpt_stats[epnum][dir].stats.stalls++;
+#endif
   _usbd_dev.ep_status[epnum][dir].busy = 1;
+  tu_varclr(&_usbd_dev.xfer32[epnum][dir]); // abort split transfer if any
 }
 
 void usbd_edpt_clear_stall(uint8_t rhport, uint8_t ep_addr) {
@@ -1456,6 +1715,7 @@ void usbd_edpt_close(uint8_t rhport, uint8_t ep_addr) {
   _usbd_dev.ep_status[epnum][dir].stalled = 0;
   _usbd_dev.ep_status[epnum][dir].busy = 0;
   _usbd_dev.ep_status[epnum][dir].claimed = 0;
+  tu_varclr(&_usbd_dev.xfer32[epnum][dir]);
 #endif
 
   return;
@@ -1503,6 +1763,9 @@ bool usbd_edpt_iso_activate(uint8_t rhport, tusb_desc_endpoint_t const* desc_ep)
   _usbd_dev.ep_status[epnum][dir].stalled = 0;
   _usbd_dev.ep_status[epnum][dir].busy = 0;
   _usbd_dev.ep_status[epnum][dir].claimed = 0;
+#if CFG_TUSB_CAPTURE
+  _usbd_capture[epnum][dir].xfer_type = TUSB_XFER_ISOCHRONOUS;
+#endif
   return dcd_edpt_iso_activate(rhport, desc_ep);
 #else
   (void) rhport; (void) desc_ep;
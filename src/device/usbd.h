@@ -72,6 +72,17 @@ void tud_task (void) {
 // Check if there is pending events need processing by tud_task()
 bool tud_task_event_ready(void);
 
+// Get statistics of device task event queue e.g high water mark to tune CFG_TUD_TASK_QUEUE_SZ
+void tud_queue_stats_get(tusb_queue_stats_t* stats);
+
+#if CFG_TUSB_STATS
+// Get statistics of an endpoint. Return false if endpoint is out of range
+bool tud_stats_get(uint8_t ep_addr, tusb_edpt_stats_t* stats);
+
+// Clear statistics of all endpoints
+void tud_stats_clear(void);
+#endif
+
 #ifndef TUSB_DCD_H_
 extern void dcd_int_handler(uint8_t rhport);
 #endif
@@ -59,9 +59,16 @@ typedef struct {
 
 static usbd_control_xfer_t _ctrl_xfer;
 
+// OUT data stage is received packet by packet via internal EP0 buffer unless multi-packet is enabled without dcache:
+// invalidating an application buffer that is not cache line aligned e.g line coding inside CDC interface struct is
+// not safe. IN data stage only needs cache clean, which is fine for any buffer.
+#define CTRL_OUT_EPBUF  (!CFG_TUD_EDPT0_MULTI_PACKET || CFG_TUD_MEM_DCACHE_ENABLE)
+
+#if CTRL_OUT_EPBUF
 CFG_TUD_MEM_SECTION static struct {
   TUD_EPBUF_DEF(buf, CFG_TUD_ENDPOINT0_SIZE);
 } _ctrl_epbuf;
+#endif
 
 //--------------------------------------------------------------------+
 // Application API
@@ -84,6 +91,24 @@ bool tud_control_status(uint8_t rhport, const tusb_control_request_t* request) {
   return status_stage_xact(rhport, request);
 }
 
+#if CFG_TUD_EDPT0_MULTI_PACKET
+// Queue the remaining Data Stage as one transfer directly from/to application buffer, port splits it into packets.
+// OUT is still one packet at a time via EP0 buffer with dcache. This function can also transfer an zero-length packet
+static bool data_stage_xact(uint8_t rhport) {
+  uint16_t xact_len = _ctrl_xfer.data_len - _ctrl_xfer.total_xferred;
+
+  if (_ctrl_xfer.request.bmRequestType_bit.direction == TUSB_DIR_IN) {
+    return usbd_edpt_xfer(rhport, EDPT_CTRL_IN, xact_len ? _ctrl_xfer.buffer : NULL, xact_len);
+  }
+
+  #if CTRL_OUT_EPBUF
+  xact_len = tu_min16(xact_len, CFG_TUD_ENDPOINT0_SIZE);
+  return usbd_edpt_xfer(rhport, EDPT_CTRL_OUT, xact_len ? _ctrl_epbuf.buf : NULL, xact_len);
+  #else
+  return usbd_edpt_xfer(rhport, EDPT_CTRL_OUT, xact_len ? _ctrl_xfer.buffer : NULL, xact_len);
+  #endif
+}
+#else
 // Queue a transaction in Data Stage
 // Each transaction has up to Endpoint0's max packet size.
 // This function can also transfer an zero-length packet
@@ -100,6 +125,7 @@ static bool data_stage_xact(uint8_t rhport) {
 
   return usbd_edpt_xfer(rhport, ep_addr, xact_len ? _ctrl_epbuf.buf : NULL, xact_len);
 }
+#endif
 
 // Transmit data to/from the control endpoint.
 // If the request's wLength is zero, a status packet is sent instead.
@@ -169,17 +195,25 @@ bool usbd_control_xfer_cb(uint8_t rhport, uint8_t ep_addr, xfer_result_t result,
 
   if (_ctrl_xfer.request.bmRequestType_bit.direction == TUSB_DIR_OUT) {
     TU_VERIFY(_ctrl_xfer.buffer);
+    #if CTRL_OUT_EPBUF
     memcpy(_ctrl_xfer.buffer, _ctrl_epbuf.buf, xferred_bytes);
+    #endif
     TU_LOG_MEM(CFG_TUD_LOG_LEVEL, _ctrl_xfer.buffer, xferred_bytes, 2);
   }
 
   _ctrl_xfer.total_xferred += (uint16_t) xferred_bytes;
   _ctrl_xfer.buffer += xferred_bytes;
 
+  #if CFG_TUD_EDPT0_MULTI_PACKET
+  // transfer can span multiple packets, it is short if it does not end with a full packet
+  const bool short_xfer = (xferred_bytes == 0) || (xferred_bytes % CFG_TUD_ENDPOINT0_SIZE);
+  #else
+  const bool short_xfer = (xferred_bytes < CFG_TUD_ENDPOINT0_SIZE);
+  #endif
+
   // Data Stage is complete when all request's length are transferred or
   // a short packet is sent including zero-length packet.
-  if ((_ctrl_xfer.request.wLength == _ctrl_xfer.total_xferred) ||
-      (xferred_bytes < CFG_TUD_ENDPOINT0_SIZE)) {
+  if ((_ctrl_xfer.request.wLength == _ctrl_xfer.total_xferred) || short_xfer) {
     // DATA stage is complete
     bool is_ok = true;
 
@@ -58,6 +58,10 @@ typedef struct {
   bool     (* control_xfer_cb  ) (uint8_t rhport, uint8_t stage, tusb_control_request_t const * request);
   bool     (* xfer_cb          ) (uint8_t rhport, uint8_t ep_addr, xfer_result_t result, uint32_t xferred_bytes);
   void     (* sof              ) (uint8_t rhport, uint32_t frame_count); // optional
+
+  // optional: invoked in ISR context (from dcd_event_handler) instead of xfer_cb for transfer complete of this
+  // driver's endpoints. Must be ISR-safe e.g does not claim endpoint or block, use usbd_defer_func() for the rest.
+  bool     (* xfer_isr         ) (uint8_t rhport, uint8_t ep_addr, xfer_result_t result, uint32_t xferred_bytes);
 } usbd_class_driver_t;
 
 // Invoked when initializing device stack to get additional class drivers.
@@ -83,6 +87,10 @@ void usbd_edpt_close(uint8_t rhport, uint8_t ep_addr);
 // Submit a usb transfer
 bool usbd_edpt_xfer(uint8_t rhport, uint8_t ep_addr, uint8_t * buffer, uint16_t total_bytes);
 
+// Submit a usb transfer with 32-bit length. Executed natively if DCD implements dcd_edpt_xfer32(), otherwise
+// split into multiple dcd_edpt_xfer(). Class driver is notified once when the whole transfer is complete.
+bool usbd_edpt_xfer32(uint8_t rhport, uint8_t ep_addr, uint8_t * buffer, uint32_t total_bytes);
+
 // Submit a usb ISO transfer by use of a FIFO (ring buffer) - all bytes in FIFO get transmitted
 bool usbd_edpt_xfer_fifo(uint8_t rhport, uint8_t ep_addr, tu_fifo_t * ff, uint16_t total_bytes);
 
@@ -172,6 +172,15 @@ bool hcd_edpt_close(uint8_t rhport, uint8_t daddr, uint8_t ep_addr);
 // Submit a transfer, when complete hcd_event_xfer_complete() must be invoked
 bool hcd_edpt_xfer(uint8_t rhport, uint8_t daddr, uint8_t ep_addr, uint8_t * buffer, uint16_t buflen);
 
+#if CFG_TUH_API_EDPT_XFER_SG
+// Submit a scatter-gather transfer, when complete hcd_event_xfer_complete() must be invoked once for the whole list.
+// - sg list must stay valid until transfer is complete
+// - all segments except the last one must be multiple of endpoint max packet size
+// - transfer ends early if a short packet is received
+// Optional: usbh provides a default implementation that submits each chunk with hcd_edpt_xfer()
+bool hcd_edpt_xfer_sg(uint8_t rhport, uint8_t daddr, uint8_t ep_addr, tusb_xfer_sg_t const* sg, uint8_t sg_count);
+#endif
+
 // Abort a queued transfer. Note: it can only abort transfer that has not been started
 // Return true if a queued transfer is aborted, false if there is no transfer to abort
 bool hcd_edpt_abort_xfer(uint8_t rhport, uint8_t dev_addr, uint8_t ep_addr);
@@ -235,6 +244,74 @@ void hcd_event_xfer_complete(uint8_t dev_addr, uint8_t ep_addr, uint32_t xferred
   hcd_event_handler(&event, in_isr);
 }
 
+//--------------------------------------------------------------------+
+// Scatter-gather helper
+//--------------------------------------------------------------------+
+#if CFG_TUH_API_EDPT_XFER_SG
+
+// Walk a scatter-gather list in chunks that fit a single hardware transfer
+typedef struct {
+  tusb_xfer_sg_t const* sg;
+  uint32_t offset;    // offset of next chunk within current segment
+  uint32_t xferred;   // bytes transferred by completed chunks
+  uint16_t chunk_len; // length of the chunk in progress
+  uint8_t  count;
+  uint8_t  index;
+} hcd_xfer_sg_cursor_t;
+
+TU_ATTR_ALWAYS_INLINE static inline
+void hcd_xfer_sg_start(hcd_xfer_sg_cursor_t* cur, tusb_xfer_sg_t const* sg, uint8_t sg_count) {
+  cur->sg        = sg;
+  cur->offset    = 0;
+  cur->xferred   = 0;
+  cur->chunk_len = 0;
+  cur->count     = sg_count;
+  cur->index     = 0;
+}
+
+// Get next chunk of up to max_len bytes, max_len should be multiple of endpoint packet size. Empty segments are skipped,
+// segments that are contiguous in memory are merged into one chunk.
+TU_ATTR_ALWAYS_INLINE static inline
+uint8_t* hcd_xfer_sg_next(hcd_xfer_sg_cursor_t* cur, uint16_t max_len) {
+  while (cur->index + 1 < cur->count && cur->offset >= cur->sg[cur->index].len) {
+    cur->index++;
+    cur->offset = 0;
+  }
+
+  tusb_xfer_sg_t const* seg = &cur->sg[cur->index];
+  uint8_t* buffer = (seg->buffer != NULL) ? (seg->buffer + cur->offset) : NULL;
+
+  cur->chunk_len = (uint16_t) tu_min32(seg->len - cur->offset, max_len);
+  cur->offset   += cur->chunk_len;
+
+  // extend chunk with following segments as long as they start where the previous one ends
+  while (buffer != NULL && cur->chunk_len < max_len && cur->offset == seg->len && cur->index + 1 < cur->count &&
+         seg[1].buffer == seg->buffer + seg->len) {
+    cur->index++;
+    seg++;
+    cur->offset = (uint32_t) tu_min32(seg->len, (uint32_t) (max_len - cur->chunk_len));
+    cur->chunk_len = (uint16_t) (cur->chunk_len + cur->offset);
+  }
+
+  return buffer;
+}
+
+// Account bytes of the completed chunk. Return true if there is more to transfer i.e chunk is complete without
+// short packet and there is remaining data in the list
+TU_ATTR_ALWAYS_INLINE static inline
+bool hcd_xfer_sg_advance(hcd_xfer_sg_cursor_t* cur, uint32_t xferred_bytes) {
+  cur->xferred += xferred_bytes;
+  if (xferred_bytes < cur->chunk_len) return false;
+  if (cur->offset < cur->sg[cur->index].len) return true;
+
+  for (uint8_t i = cur->index + 1; i < cur->count; i++) {
+    if (cur->sg[i].len) return true;
+  }
+  return false;
+}
+
+#endif
+
 #ifdef __cplusplus
  }
 #endif
@@ -48,6 +48,10 @@ enum {
   USBH_CONTROL_RETRY_MAX = 3,
 };
 
+// Largest chunk submitted with hcd_edpt_xfer() by the default scatter-gather implementation: must fit 16-bit length
+// and be multiple of any bulk packet size
+#define USBH_XFER_SG_CHUNK_MAX  (UINT16_MAX & ~1023u)
+
 //--------------------------------------------------------------------+
 // Weak stubs: invoked if no strong implementation is available
 //--------------------------------------------------------------------+
@@ -149,6 +153,19 @@ typedef struct {
   }ep_callback[CFG_TUH_ENDPOINT_MAX][2];
 #endif
 
+#if CFG_TUH_API_EDPT_XFER_SG
+  // state of the default scatter-gather implementation, sg is NULL if not in use
+  hcd_xfer_sg_cursor_t xfer_sg[CFG_TUH_ENDPOINT_MAX][2];
+#endif
+
+#if CFG_TUSB_STATS
+  tu_edpt_stats_t ep_stats[CFG_TUH_ENDPOINT_MAX][2];
+#endif
+
+#if CFG_TUSB_CAPTURE
+  tu_capture_edpt_t capture[CFG_TUH_ENDPOINT_MAX][2];
+#endif
+
 } usbh_device_t;
 
 //--------------------------------------------------------------------+
@@ -283,6 +300,7 @@ static usbh_device_t _usbh_devices[TOTAL_DEVICES];
 // usbh_int_set is used as mutex in OS NONE config
 OSAL_QUEUE_DEF(usbh_int_set, _usbh_qdef, CFG_TUH_TASK_QUEUE_SZ, hcd_event_t);
 static osal_queue_t _usbh_q;
+static tu_evq_stats_t _usbh_qstats;
 
 // Control transfers: since most controllers do not support multiple control transfers
 // on multiple devices concurrently and control transfers are not used much except for
@@ -301,23 +319,102 @@ static struct {
 typedef struct {
   TUH_EPBUF_TYPE_DEF(tusb_control_request_t, request);
   TUH_EPBUF_DEF(ctrl, CFG_TUH_ENUMERATION_BUFSIZE);
+
+  #if CFG_TUH_ENUMERATION_CONCURRENT > 1
+  // each enumeration slot has its own buffer, ctrl is only shared by configured devices
+  struct {
+    TUH_EPBUF_DEF(buf, CFG_TUH_ENUMERATION_BUFSIZE);
+  } enum_slot[CFG_TUH_ENUMERATION_CONCURRENT];
+  #endif
 } usbh_epbuf_t;
 
 CFG_TUH_MEM_SECTION static usbh_epbuf_t _usbh_epbuf;
 
+// Control request waiting for control pipe
+typedef struct {
+  uint8_t daddr;
+  bool pending;
+  tusb_control_request_t request;
+  uint8_t* buffer;
+  tuh_xfer_cb_t complete_cb;
+  uintptr_t user_data;
+} usbh_ctrl_pending_t;
+
+// Enumeration slot: active from attach until all interfaces are configured (or failed). Address 0 phase (port reset,
+// SET_ADDRESS) is serialized by dev0, post-address phase of up to CFG_TUH_ENUMERATION_CONCURRENT devices can run
+// concurrently. With a single slot, dev0 is held until the whole enumeration is complete as there is nothing to gain
+// from releasing it early. Since there is only one control pipe, control request of an enumerating device is kept as
+// pending in its slot when pipe is busy and started when pipe is free (round-robin between slots and hubs).
+typedef struct {
+  uint8_t daddr; // assigned address, 0 while in address 0 phase
+  uint8_t failed_count;
+
+  struct TU_ATTR_PACKED {
+    uint8_t active      : 1;
+    uint8_t addr0       : 1; // address 0 phase i.e before SET_ADDRESS complete
+    uint8_t dev0        : 1; // holding dev0, next attached device is deferred until released
+    uint8_t TU_RESERVED : 5;
+  };
+
+  #if CFG_TUH_ENUMERATION_CACHE
+  tusb_desc_device_t desc_device; // cache key
+  uint32_t serial_hash;
+  uint16_t serial_langid;
+  uint8_t cache_idx; // cache entry used for this enumeration, TUSB_INDEX_INVALID_8 if none
+  #endif
+
+  usbh_ctrl_pending_t ctrl;
+} usbh_enum_t;
+
+static usbh_enum_t _usbh_enum[CFG_TUH_ENUMERATION_CONCURRENT];
+
+#if CFG_TUH_HUB && CFG_TUH_ENUMERATION_CONCURRENT > 1
+// Hub driver requests (port status, reset) run in between requests of enumerating devices: also kept as pending when
+// control pipe is busy, otherwise a hub port change is only handled once all other enumerations are complete
+static usbh_ctrl_pending_t _usbh_hub_ctrl[CFG_TUH_HUB];
+  #define CTRL_PENDING_COUNT  (CFG_TUH_ENUMERATION_CONCURRENT + CFG_TUH_HUB)
+#else
+  #define CTRL_PENDING_COUNT  CFG_TUH_ENUMERATION_CONCURRENT
+#endif
+
+static uint8_t _usbh_ctrl_rr; // pending entry that started control request last
+
+TU_ATTR_ALWAYS_INLINE static inline uint8_t* enum_slot_buf(usbh_enum_t const* slot) {
+  #if CFG_TUH_ENUMERATION_CONCURRENT > 1
+  return _usbh_epbuf.enum_slot[slot - _usbh_enum].buf;
+  #else
+  (void) slot;
+  return _usbh_epbuf.ctrl;
+  #endif
+}
+
 //------------- Helper Function -------------//
+TU_ATTR_ALWAYS_INLINE static inline bool is_hub_addr(uint8_t daddr) {
+  return (CFG_TUH_HUB > 0) && (daddr > CFG_TUH_DEVICE_MAX);
+}
+
 TU_ATTR_ALWAYS_INLINE static inline usbh_device_t* get_device(uint8_t dev_addr) {
   TU_VERIFY(dev_addr > 0 && dev_addr <= TOTAL_DEVICES, NULL);
   return &_usbh_devices[dev_addr-1];
 }
 
 static bool enum_new_device(hcd_event_t* event);
+static usbh_enum_t* enum_slot_find(uint8_t daddr);
+static usbh_enum_t* enum_slot_alloc(void);
+static void enum_dev0_restart(void);
+static void enum_full_complete(usbh_enum_t* slot);
 static void process_removing_device(uint8_t rhport, uint8_t hub_addr, uint8_t hub_port);
 static bool usbh_edpt_control_open(uint8_t dev_addr, uint8_t max_packet_size);
 static bool usbh_control_xfer_cb (uint8_t daddr, uint8_t ep_addr, xfer_result_t result, uint32_t xferred_bytes);
 
+#if CFG_TUH_API_EDPT_XFER_SG
+static bool xfer_sg_continue(usbh_device_t* dev, uint8_t daddr, uint8_t ep_addr, uint8_t* result, uint32_t* len);
+#endif
+
 TU_ATTR_ALWAYS_INLINE static inline bool queue_event(hcd_event_t const * event, bool in_isr) {
-  TU_ASSERT(osal_queue_send(_usbh_q, event, in_isr));
+  bool const success = osal_queue_send(_usbh_q, event, in_isr);
+  tu_evq_stats_send(&_usbh_qstats, success);
+  TU_ASSERT(success);
   tuh_event_hook_cb(event->rhport, event->event_id, in_isr);
   return true;
 }
@@ -409,6 +506,7 @@ bool tuh_rhport_init(uint8_t rhport, const tusb_rhport_init_t* rh_init) {
 
     // Event queue
     _usbh_q = osal_queue_create(&_usbh_qdef);
+    tu_varclr(&_usbh_qstats);
     TU_ASSERT(_usbh_q != NULL);
 
 #if OSAL_MUTEX_REQUIRED
@@ -426,6 +524,10 @@ bool tuh_rhport_init(uint8_t rhport, const tusb_rhport_init_t* rh_init) {
     tu_memclr(&_dev0, sizeof(_dev0));
     tu_memclr(_usbh_devices, sizeof(_usbh_devices));
     tu_memclr(&_ctrl_xfer, sizeof(_ctrl_xfer));
+    tu_memclr(_usbh_enum, sizeof(_usbh_enum));
+    #if CTRL_PENDING_COUNT > CFG_TUH_ENUMERATION_CONCURRENT
+    tu_memclr(_usbh_hub_ctrl, sizeof(_usbh_hub_ctrl));
+    #endif
 
     for (uint8_t i = 0; i < TOTAL_DEVICES; i++) {
       clear_device(&_usbh_devices[i]);
@@ -486,6 +588,30 @@ bool tuh_deinit(uint8_t rhport) {
   return true;
 }
 
+void tuh_queue_stats_get(tusb_queue_stats_t* stats) {
+  tu_evq_stats_get(&_usbh_qstats, CFG_TUH_TASK_QUEUE_SZ, stats);
+}
+
+#if CFG_TUSB_STATS
+bool tuh_stats_get(uint8_t daddr, uint8_t ep_addr, tusb_edpt_stats_t* stats) {
+  usbh_device_t const* dev = get_device(daddr);
+  uint8_t const epnum = tu_edpt_number(ep_addr);
+  TU_VERIFY(dev && epnum < CFG_TUH_ENDPOINT_MAX && stats);
+  *stats = dev->ep_stats[epnum][tu_edpt_dir(ep_addr)].stats;
+  return true;
+}
+
+bool tuh_stats_clear(uint8_t daddr) {
+  usbh_device_t* dev = get_device(daddr);
+  TU_VERIFY(dev);
+  for (uint8_t epnum = 0; epnum < CFG_TUH_ENDPOINT_MAX; epnum++) {
+    tu_varclr(&dev->ep_stats[epnum][0].stats);
+    tu_varclr(&dev->ep_stats[epnum][1].stats);
+  }
+  return true;
+}
+#endif
+
 bool tuh_task_event_ready(void) {
   if (!tuh_inited()) {
     return false; // Skip if stack is not initialized
@@ -521,22 +647,25 @@ void tuh_task_ext(uint32_t timeout_ms, bool in_isr) {
   while (1) {
     hcd_event_t event;
     if (!osal_queue_receive(_usbh_q, &event, timeout_ms)) { return; }
+    _usbh_qstats.received++;
 
     switch (event.event_id) {
       case HCD_EVENT_DEVICE_ATTACH:
-        // due to the shared control buffer, we must complete enumerating one device before enumerating another one.
+        // address 0 phase is serialized by dev0, also only CFG_TUH_ENUMERATION_CONCURRENT devices can be enumerated
+        // at the same time. Otherwise defer attach until dev0/slot is released
         // TODO better to have an separated queue for newly attached devices
-        if (_dev0.enumerating) {
+        if (_dev0.enumerating || enum_slot_find(0) != NULL || enum_slot_alloc() == NULL) {
           // Some device can cause multiple duplicated attach events
           // drop current enumerating and start over for a proper port reset
-          if (event.rhport == _dev0.rhport && event.connection.hub_addr == _dev0.hub_addr &&
+          if (_dev0.enumerating && event.rhport == _dev0.rhport && event.connection.hub_addr == _dev0.hub_addr &&
               event.connection.hub_port == _dev0.hub_port) {
             // abort/cancel current enumeration and start new one
             TU_LOG1("[%u:] USBH Device Attach (duplicated)\r\n", event.rhport);
             tuh_edpt_abort_xfer(0, 0);
+            enum_dev0_restart();
             enum_new_device(&event);
           } else {
-            TU_LOG_USBH("[%u:] USBH Defer Attach until current enumeration complete\r\n", event.rhport);
+            TU_LOG_USBH("[%u:] USBH Defer Attach until enumeration slot is available\r\n", event.rhport);
 
             bool is_empty = osal_queue_empty(_usbh_q);
             queue_event(&event, in_isr);
@@ -548,6 +677,10 @@ void tuh_task_ext(uint32_t timeout_ms, bool in_isr) {
           }
         } else {
           TU_LOG1("[%u:] USBH Device Attach\r\n", event.rhport);
+          usbh_enum_t* slot = enum_slot_alloc();
+          slot->active = 1;
+          slot->addr0 = 1;
+          slot->dev0 = 1;
           _dev0.enumerating = 1;
           enum_new_device(&event);
         }
@@ -581,9 +714,31 @@ void tuh_task_ext(uint32_t timeout_ms, bool in_isr) {
           usbh_device_t* dev = get_device(event.dev_addr);
           TU_VERIFY(dev && dev->connected,);
 
+          #if CFG_TUH_API_EDPT_XFER_SG
+          if (xfer_sg_continue(dev, event.dev_addr, ep_addr, &event.xfer_complete.result, &event.xfer_complete.len)) {
+            break; // next chunk is submitted
+          }
+          #endif
+
           dev->ep_status[epnum][ep_dir].busy = 0;
           dev->ep_status[epnum][ep_dir].claimed = 0;
 
+          #if CFG_TUSB_STATS
+          tu_edpt_stats_t* ep_stats = &dev->ep_stats[epnum][ep_dir];
+          tu_edpt_stats_complete(ep_stats, event.xfer_complete.result, event.xfer_complete.len);
+          if (event.xfer_complete.result == XFER_RESULT_STALLED) {
+            ep_stats->stats.stalls++;
+          }
+          uint32_t const cb_start = CFG_TUSB_STATS_TIMESTAMP();
+          #endif
+
+          #if CFG_TUSB_CAPTURE
+          if (epnum != 0) { // control transfer is captured as a whole
+            tu_capture_complete(&dev->capture[epnum][ep_dir], true, dev->rhport, event.dev_addr, ep_addr,
+                                event.xfer_complete.result, event.xfer_complete.len);
+          }
+          #endif
+
           if (0 == epnum) {
             usbh_control_xfer_cb(event.dev_addr, ep_addr, (xfer_result_t) event.xfer_complete.result, event.xfer_complete.len);
           } else {
@@ -619,6 +774,10 @@ void tuh_task_ext(uint32_t timeout_ms, bool in_isr) {
               }
             }
           }
+
+          #if CFG_TUSB_STATS
+          tu_edpt_stats_cb(ep_stats, cb_start);
+          #endif
         }
         break;
       }
@@ -647,11 +806,118 @@ static void _control_blocking_complete_cb(tuh_xfer_t* xfer) {
   *((xfer_result_t*) xfer->user_data) = xfer->result;
 }
 
+static bool control_xfer_submit(tuh_xfer_t* xfer);
+
+// Pending entry by index: enumeration slots then hubs, NULL if slot is not active
+static usbh_ctrl_pending_t* ctrl_pending_get(uint8_t idx) {
+  #if CTRL_PENDING_COUNT > CFG_TUH_ENUMERATION_CONCURRENT
+  if (idx >= CFG_TUH_ENUMERATION_CONCURRENT) {
+    return &_usbh_hub_ctrl[idx - CFG_TUH_ENUMERATION_CONCURRENT];
+  }
+  #endif
+  return _usbh_enum[idx].active ? &_usbh_enum[idx].ctrl : NULL;
+}
+
+// Pending entry of a device: its enumeration slot or hub entry, NULL if its requests are not kept as pending
+static usbh_ctrl_pending_t* ctrl_pending_find(uint8_t daddr) {
+  usbh_enum_t* slot = enum_slot_find(daddr);
+  if (slot != NULL) {
+    return &slot->ctrl;
+  }
+  #if CTRL_PENDING_COUNT > CFG_TUH_ENUMERATION_CONCURRENT
+  if (is_hub_addr(daddr)) {
+    return &_usbh_hub_ctrl[daddr - 1 - CFG_TUH_DEVICE_MAX];
+  }
+  #endif
+  return NULL;
+}
+
+// Start next pending control request of enumerating devices and hubs (round-robin) if control pipe is idle
+static void control_xfer_next(void) {
+  for (uint8_t i = 1; i <= CTRL_PENDING_COUNT; i++) {
+    if (_ctrl_xfer.stage != CONTROL_STAGE_IDLE) {
+      return;
+    }
+
+    uint8_t const idx = (uint8_t) ((_usbh_ctrl_rr + i) % CTRL_PENDING_COUNT);
+    usbh_ctrl_pending_t* entry = ctrl_pending_get(idx);
+    if (entry == NULL) {
+      continue;
+    }
+
+    (void) osal_mutex_lock(_usbh_mutex, OSAL_TIMEOUT_WAIT_FOREVER);
+    bool const pending = entry->pending;
+    entry->pending = false;
+    (void) osal_mutex_unlock(_usbh_mutex);
+
+    if (pending) {
+      _usbh_ctrl_rr = idx;
+
+      tuh_xfer_t xfer = {
+        .daddr       = entry->daddr,
+        .ep_addr     = 0,
+        .setup       = &entry->request,
+        .buffer      = entry->buffer,
+        .complete_cb = entry->complete_cb,
+        .user_data   = entry->user_data
+      };
+
+      if (!control_xfer_submit(&xfer)) {
+        // device is removed while waiting
+        xfer.result = XFER_RESULT_FAILED;
+        xfer.actual_len = 0;
+        xfer.complete_cb(&xfer);
+      }
+    }
+  }
+}
+
+// Queue control request of an enumerating device or hub if control pipe is busy or others are waiting for it.
+// Return false if request is not queued and should be submitted as usual.
+static bool control_xfer_queue(tuh_xfer_t* xfer) {
+  usbh_ctrl_pending_t* entry = ctrl_pending_find(xfer->daddr);
+  TU_VERIFY(entry != NULL && !entry->pending);
+
+  (void) osal_mutex_lock(_usbh_mutex, OSAL_TIMEOUT_WAIT_FOREVER);
+  bool queued = (_ctrl_xfer.stage != CONTROL_STAGE_IDLE);
+  for (uint8_t i = 0; i < CTRL_PENDING_COUNT && !queued; i++) {
+    usbh_ctrl_pending_t const* other = ctrl_pending_get(i);
+    queued = (other != NULL) && other->pending;
+  }
+
+  if (queued) {
+    entry->pending     = true;
+    entry->daddr       = xfer->daddr;
+    entry->request     = *xfer->setup;
+    entry->buffer      = xfer->buffer;
+    entry->complete_cb = xfer->complete_cb;
+    entry->user_data   = xfer->user_data;
+  }
+  (void) osal_mutex_unlock(_usbh_mutex);
+
+  TU_VERIFY(queued);
+  TU_LOG_USBH("[%u] Control request queued\r\n", xfer->daddr);
+
+  control_xfer_next(); // in case control pipe is idle
+  return true;
+}
+
 // TODO timeout_ms is not supported yet
 bool tuh_control_xfer (tuh_xfer_t* xfer) {
   TU_VERIFY(xfer->ep_addr == 0 && xfer->setup); // EP0 with setup packet
+  TU_VERIFY(tuh_connected(xfer->daddr)); // Check if device is still connected (enumerating for dev0)
+
+  // non-blocking request of enumerating device does not fail when control pipe is busy
+  if (xfer->complete_cb && control_xfer_queue(xfer)) {
+    return true;
+  }
+
+  return control_xfer_submit(xfer);
+}
+
+static bool control_xfer_submit(tuh_xfer_t* xfer) {
   const uint8_t daddr = xfer->daddr;
-  TU_VERIFY(tuh_connected(daddr)); // Check if device is still connected (enumerating for dev0)
+  TU_VERIFY(tuh_connected(daddr));
 
   // pre-check to help reducing mutex lock
   TU_VERIFY(_ctrl_xfer.stage == CONTROL_STAGE_IDLE);
@@ -680,6 +946,10 @@ bool tuh_control_xfer (tuh_xfer_t* xfer) {
                   tu_str_std_request[xfer->setup->bRequest] : "Class Request");
   TU_LOG_BUF_USBH(xfer->setup, 8);
 
+#if CFG_TUSB_CAPTURE
+  tu_capture_setup(true, rhport, daddr, xfer->setup, xfer->buffer);
+#endif
+
   if (xfer->complete_cb) {
     TU_ASSERT(hcd_setup_send(rhport, daddr, (uint8_t const *) &_usbh_epbuf.request));
   }else {
@@ -708,6 +978,8 @@ bool tuh_control_xfer (tuh_xfer_t* xfer) {
     }
     xfer->result     = result;
     xfer->actual_len = _ctrl_xfer.actual_len;
+
+    control_xfer_next(); // deferred by _control_xfer_complete() until actual_len is read
   }
 
   return true;
@@ -737,9 +1009,19 @@ static void _control_xfer_complete(uint8_t daddr, xfer_result_t result) {
 
   _set_control_xfer_stage(CONTROL_STAGE_IDLE);
 
+#if CFG_TUSB_CAPTURE
+  tu_capture_edpt_t const ep0_capture = { .buffer = _ctrl_xfer.buffer, .xfer_type = TUSB_XFER_CONTROL };
+  tu_capture_complete(&ep0_capture, true, usbh_get_rhport(daddr), daddr,
+                      request.bmRequestType_bit.direction ? TUSB_DIR_IN_MASK : 0, result, xfer_temp.actual_len);
+#endif
+
   if (xfer_temp.complete_cb) {
     xfer_temp.complete_cb(&xfer_temp);
   }
+
+  if (xfer_temp.complete_cb != _control_blocking_complete_cb) {
+    control_xfer_next();
+  }
 }
 
 static bool usbh_control_xfer_cb (uint8_t daddr, uint8_t ep_addr, xfer_result_t result, uint32_t xferred_bytes) {
@@ -862,6 +1144,10 @@ bool tuh_edpt_abort_xfer(uint8_t daddr, uint8_t ep_addr) {
     TU_VERIFY(dev->ep_status[epnum][dir].busy); // non-control skip if not busy
     hcd_edpt_abort_xfer(dev->rhport, daddr, ep_addr);
 
+    #if CFG_TUH_API_EDPT_XFER_SG
+    dev->xfer_sg[epnum][dir].sg = NULL;
+    #endif
+
     // mark as ready and release endpoint if transfer is aborted
     dev->ep_status[epnum][dir].busy = false;
     tu_edpt_release(&dev->ep_status[epnum][dir], _usbh_mutex);
@@ -879,8 +1165,10 @@ uint8_t usbh_get_rhport(uint8_t dev_addr) {
   return dev ? dev->rhport : _dev0.rhport;
 }
 
-uint8_t *usbh_get_enum_buf(void) {
-  return _usbh_epbuf.ctrl;
+// Enumeration buffer of the slot if device is enumerating, shared control buffer otherwise
+uint8_t *usbh_get_enum_buf(uint8_t dev_addr) {
+  usbh_enum_t const* slot = enum_slot_find(dev_addr);
+  return slot ? enum_slot_buf(slot) : _usbh_epbuf.ctrl;
 }
 
 void usbh_int_set(bool enabled) {
@@ -957,6 +1245,14 @@ bool usbh_edpt_xfer_with_callback(uint8_t dev_addr, uint8_t ep_addr, uint8_t* bu
   // could return and USBH task can preempt and clear the busy
   ep_state->busy = 1;
 
+#if CFG_TUSB_STATS
+  tu_edpt_stats_submit(&dev->ep_stats[epnum][dir], total_bytes);
+#endif
+
+#if CFG_TUSB_CAPTURE
+  tu_capture_submit(&dev->capture[epnum][dir], true, dev->rhport, dev_addr, ep_addr, buffer, total_bytes);
+#endif
+
 #if CFG_TUH_API_EDPT_XFER
   dev->ep_callback[epnum][dir].complete_cb = complete_cb;
   dev->ep_callback[epnum][dir].user_data   = user_data;
@@ -975,6 +1271,93 @@ bool usbh_edpt_xfer_with_callback(uint8_t dev_addr, uint8_t ep_addr, uint8_t* bu
   }
 }
 
+#if CFG_TUH_API_EDPT_XFER_SG
+// Default implementation if HCD does not support scatter-gather: submit chunk by chunk with hcd_edpt_xfer(), next
+// chunk is submitted by usbh task when previous one completes.
+TU_ATTR_WEAK bool hcd_edpt_xfer_sg(uint8_t rhport, uint8_t daddr, uint8_t ep_addr, tusb_xfer_sg_t const* sg,
+                                   uint8_t sg_count) {
+  usbh_device_t* dev = get_device(daddr);
+  TU_VERIFY(dev);
+
+  hcd_xfer_sg_cursor_t* cur = &dev->xfer_sg[tu_edpt_number(ep_addr)][tu_edpt_dir(ep_addr)];
+  hcd_xfer_sg_start(cur, sg, sg_count);
+  uint8_t* buffer = hcd_xfer_sg_next(cur, USBH_XFER_SG_CHUNK_MAX);
+
+  if (!hcd_edpt_xfer(rhport, daddr, ep_addr, buffer, cur->chunk_len)) {
+    cur->sg = NULL;
+    return false;
+  }
+  return true;
+}
+
+// Called on transfer complete event. Return true if default scatter-gather is in progress and next chunk is submitted,
+// otherwise result and len are updated with status of the whole list.
+static bool xfer_sg_continue(usbh_device_t* dev, uint8_t daddr, uint8_t ep_addr, uint8_t* result, uint32_t* len) {
+  hcd_xfer_sg_cursor_t* cur = &dev->xfer_sg[tu_edpt_number(ep_addr)][tu_edpt_dir(ep_addr)];
+  if (cur->sg == NULL) return false;
+
+  bool const more = hcd_xfer_sg_advance(cur, *len);
+  if (*result == XFER_RESULT_SUCCESS && more) {
+    uint8_t* buffer = hcd_xfer_sg_next(cur, USBH_XFER_SG_CHUNK_MAX);
+    if (hcd_edpt_xfer(dev->rhport, daddr, ep_addr, buffer, cur->chunk_len)) {
+      return true;
+    }
+    *result = XFER_RESULT_FAILED;
+  }
+
+  *len = cur->xferred;
+  cur->sg = NULL;
+  return false;
+}
+
+// Submit a scatter-gather transfer
+bool usbh_edpt_xfer_sg(uint8_t dev_addr, uint8_t ep_addr, tusb_xfer_sg_t const* sg, uint8_t sg_count) {
+  usbh_device_t* dev = get_device(dev_addr);
+  TU_VERIFY(dev && sg && sg_count);
+
+  uint8_t const epnum = tu_edpt_number(ep_addr);
+  uint8_t const dir = tu_edpt_dir(ep_addr);
+  tu_edpt_state_t* ep_state = &dev->ep_status[epnum][dir];
+
+  TU_LOG_USBH("  Queue EP %02X with %u segments ... \r\n", ep_addr, sg_count);
+  TU_ASSERT(epnum != 0 && ep_state->busy == 0);
+
+  // Set busy first since the actual transfer can be complete before hcd_edpt_xfer_sg() returns
+  ep_state->busy = 1;
+
+#if CFG_TUSB_STATS || CFG_TUSB_CAPTURE
+  uint32_t total_bytes = 0;
+  for (uint8_t i = 0; i < sg_count; i++) {
+    total_bytes += sg[i].len;
+  }
+#endif
+
+#if CFG_TUSB_STATS
+  tu_edpt_stats_submit(&dev->ep_stats[epnum][dir], total_bytes);
+#endif
+
+#if CFG_TUSB_CAPTURE
+  tu_capture_submit(&dev->capture[epnum][dir], true, dev->rhport, dev_addr, ep_addr, NULL, total_bytes);
+#endif
+
+#if CFG_TUH_API_EDPT_XFER
+  dev->ep_callback[epnum][dir].complete_cb = NULL;
+  dev->ep_callback[epnum][dir].user_data   = 0;
+#endif
+
+  if (hcd_edpt_xfer_sg(dev->rhport, dev_addr, ep_addr, sg, sg_count)) {
+    TU_LOG_USBH("OK\r\n");
+    return true;
+  } else {
+    // HCD error, mark endpoint as ready to allow next transfer
+    ep_state->busy = 0;
+    ep_state->claimed = 0;
+    TU_LOG1("Failed\r\n");
+    return false;
+  }
+}
+#endif
+
 static bool usbh_edpt_control_open(uint8_t dev_addr, uint8_t max_packet_size) {
   TU_LOG_USBH("[%u:%u] Open EP0 with Size = %u\r\n", usbh_get_rhport(dev_addr), dev_addr, max_packet_size);
   tusb_desc_endpoint_t ep0_desc = {
@@ -991,6 +1374,13 @@ static bool usbh_edpt_control_open(uint8_t dev_addr, uint8_t max_packet_size) {
 
 bool tuh_edpt_open(uint8_t dev_addr, tusb_desc_endpoint_t const* desc_ep) {
   TU_ASSERT(tu_edpt_validate(desc_ep, tuh_speed_get(dev_addr), true));
+#if CFG_TUSB_CAPTURE
+  usbh_device_t* dev = get_device(dev_addr);
+  uint8_t const epnum = tu_edpt_number(desc_ep->bEndpointAddress);
+  if (dev && epnum < CFG_TUH_ENDPOINT_MAX) {
+    dev->capture[epnum][tu_edpt_dir(desc_ep->bEndpointAddress)].xfer_type = desc_ep->bmAttributes.xfer;
+  }
+#endif
   return hcd_edpt_open(usbh_get_rhport(dev_addr), dev_addr, desc_ep);
 }
 
@@ -1259,10 +1649,6 @@ uint8_t tuh_descriptor_get_serial_string_sync(uint8_t daddr, uint16_t language_i
 // Detaching
 //--------------------------------------------------------------------+
 
-TU_ATTR_ALWAYS_INLINE static inline bool is_hub_addr(uint8_t daddr) {
-  return (CFG_TUH_HUB > 0) && (daddr > CFG_TUH_DEVICE_MAX);
-}
-
 //static void mark_removing_device_isr(uint8_t rhport, uint8_t hub_addr, uint8_t hub_port) {
 //  for (uint8_t dev_id = 0; dev_id < TOTAL_DEVICES; dev_id++) {
 //    usbh_device_t *dev = &_usbh_devices[dev_id];
@@ -1302,6 +1688,9 @@ static void process_removing_device(uint8_t rhport, uint8_t hub_addr, uint8_t hu
         if (is_hub_addr(daddr)) {
           TU_LOG_USBH("  is a HUB device %u\r\n", daddr);
           removing_hubs |= TU_BIT(dev_id - CFG_TUH_DEVICE_MAX);
+          #if CTRL_PENDING_COUNT > CFG_TUH_ENUMERATION_CONCURRENT
+          _usbh_hub_ctrl[dev_id - CFG_TUH_DEVICE_MAX].pending = false; // drop its pending request
+          #endif
         } else {
           // Invoke callback before closing driver (maybe call it later ?)
           if (tuh_umount_cb) {
@@ -1322,6 +1711,12 @@ static void process_removing_device(uint8_t rhport, uint8_t hub_addr, uint8_t hu
 
         // abort on-going control xfer on this device if any
         if (_ctrl_xfer.daddr == daddr) _set_control_xfer_stage(CONTROL_STAGE_IDLE);
+
+        // stop enumerating
+        usbh_enum_t* slot = enum_slot_find(daddr);
+        if (slot != NULL && !slot->addr0) {
+          enum_full_complete(slot);
+        }
       }
     }
 
@@ -1345,14 +1740,25 @@ static void process_removing_device(uint8_t rhport, uint8_t hub_addr, uint8_t hu
     break;
     #endif
   } while(1);
+
+  // stop address 0 phase if dev0 or its hub is unplugged
+  usbh_enum_t* slot = enum_slot_find(0);
+  if (slot != NULL && (!_dev0.enumerating || (_dev0.hub_addr != 0 && !tuh_connected(_dev0.hub_addr)))) {
+    if (_ctrl_xfer.daddr == 0) _set_control_xfer_stage(CONTROL_STAGE_IDLE);
+    enum_full_complete(slot);
+  }
+
+  // control pipe may be freed by aborted transfer
+  control_xfer_next();
 }
 
 //--------------------------------------------------------------------+
 // Enumeration Process
 // is a lengthy process with a series of control transfer to configure
 // newly attached device.
-// NOTE: due to the shared control buffer, we must complete enumerating
-// one device before enumerating another one.
+// NOTE: address 0 phase (port reset, SET_ADDRESS) is serialized through
+// dev0, after that each device is enumerated in its own slot with its own
+// buffer, up to CFG_TUH_ENUMERATION_CONCURRENT devices at the same time.
 //--------------------------------------------------------------------+
 
 enum {
@@ -1379,17 +1785,172 @@ enum {
   ENUM_GET_9BYTE_CONFIG_DESC,
   ENUM_GET_FULL_CONFIG_DESC,
   ENUM_SET_CONFIG,
-  ENUM_CONFIG_DRIVER
+  ENUM_CONFIG_DRIVER,
+  ENUM_CACHE_CHECK_SERIAL, // serial number of cached device
 };
 
 static bool enum_request_set_addr(tusb_desc_device_t const* desc_device);
 static bool enum_parse_configuration_desc (uint8_t dev_addr, tusb_desc_configuration_t const* desc_cfg);
-static void enum_full_complete(void);
+
+// Find enumeration slot of a device. Request to dev0 or its parent hub belongs to slot in address 0 phase.
+static usbh_enum_t* enum_slot_find(uint8_t daddr) {
+  usbh_enum_t* slot_addr0 = NULL;
+  for (uint8_t i = 0; i < CFG_TUH_ENUMERATION_CONCURRENT; i++) {
+    usbh_enum_t* slot = &_usbh_enum[i];
+    if (slot->active) {
+      if (slot->addr0) {
+        slot_addr0 = slot;
+      } else if (daddr != 0 && slot->daddr == daddr) {
+        return slot;
+      }
+    }
+  }
+
+  if (slot_addr0 != NULL && (daddr == 0 || daddr == _dev0.hub_addr)) {
+    return slot_addr0;
+  }
+  return NULL;
+}
+
+static usbh_enum_t* enum_slot_alloc(void) {
+  for (uint8_t i = 0; i < CFG_TUH_ENUMERATION_CONCURRENT; i++) {
+    if (!_usbh_enum[i].active) {
+      tu_memclr(&_usbh_enum[i], sizeof(usbh_enum_t));
+      return &_usbh_enum[i];
+    }
+  }
+  return NULL;
+}
+
+// Address 0 phase (or whole enumeration with single slot) is complete or failed: release dev0 so that next attached
+// device can be enumerated
+static void enum_dev0_release(usbh_enum_t* slot) {
+  if (!slot->dev0) {
+    return;
+  }
+  slot->addr0 = 0;
+  slot->dev0 = 0;
+  _dev0.enumerating = 0;
+
+#if CFG_TUH_HUB
+  if (_dev0.hub_addr) {
+    hub_edpt_status_xfer(_dev0.hub_addr); // get next hub status
+  }
+#endif
+}
+
+// Device holding dev0 is attached again: it is reset, enumerate it from address 0 phase
+static void enum_dev0_restart(void) {
+  for (uint8_t i = 0; i < CFG_TUH_ENUMERATION_CONCURRENT; i++) {
+    usbh_enum_t* slot = &_usbh_enum[i];
+    if (slot->active && slot->dev0 && !slot->addr0) {
+      tuh_edpt_abort_xfer(slot->daddr, 0);
+      slot->daddr = 0;
+      slot->addr0 = 1;
+      slot->ctrl.pending = false;
+    }
+  }
+}
+
+//--------------------------------------------------------------------+
+// Enumeration Cache
+//--------------------------------------------------------------------+
+#if CFG_TUH_ENUMERATION_CACHE
+
+typedef struct {
+  tusb_desc_device_t desc_device;
+  uint32_t serial_hash; // 0 if device has no serial number
+  uint16_t serial_langid;
+  uint8_t config_idx;
+  uint8_t valid;
+  uint8_t desc_config[CFG_TUH_ENUMERATION_BUFSIZE];
+} usbh_enum_cache_t;
+
+static usbh_enum_cache_t _usbh_enum_cache[CFG_TUH_ENUMERATION_CACHE];
+static uint8_t _usbh_enum_cache_next; // entry to replace when cache is full
+
+void tuh_enum_cache_clear(void) {
+  tu_memclr(_usbh_enum_cache, sizeof(_usbh_enum_cache));
+}
+
+// FNV-1a hash of serial number string descriptor
+static uint32_t enum_cache_serial_hash(uint8_t const* desc_str, uint32_t len) {
+  len = tu_min32(len, desc_str[0]);
+  uint32_t hash = 2166136261u;
+  for (uint32_t i = 0; i < len; i++) {
+    hash = (hash ^ desc_str[i]) * 16777619u;
+  }
+  return hash;
+}
+
+// Find cached entry of device, serial hash is only compared if check_serial is true
+static uint8_t enum_cache_find(tusb_desc_device_t const* desc_device, bool check_serial, uint32_t serial_hash) {
+  for (uint8_t i = 0; i < CFG_TUH_ENUMERATION_CACHE; i++) {
+    usbh_enum_cache_t const* entry = &_usbh_enum_cache[i];
+    if (entry->valid && 0 == memcmp(&entry->desc_device, desc_device, sizeof(tusb_desc_device_t)) &&
+        (!check_serial || entry->serial_hash == serial_hash)) {
+      return i;
+    }
+  }
+  return TUSB_INDEX_INVALID_8;
+}
+
+// Remember configuration descriptor of a successfully parsed (fully enumerated) device
+static void enum_cache_save(usbh_enum_t const* slot, uint8_t config_idx, uint8_t const* desc_config) {
+  uint8_t idx = enum_cache_find(&slot->desc_device, true, slot->serial_hash);
+  for (uint8_t i = 0; i < CFG_TUH_ENUMERATION_CACHE && idx == TUSB_INDEX_INVALID_8; i++) {
+    if (!_usbh_enum_cache[i].valid) {
+      idx = i;
+    }
+  }
+  if (idx == TUSB_INDEX_INVALID_8) {
+    idx = _usbh_enum_cache_next;
+    _usbh_enum_cache_next = (uint8_t) ((_usbh_enum_cache_next + 1) % CFG_TUH_ENUMERATION_CACHE);
+  }
+
+  usbh_enum_cache_t* entry = &_usbh_enum_cache[idx];
+  uint16_t const total_len = tu_le16toh(tu_unaligned_read16(desc_config + offsetof(tusb_desc_configuration_t, wTotalLength)));
+  entry->desc_device = slot->desc_device;
+  entry->serial_hash = slot->serial_hash;
+  entry->serial_langid = slot->serial_langid;
+  entry->config_idx = config_idx;
+  entry->valid = 1;
+  memcpy(entry->desc_config, desc_config, total_len);
+}
+
+// Cached configuration does not work for this device anymore
+static void enum_cache_invalidate(usbh_enum_t const* slot) {
+  if (slot->cache_idx < CFG_TUH_ENUMERATION_CACHE) {
+    usbh_enum_cache_t* entry = &_usbh_enum_cache[slot->cache_idx];
+    // entry may be re-used by other device in the meantime
+    if (0 == memcmp(&entry->desc_device, &slot->desc_device, sizeof(tusb_desc_device_t))) {
+      entry->valid = 0;
+    }
+  }
+}
+
+static void process_enumeration(tuh_xfer_t* xfer);
+
+// Skip string and configuration descriptors: restore cached configuration and set it
+static bool enum_cache_set_config(usbh_enum_t* slot, uint8_t daddr, uint8_t cache_idx) {
+  usbh_enum_cache_t const* entry = &_usbh_enum_cache[cache_idx];
+  uint16_t const total_len = tu_le16toh(tu_unaligned_read16(entry->desc_config + offsetof(tusb_desc_configuration_t, wTotalLength)));
+  memcpy(enum_slot_buf(slot), entry->desc_config, total_len);
+  slot->cache_idx = cache_idx;
+
+  TU_LOG_USBH("Configuration[%u] is cached\r\n", entry->config_idx);
+  return tuh_configuration_set(daddr, entry->config_idx + 1, process_enumeration, ENUM_CONFIG_DRIVER);
+}
+
+#endif
 
 // process device enumeration
 static void process_enumeration(tuh_xfer_t* xfer) {
+  usbh_enum_t* slot = enum_slot_find(xfer->daddr);
+  TU_VERIFY(slot != NULL,); // device is unplugged or enumeration is aborted
+  uint8_t* enum_buf = enum_slot_buf(slot);
+
   // Retry a few times while enumerating since device can be unstable when starting up
-  static uint8_t failed_count = 0;
   if (XFER_RESULT_FAILED == xfer->result) {
     enum {
       ATTEMPT_COUNT_MAX = 3,
@@ -1397,21 +1958,25 @@ static void process_enumeration(tuh_xfer_t* xfer) {
     };
 
     // retry if not reaching max attempt
-    failed_count++;
-    bool retry = _dev0.enumerating && (failed_count < ATTEMPT_COUNT_MAX);
+    slot->failed_count++;
+    bool retry = (slot->addr0 ? _dev0.enumerating : tuh_connected(slot->daddr)) &&
+                 (slot->failed_count < ATTEMPT_COUNT_MAX);
     if (retry) {
       tusb_time_delay_ms_api(ATTEMPT_DELAY_MS); // delay a bit
-      TU_LOG1("Enumeration attempt %u/%u\r\n", failed_count+1, ATTEMPT_COUNT_MAX);
+      TU_LOG1("Enumeration attempt %u/%u\r\n", slot->failed_count+1, ATTEMPT_COUNT_MAX);
       retry = tuh_control_xfer(xfer);
     }
 
     if (!retry) {
-      enum_full_complete(); // complete as failed
+      #if CFG_TUH_ENUMERATION_CACHE
+      enum_cache_invalidate(slot);
+      #endif
+      enum_full_complete(slot); // complete as failed
     }
 
     return;
   }
-  failed_count = 0;
+  slot->failed_count = 0;
 
   uint8_t const daddr = xfer->daddr;
   uintptr_t const state = xfer->user_data;
@@ -1424,11 +1989,11 @@ static void process_enumeration(tuh_xfer_t* xfer) {
 
     case ENUM_HUB_CLEAR_RESET_1: {
       hub_port_status_response_t port_status;
-      memcpy(&port_status, _usbh_epbuf.ctrl, sizeof(hub_port_status_response_t));
+      memcpy(&port_status, enum_buf, sizeof(hub_port_status_response_t));
 
       if (!port_status.status.connection) {
         // device unplugged while delaying, nothing else to do
-        enum_full_complete();
+        enum_full_complete(slot);
         return;
       }
 
@@ -1445,13 +2010,13 @@ static void process_enumeration(tuh_xfer_t* xfer) {
 
     case ENUM_HUB_GET_STATUS_2:
       tusb_time_delay_ms_api(ENUM_RESET_DELAY_MS);
-      TU_ASSERT(hub_port_get_status(_dev0.hub_addr, _dev0.hub_port, _usbh_epbuf.ctrl,
+      TU_ASSERT(hub_port_get_status(_dev0.hub_addr, _dev0.hub_port, enum_buf,
                                     process_enumeration, ENUM_HUB_CLEAR_RESET_2),);
       break;
 
     case ENUM_HUB_CLEAR_RESET_2: {
       hub_port_status_response_t port_status;
-      memcpy(&port_status, _usbh_epbuf.ctrl, sizeof(hub_port_status_response_t));
+      memcpy(&port_status, enum_buf, sizeof(hub_port_status_response_t));
 
       // Acknowledge Port Reset Change if Reset Successful
       if (port_status.change.reset) {
@@ -1469,7 +2034,7 @@ static void process_enumeration(tuh_xfer_t* xfer) {
 
       // Get first 8 bytes of device descriptor for Control Endpoint size
       TU_LOG_USBH("Get 8 byte of Device Descriptor\r\n");
-      TU_ASSERT(tuh_descriptor_get_device(addr0, _usbh_epbuf.ctrl, 8,
+      TU_ASSERT(tuh_descriptor_get_device(addr0, enum_buf, 8,
                                           process_enumeration, ENUM_SET_ADDR),);
       break;
     }
@@ -1499,7 +2064,7 @@ static void process_enumeration(tuh_xfer_t* xfer) {
 #endif
 
     case ENUM_SET_ADDR:
-      enum_request_set_addr((tusb_desc_device_t*) _usbh_epbuf.ctrl);
+      enum_request_set_addr((tusb_desc_device_t*) enum_buf);
       break;
 
     case ENUM_GET_DEVICE_DESC: {
@@ -1511,15 +2076,20 @@ static void process_enumeration(tuh_xfer_t* xfer) {
       TU_ASSERT(new_dev,);
       new_dev->addressed = 1;
 
-      // Close device 0
+      // Close device 0 and continue enumerating with new address
       hcd_device_close(_dev0.rhport, 0);
+      slot->daddr = new_addr;
+      slot->addr0 = 0;
+      #if CFG_TUH_ENUMERATION_CONCURRENT > 1
+      enum_dev0_release(slot); // next attached device can start its address 0 phase
+      #endif
 
       // open control pipe for new address
       TU_ASSERT(usbh_edpt_control_open(new_addr, new_dev->ep0_size),);
 
       // Get full device descriptor
       TU_LOG_USBH("Get Device Descriptor\r\n");
-      TU_ASSERT(tuh_descriptor_get_device(new_addr, _usbh_epbuf.ctrl, sizeof(tusb_desc_device_t),
+      TU_ASSERT(tuh_descriptor_get_device(new_addr, enum_buf, sizeof(tusb_desc_device_t),
                                           process_enumeration, ENUM_GET_STRING_LANGUAGE_ID),);
       break;
     }
@@ -1527,7 +2097,7 @@ static void process_enumeration(tuh_xfer_t* xfer) {
     case ENUM_GET_STRING_LANGUAGE_ID: {
       // save the received device descriptor
       TU_ASSERT(dev,);
-      tusb_desc_device_t const* desc_device = (tusb_desc_device_t const*) _usbh_epbuf.ctrl;
+      tusb_desc_device_t const* desc_device = (tusb_desc_device_t const*) enum_buf;
       dev->vid = desc_device->idVendor;
       dev->pid = desc_device->idProduct;
       dev->i_manufacturer = desc_device->iManufacturer;
@@ -1537,19 +2107,37 @@ static void process_enumeration(tuh_xfer_t* xfer) {
 
       tuh_enum_descriptor_device_cb(daddr, desc_device); // callback
 
-      tuh_descriptor_get_string_langid(daddr, _usbh_epbuf.ctrl, CFG_TUH_ENUMERATION_BUFSIZE,
+      #if CFG_TUH_ENUMERATION_CACHE
+      slot->desc_device = *desc_device;
+      slot->serial_hash = 0;
+      slot->cache_idx = TUSB_INDEX_INVALID_8;
+
+      // Device is cached: only need its serial number (if any) to tell it apart from others with same descriptor
+      uint8_t const cache_idx = enum_cache_find(desc_device, false, 0);
+      if (cache_idx != TUSB_INDEX_INVALID_8) {
+        if (dev->i_serial != 0) {
+          TU_ASSERT(tuh_descriptor_get_string(daddr, dev->i_serial, _usbh_enum_cache[cache_idx].serial_langid, enum_buf,
+                                              CFG_TUH_ENUMERATION_BUFSIZE, process_enumeration, ENUM_CACHE_CHECK_SERIAL),);
+        } else {
+          TU_ASSERT(enum_cache_set_config(slot, daddr, cache_idx),);
+        }
+        break;
+      }
+      #endif
+
+      tuh_descriptor_get_string_langid(daddr, enum_buf, CFG_TUH_ENUMERATION_BUFSIZE,
                                        process_enumeration, ENUM_GET_STRING_MANUFACTURER);
       break;
     }
 
     case ENUM_GET_STRING_MANUFACTURER: {
       TU_ASSERT(dev,);
-      const tusb_desc_string_t* desc_langid = (tusb_desc_string_t const*) _usbh_epbuf.ctrl;
+      const tusb_desc_string_t* desc_langid = (tusb_desc_string_t const*) enum_buf;
       if (desc_langid->bLength >= 4) {
         langid = tu_le16toh(desc_langid->utf16le[0]);
       }
       if (dev->i_manufacturer != 0) {
-        tuh_descriptor_get_string(daddr, dev->i_manufacturer, langid, _usbh_epbuf.ctrl, CFG_TUH_ENUMERATION_BUFSIZE,
+        tuh_descriptor_get_string(daddr, dev->i_manufacturer, langid, enum_buf, CFG_TUH_ENUMERATION_BUFSIZE,
                                   process_enumeration, ENUM_GET_STRING_PRODUCT);
         break;
       } else {
@@ -1563,7 +2151,7 @@ static void process_enumeration(tuh_xfer_t* xfer) {
         langid = tu_le16toh(xfer->setup->wIndex); // if not fall through, get langid from previous setup packet
       }
       if (dev->i_product != 0) {
-        tuh_descriptor_get_string(daddr, dev->i_product, 0x0409, _usbh_epbuf.ctrl, CFG_TUH_ENUMERATION_BUFSIZE,
+        tuh_descriptor_get_string(daddr, dev->i_product, 0x0409, enum_buf, CFG_TUH_ENUMERATION_BUFSIZE,
                             process_enumeration, ENUM_GET_STRING_SERIAL);
         break;
       } else {
@@ -1577,7 +2165,7 @@ static void process_enumeration(tuh_xfer_t* xfer) {
         langid = tu_le16toh(xfer->setup->wIndex); // if not fall through, get langid from previous setup packet
       }
       if (dev->i_serial != 0) {
-        tuh_descriptor_get_string(daddr, dev->i_serial, langid, _usbh_epbuf.ctrl, CFG_TUH_ENUMERATION_BUFSIZE,
+        tuh_descriptor_get_string(daddr, dev->i_serial, langid, enum_buf, CFG_TUH_ENUMERATION_BUFSIZE,
                             process_enumeration, ENUM_GET_9BYTE_CONFIG_DESC);
         break;
       } else {
@@ -1586,16 +2174,24 @@ static void process_enumeration(tuh_xfer_t* xfer) {
     }
 
     case ENUM_GET_9BYTE_CONFIG_DESC: {
+      #if CFG_TUH_ENUMERATION_CACHE
+      if (state == ENUM_GET_9BYTE_CONFIG_DESC && xfer->result == XFER_RESULT_SUCCESS) {
+        // serial number string is received
+        slot->serial_hash = enum_cache_serial_hash(enum_buf, xfer->actual_len);
+        slot->serial_langid = tu_le16toh(xfer->setup->wIndex);
+      }
+      #endif
+
       // Get 9-byte for total length
       uint8_t const config_idx = 0;
       TU_LOG_USBH("Get Configuration[%u] Descriptor (9 bytes)\r\n", config_idx);
-      TU_ASSERT(tuh_descriptor_get_configuration(daddr, config_idx, _usbh_epbuf.ctrl, 9,
+      TU_ASSERT(tuh_descriptor_get_configuration(daddr, config_idx, enum_buf, 9,
                                                  process_enumeration, ENUM_GET_FULL_CONFIG_DESC),);
       break;
     }
 
     case ENUM_GET_FULL_CONFIG_DESC: {
-      uint8_t const* desc_config = _usbh_epbuf.ctrl;
+      uint8_t const* desc_config = enum_buf;
 
       // Use offsetof to avoid pointer to the odd/misaligned address
       uint16_t const total_len = tu_le16toh(tu_unaligned_read16(desc_config + offsetof(tusb_desc_configuration_t, wTotalLength)));
@@ -1606,20 +2202,20 @@ static void process_enumeration(tuh_xfer_t* xfer) {
       // Get full configuration descriptor
       uint8_t const config_idx = (uint8_t) tu_le16toh(xfer->setup->wIndex);
       TU_LOG_USBH("Get Configuration[%u] Descriptor\r\n", config_idx);
-      TU_ASSERT(tuh_descriptor_get_configuration(daddr, config_idx, _usbh_epbuf.ctrl, total_len,
+      TU_ASSERT(tuh_descriptor_get_configuration(daddr, config_idx, enum_buf, total_len,
                                                  process_enumeration, ENUM_SET_CONFIG),);
       break;
     }
 
     case ENUM_SET_CONFIG: {
       uint8_t config_idx = (uint8_t) tu_le16toh(xfer->setup->wIndex);
-      if (tuh_enum_descriptor_configuration_cb(daddr, config_idx, (const tusb_desc_configuration_t*) _usbh_epbuf.ctrl)) {
+      if (tuh_enum_descriptor_configuration_cb(daddr, config_idx, (const tusb_desc_configuration_t*) enum_buf)) {
         TU_ASSERT(tuh_configuration_set(daddr, config_idx+1, process_enumeration, ENUM_CONFIG_DRIVER),);
       } else {
         config_idx++;
         TU_ASSERT(config_idx < dev->bNumConfigurations,);
         TU_LOG_USBH("Get Configuration[%u] Descriptor (9 bytes)\r\n", config_idx);
-        TU_ASSERT(tuh_descriptor_get_configuration(daddr, config_idx, _usbh_epbuf.ctrl, 9,
+        TU_ASSERT(tuh_descriptor_get_configuration(daddr, config_idx, enum_buf, 9,
                                                    process_enumeration, ENUM_GET_FULL_CONFIG_DESC),);
       }
       break;
@@ -1633,7 +2229,17 @@ static void process_enumeration(tuh_xfer_t* xfer) {
 
       // Parse configuration & set up drivers
       // driver_open() must not make any usb transfer
-      TU_ASSERT(enum_parse_configuration_desc(daddr, (tusb_desc_configuration_t*) _usbh_epbuf.ctrl),);
+      bool const parsed = enum_parse_configuration_desc(daddr, (tusb_desc_configuration_t*) enum_buf);
+
+      #if CFG_TUH_ENUMERATION_CACHE
+      if (!parsed) {
+        enum_cache_invalidate(slot);
+      } else if (slot->cache_idx == TUSB_INDEX_INVALID_8) {
+        enum_cache_save(slot, (uint8_t) (tu_le16toh(xfer->setup->wValue) - 1), enum_buf);
+      }
+      #endif
+
+      TU_ASSERT(parsed,);
 
       // Start the Set Configuration process for interfaces (itf = TUSB_INDEX_INVALID_8)
       // Since driver can perform control transfer within its set_config, this is done asynchronously.
@@ -1643,13 +2249,41 @@ static void process_enumeration(tuh_xfer_t* xfer) {
       break;
     }
 
+    #if CFG_TUH_ENUMERATION_CACHE
+    case ENUM_CACHE_CHECK_SERIAL: {
+      uint8_t cache_idx = TUSB_INDEX_INVALID_8;
+      if (xfer->result == XFER_RESULT_SUCCESS) {
+        slot->serial_hash = enum_cache_serial_hash(enum_buf, xfer->actual_len);
+        slot->serial_langid = tu_le16toh(xfer->setup->wIndex);
+        cache_idx = enum_cache_find(&slot->desc_device, true, slot->serial_hash);
+      }
+
+      if (cache_idx != TUSB_INDEX_INVALID_8) {
+        TU_ASSERT(enum_cache_set_config(slot, daddr, cache_idx),);
+      } else {
+        // e.g another unit of the same product: fall back to full enumeration
+        slot->serial_hash = 0;
+        tuh_descriptor_get_string_langid(daddr, enum_buf, CFG_TUH_ENUMERATION_BUFSIZE,
+                                         process_enumeration, ENUM_GET_STRING_MANUFACTURER);
+      }
+      break;
+    }
+    #endif
+
     default:
-      enum_full_complete(); // stop enumeration if unknown state
+      enum_full_complete(slot); // stop enumeration if unknown state
       break;
   }
 }
 
 static bool enum_new_device(hcd_event_t* event) {
+  usbh_enum_t* slot = enum_slot_find(0);
+  TU_ASSERT(slot != NULL);
+  slot->failed_count = 0;
+  #if CFG_TUH_ENUMERATION_CACHE
+  slot->cache_idx = TUSB_INDEX_INVALID_8;
+  #endif
+
   _dev0.rhport = event->rhport;
   _dev0.hub_addr = event->connection.hub_addr;
   _dev0.hub_port = event->connection.hub_port;
@@ -1669,7 +2303,7 @@ static bool enum_new_device(hcd_event_t* event) {
 
     // device unplugged while delaying
     if (!hcd_port_connect_status(_dev0.rhport)) {
-      enum_full_complete();
+      enum_full_complete(slot);
       return true;
     }
 
@@ -1691,7 +2325,7 @@ static bool enum_new_device(hcd_event_t* event) {
     tusb_time_delay_ms_api(ENUM_DEBOUNCING_DELAY_MS);
 
     // ENUM_HUB_GET_STATUS
-    TU_ASSERT(hub_port_get_status(_dev0.hub_addr, _dev0.hub_port, _usbh_epbuf.ctrl,
+    TU_ASSERT(hub_port_get_status(_dev0.hub_addr, _dev0.hub_port, enum_slot_buf(slot),
                                   process_enumeration, ENUM_HUB_CLEAR_RESET_1));
   }
 #endif // hub
@@ -1769,7 +2403,7 @@ static bool enum_parse_configuration_desc(uint8_t dev_addr, tusb_desc_configurat
     if ( 0 == tu_desc_len(p_desc) ) {
       // A zero length descriptor indicates that the device is off spec (e.g. wrong wTotalLength).
       // Parsed interfaces should still be usable
-      TU_LOG_USBH("Encountered a zero-length descriptor after %" PRIu32 " bytes\r\n", (uint32_t)p_desc - (uint32_t)desc_cfg);
+      TU_LOG_USBH("Encountered a zero-length descriptor after %" PRIu32 " bytes\r\n", (uint32_t) (p_desc - (uint8_t const*) desc_cfg));
       break;
     }
 
@@ -1867,7 +2501,7 @@ void usbh_driver_set_config_complete(uint8_t dev_addr, uint8_t itf_num) {
 
   // all interface are configured
   if (itf_num == CFG_TUH_INTERFACE_MAX) {
-    enum_full_complete();
+    enum_full_complete(enum_slot_find(dev_addr));
 
     if (is_hub_addr(dev_addr)) {
       TU_LOG_USBH("HUB address = %u is mounted\r\n", dev_addr);
@@ -1880,16 +2514,15 @@ void usbh_driver_set_config_complete(uint8_t dev_addr, uint8_t itf_num) {
   }
 }
 
-static void enum_full_complete(void) {
-  // mark enumeration as complete
-  _dev0.enumerating = 0;
-
-#if CFG_TUH_HUB
-  if (_dev0.hub_addr) {
-    hub_edpt_status_xfer(_dev0.hub_addr); // get next hub status
-  }
-#endif
+static void enum_full_complete(usbh_enum_t* slot) {
+  TU_VERIFY(slot != NULL,);
+  enum_dev0_release(slot); // if failed in address 0 phase
 
+  // mark enumeration as complete, drop pending control request if any
+  (void) osal_mutex_lock(_usbh_mutex, OSAL_TIMEOUT_WAIT_FOREVER);
+  slot->active = 0;
+  slot->ctrl.pending = false;
+  (void) osal_mutex_unlock(_usbh_mutex);
 }
 
 #endif
@@ -169,6 +169,22 @@ TU_ATTR_ALWAYS_INLINE static inline void tuh_task(void) {
 // Check if there is pending events need processing by tuh_task()
 bool tuh_task_event_ready(void);
 
+// Get statistics of host task event queue e.g high water mark to tune CFG_TUH_TASK_QUEUE_SZ
+void tuh_queue_stats_get(tusb_queue_stats_t* stats);
+
+#if CFG_TUSB_STATS
+// Get statistics of an endpoint of a device. Statistics are reset when device is removed
+bool tuh_stats_get(uint8_t daddr, uint8_t ep_addr, tusb_edpt_stats_t* stats);
+
+// Clear statistics of all endpoints of a device
+bool tuh_stats_clear(uint8_t daddr);
+#endif
+
+#if CFG_TUH_ENUMERATION_CACHE
+// Forget all cached device configurations, next attached devices are fully enumerated
+void tuh_enum_cache_clear(void);
+#endif
+
 #ifndef _TUSB_HCD_H_
 extern void hcd_int_handler(uint8_t rhport, bool in_isr);
 #endif
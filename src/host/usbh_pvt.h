@@ -65,7 +65,8 @@ void usbh_driver_set_config_complete(uint8_t dev_addr, uint8_t itf_num);
 
 uint8_t usbh_get_rhport(uint8_t dev_addr);
 
-uint8_t* usbh_get_enum_buf(void);
+// Buffer for enumeration and short-lived control transfer data, each enumerating device has its own buffer
+uint8_t* usbh_get_enum_buf(uint8_t dev_addr);
 
 void usbh_int_set(bool enabled);
 
@@ -84,6 +85,13 @@ bool usbh_edpt_xfer(uint8_t dev_addr, uint8_t ep_addr, uint8_t * buffer, uint16_
   return usbh_edpt_xfer_with_callback(dev_addr, ep_addr, buffer, total_bytes, NULL, 0);
 }
 
+#if CFG_TUH_API_EDPT_XFER_SG
+// Submit a scatter-gather transfer with 32-bit total length, complete callback is invoked once for the whole list with
+// total transferred bytes. sg list must stay valid until transfer completes, all segments except the last one must be
+// multiple of endpoint max packet size. Require CFG_TUH_API_EDPT_XFER_SG
+bool usbh_edpt_xfer_sg(uint8_t dev_addr, uint8_t ep_addr, tusb_xfer_sg_t const* sg, uint8_t sg_count);
+#endif
+
 // Claim an endpoint before submitting a transfer.
 // If caller does not make any transfer, it must release endpoint for others.
 bool usbh_edpt_claim(uint8_t dev_addr, uint8_t ep_addr);
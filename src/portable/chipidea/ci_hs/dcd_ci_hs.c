@@ -144,7 +144,9 @@ typedef struct
   // Therefore there are 16 bytes padding that we can use.
   //--------------------------------------------------------------------+
   tu_fifo_t * ff;
-  uint8_t reserved[12];
+  uint8_t* xfer_next;   ///< buffer of the next qtd when transfer is larger than a single qtd
+  uint32_t xfer_remain; ///< bytes not yet queued
+  uint32_t xferred;     ///< bytes transferred by previous qtds
 } dcd_qhd_t;
 
 TU_VERIFY_STATIC( sizeof(dcd_qhd_t) == 64, "size is not correct");
@@ -461,7 +463,32 @@ static void qhd_start_xfer(uint8_t rhport, uint8_t epnum, uint8_t dir)
   dcd_reg->ENDPTPRIME = TU_BIT(epnum + (dir ? 16 : 0));
 }
 
+// Number of bytes of next qtd: limited by 5 buffer pages and 15-bit total bytes. If transfer does not fit, qtd length
+// is rounded down to multiple of max packet size so that only the last qtd can end with a short packet.
+static uint16_t qhd_next_qtd_len(dcd_qhd_t const* p_qhd)
+{
+  uint32_t const qtd_max = tu_min32(5*4096 - tu_offset4k((uint32_t) p_qhd->xfer_next), 0x7FFFu);
+  if (p_qhd->xfer_remain <= qtd_max) return (uint16_t) p_qhd->xfer_remain;
+
+  uint16_t const mps = p_qhd->max_packet_size;
+  return (uint16_t) (qtd_max - (qtd_max % mps));
+}
+
+static void qhd_queue_next_qtd(dcd_qhd_t* p_qhd, dcd_qtd_t* p_qtd)
+{
+  uint16_t const len = qhd_next_qtd_len(p_qhd);
+  qtd_init(p_qtd, p_qhd->xfer_next, len);
+
+  if (p_qhd->xfer_next != NULL) p_qhd->xfer_next += len;
+  p_qhd->xfer_remain -= len;
+}
+
 bool dcd_edpt_xfer(uint8_t rhport, uint8_t ep_addr, uint8_t * buffer, uint16_t total_bytes)
+{
+  return dcd_edpt_xfer32(rhport, ep_addr, buffer, total_bytes);
+}
+
+bool dcd_edpt_xfer32(uint8_t rhport, uint8_t ep_addr, uint8_t * buffer, uint32_t total_bytes)
 {
   uint8_t const epnum = tu_edpt_number(ep_addr);
   uint8_t const dir   = tu_edpt_dir(ep_addr);
@@ -469,8 +496,12 @@ bool dcd_edpt_xfer(uint8_t rhport, uint8_t ep_addr, uint8_t * buffer, uint16_t t
   dcd_qhd_t* p_qhd = &_dcd_data.qhd[epnum][dir];
   dcd_qtd_t* p_qtd = &_dcd_data.qtd[epnum][dir];
 
-  // Prepare qtd
-  qtd_init(p_qtd, buffer, total_bytes);
+  p_qhd->xfer_next   = buffer;
+  p_qhd->xfer_remain = total_bytes;
+  p_qhd->xferred     = 0;
+
+  // Prepare qtd, remaining bytes are queued in ISR when this qtd completes
+  qhd_queue_next_qtd(p_qhd, p_qtd);
 
   // Start qhd transfer
   p_qhd->ff = NULL;
@@ -537,6 +568,8 @@ bool dcd_edpt_xfer_fifo (uint8_t rhport, uint8_t ep_addr, tu_fifo_t * ff, uint16
 
   // Start qhd transfer
   p_qhd->ff = ff;
+  p_qhd->xfer_remain = 0;
+  p_qhd->xferred = 0;
   qhd_start_xfer(rhport, epnum, dir);
 
   return true;
@@ -564,6 +597,15 @@ static void process_edpt_complete_isr(uint8_t rhport, uint8_t epnum, uint8_t dir
 
   uint16_t const xferred_bytes = p_qtd->expected_bytes - p_qtd->total_bytes;
 
+  // qtd is fully completed and there are more bytes to queue
+  if ( result == XFER_RESULT_SUCCESS && p_qtd->total_bytes == 0 && p_qhd->xfer_remain )
+  {
+    p_qhd->xferred += xferred_bytes;
+    qhd_queue_next_qtd(p_qhd, p_qtd);
+    qhd_start_xfer(rhport, epnum, dir);
+    return;
+  }
+
   if (p_qhd->ff)
   {
     if (dir == TUSB_DIR_IN)
@@ -575,8 +617,12 @@ static void process_edpt_complete_isr(uint8_t rhport, uint8_t epnum, uint8_t dir
     }
   }
 
-  // only number of bytes in the IOC qtd
-  dcd_event_xfer_complete(rhport, tu_edpt_addr(epnum, dir), xferred_bytes, result, true);
+  // bytes in the IOC qtd plus previously completed qtds of the same transfer
+  uint32_t const total_xferred = p_qhd->xferred + xferred_bytes;
+  p_qhd->xfer_remain = 0;
+  p_qhd->xferred = 0;
+
+  dcd_event_xfer_complete(rhport, tu_edpt_addr(epnum, dir), total_xferred, result, true);
 }
 
 void dcd_int_handler(uint8_t rhport)
@@ -62,6 +62,10 @@
 #define QHD_MAX      (CFG_TUH_DEVICE_MAX*CFG_TUH_ENDPOINT_MAX + CFG_TUH_HUB)
 #define QTD_MAX      QHD_MAX
 
+// Max bytes per qTD for scatter-gather transfer: always fits 5 buffer pages regardless of starting offset and
+// is multiple of any packet size
+#define QTD_SG_CHUNK_MAX  (4*4096)
+
 typedef struct {
   ehci_link_t period_framelist[FRAMELIST_SIZE];
 
@@ -79,6 +83,11 @@ typedef struct {
   ehci_qhd_t qhd_pool[QHD_MAX];
   ehci_qtd_t qtd_pool[QTD_MAX] TU_ATTR_ALIGNED(32);
 
+#if CFG_TUH_API_EDPT_XFER_SG
+  // scatter-gather state for each qhd in pool, qTD is re-queued within ISR until list is complete
+  hcd_xfer_sg_cursor_t sg_cursor[QHD_MAX];
+#endif
+
   ehci_registers_t* regs;         // operational register
   ehci_cap_registers_t* cap_regs; // capability register
 
@@ -149,6 +158,11 @@ TU_ATTR_ALWAYS_INLINE static inline ehci_qtd_t* qtd_control(uint8_t dev_addr);
 TU_ATTR_ALWAYS_INLINE static inline ehci_qtd_t* qtd_find_free (void);
 static void qtd_init (ehci_qtd_t* qtd, void const* buffer, uint16_t total_bytes);
 
+#if CFG_TUH_API_EDPT_XFER_SG
+static hcd_xfer_sg_cursor_t* qhd_sg_cursor(ehci_qhd_t const* qhd);
+static void qhd_sg_queue_next(ehci_qhd_t* qhd, ehci_qtd_t* qtd);
+#endif
+
 TU_ATTR_ALWAYS_INLINE static inline ehci_link_t* list_get_period_head(uint8_t rhport, uint32_t interval_ms);
 TU_ATTR_ALWAYS_INLINE static inline ehci_qhd_t* list_get_async_head(uint8_t rhport);
 TU_ATTR_ALWAYS_INLINE static inline ehci_link_t* list_next (ehci_link_t const *p_link);
@@ -492,6 +506,10 @@ bool hcd_edpt_xfer(uint8_t rhport, uint8_t dev_addr, uint8_t ep_addr, uint8_t *
 
     qtd_init(qtd, buffer, buflen);
     qtd->pid = qhd->pid;
+
+    #if CFG_TUH_API_EDPT_XFER_SG
+    qhd_sg_cursor(qhd)->sg = NULL;
+    #endif
   }
 
   // IN transfer: invalidate buffer, OUT transfer: clean buffer
@@ -507,6 +525,27 @@ bool hcd_edpt_xfer(uint8_t rhport, uint8_t dev_addr, uint8_t ep_addr, uint8_t *
   return true;
 }
 
+#if CFG_TUH_API_EDPT_XFER_SG
+bool hcd_edpt_xfer_sg(uint8_t rhport, uint8_t dev_addr, uint8_t ep_addr, tusb_xfer_sg_t const* sg, uint8_t sg_count) {
+  (void) rhport;
+  TU_VERIFY(tu_edpt_number(ep_addr) != 0); // control transfer use hcd_edpt_xfer()
+
+  ehci_qhd_t* qhd = qhd_get_from_addr(dev_addr, ep_addr);
+  TU_VERIFY(qhd != NULL);
+
+  // skip if endpoint is halted
+  TU_VERIFY(!qhd->qtd_overlay.halted);
+
+  ehci_qtd_t* qtd = qtd_find_free();
+  TU_ASSERT(qtd);
+
+  hcd_xfer_sg_start(qhd_sg_cursor(qhd), sg, sg_count);
+  qhd_sg_queue_next(qhd, qtd);
+
+  return true;
+}
+#endif
+
 bool hcd_edpt_abort_xfer(uint8_t rhport, uint8_t dev_addr, uint8_t ep_addr) {
   (void) rhport;
 
@@ -532,6 +571,11 @@ bool hcd_edpt_abort_xfer(uint8_t rhport, uint8_t dev_addr, uint8_t ep_addr) {
 
     // remove TD from QH software list
     qhd_remove_qtd(qhd);
+
+    #if CFG_TUH_API_EDPT_XFER_SG
+    hcd_xfer_sg_cursor_t* cur = qhd_sg_cursor(qhd);
+    if (cur) cur->sg = NULL;
+    #endif
   }
 
   ehci_enable_schedule(ehci_data.regs, is_period);
@@ -618,12 +662,28 @@ void qhd_xfer_complete_isr(ehci_qhd_t * qhd) {
       hcd_dcache_invalidate((void*) qhd->attached_buffer, xferred_bytes);
     }
 
+    uint32_t total_bytes = xferred_bytes;
+
+    #if CFG_TUH_API_EDPT_XFER_SG
+    hcd_xfer_sg_cursor_t* cur = qhd_sg_cursor(qhd);
+    if (cur != NULL && cur->sg != NULL) {
+      bool const more = hcd_xfer_sg_advance(cur, xferred_bytes);
+      if (xfer_result == XFER_RESULT_SUCCESS && more) {
+        // re-use the same TD for next chunk without notifying usbh
+        qhd_sg_queue_next(qhd, qtd);
+        return;
+      }
+      total_bytes = cur->xferred;
+      cur->sg = NULL;
+    }
+    #endif
+
     // remove and free TD before invoking callback
     qhd_remove_qtd(qhd);
 
     // notify usbh
     uint8_t const ep_addr = tu_edpt_addr(qhd->ep_number, dir);
-    hcd_event_xfer_complete(qhd->dev_addr, ep_addr, xferred_bytes, xfer_result, true);
+    hcd_event_xfer_complete(qhd->dev_addr, ep_addr, total_bytes, xfer_result, true);
   }
 }
 
@@ -947,6 +1007,33 @@ TU_ATTR_ALWAYS_INLINE static inline ehci_qtd_t *qtd_find_free(void) {
   return NULL;
 }
 
+#if CFG_TUH_API_EDPT_XFER_SG
+// Scatter-gather cursor of a qhd, NULL for control qhd which is not part of the pool
+static hcd_xfer_sg_cursor_t* qhd_sg_cursor(ehci_qhd_t const* qhd) {
+  if (qhd < ehci_data.qhd_pool || qhd >= ehci_data.qhd_pool + QHD_MAX) return NULL;
+  return &ehci_data.sg_cursor[qhd - ehci_data.qhd_pool];
+}
+
+// Prepare TD with next chunk of scatter-gather list and attach it to queue head
+static void qhd_sg_queue_next(ehci_qhd_t* qhd, ehci_qtd_t* qtd) {
+  hcd_xfer_sg_cursor_t* cur = qhd_sg_cursor(qhd);
+  uint8_t* buffer = hcd_xfer_sg_next(cur, QTD_SG_CHUNK_MAX);
+
+  qtd_init(qtd, buffer, cur->chunk_len);
+  qtd->pid = qhd->pid;
+
+  // IN transfer: invalidate buffer, OUT transfer: clean buffer
+  if (qhd->pid == EHCI_PID_IN) {
+    hcd_dcache_invalidate(buffer, cur->chunk_len);
+  } else {
+    hcd_dcache_clean(buffer, cur->chunk_len);
+  }
+
+  // attach TD to QHD -> start transferring
+  qhd_attach_qtd(qhd, qtd);
+}
+#endif
+
 static void qtd_init(ehci_qtd_t* qtd, void const* buffer, uint16_t total_bytes) {
   tu_memclr(qtd, sizeof(ehci_qtd_t));
   qtd->used                = 1;
@@ -67,8 +67,8 @@ typedef union {
 typedef struct TU_ATTR_PACKED
 {
   void      *buf;      /* the start address of a transfer data buffer */
-  uint16_t  length;    /* the number of bytes in the buffer */
-  uint16_t  remaining; /* the number of bytes remaining in the buffer */
+  uint32_t  length;    /* the number of bytes in the buffer */
+  uint32_t  remaining; /* the number of bytes remaining in the buffer */
 } pipe_state_t;
 
 typedef struct
@@ -323,7 +323,7 @@ static bool handle_xfer_out(uint8_t rhport, uint_fast8_t ep_addr)
   return false;
 }
 
-static bool edpt_n_xfer(uint8_t rhport, uint8_t ep_addr, uint8_t *buffer, uint16_t total_bytes)
+static bool edpt_n_xfer(uint8_t rhport, uint8_t ep_addr, uint8_t *buffer, uint32_t total_bytes)
 {
   unsigned epnum = tu_edpt_number(ep_addr);
   unsigned epnum_minus1 = epnum - 1;
@@ -773,11 +773,18 @@ void dcd_edpt_close_all(uint8_t rhport)
 
 // Submit a transfer, When complete dcd_event_xfer_complete() is invoked to notify the stack
 bool dcd_edpt_xfer(uint8_t rhport, uint8_t ep_addr, uint8_t * buffer, uint16_t total_bytes)
+{
+  return dcd_edpt_xfer32(rhport, ep_addr, buffer, total_bytes);
+}
+
+// Submit a transfer with 32-bit length, data is moved packet by packet in ISR so there is no hardware limit
+bool dcd_edpt_xfer32(uint8_t rhport, uint8_t ep_addr, uint8_t * buffer, uint32_t total_bytes)
 {
   (void)rhport;
   bool ret;
   // TU_LOG1("X %x %d\r\n", ep_addr, total_bytes);
   unsigned const epnum = tu_edpt_number(ep_addr);
+  TU_ASSERT(epnum || total_bytes <= UINT16_MAX);
   unsigned const ie = musb_dcd_get_int_enable(rhport);
   musb_dcd_int_disable(rhport);
 
@@ -785,7 +792,7 @@ bool dcd_edpt_xfer(uint8_t rhport, uint8_t ep_addr, uint8_t * buffer, uint16_t t
     _dcd.pipe_buf_is_fifo[tu_edpt_dir(ep_addr)] &= ~TU_BIT(epnum - 1);
     ret = edpt_n_xfer(rhport, ep_addr, buffer, total_bytes);
   } else {
-    ret = edpt0_xfer(rhport, ep_addr, buffer, total_bytes);
+    ret = edpt0_xfer(rhport, ep_addr, buffer, (uint16_t) total_bytes);
   }
 
   if (ie) musb_dcd_int_enable(rhport);
@@ -0,0 +1,335 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025, Ha Thach (tinyusb.org)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * This file is part of the TinyUSB stack.
+ */
+
+#include "tusb_option.h"
+
+#if CFG_TUD_ENABLED && CFG_TUSB_MCU == OPT_MCU_SIM
+
+#include "device/dcd.h"
+#include "sim_usb.h"
+
+//--------------------------------------------------------------------+
+// MACRO TYPEDEF CONSTANT ENUM DECLARATION
+//--------------------------------------------------------------------+
+
+// Address alignment of transfer buffers, e.g 4 to behave like dwc2 buffer DMA
+#ifndef CFG_SIM_DCD_DMA_ALIGN
+  #define CFG_SIM_DCD_DMA_ALIGN 1
+#endif
+
+typedef struct {
+  uint8_t* buffer;
+  tu_fifo_t* ff;
+  uint16_t total_len;
+  uint16_t actual_len;
+  uint16_t mps;
+  uint8_t xfer_type;
+  bool opened;
+  bool busy;
+  bool stalled;
+} sim_dcd_edpt_t;
+
+static struct {
+  uint8_t rhport;
+  uint8_t addr;
+  uint8_t addr_pending; // applied after status stage of SET_ADDRESS
+  bool connected;
+  bool sof_enabled;
+  sim_dcd_edpt_t ep[TUP_DCD_ENDPOINT_MAX][2];
+} _dcd;
+
+TU_ATTR_ALWAYS_INLINE static inline sim_dcd_edpt_t* edpt_get(uint8_t ep_addr) {
+  uint8_t const epnum = tu_edpt_number(ep_addr);
+  return (epnum < TUP_DCD_ENDPOINT_MAX) ? &_dcd.ep[epnum][tu_edpt_dir(ep_addr)] : NULL;
+}
+
+static void edpt0_open(void) {
+  for (uint8_t dir = 0; dir < 2; dir++) {
+    sim_dcd_edpt_t* ep = &_dcd.ep[0][dir];
+    tu_memclr(ep, sizeof(sim_dcd_edpt_t));
+    ep->mps = CFG_TUD_ENDPOINT0_SIZE;
+    ep->xfer_type = TUSB_XFER_CONTROL;
+    ep->opened = true;
+  }
+}
+
+static void edpt_xfer_complete(uint8_t ep_addr, sim_dcd_edpt_t* ep) {
+  ep->busy = false;
+
+  if (ep_addr == 0x80 && _dcd.addr_pending) {
+    // status stage of SET_ADDRESS is complete
+    _dcd.addr = _dcd.addr_pending;
+    _dcd.addr_pending = 0;
+  }
+
+  dcd_event_xfer_complete(_dcd.rhport, ep_addr, ep->actual_len, XFER_RESULT_SUCCESS, true);
+}
+
+//--------------------------------------------------------------------+
+// Link API
+//--------------------------------------------------------------------+
+
+void sim_dcd_bus_reset(tusb_speed_t speed) {
+  if (!_dcd.connected) {
+    return;
+  }
+
+  _dcd.addr = 0;
+  _dcd.addr_pending = 0;
+  tu_memclr(_dcd.ep, sizeof(_dcd.ep));
+  edpt0_open();
+
+  dcd_event_bus_reset(_dcd.rhport, speed, true);
+}
+
+void sim_dcd_sof(uint32_t frame_count) {
+  if (_dcd.connected && _dcd.sof_enabled) {
+    dcd_event_sof(_dcd.rhport, frame_count, true);
+  }
+}
+
+sim_handshake_t sim_dcd_setup(uint8_t daddr, uint8_t const setup[8]) {
+  if (!_dcd.connected || daddr != _dcd.addr) {
+    return SIM_HANDSHAKE_NONE;
+  }
+
+  // SETUP is always accepted, it aborts pending control transfer and clears stall of endpoint 0
+  _dcd.ep[0][0].busy = _dcd.ep[0][1].busy = false;
+  _dcd.ep[0][0].stalled = _dcd.ep[0][1].stalled = false;
+
+  dcd_event_setup_received(_dcd.rhport, setup, true);
+  return SIM_HANDSHAKE_ACK;
+}
+
+sim_handshake_t sim_dcd_in(uint8_t daddr, uint8_t ep_addr, uint8_t* buffer, uint16_t* len) {
+  sim_dcd_edpt_t* ep = edpt_get(ep_addr);
+  if (!_dcd.connected || daddr != _dcd.addr || ep == NULL || !ep->opened) {
+    return SIM_HANDSHAKE_NONE;
+  }
+  if (ep->stalled) {
+    return SIM_HANDSHAKE_STALL;
+  }
+  if (!ep->busy) {
+    // isochronous has no handshake: controller sends zero-length packet if no transfer is queued
+    if (ep->xfer_type == TUSB_XFER_ISOCHRONOUS) {
+      *len = 0;
+      return SIM_HANDSHAKE_ACK;
+    }
+    return SIM_HANDSHAKE_NAK;
+  }
+
+  uint16_t const packet_len = tu_min16(ep->mps, ep->total_len - ep->actual_len);
+  uint16_t const copy_len = tu_min16(packet_len, *len);
+
+  if (ep->ff) {
+    tu_fifo_read_n(ep->ff, buffer, copy_len);
+  } else if (copy_len) {
+    memcpy(buffer, ep->buffer + ep->actual_len, copy_len);
+  }
+
+  ep->actual_len += packet_len;
+  *len = packet_len;
+
+  if (ep->actual_len == ep->total_len) {
+    edpt_xfer_complete(ep_addr, ep);
+  }
+
+  return SIM_HANDSHAKE_ACK;
+}
+
+sim_handshake_t sim_dcd_out(uint8_t daddr, uint8_t ep_addr, uint8_t const* buffer, uint16_t len) {
+  sim_dcd_edpt_t* ep = edpt_get(ep_addr);
+  if (!_dcd.connected || daddr != _dcd.addr || ep == NULL || !ep->opened) {
+    return SIM_HANDSHAKE_NONE;
+  }
+  if (ep->stalled) {
+    return SIM_HANDSHAKE_STALL;
+  }
+  if (!ep->busy) {
+    // isochronous data is lost if no transfer is queued
+    return (ep->xfer_type == TUSB_XFER_ISOCHRONOUS) ? SIM_HANDSHAKE_ACK : SIM_HANDSHAKE_NAK;
+  }
+
+  // data exceeding the transfer is dropped
+  uint16_t const copy_len = tu_min16(len, ep->total_len - ep->actual_len);
+
+  if (ep->ff) {
+    tu_fifo_write_n(ep->ff, buffer, copy_len);
+  } else if (copy_len) {
+    memcpy(ep->buffer + ep->actual_len, buffer, copy_len);
+  }
+
+  ep->actual_len += copy_len;
+
+  if (len < ep->mps || ep->actual_len == ep->total_len) {
+    edpt_xfer_complete(ep_addr, ep);
+  }
+
+  return SIM_HANDSHAKE_ACK;
+}
+
+/*------------------------------------------------------------------*/
+/* Device API
+ *------------------------------------------------------------------*/
+
+bool dcd_init(uint8_t rhport, const tusb_rhport_init_t* rh_init) {
+  (void) rh_init;
+  tu_memclr(&_dcd, sizeof(_dcd));
+  _dcd.rhport = rhport;
+  edpt0_open();
+
+  dcd_connect(rhport);
+  return true;
+}
+
+bool dcd_deinit(uint8_t rhport) {
+  dcd_disconnect(rhport);
+  return true;
+}
+
+// Events are generated while running the bus with sim_usb_step()
+void dcd_int_handler(uint8_t rhport) {
+  (void) rhport;
+}
+
+void dcd_int_enable (uint8_t rhport) {
+  (void) rhport;
+}
+
+void dcd_int_disable (uint8_t rhport) {
+  (void) rhport;
+}
+
+// Receive Set Address request, mcu port must also include status IN response
+void dcd_set_address (uint8_t rhport, uint8_t dev_addr) {
+  _dcd.addr_pending = dev_addr;
+  dcd_edpt_xfer(rhport, tu_edpt_addr(0, TUSB_DIR_IN), NULL, 0);
+}
+
+void dcd_remote_wakeup (uint8_t rhport) {
+  (void) rhport;
+}
+
+void dcd_connect(uint8_t rhport) {
+  (void) rhport;
+  _dcd.connected = true;
+  sim_hcd_connect(true);
+}
+
+void dcd_disconnect(uint8_t rhport) {
+  (void) rhport;
+  _dcd.connected = false;
+  sim_hcd_connect(false);
+}
+
+void dcd_sof_enable(uint8_t rhport, bool en) {
+  (void) rhport;
+  _dcd.sof_enabled = en;
+}
+
+void dcd_enter_test_mode(uint8_t rhport, tusb_feature_test_mode_t test_selector) {
+  (void) rhport;
+  (void) test_selector;
+}
+
+//--------------------------------------------------------------------+
+// Endpoint API
+//--------------------------------------------------------------------+
+
+bool dcd_edpt_open (uint8_t rhport, tusb_desc_endpoint_t const * ep_desc) {
+  (void) rhport;
+  sim_dcd_edpt_t* ep = edpt_get(ep_desc->bEndpointAddress);
+  TU_ASSERT(ep);
+
+  tu_memclr(ep, sizeof(sim_dcd_edpt_t));
+  ep->mps = tu_edpt_packet_size(ep_desc);
+  ep->xfer_type = ep_desc->bmAttributes.xfer;
+  ep->opened = true;
+
+  return true;
+}
+
+void dcd_edpt_close_all (uint8_t rhport) {
+  (void) rhport;
+  for (uint8_t epnum = 1; epnum < TUP_DCD_ENDPOINT_MAX; epnum++) {
+    tu_memclr(_dcd.ep[epnum], sizeof(_dcd.ep[epnum]));
+  }
+}
+
+void dcd_edpt_close(uint8_t rhport, uint8_t ep_addr) {
+  (void) rhport;
+  sim_dcd_edpt_t* ep = edpt_get(ep_addr);
+  if (ep) {
+    tu_memclr(ep, sizeof(sim_dcd_edpt_t));
+  }
+}
+
+bool dcd_edpt_xfer (uint8_t rhport, uint8_t ep_addr, uint8_t * buffer, uint16_t total_bytes) {
+  (void) rhport;
+  sim_dcd_edpt_t* ep = edpt_get(ep_addr);
+  TU_ASSERT(ep && ep->opened);
+  TU_ASSERT(0 == (uintptr_t) buffer % CFG_SIM_DCD_DMA_ALIGN);
+
+  ep->buffer = buffer;
+  ep->ff = NULL;
+  ep->total_len = total_bytes;
+  ep->actual_len = 0;
+  ep->busy = true;
+
+  return true;
+}
+
+bool dcd_edpt_xfer_fifo (uint8_t rhport, uint8_t ep_addr, tu_fifo_t * ff, uint16_t total_bytes) {
+  (void) rhport;
+  sim_dcd_edpt_t* ep = edpt_get(ep_addr);
+  TU_ASSERT(ep && ep->opened);
+
+  ep->buffer = NULL;
+  ep->ff = ff;
+  ep->total_len = total_bytes;
+  ep->actual_len = 0;
+  ep->busy = true;
+
+  return true;
+}
+
+void dcd_edpt_stall (uint8_t rhport, uint8_t ep_addr) {
+  (void) rhport;
+  sim_dcd_edpt_t* ep = edpt_get(ep_addr);
+  if (ep) {
+    ep->stalled = true;
+  }
+}
+
+void dcd_edpt_clear_stall (uint8_t rhport, uint8_t ep_addr) {
+  (void) rhport;
+  sim_dcd_edpt_t* ep = edpt_get(ep_addr);
+  if (ep) {
+    ep->stalled = false;
+  }
+}
+
+#endif
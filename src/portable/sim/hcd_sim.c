@@ -0,0 +1,461 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025, Ha Thach (tinyusb.org)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * This file is part of the TinyUSB stack.
+ */
+
+#include "tusb_option.h"
+
+#if CFG_TUH_ENABLED && CFG_TUSB_MCU == OPT_MCU_SIM
+
+#include "host/hcd.h"
+#include "sim_usb.h"
+
+//--------------------------------------------------------------------+
+// MACRO TYPEDEF CONSTANT ENUM DECLARATION
+//--------------------------------------------------------------------+
+
+#ifndef CFG_TUH_SIM_PIPE_MAX
+  #define CFG_TUH_SIM_PIPE_MAX  32
+#endif
+
+typedef struct {
+  uint8_t* buffer;
+  uint16_t buflen;
+  uint16_t actual_len;
+  uint16_t mps;
+  uint16_t interval;    // in (micro)frames, periodic only
+  uint32_t last_frame;  // frame of last periodic transaction
+  uint8_t setup[8];
+  uint8_t daddr;
+  uint8_t ep_addr;      // direction of control endpoint follows current stage
+  uint8_t xfer_type;
+  bool used;
+  bool active;
+  bool is_setup;
+  bool nak;             // NAKed in current step, retried in the next one
+} sim_hcd_pipe_t;
+
+static struct {
+  uint8_t rhport;
+  bool initialized;
+  bool connected; // device pull-up
+  bool attached;  // connection reported to usbh
+
+  tusb_speed_t speed;
+  uint16_t frame_bytes;
+  uint16_t packet_overhead;
+  uint16_t bits_per_us;
+  uint32_t frame_ns;
+
+  uint32_t frame_count;  // number of (micro)frames since start
+  uint32_t frame_used;   // byte times used in current frame
+  uint64_t frame_start_ns;
+
+  sim_hcd_pipe_t pipes[CFG_TUH_SIM_PIPE_MAX];
+} _hcd = {
+  .speed = TUSB_SPEED_FULL,
+};
+
+TU_ATTR_ALWAYS_INLINE static inline bool is_periodic(uint8_t xfer_type) {
+  return xfer_type == TUSB_XFER_INTERRUPT || xfer_type == TUSB_XFER_ISOCHRONOUS;
+}
+
+static void link_setup(void) {
+  bool const is_hs = (_hcd.speed == TUSB_SPEED_HIGH);
+  _hcd.bits_per_us = is_hs ? 480 : 12;
+  _hcd.frame_ns = is_hs ? 125000 : 1000000;
+  if (_hcd.frame_bytes == 0) {
+    _hcd.frame_bytes = is_hs ? 7500 : 1500;
+  }
+  if (_hcd.packet_overhead == 0) {
+    _hcd.packet_overhead = is_hs ? 55 : 13;
+  }
+}
+
+static sim_hcd_pipe_t* pipe_find(uint8_t daddr, uint8_t ep_addr) {
+  for (uint8_t i = 0; i < CFG_TUH_SIM_PIPE_MAX; i++) {
+    sim_hcd_pipe_t* p = &_hcd.pipes[i];
+    if (p->used && p->daddr == daddr) {
+      // control pipe is bi-directional
+      if ((tu_edpt_number(ep_addr) == 0 && tu_edpt_number(p->ep_addr) == 0) || p->ep_addr == ep_addr) {
+        return p;
+      }
+    }
+  }
+  return NULL;
+}
+
+static void pipe_complete(sim_hcd_pipe_t* p, uint32_t len, xfer_result_t result) {
+  p->active = false;
+  uint8_t const ep_addr = p->is_setup ? 0 : p->ep_addr;
+  hcd_event_xfer_complete(p->daddr, ep_addr, len, result, true);
+}
+
+// Consume bus time of a transaction, return false if it does not fit in current frame
+static bool bus_use(uint16_t payload_len) {
+  uint32_t const cost = (uint32_t) payload_len + _hcd.packet_overhead;
+  // a single transaction is always allowed in a frame even if it exceeds configured bandwidth
+  if (_hcd.frame_used && _hcd.frame_used + cost > _hcd.frame_bytes) {
+    return false;
+  }
+  _hcd.frame_used += cost;
+  return true;
+}
+
+// Run a single transaction of pipe, return false if nothing is transferred e.g NAK or frame is full
+static bool pipe_transact(sim_hcd_pipe_t* p) {
+  if (p->is_setup) {
+    TU_VERIFY(bus_use(8));
+    sim_handshake_t const hs = sim_dcd_setup(p->daddr, p->setup);
+    pipe_complete(p, 8, (hs == SIM_HANDSHAKE_ACK) ? XFER_RESULT_SUCCESS : XFER_RESULT_FAILED);
+    return true;
+  }
+
+  uint16_t const remaining = p->buflen - p->actual_len;
+  uint16_t len;
+  sim_handshake_t hs;
+
+  if (tu_edpt_dir(p->ep_addr) == TUSB_DIR_IN) {
+    // reserve a full packet since its size is only known after device responds
+    TU_VERIFY(_hcd.frame_used == 0 || _hcd.frame_used + p->mps + _hcd.packet_overhead <= _hcd.frame_bytes);
+    len = remaining;
+    hs = sim_dcd_in(p->daddr, p->ep_addr, p->buffer ? p->buffer + p->actual_len : NULL, &len);
+  } else {
+    len = tu_min16(p->mps, remaining);
+    TU_VERIFY(_hcd.frame_used == 0 || _hcd.frame_used + len + _hcd.packet_overhead <= _hcd.frame_bytes);
+    hs = sim_dcd_out(p->daddr, p->ep_addr, p->buffer ? p->buffer + p->actual_len : NULL, len);
+  }
+
+  switch (hs) {
+    case SIM_HANDSHAKE_NAK:
+      // NAK is not accounted for bus time
+      p->nak = true;
+      return false;
+
+    case SIM_HANDSHAKE_STALL:
+      bus_use(0);
+      pipe_complete(p, p->actual_len, XFER_RESULT_STALLED);
+      return true;
+
+    case SIM_HANDSHAKE_NONE:
+      bus_use(0);
+      pipe_complete(p, p->actual_len, XFER_RESULT_FAILED);
+      return true;
+
+    default: break;
+  }
+
+  bus_use(len);
+  p->last_frame = _hcd.frame_count;
+
+  if (len > remaining) {
+    // babble: device sent more than requested
+    pipe_complete(p, p->actual_len, XFER_RESULT_FAILED);
+    return true;
+  }
+
+  p->actual_len += len;
+
+  // IN is complete with short packet, OUT is complete when all data is sent (zero-length transfer has one packet)
+  bool const is_in = (tu_edpt_dir(p->ep_addr) == TUSB_DIR_IN);
+  if (p->actual_len == p->buflen || (is_in && len < p->mps)) {
+    pipe_complete(p, p->actual_len, XFER_RESULT_SUCCESS);
+  }
+
+  return true;
+}
+
+static void frame_next(void) {
+  _hcd.frame_start_ns += _hcd.frame_ns;
+  _hcd.frame_count++;
+  _hcd.frame_used = 0;
+
+  if (_hcd.attached) {
+    // SOF carries 1ms frame number
+    sim_dcd_sof((_hcd.speed == TUSB_SPEED_HIGH) ? (_hcd.frame_count >> 3) : _hcd.frame_count);
+  }
+}
+
+//--------------------------------------------------------------------+
+// Application API
+//--------------------------------------------------------------------+
+
+void sim_usb_configure(sim_usb_config_t const* cfg) {
+  _hcd.speed = (cfg->speed == TUSB_SPEED_HIGH) ? TUSB_SPEED_HIGH : TUSB_SPEED_FULL;
+  _hcd.frame_bytes = cfg->frame_bytes;
+  _hcd.packet_overhead = cfg->packet_overhead;
+  link_setup();
+}
+
+bool sim_usb_step(void) {
+  if (_hcd.frame_ns == 0) {
+    link_setup();
+  }
+
+  // report pull-up change
+  if (_hcd.initialized && _hcd.connected != _hcd.attached) {
+    _hcd.attached = _hcd.connected;
+    if (_hcd.attached) {
+      hcd_event_device_attach(_hcd.rhport, true);
+    } else {
+      hcd_event_device_remove(_hcd.rhport, true);
+    }
+  }
+
+  bool progress = false;
+
+  if (_hcd.attached) {
+    for (uint8_t i = 0; i < CFG_TUH_SIM_PIPE_MAX; i++) {
+      _hcd.pipes[i].nak = false;
+    }
+
+    // periodic endpoints are served first, one transaction per interval. Completion callback may queue a new transfer
+    // from isr context, therefore pipe state is re-checked on every pass
+    for (uint8_t i = 0; i < CFG_TUH_SIM_PIPE_MAX; i++) {
+      sim_hcd_pipe_t* p = &_hcd.pipes[i];
+      if (p->active && is_periodic(p->xfer_type) && (_hcd.frame_count - p->last_frame >= p->interval)) {
+        progress |= pipe_transact(p);
+      }
+    }
+
+    // control and bulk share the remaining bandwidth round-robin packet by packet
+    bool moved;
+    do {
+      moved = false;
+      for (uint8_t i = 0; i < CFG_TUH_SIM_PIPE_MAX; i++) {
+        sim_hcd_pipe_t* p = &_hcd.pipes[i];
+        if (p->active && !p->nak && !is_periodic(p->xfer_type)) {
+          moved |= pipe_transact(p);
+        }
+      }
+      progress |= moved;
+    } while (moved);
+  }
+
+  if (!progress) {
+    frame_next();
+  }
+
+  return progress;
+}
+
+void sim_usb_run(uint32_t us) {
+  uint64_t const end_ns = sim_usb_time_us() * 1000 + (uint64_t) us * 1000;
+  while (sim_usb_time_us() * 1000 < end_ns) {
+    sim_usb_step();
+  }
+}
+
+uint64_t sim_usb_time_us(void) {
+  if (_hcd.bits_per_us == 0) {
+    link_setup();
+  }
+  // byte times used so far in current frame, capped at end of frame
+  uint64_t ns = (uint64_t) _hcd.frame_used * 8 * 1000 / _hcd.bits_per_us;
+  if (ns > _hcd.frame_ns) {
+    ns = _hcd.frame_ns;
+  }
+  return (_hcd.frame_start_ns + ns) / 1000;
+}
+
+// Simulated clock only advances when the bus is run: time API of the stack is derived from it and delay must run
+// the bus rather than busy waiting.
+uint32_t tusb_time_millis_api(void) {
+  return (uint32_t) (sim_usb_time_us() / 1000);
+}
+
+void tusb_time_delay_ms_api(uint32_t ms) {
+  sim_usb_run(ms * 1000);
+}
+
+//--------------------------------------------------------------------+
+// Link API
+//--------------------------------------------------------------------+
+
+void sim_hcd_connect(bool connected) {
+  _hcd.connected = connected;
+}
+
+//--------------------------------------------------------------------+
+// Controller API
+//--------------------------------------------------------------------+
+
+bool hcd_init(uint8_t rhport, const tusb_rhport_init_t* rh_init) {
+  (void) rh_init;
+  _hcd.rhport = rhport;
+  _hcd.initialized = true;
+  _hcd.attached = false;
+  tu_memclr(_hcd.pipes, sizeof(_hcd.pipes));
+  link_setup();
+  return true;
+}
+
+bool hcd_deinit(uint8_t rhport) {
+  (void) rhport;
+  _hcd.initialized = false;
+  _hcd.attached = false;
+  return true;
+}
+
+// Events are generated while running the bus with sim_usb_step()
+void hcd_int_handler(uint8_t rhport, bool in_isr) {
+  (void) rhport;
+  (void) in_isr;
+}
+
+void hcd_int_enable(uint8_t rhport) {
+  (void) rhport;
+}
+
+void hcd_int_disable(uint8_t rhport) {
+  (void) rhport;
+}
+
+uint32_t hcd_frame_number(uint8_t rhport) {
+  (void) rhport;
+  return (_hcd.speed == TUSB_SPEED_HIGH) ? (_hcd.frame_count >> 3) : _hcd.frame_count;
+}
+
+//--------------------------------------------------------------------+
+// Port API
+//--------------------------------------------------------------------+
+
+bool hcd_port_connect_status(uint8_t rhport) {
+  (void) rhport;
+  return _hcd.connected;
+}
+
+void hcd_port_reset(uint8_t rhport) {
+  (void) rhport;
+  sim_dcd_bus_reset(_hcd.speed);
+}
+
+void hcd_port_reset_end(uint8_t rhport) {
+  (void) rhport;
+}
+
+tusb_speed_t hcd_port_speed_get(uint8_t rhport) {
+  (void) rhport;
+  return _hcd.speed;
+}
+
+void hcd_device_close(uint8_t rhport, uint8_t dev_addr) {
+  (void) rhport;
+  for (uint8_t i = 0; i < CFG_TUH_SIM_PIPE_MAX; i++) {
+    if (_hcd.pipes[i].daddr == dev_addr) {
+      tu_memclr(&_hcd.pipes[i], sizeof(sim_hcd_pipe_t));
+    }
+  }
+}
+
+//--------------------------------------------------------------------+
+// Endpoints API
+//--------------------------------------------------------------------+
+
+bool hcd_edpt_open(uint8_t rhport, uint8_t dev_addr, tusb_desc_endpoint_t const * ep_desc) {
+  (void) rhport;
+  uint8_t const ep_addr = ep_desc->bEndpointAddress;
+
+  sim_hcd_pipe_t* p = pipe_find(dev_addr, ep_addr);
+  for (uint8_t i = 0; p == NULL && i < CFG_TUH_SIM_PIPE_MAX; i++) {
+    if (!_hcd.pipes[i].used) {
+      p = &_hcd.pipes[i];
+    }
+  }
+  TU_ASSERT(p);
+
+  tu_memclr(p, sizeof(sim_hcd_pipe_t));
+  p->daddr = dev_addr;
+  p->ep_addr = ep_addr;
+  p->xfer_type = ep_desc->bmAttributes.xfer;
+  p->mps = tu_edpt_packet_size(ep_desc);
+  p->used = true;
+
+  if (is_periodic(p->xfer_type)) {
+    uint8_t const binterval = tu_max8(ep_desc->bInterval, 1);
+    if (_hcd.speed == TUSB_SPEED_HIGH || p->xfer_type == TUSB_XFER_ISOCHRONOUS) {
+      p->interval = (uint16_t) (1u << (tu_min8(binterval, 16) - 1));
+    } else {
+      p->interval = binterval;
+    }
+  }
+
+  return true;
+}
+
+bool hcd_edpt_close(uint8_t rhport, uint8_t daddr, uint8_t ep_addr) {
+  (void) rhport;
+  sim_hcd_pipe_t* p = pipe_find(daddr, ep_addr);
+  TU_VERIFY(p);
+  tu_memclr(p, sizeof(sim_hcd_pipe_t));
+  return true;
+}
+
+bool hcd_edpt_xfer(uint8_t rhport, uint8_t dev_addr, uint8_t ep_addr, uint8_t * buffer, uint16_t buflen) {
+  (void) rhport;
+  sim_hcd_pipe_t* p = pipe_find(dev_addr, ep_addr);
+  TU_ASSERT(p && !p->active);
+
+  p->ep_addr = ep_addr;
+  p->buffer = buffer;
+  p->buflen = buflen;
+  p->actual_len = 0;
+  p->is_setup = false;
+  p->active = true;
+
+  return true;
+}
+
+bool hcd_edpt_abort_xfer(uint8_t rhport, uint8_t dev_addr, uint8_t ep_addr) {
+  (void) rhport;
+  sim_hcd_pipe_t* p = pipe_find(dev_addr, ep_addr);
+  TU_VERIFY(p);
+  p->active = false;
+  return true;
+}
+
+bool hcd_setup_send(uint8_t rhport, uint8_t dev_addr, uint8_t const setup_packet[8]) {
+  (void) rhport;
+  sim_hcd_pipe_t* p = pipe_find(dev_addr, 0);
+  TU_ASSERT(p);
+
+  memcpy(p->setup, setup_packet, 8);
+  p->ep_addr = 0;
+  p->buffer = NULL;
+  p->buflen = 0;
+  p->actual_len = 0;
+  p->is_setup = true;
+  p->active = true;
+
+  return true;
+}
+
+bool hcd_edpt_clear_stall(uint8_t rhport, uint8_t dev_addr, uint8_t ep_addr) {
+  (void) rhport;
+  (void) dev_addr;
+  (void) ep_addr;
+  return true;
+}
+
+#endif
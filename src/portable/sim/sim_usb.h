@@ -0,0 +1,94 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025, Ha Thach (tinyusb.org)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * This file is part of the TinyUSB stack.
+ */
+
+#ifndef TUSB_SIM_USB_H_
+#define TUSB_SIM_USB_H_
+
+#include "common/tusb_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Loopback simulation: device controller (dcd_sim.c) is wired to the root port of host controller (hcd_sim.c) in
+// the same process. Bus is driven by the host side: each call to sim_usb_step() runs transactions until all pipes are
+// idle/NAKed or the (micro)frame bandwidth is used up, then advances the simulated clock to the next frame.
+// Completion events are reported with in_isr = true as if they were raised by controller interrupt.
+// Since the device stack and the bus only run from the application loop, blocking (sync) host API cannot be used.
+
+typedef struct {
+  tusb_speed_t speed;       // link speed: TUSB_SPEED_FULL (default) or TUSB_SPEED_HIGH
+  uint16_t frame_bytes;     // bus bandwidth in byte times per (micro)frame, 0 for default of the speed (1500 FS, 7500 HS)
+  uint16_t packet_overhead; // byte times of each transaction beside its payload: token, handshake, inter-packet delay.
+                            // 0 for default of the speed (13 FS, 55 HS) i.e 19 x 64 FS or 13 x 512 HS bulk per frame
+} sim_usb_config_t;
+
+//--------------------------------------------------------------------+
+// Application API
+//--------------------------------------------------------------------+
+
+// Configure link, must be called before tusb_init()
+void sim_usb_configure(sim_usb_config_t const* cfg);
+
+// Run bus with remaining bandwidth of current (micro)frame. Return false (and start next frame) if no transaction
+// could be made i.e bus is idle or waiting for software to queue transfers.
+bool sim_usb_step(void);
+
+// Run bus for (at least) a period of simulated time
+void sim_usb_run(uint32_t us);
+
+// Simulated time since start in microseconds
+uint64_t sim_usb_time_us(void);
+
+//--------------------------------------------------------------------+
+// Internal link API between dcd_sim and hcd_sim
+//--------------------------------------------------------------------+
+
+// handshake of device to a transaction
+typedef enum {
+  SIM_HANDSHAKE_ACK = 0,
+  SIM_HANDSHAKE_NAK,
+  SIM_HANDSHAKE_STALL,
+  SIM_HANDSHAKE_NONE, // no response e.g address mismatched or disconnected
+} sim_handshake_t;
+
+// implemented by dcd
+void sim_dcd_bus_reset(tusb_speed_t speed);
+void sim_dcd_sof(uint32_t frame_count);
+sim_handshake_t sim_dcd_setup(uint8_t daddr, uint8_t const setup[8]);
+
+// IN data packet: len is capacity of buffer on input, actual packet length on output (can be larger than capacity)
+sim_handshake_t sim_dcd_in(uint8_t daddr, uint8_t ep_addr, uint8_t* buffer, uint16_t* len);
+sim_handshake_t sim_dcd_out(uint8_t daddr, uint8_t ep_addr, uint8_t const* buffer, uint16_t len);
+
+// implemented by hcd: device pull-up is changed
+void sim_hcd_connect(bool connected);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -53,7 +53,9 @@
 typedef struct {
   uint8_t* buffer;
   tu_fifo_t* ff;
-  uint16_t total_len;
+  uint32_t total_len;
+  uint32_t pending_len; // bytes not yet scheduled, large transfer is split into segments within the ISR
+  uint32_t seg_len;     // bytes of currently scheduled segment
   uint16_t max_size;
   uint8_t interval;
 } xfer_ctl_t;
@@ -321,13 +323,21 @@ static void edpt_disable(uint8_t rhport, uint8_t ep_addr, bool stall) {
   }
 }
 
+// Largest segment that fits transfer size and packet count of endpoint registers, multiple of packet size so that
+// only the last segment can end with a short packet
+static uint32_t edpt_segment_max(dwc2_regs_t* dwc2, uint16_t max_size) {
+  const uint32_t xfer_size_max = (1ul << (11u + dwc2->ghwcfg3_bm.xfer_size_width)) - 1u;
+  const uint32_t packet_count_max = (1ul << (4u + dwc2->ghwcfg3_bm.packet_size_width)) - 1u;
+  return tu_min32(xfer_size_max / max_size, packet_count_max) * max_size;
+}
+
 static void edpt_schedule_packets(uint8_t rhport, const uint8_t epnum, const uint8_t dir) {
   dwc2_regs_t* dwc2 = DWC2_REG(rhport);
   xfer_ctl_t* const xfer = XFER_CTL_BASE(epnum, dir);
   dwc2_dep_t* dep = &dwc2->ep[dir == TUSB_DIR_IN ? 0 : 1][epnum];
 
   uint16_t num_packets;
-  uint16_t total_bytes;
+  uint32_t total_bytes;
 
   // EP0 is limited to one packet per xfer
   if (epnum == 0) {
@@ -335,12 +345,18 @@ static void edpt_schedule_packets(uint8_t rhport, const uint8_t epnum, const uin
     _dcd_data.ep0_pending[dir] -= total_bytes;
     num_packets = 1;
   } else {
-    total_bytes = xfer->total_len;
-    num_packets = tu_div_ceil(total_bytes, xfer->max_size);
+    total_bytes = xfer->pending_len;
+    if (total_bytes > 0xFFFFu) {
+      total_bytes = tu_min32(total_bytes, edpt_segment_max(dwc2, xfer->max_size));
+    }
+    xfer->pending_len -= total_bytes;
+
+    num_packets = (uint16_t) tu_div_ceil(total_bytes, xfer->max_size);
     if (num_packets == 0) {
       num_packets = 1; // zero length packet still count as 1
     }
   }
+  xfer->seg_len = total_bytes;
 
   // transfer size: A full OUT transfer (multiple packets, possibly) triggers XFRC.
   union {
@@ -573,6 +589,10 @@ bool dcd_edpt_iso_activate(uint8_t rhport,  tusb_desc_endpoint_t const * p_endpo
 }
 
 bool dcd_edpt_xfer(uint8_t rhport, uint8_t ep_addr, uint8_t* buffer, uint16_t total_bytes) {
+  return dcd_edpt_xfer32(rhport, ep_addr, buffer, total_bytes);
+}
+
+bool dcd_edpt_xfer32(uint8_t rhport, uint8_t ep_addr, uint8_t* buffer, uint32_t total_bytes) {
   uint8_t const epnum = tu_edpt_number(ep_addr);
   uint8_t const dir = tu_edpt_dir(ep_addr);
 
@@ -583,7 +603,11 @@ bool dcd_edpt_xfer(uint8_t rhport, uint8_t ep_addr, uint8_t* buffer, uint16_t to
 
   // EP0 can only handle one packet
   if (epnum == 0) {
-    _dcd_data.ep0_pending[dir] = total_bytes;
+    TU_ASSERT(total_bytes <= UINT16_MAX);
+    _dcd_data.ep0_pending[dir] = (uint16_t) total_bytes;
+    xfer->pending_len = 0;
+  } else {
+    xfer->pending_len = total_bytes;
   }
 
   // Schedule packets to be sent within interrupt
@@ -607,6 +631,7 @@ bool dcd_edpt_xfer_fifo(uint8_t rhport, uint8_t ep_addr, tu_fifo_t* ff, uint16_t
   xfer->buffer = NULL;
   xfer->ff = ff;
   xfer->total_len = total_bytes;
+  xfer->pending_len = total_bytes;
 
   // Schedule packets to be sent within interrupt
   // TODO xfer fifo may only available for slave mode
@@ -776,9 +801,10 @@ static void handle_rxflvl_irq(uint8_t rhport) {
           xfer->buffer += byte_count;
         }
 
-        // short packet, minus remaining bytes (xfer_size)
+        // short packet, minus remaining bytes (xfer_size) and segments not yet scheduled
         if (byte_count < xfer->max_size) {
-          xfer->total_len -= epout->tsiz_bm.xfer_size;
+          xfer->total_len -= epout->tsiz_bm.xfer_size + xfer->pending_len;
+          xfer->pending_len = 0;
           if (epnum == 0) {
             xfer->total_len -= _dcd_data.ep0_pending[TUSB_DIR_OUT];
             _dcd_data.ep0_pending[TUSB_DIR_OUT] = 0;
@@ -812,8 +838,8 @@ static void handle_epout_slave(uint8_t rhport, uint8_t epnum, dwc2_doepint_t doe
     if (!doepint_bm.status_phase_rx && !doepint_bm.setup_packet_rx) {
       xfer_ctl_t* xfer = XFER_CTL_BASE(epnum, TUSB_DIR_OUT);
 
-      if ((epnum == 0) && _dcd_data.ep0_pending[TUSB_DIR_OUT]) {
-        // EP0 can only handle one packet, Schedule another packet to be received.
+      if (((epnum == 0) && _dcd_data.ep0_pending[TUSB_DIR_OUT]) || xfer->pending_len) {
+        // EP0 can only handle one packet or segment is complete: schedule the rest to be received.
         edpt_schedule_packets(rhport, epnum, TUSB_DIR_OUT);
       } else {
         dcd_event_xfer_complete(rhport, epnum, xfer->total_len, XFER_RESULT_SUCCESS, true);
@@ -828,8 +854,8 @@ static void handle_epin_slave(uint8_t rhport, uint8_t epnum, dwc2_diepint_t diep
   xfer_ctl_t* xfer = XFER_CTL_BASE(epnum, TUSB_DIR_IN);
 
   if (diepint_bm.xfer_complete) {
-    if ((epnum == 0) && _dcd_data.ep0_pending[TUSB_DIR_IN]) {
-      // EP0 can only handle one packet. Schedule another packet to be transmitted.
+    if (((epnum == 0) && _dcd_data.ep0_pending[TUSB_DIR_IN]) || xfer->pending_len) {
+      // EP0 can only handle one packet or segment is complete: schedule the rest to be transmitted.
       edpt_schedule_packets(rhport, epnum, TUSB_DIR_IN);
     } else {
       dcd_event_xfer_complete(rhport, epnum | TUSB_DIR_IN_MASK, xfer->total_len, XFER_RESULT_SUCCESS, true);
@@ -893,18 +919,28 @@ static void handle_epout_dma(uint8_t rhport, uint8_t epnum, dwc2_doepint_t doepi
         dwc2_dep_t* epout = &dwc2->epout[epnum];
         xfer_ctl_t* xfer = XFER_CTL_BASE(epnum, TUSB_DIR_OUT);
 
-        // determine actual received bytes
-        const uint16_t remain = epout->tsiz_bm.xfer_size;
-        xfer->total_len -= remain;
+        // determine actual received bytes of this segment
+        const uint32_t remain = epout->tsiz_bm.xfer_size;
+        const uint32_t seg_xferred = xfer->seg_len - remain;
+        dcd_dcache_invalidate(xfer->buffer, seg_xferred);
 
-        // this is ZLP, so prepare EP0 for next setup
-        // TODO use status phase rx
-        if(epnum == 0 && xfer->total_len == 0) {
-          dma_setup_prepare(rhport);
-        }
+        if (remain == 0 && xfer->pending_len) {
+          // segment complete, schedule the rest to be received
+          xfer->buffer += seg_xferred;
+          edpt_schedule_packets(rhport, epnum, TUSB_DIR_OUT);
+        } else {
+          // short packet: minus bytes not received
+          xfer->total_len -= remain + xfer->pending_len;
+          xfer->pending_len = 0;
+
+          // this is ZLP, so prepare EP0 for next setup
+          // TODO use status phase rx
+          if(epnum == 0 && xfer->total_len == 0) {
+            dma_setup_prepare(rhport);
+          }
 
-        dcd_dcache_invalidate(xfer->buffer, xfer->total_len);
-        dcd_event_xfer_complete(rhport, epnum, xfer->total_len, XFER_RESULT_SUCCESS, true);
+          dcd_event_xfer_complete(rhport, epnum, xfer->total_len, XFER_RESULT_SUCCESS, true);
+        }
       }
     }
   }
@@ -917,6 +953,10 @@ static void handle_epin_dma(uint8_t rhport, uint8_t epnum, dwc2_diepint_t diepin
     if ((epnum == 0) && _dcd_data.ep0_pending[TUSB_DIR_IN]) {
       // EP0 can only handle one packet. Schedule another packet to be transmitted.
       edpt_schedule_packets(rhport, epnum, TUSB_DIR_IN);
+    } else if (xfer->pending_len) {
+      // segment complete, schedule the rest to be transmitted
+      xfer->buffer += xfer->seg_len;
+      edpt_schedule_packets(rhport, epnum, TUSB_DIR_IN);
     } else {
       if(epnum == 0) {
         dma_setup_prepare(rhport);
@@ -87,6 +87,10 @@ typedef struct {
 
   uint8_t* buffer;
   uint16_t buflen;
+
+#if CFG_TUH_API_EDPT_XFER_SG
+  hcd_xfer_sg_cursor_t sg; // scatter-gather list, each chunk is a channel transfer
+#endif
 } hcd_endpoint_t;
 
 // Additional info for each channel when it is active
@@ -640,6 +644,9 @@ bool hcd_edpt_xfer(uint8_t rhport, uint8_t dev_addr, uint8_t ep_addr, uint8_t *
 
   edpt->buffer = buffer;
   edpt->buflen = buflen;
+#if CFG_TUH_API_EDPT_XFER_SG
+  edpt->sg.sg = NULL;
+#endif
 
   if (ep_num == 0) {
     // update ep_dir since control endpoint can switch direction
@@ -649,6 +656,40 @@ bool hcd_edpt_xfer(uint8_t rhport, uint8_t dev_addr, uint8_t ep_addr, uint8_t *
   return edpt_xfer_kickoff(dwc2, ep_id);
 }
 
+#if CFG_TUH_API_EDPT_XFER_SG
+// kick-off next chunk of scatter-gather list: limited by 16-bit buflen and hctsiz transfer size/packet count width
+static bool edpt_sg_kickoff(dwc2_regs_t* dwc2, uint8_t ep_id) {
+  hcd_endpoint_t* edpt = &_hcd_data.edpt[ep_id];
+  const uint32_t ep_size = edpt->hcchar_bm.ep_size;
+  const uint32_t xfer_size_max = tu_min32((1ul << (11u + dwc2->ghwcfg3_bm.xfer_size_width)) - 1u, UINT16_MAX);
+  const uint32_t packet_count_max = (1ul << (4u + dwc2->ghwcfg3_bm.packet_size_width)) - 1u;
+  const uint16_t chunk_max = (uint16_t) (tu_min32(xfer_size_max / ep_size, packet_count_max) * ep_size);
+
+  edpt->buffer = hcd_xfer_sg_next(&edpt->sg, chunk_max);
+  edpt->buflen = edpt->sg.chunk_len;
+
+  return edpt_xfer_kickoff(dwc2, ep_id);
+}
+
+bool hcd_edpt_xfer_sg(uint8_t rhport, uint8_t dev_addr, uint8_t ep_addr, tusb_xfer_sg_t const* sg, uint8_t sg_count) {
+  dwc2_regs_t* dwc2 = DWC2_REG(rhport);
+  const uint8_t ep_num = tu_edpt_number(ep_addr);
+  const uint8_t ep_dir = tu_edpt_dir(ep_addr);
+  TU_VERIFY(ep_num != 0); // control transfer use hcd_edpt_xfer()
+
+  uint8_t ep_id = edpt_find_opened(dev_addr, ep_num, ep_dir);
+  TU_ASSERT(ep_id < CFG_TUH_DWC2_ENDPOINT_MAX);
+  hcd_endpoint_t* edpt = &_hcd_data.edpt[ep_id];
+
+  hcd_xfer_sg_start(&edpt->sg, sg, sg_count);
+  if (!edpt_sg_kickoff(dwc2, ep_id)) {
+    edpt->sg.sg = NULL;
+    return false;
+  }
+  return true;
+}
+#endif
+
 // Abort a queued transfer. Note: it can only abort transfer that has not been started
 // Return true if a queued transfer is aborted, false if there is no transfer to abort
 bool hcd_edpt_abort_xfer(uint8_t rhport, uint8_t dev_addr, uint8_t ep_addr) {
@@ -1171,8 +1212,33 @@ static void handle_channel_irq(uint8_t rhport, bool in_isr) {
 
       if (is_done) {
         const uint8_t ep_addr = tu_edpt_addr(hcchar_bm.ep_num, hcchar_bm.ep_dir);
-        hcd_event_xfer_complete(hcchar_bm.dev_addr, ep_addr, xfer->xferred_bytes, xfer->result, in_isr);
-        channel_dealloc(dwc2, ch_id);
+        uint32_t xferred_bytes = xfer->xferred_bytes;
+        xfer_result_t result = (xfer_result_t) xfer->result;
+        bool ch_allocated = true;
+
+        #if CFG_TUH_API_EDPT_XFER_SG
+        const uint8_t ep_id = xfer->ep_id;
+        hcd_endpoint_t* edpt = &_hcd_data.edpt[ep_id];
+        if (edpt->sg.sg != NULL) {
+          const bool more = hcd_xfer_sg_advance(&edpt->sg, xferred_bytes);
+          if (result == XFER_RESULT_SUCCESS && more) {
+            // continue with next chunk without notifying usbh, channel is freed so that it can be re-used
+            channel_dealloc(dwc2, ch_id);
+            ch_allocated = false;
+            if (edpt_sg_kickoff(dwc2, ep_id)) {
+              continue;
+            }
+            result = XFER_RESULT_FAILED;
+          }
+          xferred_bytes = edpt->sg.xferred;
+          edpt->sg.sg = NULL;
+        }
+        #endif
+
+        hcd_event_xfer_complete(hcchar_bm.dev_addr, ep_addr, xferred_bytes, result, in_isr);
+        if (ch_allocated) {
+          channel_dealloc(dwc2, ch_id);
+        }
       }
     }
   }
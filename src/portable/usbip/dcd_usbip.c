@@ -0,0 +1,990 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025, Ha Thach (tinyusb.org)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * This file is part of the TinyUSB stack.
+ */
+
+#include "tusb_option.h"
+
+#if CFG_TUD_ENABLED && CFG_TUSB_MCU == OPT_MCU_USBIP
+
+// USB/IP server: device stack is exported as bus id "1-1" over TCP, it can be attached by Linux vhci-hcd with
+//   usbip list -r <host> && sudo usbip attach -r <host> -b 1-1
+// Only local clients can connect unless CFG_TUD_USBIP_ADDR is changed.
+// Each URB submitted by the client is queued on its endpoint and matched against transfers queued by the stack with
+// dcd_edpt_xfer() following USB packet rules: an URB/transfer ends when its buffer is full or a short packet is seen.
+// There is no interrupt: application must call tud_int_handler() in its loop, which waits up to
+// CFG_TUD_USBIP_POLL_MS for socket activity and processes received commands.
+
+#include <errno.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <poll.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#include "device/dcd.h"
+#include "device/usbd.h"
+
+//--------------------------------------------------------------------+
+// MACRO TYPEDEF CONSTANT ENUM DECLARATION
+//--------------------------------------------------------------------+
+
+// TCP port to listen on, 3240 is the port of usbipd
+#ifndef CFG_TUD_USBIP_PORT
+  #define CFG_TUD_USBIP_PORT     3240
+#endif
+
+// IPv4 address (host byte order) to listen on. Loopback by default since any client reaching the port gets full access
+// to the device, use INADDR_ANY to export it to other machines
+#ifndef CFG_TUD_USBIP_ADDR
+  #define CFG_TUD_USBIP_ADDR     INADDR_LOOPBACK
+#endif
+
+// Maximum number of URBs in flight, client is not read while all are in use
+#ifndef CFG_TUD_USBIP_URB_MAX
+  #define CFG_TUD_USBIP_URB_MAX  64
+#endif
+
+// Maximum time tud_int_handler() waits for socket activity
+#ifndef CFG_TUD_USBIP_POLL_MS
+  #define CFG_TUD_USBIP_POLL_MS  1
+#endif
+
+// Largest transfer buffer accepted from client, larger one is considered as protocol error
+#define USBIP_XFER_MAX           (1024u * 1024u)
+
+enum {
+  USBIP_VERSION         = 0x0111,
+
+  USBIP_OP_REQ_DEVLIST  = 0x8005,
+  USBIP_OP_REP_DEVLIST  = 0x0005,
+  USBIP_OP_REQ_IMPORT   = 0x8003,
+  USBIP_OP_REP_IMPORT   = 0x0003,
+
+  USBIP_CMD_SUBMIT      = 1,
+  USBIP_CMD_UNLINK      = 2,
+  USBIP_RET_SUBMIT      = 3,
+  USBIP_RET_UNLINK      = 4,
+
+  USBIP_DIR_OUT         = 0,
+  USBIP_DIR_IN          = 1,
+
+  USBIP_URB_ZERO_PACKET = 0x0040,
+};
+
+// Linux usb_device_speed
+enum {
+  USBIP_SPEED_FULL = 2,
+  USBIP_SPEED_HIGH = 3,
+};
+
+// All fields are big endian on the wire
+typedef struct TU_ATTR_PACKED {
+  uint16_t version;
+  uint16_t code;
+  uint32_t status;
+} usbip_op_header_t;
+
+TU_VERIFY_STATIC(sizeof(usbip_op_header_t) == 8, "size is not correct");
+
+typedef struct TU_ATTR_PACKED {
+  char     path[256];
+  char     busid[32];
+  uint32_t busnum;
+  uint32_t devnum;
+  uint32_t speed;
+  uint16_t idVendor;
+  uint16_t idProduct;
+  uint16_t bcdDevice;
+  uint8_t  bDeviceClass;
+  uint8_t  bDeviceSubClass;
+  uint8_t  bDeviceProtocol;
+  uint8_t  bConfigurationValue;
+  uint8_t  bNumConfigurations;
+  uint8_t  bNumInterfaces;
+} usbip_usb_device_t;
+
+TU_VERIFY_STATIC(sizeof(usbip_usb_device_t) == 312, "size is not correct");
+
+typedef struct TU_ATTR_PACKED {
+  uint32_t command;
+  uint32_t seqnum;
+  uint32_t devid;
+  uint32_t direction;
+  uint32_t ep;
+
+  union {
+    struct TU_ATTR_PACKED {
+      uint32_t transfer_flags;
+      int32_t  transfer_buffer_length;
+      int32_t  start_frame;
+      int32_t  number_of_packets;
+      int32_t  interval;
+      uint8_t  setup[8];
+    } cmd_submit;
+
+    struct TU_ATTR_PACKED {
+      int32_t  status;
+      int32_t  actual_length;
+      int32_t  start_frame;
+      int32_t  number_of_packets;
+      int32_t  error_count;
+      uint8_t  padding[8];
+    } ret_submit;
+
+    struct TU_ATTR_PACKED {
+      uint32_t seqnum;
+      uint8_t  padding[24];
+    } cmd_unlink;
+
+    struct TU_ATTR_PACKED {
+      int32_t  status;
+      uint8_t  padding[24];
+    } ret_unlink;
+  };
+} usbip_header_t;
+
+TU_VERIFY_STATIC(sizeof(usbip_header_t) == 48, "size is not correct");
+
+typedef struct TU_ATTR_PACKED {
+  uint32_t offset;
+  uint32_t length;
+  uint32_t actual_length;
+  uint32_t status;
+} usbip_iso_desc_t;
+
+enum {
+  URB_STAGE_SETUP = 0, // control: waiting to be dispatched
+  URB_STAGE_DATA,
+  URB_STAGE_STATUS,    // control: waiting for status stage of device
+};
+
+typedef struct {
+  uint8_t* buffer;         // transfer buffer followed by 4-byte aligned iso descriptors (host byte order)
+  usbip_iso_desc_t* iso;
+  uint32_t seqnum;
+  uint32_t length;
+  uint32_t actual_len;
+  uint16_t iso_count;
+  uint16_t iso_index;
+  uint8_t  setup[8];
+  uint8_t  ep_addr;        // for control: direction of data stage
+  uint8_t  stage;
+  bool     zlp;            // OUT: zero length packet follows data of multiple of packet size
+  uint8_t  next;           // next urb in endpoint queue
+} usbip_urb_t;
+
+typedef struct {
+  uint8_t* buffer;
+  tu_fifo_t* ff;
+  uint16_t total_len;
+  uint16_t actual_len;
+  uint16_t mps;
+  uint8_t xfer_type;
+  bool opened;
+  bool busy;
+  bool stalled;
+} usbip_edpt_t;
+
+#define URB_NONE  0xffu
+
+TU_VERIFY_STATIC(CFG_TUD_USBIP_URB_MAX < URB_NONE, "too many URBs");
+
+typedef struct {
+  uint8_t head;
+  uint8_t tail;
+} urb_queue_t;
+
+static struct {
+  uint8_t rhport;
+  tusb_speed_t speed;
+  bool connected;
+  bool in_isr;
+
+  int listen_fd;
+  int conn_fd;         // imported client, -1 if none
+  uint32_t sof_ms;
+  bool sof_enabled;
+
+  usbip_edpt_t ep[TUP_DCD_ENDPOINT_MAX][2];
+  urb_queue_t queue[TUP_DCD_ENDPOINT_MAX][2]; // control URBs are all queued on queue[0][0]
+
+  usbip_urb_t urb[CFG_TUD_USBIP_URB_MAX];
+  uint8_t urb_free;    // linked list of free urbs
+} _usbip = { .listen_fd = -1, .conn_fd = -1 };
+
+#define BUSID  "1-1"
+
+//--------------------------------------------------------------------+
+// Socket
+//--------------------------------------------------------------------+
+
+static bool sock_read(int fd, void* buf, size_t len) {
+  uint8_t* p = (uint8_t*) buf;
+  while (len) {
+    ssize_t const n = recv(fd, p, len, 0);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    TU_VERIFY(n > 0);
+    p += n;
+    len -= (size_t) n;
+  }
+  return true;
+}
+
+static bool sock_write(int fd, void const* buf, size_t len) {
+  uint8_t const* p = (uint8_t const*) buf;
+  while (len) {
+    ssize_t const n = send(fd, p, len, MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    TU_VERIFY(n > 0);
+    p += n;
+    len -= (size_t) n;
+  }
+  return true;
+}
+
+static bool sock_wait(int fd, int timeout_ms) {
+  struct pollfd pfd = { .fd = fd, .events = POLLIN, .revents = 0 };
+  return poll(&pfd, 1, timeout_ms) > 0;
+}
+
+static uint32_t millis(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t) (ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+//--------------------------------------------------------------------+
+// URB pool & queue
+//--------------------------------------------------------------------+
+
+static void urb_pool_init(void) {
+  for (uint8_t i = 0; i < CFG_TUD_USBIP_URB_MAX; i++) {
+    _usbip.urb[i].next = (i + 1 < CFG_TUD_USBIP_URB_MAX) ? (uint8_t) (i + 1) : URB_NONE;
+  }
+  _usbip.urb_free = 0;
+
+  for (uint8_t epnum = 0; epnum < TUP_DCD_ENDPOINT_MAX; epnum++) {
+    for (uint8_t dir = 0; dir < 2; dir++) {
+      _usbip.queue[epnum][dir].head = _usbip.queue[epnum][dir].tail = URB_NONE;
+    }
+  }
+}
+
+static uint8_t urb_alloc(void) {
+  uint8_t const idx = _usbip.urb_free;
+  if (idx != URB_NONE) {
+    _usbip.urb_free = _usbip.urb[idx].next;
+    tu_memclr(&_usbip.urb[idx], sizeof(usbip_urb_t));
+    _usbip.urb[idx].next = URB_NONE;
+  }
+  return idx;
+}
+
+static void urb_free(uint8_t idx) {
+  free(_usbip.urb[idx].buffer);
+  _usbip.urb[idx].buffer = NULL;
+  _usbip.urb[idx].next = _usbip.urb_free;
+  _usbip.urb_free = idx;
+}
+
+TU_ATTR_ALWAYS_INLINE static inline urb_queue_t* urb_queue(uint8_t ep_addr) {
+  // control URBs of both directions share one queue
+  uint8_t const epnum = tu_edpt_number(ep_addr);
+  return epnum ? &_usbip.queue[epnum][tu_edpt_dir(ep_addr)] : &_usbip.queue[0][0];
+}
+
+static void urb_enqueue(urb_queue_t* q, uint8_t idx) {
+  if (q->tail == URB_NONE) {
+    q->head = idx;
+  } else {
+    _usbip.urb[q->tail].next = idx;
+  }
+  q->tail = idx;
+}
+
+// remove urb from queue, return false if not found
+static bool urb_remove(urb_queue_t* q, uint8_t idx) {
+  uint8_t prev = URB_NONE;
+  for (uint8_t i = q->head; i != URB_NONE; prev = i, i = _usbip.urb[i].next) {
+    if (i == idx) {
+      uint8_t const next = _usbip.urb[i].next;
+      if (prev == URB_NONE) {
+        q->head = next;
+      } else {
+        _usbip.urb[prev].next = next;
+      }
+      if (q->tail == idx) {
+        q->tail = prev;
+      }
+      _usbip.urb[i].next = URB_NONE;
+      return true;
+    }
+  }
+  return false;
+}
+
+//--------------------------------------------------------------------+
+// Transfer engine
+//--------------------------------------------------------------------+
+
+TU_ATTR_ALWAYS_INLINE static inline usbip_edpt_t* edpt_get(uint8_t ep_addr) {
+  uint8_t const epnum = tu_edpt_number(ep_addr);
+  return (epnum < TUP_DCD_ENDPOINT_MAX) ? &_usbip.ep[epnum][tu_edpt_dir(ep_addr)] : NULL;
+}
+
+static void edpt0_open(void) {
+  for (uint8_t dir = 0; dir < 2; dir++) {
+    usbip_edpt_t* ep = &_usbip.ep[0][dir];
+    tu_memclr(ep, sizeof(usbip_edpt_t));
+    ep->mps = CFG_TUD_ENDPOINT0_SIZE;
+    ep->xfer_type = TUSB_XFER_CONTROL;
+    ep->opened = true;
+  }
+}
+
+static void edpt_xfer_complete(uint8_t ep_addr, usbip_edpt_t* ep) {
+  ep->busy = false;
+  dcd_event_xfer_complete(_usbip.rhport, ep_addr, ep->actual_len, XFER_RESULT_SUCCESS, _usbip.in_isr);
+}
+
+// move data between device transfer and urb buffer
+static void edpt_copy(usbip_edpt_t* ep, uint8_t dir, uint8_t* urb_buf, uint16_t len) {
+  if (len == 0) {
+    return;
+  }
+  if (dir == TUSB_DIR_IN) {
+    if (ep->ff) {
+      tu_fifo_read_n(ep->ff, urb_buf, len);
+    } else {
+      memcpy(urb_buf, ep->buffer + ep->actual_len, len);
+    }
+  } else {
+    if (ep->ff) {
+      tu_fifo_write_n(ep->ff, urb_buf, len);
+    } else {
+      memcpy(ep->buffer + ep->actual_len, urb_buf, len);
+    }
+  }
+}
+
+static void urb_send_ret(uint8_t idx, int32_t status) {
+  usbip_urb_t* urb = &_usbip.urb[idx];
+  bool const is_in = (tu_edpt_dir(urb->ep_addr) == TUSB_DIR_IN);
+
+  usbip_header_t hdr;
+  tu_memclr(&hdr, sizeof(hdr));
+  hdr.command = tu_htonl(USBIP_RET_SUBMIT);
+  hdr.seqnum = tu_htonl(urb->seqnum);
+  hdr.ret_submit.status = (int32_t) tu_htonl((uint32_t) status);
+  // failed IN urb has no data
+  uint32_t const actual_len = (status == 0 || !is_in || urb->iso_count) ? urb->actual_len : 0;
+  hdr.ret_submit.actual_length = (int32_t) tu_htonl(actual_len);
+  hdr.ret_submit.number_of_packets = (int32_t) tu_htonl(urb->iso_count ? urb->iso_count : 0xffffffffu);
+
+  bool ok = sock_write(_usbip.conn_fd, &hdr, sizeof(hdr));
+
+  if (urb->iso_count) {
+    // iso IN data is sent packed: actual length of each packet only
+    for (uint16_t i = 0; ok && is_in && i < urb->iso_count; i++) {
+      ok = sock_write(_usbip.conn_fd, urb->buffer + urb->iso[i].offset, urb->iso[i].actual_length);
+    }
+    for (uint16_t i = 0; ok && i < urb->iso_count; i++) {
+      usbip_iso_desc_t const desc = {
+        .offset        = tu_htonl(urb->iso[i].offset),
+        .length        = tu_htonl(urb->iso[i].length),
+        .actual_length = tu_htonl(urb->iso[i].actual_length),
+        .status        = 0
+      };
+      ok = sock_write(_usbip.conn_fd, &desc, sizeof(desc));
+    }
+  } else if (ok && is_in && status == 0) {
+    ok = sock_write(_usbip.conn_fd, urb->buffer, urb->actual_len);
+  }
+
+  // write error is detected as closed connection by next read
+  (void) ok;
+}
+
+// complete head urb of queue
+static void urb_complete(urb_queue_t* q, int32_t status) {
+  uint8_t const idx = q->head;
+  urb_remove(q, idx);
+  urb_send_ret(idx, status);
+  urb_free(idx);
+}
+
+// Run transfer of an endpoint: match data of queued device transfer with urbs at head of its queue
+static void edpt_run(uint8_t ep_addr) {
+  usbip_edpt_t* ep = edpt_get(ep_addr);
+  urb_queue_t* q = urb_queue(ep_addr);
+  uint8_t const dir = tu_edpt_dir(ep_addr);
+
+  while (ep->busy && q->head != URB_NONE) {
+    usbip_urb_t* urb = &_usbip.urb[q->head];
+
+    if (tu_edpt_number(ep_addr) == 0) {
+      if (urb->stage == URB_STAGE_STATUS) {
+        // status stage is in opposite direction of data stage
+        if (dir == tu_edpt_dir(urb->ep_addr)) {
+          return;
+        }
+        edpt_xfer_complete(ep_addr, ep);
+        urb_complete(q, 0);
+        return;
+      }
+      if (urb->stage != URB_STAGE_DATA || dir != tu_edpt_dir(urb->ep_addr)) {
+        return;
+      }
+    }
+
+    if (urb->iso_count) {
+      // each iso packet is a transfer on its own
+      usbip_iso_desc_t* desc = &urb->iso[urb->iso_index];
+      uint16_t const len = (uint16_t) tu_min32(desc->length, ep->total_len);
+      edpt_copy(ep, dir, urb->buffer + desc->offset, len);
+      desc->actual_length = len;
+      ep->actual_len = len;
+      urb->actual_len += len;
+
+      edpt_xfer_complete(ep_addr, ep);
+      if (++urb->iso_index == urb->iso_count) {
+        urb_complete(q, 0);
+      }
+      continue;
+    }
+
+    uint16_t const len = (uint16_t) tu_min32(urb->length - urb->actual_len, (uint32_t) (ep->total_len - ep->actual_len));
+    edpt_copy(ep, dir, urb->buffer + urb->actual_len, len);
+    ep->actual_len += len;
+    urb->actual_len += len;
+
+    bool urb_done = (urb->actual_len == urb->length);
+    bool ep_done = (ep->actual_len == ep->total_len);
+
+    if (dir == TUSB_DIR_IN) {
+      // device ends its transfer with a short packet
+      bool const short_packet = ep_done && (ep->total_len % ep->mps || ep->total_len == 0);
+      urb_done = urb_done || short_packet;
+    } else {
+      // data of urb ends with a short packet
+      bool const short_packet = urb_done && (urb->length % ep->mps || urb->length == 0 || urb->zlp);
+      ep_done = ep_done || short_packet;
+    }
+
+    if (ep_done) {
+      edpt_xfer_complete(ep_addr, ep);
+    }
+
+    if (urb_done) {
+      if (tu_edpt_number(ep_addr) == 0) {
+        urb->stage = URB_STAGE_STATUS;
+        // status may already be queued by device
+        uint8_t const status_ep = dir ? 0x00 : 0x80;
+        if (edpt_get(status_ep)->busy) {
+          edpt_run(status_ep);
+        }
+        return;
+      }
+      urb_complete(q, 0);
+    }
+  }
+}
+
+// Dispatch control urb at head of queue to the stack as SETUP packet. It is only called by dcd_int_handler() so that
+// stalling both directions of endpoint 0 (or completing status stage) does not affect the next control transfer.
+static bool ctrl_dispatch(void) {
+  urb_queue_t* q = &_usbip.queue[0][0];
+  if (q->head == URB_NONE) {
+    return false;
+  }
+  usbip_urb_t* urb = &_usbip.urb[q->head];
+  if (urb->stage != URB_STAGE_SETUP) {
+    return false;
+  }
+
+  // SETUP aborts pending control transfer and clears stall of endpoint 0
+  _usbip.ep[0][0].busy = _usbip.ep[0][1].busy = false;
+  _usbip.ep[0][0].stalled = _usbip.ep[0][1].stalled = false;
+
+  // direction of data stage, status stage is IN if there is no data
+  tusb_control_request_t const* request = (tusb_control_request_t const*) urb->setup;
+  urb->stage = request->wLength ? URB_STAGE_DATA : URB_STAGE_STATUS;
+  urb->ep_addr = request->wLength ? (request->bmRequestType & TUSB_DIR_IN_MASK) : 0x00;
+
+  dcd_event_setup_received(_usbip.rhport, urb->setup, _usbip.in_isr);
+  return true;
+}
+
+//--------------------------------------------------------------------+
+// Command processing
+//--------------------------------------------------------------------+
+
+static void device_info(usbip_usb_device_t* info) {
+  tusb_desc_device_t const* desc_dev = (tusb_desc_device_t const*) tud_descriptor_device_cb();
+  tusb_desc_configuration_t const* desc_cfg = (tusb_desc_configuration_t const*) tud_descriptor_configuration_cb(0);
+
+  tu_memclr(info, sizeof(usbip_usb_device_t));
+  strcpy(info->path, "/sys/devices/platform/tinyusb/usb1/" BUSID);
+  strcpy(info->busid, BUSID);
+  info->busnum = tu_htonl(1);
+  info->devnum = tu_htonl(2);
+  info->speed = tu_htonl(_usbip.speed == TUSB_SPEED_HIGH ? USBIP_SPEED_HIGH : USBIP_SPEED_FULL);
+  info->idVendor = tu_htons(desc_dev->idVendor);
+  info->idProduct = tu_htons(desc_dev->idProduct);
+  info->bcdDevice = tu_htons(desc_dev->bcdDevice);
+  info->bDeviceClass = desc_dev->bDeviceClass;
+  info->bDeviceSubClass = desc_dev->bDeviceSubClass;
+  info->bDeviceProtocol = desc_dev->bDeviceProtocol;
+  info->bNumConfigurations = desc_dev->bNumConfigurations;
+  info->bNumInterfaces = desc_cfg ? desc_cfg->bNumInterfaces : 0;
+}
+
+static bool op_reply(int fd, uint16_t code, uint32_t status) {
+  usbip_op_header_t const hdr = {
+    .version = tu_htons(USBIP_VERSION),
+    .code    = tu_htons(code),
+    .status  = tu_htonl(status)
+  };
+  return sock_write(fd, &hdr, sizeof(hdr));
+}
+
+static bool op_devlist(int fd) {
+  usbip_usb_device_t info;
+  device_info(&info);
+
+  uint32_t const ndev = tu_htonl(1);
+  TU_VERIFY(op_reply(fd, USBIP_OP_REP_DEVLIST, 0));
+  TU_VERIFY(sock_write(fd, &ndev, 4));
+  TU_VERIFY(sock_write(fd, &info, sizeof(info)));
+
+  // class triple of each interface (first alternate)
+  uint8_t const* desc_cfg = tud_descriptor_configuration_cb(0);
+  if (desc_cfg) {
+    uint8_t const* p_desc = desc_cfg;
+    uint8_t const* desc_end = desc_cfg + tu_le16toh(((tusb_desc_configuration_t const*) desc_cfg)->wTotalLength);
+    while (p_desc < desc_end) {
+      tusb_desc_interface_t const* desc_itf = (tusb_desc_interface_t const*) p_desc;
+      if (tu_desc_type(p_desc) == TUSB_DESC_INTERFACE && desc_itf->bAlternateSetting == 0) {
+        uint8_t const itf_class[4] = {desc_itf->bInterfaceClass, desc_itf->bInterfaceSubClass,
+                                      desc_itf->bInterfaceProtocol, 0};
+        TU_VERIFY(sock_write(fd, itf_class, 4));
+      }
+      p_desc = tu_desc_next(p_desc);
+    }
+  }
+
+  return true;
+}
+
+// Handle operation of new connection, return true if device is imported
+static bool op_process(int fd) {
+  usbip_op_header_t hdr;
+  TU_VERIFY(sock_read(fd, &hdr, sizeof(hdr)));
+
+  switch (tu_ntohs(hdr.code)) {
+    case USBIP_OP_REQ_DEVLIST:
+      op_devlist(fd);
+      return false;
+
+    case USBIP_OP_REQ_IMPORT: {
+      char busid[32];
+      TU_VERIFY(sock_read(fd, busid, sizeof(busid)));
+      busid[sizeof(busid) - 1] = 0;
+
+      if (!_usbip.connected || 0 != strcmp(busid, BUSID)) {
+        op_reply(fd, USBIP_OP_REP_IMPORT, 1);
+        return false;
+      }
+
+      usbip_usb_device_t info;
+      device_info(&info);
+      TU_VERIFY(op_reply(fd, USBIP_OP_REP_IMPORT, 0));
+      TU_VERIFY(sock_write(fd, &info, sizeof(info)));
+      return true;
+    }
+
+    default:
+      TU_LOG1("USBIP: unknown op %04x\r\n", tu_ntohs(hdr.code));
+      return false;
+  }
+}
+
+static bool cmd_submit(usbip_header_t const* hdr) {
+  uint32_t const length = tu_ntohl((uint32_t) hdr->cmd_submit.transfer_buffer_length);
+  int32_t const n_packets = (int32_t) tu_ntohl((uint32_t) hdr->cmd_submit.number_of_packets);
+  uint16_t const iso_count = (n_packets > 0) ? (uint16_t) n_packets : 0;
+  uint8_t const epnum = (uint8_t) tu_ntohl(hdr->ep);
+  uint8_t const dir = (tu_ntohl(hdr->direction) == USBIP_DIR_IN) ? TUSB_DIR_IN : TUSB_DIR_OUT;
+
+  TU_VERIFY(length <= USBIP_XFER_MAX && epnum < TUP_DCD_ENDPOINT_MAX && n_packets <= UINT16_MAX);
+
+  uint8_t const idx = urb_alloc();
+  TU_ASSERT(idx != URB_NONE);
+  usbip_urb_t* urb = &_usbip.urb[idx];
+
+  urb->seqnum = tu_ntohl(hdr->seqnum);
+  urb->length = length;
+  urb->ep_addr = tu_edpt_addr(epnum, dir);
+  urb->iso_count = iso_count;
+  urb->zlp = (tu_ntohl(hdr->cmd_submit.transfer_flags) & USBIP_URB_ZERO_PACKET) != 0;
+  memcpy(urb->setup, hdr->cmd_submit.setup, 8);
+
+  size_t const iso_size = iso_count * sizeof(usbip_iso_desc_t);
+  uint32_t const iso_offset = tu_round_up(length, 4);
+  urb->buffer = (uint8_t*) malloc(iso_offset + iso_size + 1); // +1 for non-null result of zero length
+  if (urb->buffer == NULL) {
+    urb_free(idx);
+    return false;
+  }
+  urb->iso = (usbip_iso_desc_t*) (urb->buffer + iso_offset);
+
+  // urb is allocated first, it is freed by caller closing connection on error
+  urb_queue_t* q = urb_queue(urb->ep_addr);
+  urb_enqueue(q, idx);
+
+  if (dir == TUSB_DIR_OUT) {
+    TU_VERIFY(sock_read(_usbip.conn_fd, urb->buffer, length));
+  }
+
+  if (iso_count) {
+    // descriptors are received right after the data, which may be misaligned: copy them out to their aligned slot.
+    // Slot is at the same or higher address, going backward never overwrites a descriptor not yet copied
+    uint8_t const* raw = urb->buffer + length;
+    TU_VERIFY(sock_read(_usbip.conn_fd, urb->buffer + length, iso_size));
+    for (uint16_t i = iso_count; i-- > 0;) {
+      usbip_iso_desc_t desc;
+      memcpy(&desc, raw + i * sizeof(usbip_iso_desc_t), sizeof(desc));
+      desc.offset = tu_ntohl(desc.offset);
+      desc.length = tu_ntohl(desc.length);
+      desc.actual_length = 0;
+      TU_VERIFY(desc.offset <= length && desc.length <= length - desc.offset);
+      urb->iso[i] = desc;
+    }
+  }
+
+  if (epnum == 0) {
+    return true; // dispatched once previous control transfer is complete
+  }
+
+  usbip_edpt_t* ep = edpt_get(urb->ep_addr);
+  if (!ep->opened || ep->stalled) {
+    urb_remove(q, idx);
+    urb_send_ret(idx, -EPIPE);
+    urb_free(idx);
+  } else {
+    edpt_run(urb->ep_addr);
+  }
+
+  return true;
+}
+
+static bool cmd_unlink(usbip_header_t const* hdr) {
+  uint32_t const seqnum = tu_ntohl(hdr->cmd_unlink.seqnum);
+  int32_t status = 0; // already completed
+
+  for (uint8_t i = 0; i < CFG_TUD_USBIP_URB_MAX; i++) {
+    usbip_urb_t* urb = &_usbip.urb[i];
+    if (urb->buffer && urb->seqnum == seqnum) {
+      // unlinking an active control transfer is the same as if it is aborted by the next SETUP
+      if (urb_remove(urb_queue(urb->ep_addr), i)) {
+        urb_free(i);
+        status = -ECONNRESET;
+      }
+      break;
+    }
+  }
+
+  usbip_header_t ret;
+  tu_memclr(&ret, sizeof(ret));
+  ret.command = tu_htonl(USBIP_RET_UNLINK);
+  ret.seqnum = hdr->seqnum;
+  ret.ret_unlink.status = (int32_t) tu_htonl((uint32_t) status);
+
+  return sock_write(_usbip.conn_fd, &ret, sizeof(ret));
+}
+
+static bool cmd_process(void) {
+  usbip_header_t hdr;
+  TU_VERIFY(sock_read(_usbip.conn_fd, &hdr, sizeof(hdr)));
+
+  switch (tu_ntohl(hdr.command)) {
+    case USBIP_CMD_SUBMIT: return cmd_submit(&hdr);
+    case USBIP_CMD_UNLINK: return cmd_unlink(&hdr);
+    default: return false;
+  }
+}
+
+static void bus_reset(void) {
+  for (uint8_t i = 0; i < CFG_TUD_USBIP_URB_MAX; i++) {
+    free(_usbip.urb[i].buffer);
+  }
+  tu_memclr(_usbip.urb, sizeof(_usbip.urb));
+  urb_pool_init();
+
+  tu_memclr(_usbip.ep, sizeof(_usbip.ep));
+  edpt0_open();
+}
+
+static void conn_close(void) {
+  close(_usbip.conn_fd);
+  _usbip.conn_fd = -1;
+  bus_reset();
+  dcd_event_bus_signal(_usbip.rhport, DCD_EVENT_UNPLUGGED, _usbip.in_isr);
+}
+
+/*------------------------------------------------------------------*/
+/* Device API
+ *------------------------------------------------------------------*/
+
+bool dcd_init(uint8_t rhport, const tusb_rhport_init_t* rh_init) {
+  _usbip.rhport = rhport;
+  _usbip.speed = (rh_init->speed == TUSB_SPEED_HIGH) ? TUSB_SPEED_HIGH : TUSB_SPEED_FULL;
+  bus_reset();
+
+  int const fd = socket(AF_INET, SOCK_STREAM, 0);
+  TU_ASSERT(fd >= 0);
+
+  int const one = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+  struct sockaddr_in addr;
+  tu_memclr(&addr, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = tu_htons(CFG_TUD_USBIP_PORT);
+  addr.sin_addr.s_addr = tu_htonl(CFG_TUD_USBIP_ADDR);
+
+  if (bind(fd, (struct sockaddr*) &addr, sizeof(addr)) < 0 || listen(fd, 1) < 0) {
+    TU_LOG1("USBIP: failed to listen on port %u, errno = %d\r\n", CFG_TUD_USBIP_PORT, errno);
+    close(fd);
+    return false;
+  }
+  _usbip.listen_fd = fd;
+  TU_LOG1("USBIP: listening on port %u\r\n", CFG_TUD_USBIP_PORT);
+
+  dcd_connect(rhport);
+  return true;
+}
+
+bool dcd_deinit(uint8_t rhport) {
+  dcd_disconnect(rhport);
+  close(_usbip.listen_fd);
+  _usbip.listen_fd = -1;
+  return true;
+}
+
+// Wait for socket activity and process received commands, must be called by application loop
+void dcd_int_handler(uint8_t rhport) {
+  (void) rhport;
+  TU_VERIFY(_usbip.listen_fd >= 0,);
+
+  _usbip.in_isr = true;
+
+  if (_usbip.conn_fd < 0) {
+    if (sock_wait(_usbip.listen_fd, CFG_TUD_USBIP_POLL_MS)) {
+      int const fd = accept(_usbip.listen_fd, NULL, NULL);
+      if (fd >= 0) {
+        int const one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        if (op_process(fd)) {
+          TU_LOG1("USBIP: device imported\r\n");
+          _usbip.conn_fd = fd;
+          bus_reset();
+          dcd_event_bus_reset(rhport, _usbip.speed, true);
+        } else {
+          close(fd);
+        }
+      }
+    }
+  } else {
+    // don't wait if there is a control transfer to start
+    int timeout = ctrl_dispatch() ? 0 : CFG_TUD_USBIP_POLL_MS;
+
+    // process all pending commands as long as there is free urb
+    while (_usbip.conn_fd >= 0 && _usbip.urb_free != URB_NONE && sock_wait(_usbip.conn_fd, timeout)) {
+      if (!cmd_process()) {
+        TU_LOG1("USBIP: connection closed\r\n");
+        conn_close();
+      }
+      timeout = 0;
+    }
+
+    if (_usbip.conn_fd >= 0) {
+      ctrl_dispatch();
+    }
+  }
+
+  // there is no bus, SOF is generated from system clock
+  if (_usbip.sof_enabled && _usbip.conn_fd >= 0) {
+    uint32_t const now = millis();
+    if (now != _usbip.sof_ms) {
+      _usbip.sof_ms = now;
+      dcd_event_sof(rhport, now & 0x7ff, true);
+    }
+  }
+
+  _usbip.in_isr = false;
+}
+
+void dcd_int_enable (uint8_t rhport) {
+  (void) rhport;
+}
+
+void dcd_int_disable (uint8_t rhport) {
+  (void) rhport;
+}
+
+// SET_ADDRESS is handled by client (vhci-hcd) and not forwarded, only status is needed
+void dcd_set_address (uint8_t rhport, uint8_t dev_addr) {
+  (void) dev_addr;
+  dcd_edpt_xfer(rhport, tu_edpt_addr(0, TUSB_DIR_IN), NULL, 0);
+}
+
+void dcd_remote_wakeup (uint8_t rhport) {
+  (void) rhport;
+}
+
+void dcd_connect(uint8_t rhport) {
+  (void) rhport;
+  _usbip.connected = true;
+}
+
+// Disconnect drops imported client, new import is refused until connected again
+void dcd_disconnect(uint8_t rhport) {
+  (void) rhport;
+  _usbip.connected = false;
+  if (_usbip.conn_fd >= 0) {
+    conn_close();
+  }
+}
+
+void dcd_sof_enable(uint8_t rhport, bool en) {
+  (void) rhport;
+  _usbip.sof_enabled = en;
+}
+
+void dcd_enter_test_mode(uint8_t rhport, tusb_feature_test_mode_t test_selector) {
+  (void) rhport;
+  (void) test_selector;
+}
+
+//--------------------------------------------------------------------+
+// Endpoint API
+//--------------------------------------------------------------------+
+
+bool dcd_edpt_open (uint8_t rhport, tusb_desc_endpoint_t const * ep_desc) {
+  (void) rhport;
+  usbip_edpt_t* ep = edpt_get(ep_desc->bEndpointAddress);
+  TU_ASSERT(ep);
+
+  tu_memclr(ep, sizeof(usbip_edpt_t));
+  ep->mps = tu_edpt_packet_size(ep_desc);
+  ep->xfer_type = ep_desc->bmAttributes.xfer;
+  ep->opened = true;
+
+  return true;
+}
+
+void dcd_edpt_close_all (uint8_t rhport) {
+  (void) rhport;
+  for (uint8_t epnum = 1; epnum < TUP_DCD_ENDPOINT_MAX; epnum++) {
+    tu_memclr(_usbip.ep[epnum], sizeof(_usbip.ep[epnum]));
+  }
+}
+
+void dcd_edpt_close(uint8_t rhport, uint8_t ep_addr) {
+  (void) rhport;
+  usbip_edpt_t* ep = edpt_get(ep_addr);
+  if (ep) {
+    tu_memclr(ep, sizeof(usbip_edpt_t));
+  }
+}
+
+static bool edpt_xfer(uint8_t ep_addr, uint8_t* buffer, tu_fifo_t* ff, uint16_t total_bytes) {
+  usbip_edpt_t* ep = edpt_get(ep_addr);
+  TU_ASSERT(ep && ep->opened);
+
+  ep->buffer = buffer;
+  ep->ff = ff;
+  ep->total_len = total_bytes;
+  ep->actual_len = 0;
+  ep->busy = true;
+
+  if (_usbip.conn_fd >= 0) {
+    edpt_run(ep_addr);
+  }
+
+  return true;
+}
+
+bool dcd_edpt_xfer (uint8_t rhport, uint8_t ep_addr, uint8_t * buffer, uint16_t total_bytes) {
+  (void) rhport;
+  return edpt_xfer(ep_addr, buffer, NULL, total_bytes);
+}
+
+bool dcd_edpt_xfer_fifo (uint8_t rhport, uint8_t ep_addr, tu_fifo_t * ff, uint16_t total_bytes) {
+  (void) rhport;
+  return edpt_xfer(ep_addr, NULL, ff, total_bytes);
+}
+
+void dcd_edpt_stall (uint8_t rhport, uint8_t ep_addr) {
+  (void) rhport;
+  usbip_edpt_t* ep = edpt_get(ep_addr);
+  TU_VERIFY(ep,);
+  ep->stalled = true;
+  ep->busy = false;
+
+  if (_usbip.conn_fd < 0) {
+    return;
+  }
+
+  urb_queue_t* q = urb_queue(ep_addr);
+  if (tu_edpt_number(ep_addr) == 0) {
+    // protocol stall fails the control transfer, cleared by next SETUP
+    if (q->head != URB_NONE && _usbip.urb[q->head].stage != URB_STAGE_SETUP) {
+      urb_complete(q, -EPIPE);
+    }
+  } else {
+    while (q->head != URB_NONE) {
+      urb_complete(q, -EPIPE);
+    }
+  }
+}
+
+void dcd_edpt_clear_stall (uint8_t rhport, uint8_t ep_addr) {
+  (void) rhport;
+  usbip_edpt_t* ep = edpt_get(ep_addr);
+  if (ep) {
+    ep->stalled = false;
+  }
+}
+
+#endif
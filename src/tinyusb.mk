@@ -2,6 +2,7 @@
 TINYUSB_SRC_C += \
 	src/tusb.c \
 	src/common/tusb_fifo.c \
+	src/common/tusb_capture.c \
 	src/device/usbd.c \
 	src/device/usbd_control.c \
 	src/typec/usbc.c \
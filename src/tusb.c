@@ -294,6 +294,163 @@ uint16_t tu_desc_get_interface_total_len(tusb_desc_interface_t const* desc_itf,
   return len;
 }
 
+//--------------------------------------------------------------------+
+// Endpoint Statistics
+//--------------------------------------------------------------------+
+#if CFG_TUSB_STATS
+void tu_edpt_stats_submit(tu_edpt_stats_t* s, uint32_t len) {
+  s->submit_len = len;
+  s->submit_tick = CFG_TUSB_STATS_TIMESTAMP();
+}
+
+void tu_edpt_stats_complete(tu_edpt_stats_t* s, uint8_t result, uint32_t xferred) {
+  uint32_t const latency = CFG_TUSB_STATS_TIMESTAMP() - s->submit_tick;
+  uint8_t const bucket = latency ? (uint8_t) tu_min32(tu_log2(latency) + 1u, CFG_TUSB_STATS_HIST_BUCKETS - 1) : 0;
+
+  s->stats.latency_hist[bucket]++;
+  if (latency > s->stats.latency_max) {
+    s->stats.latency_max = latency;
+  }
+
+  s->stats.xfers++;
+  s->stats.bytes += xferred;
+  if (result != XFER_RESULT_SUCCESS) {
+    s->stats.failed++;
+  } else if (xferred < s->submit_len) {
+    s->stats.short_xfers++;
+  }
+}
+
+void tu_edpt_stats_cb(tu_edpt_stats_t* s, uint32_t start_tick) {
+  uint32_t const ticks = CFG_TUSB_STATS_TIMESTAMP() - start_tick;
+  s->stats.cb_ticks += ticks;
+  if (ticks > s->stats.cb_max) {
+    s->stats.cb_max = ticks;
+  }
+}
+#endif
+
+//--------------------------------------------------------------------+
+// Record Ring
+//--------------------------------------------------------------------+
+#if CFG_TUSB_DEBUG_TRACE || CFG_TUSB_CAPTURE
+#if TU_RING_LOCK_FREE
+bool tu_ring_reserve(tu_ring_t* r, uint8_t nwords, tu_ring_wr_t* w) {
+  uint32_t const seq = atomic_fetch_add_explicit(&r->seq, 1, memory_order_relaxed);
+  uint32_t wr = atomic_load_explicit(&r->wr, memory_order_relaxed);
+
+  do {
+    uint32_t const rd = atomic_load_explicit(&r->rd, memory_order_acquire);
+    if (wr + 1 + nwords - rd > r->depth) {
+      atomic_fetch_add_explicit(&r->dropped, 1, memory_order_relaxed);
+      return false;
+    }
+  } while (!atomic_compare_exchange_weak_explicit(&r->wr, &wr, wr + 1 + nwords, memory_order_relaxed,
+                                                  memory_order_relaxed));
+
+  w->start = wr;
+  w->idx = wr + 1;
+  w->header = (TU_RING_MAGIC << 24) | ((uint32_t) nwords << 16) | (seq & 0xFFFFu);
+  return true;
+}
+#else
+// mask interrupts of current core, return previous state
+TU_ATTR_ALWAYS_INLINE static inline uint32_t ring_int_save(void) {
+  uint32_t state;
+#if defined(__ARM_ARCH)
+  __asm volatile ("mrs %0, primask\n cpsid i" : "=r" (state) :: "memory");
+#else
+  __asm volatile ("csrrci %0, mstatus, 8" : "=r" (state) :: "memory");
+#endif
+  return state;
+}
+
+TU_ATTR_ALWAYS_INLINE static inline void ring_int_restore(uint32_t state) {
+#if defined(__ARM_ARCH)
+  __asm volatile ("msr primask, %0" :: "r" (state) : "memory");
+#else
+  __asm volatile ("csrs mstatus, %0" :: "r" (state & 8u) : "memory");
+#endif
+}
+
+// only plain atomic load/store are used, which are single instructions on these cores
+bool tu_ring_reserve(tu_ring_t* r, uint8_t nwords, tu_ring_wr_t* w) {
+  uint32_t const state = ring_int_save();
+
+  uint32_t const seq = atomic_load_explicit(&r->seq, memory_order_relaxed);
+  atomic_store_explicit(&r->seq, seq + 1, memory_order_relaxed);
+
+  uint32_t const wr = atomic_load_explicit(&r->wr, memory_order_relaxed);
+  uint32_t const rd = atomic_load_explicit(&r->rd, memory_order_acquire);
+  bool const ok = (wr + 1 + nwords - rd <= r->depth);
+  if (ok) {
+    atomic_store_explicit(&r->wr, wr + 1 + nwords, memory_order_relaxed);
+  } else {
+    uint32_t const dropped = atomic_load_explicit(&r->dropped, memory_order_relaxed);
+    atomic_store_explicit(&r->dropped, dropped + 1, memory_order_relaxed);
+  }
+
+  ring_int_restore(state);
+  TU_VERIFY(ok);
+
+  w->start = wr;
+  w->idx = wr + 1;
+  w->header = (TU_RING_MAGIC << 24) | ((uint32_t) nwords << 16) | (seq & 0xFFFFu);
+  return true;
+}
+#endif
+
+void tu_ring_put(tu_ring_t* r, tu_ring_wr_t* w, uint32_t value) {
+  r->buf[(w->idx++) & (r->depth - 1)] = value;
+}
+
+void tu_ring_put_bytes(tu_ring_t* r, tu_ring_wr_t* w, void const* data, uint16_t len) {
+  uint8_t const* data8 = (uint8_t const*) data;
+  for (uint16_t i = 0; i < len; i += 4) {
+    uint32_t value = 0;
+    memcpy(&value, data8 + i, tu_min16(4, (uint16_t) (len - i)));
+    tu_ring_put(r, w, value);
+  }
+}
+
+void tu_ring_commit(tu_ring_t* r, tu_ring_wr_t const* w) {
+  atomic_thread_fence(memory_order_release);
+  r->buf[w->start & (r->depth - 1)] = w->header;
+}
+
+uint32_t tu_ring_peek(tu_ring_t const* r) {
+  uint32_t const rd = atomic_load_explicit(&r->rd, memory_order_relaxed);
+  uint32_t const header = r->buf[rd & (r->depth - 1)];
+  return ((header >> 24) == TU_RING_MAGIC) ? 1 + ((header >> 16) & 0xFFu) : 0;
+}
+
+uint32_t tu_ring_read(tu_ring_t* r, void* buffer, uint32_t bufsize) {
+  uint8_t* buf8 = (uint8_t*) buffer;
+  uint32_t const max_words = bufsize / 4;
+  uint32_t rd = atomic_load_explicit(&r->rd, memory_order_relaxed);
+  uint32_t count = 0;
+
+  while (1) {
+    uint32_t const len = tu_ring_peek(r);
+    if (len == 0 || count + len > max_words) {
+      break; // no committed record or not enough space
+    }
+    atomic_thread_fence(memory_order_acquire);
+
+    for (uint32_t i = 0; i < len; i++) {
+      uint32_t const idx = (rd + i) & (r->depth - 1);
+      uint32_t const value = r->buf[idx];
+      memcpy(buf8 + 4 * count++, &value, 4);
+      r->buf[idx] = 0;
+    }
+    rd += len;
+    atomic_store_explicit(&r->rd, rd, memory_order_release);
+  }
+
+  return count * 4;
+}
+#endif
+
 //--------------------------------------------------------------------+
 // Endpoint Stream Helper for both Host and Device stack
 //--------------------------------------------------------------------+
@@ -305,7 +462,7 @@ bool tu_edpt_stream_init(tu_edpt_stream_t* s, bool is_host, bool is_tx, bool ove
   s->is_host = is_host;
   tu_fifo_config(&s->ff, ff_buf, ff_bufsize, 1, overwritable);
 
-  #if OSAL_MUTEX_REQUIRED
+  #if CFG_FIFO_MUTEX
   if (ff_buf && ff_bufsize) {
     osal_mutex_t new_mutex = osal_mutex_create(&s->ff_mutexdef);
     tu_fifo_config_mutex(&s->ff, is_tx ? new_mutex : NULL, is_tx ? NULL : new_mutex);
@@ -320,7 +477,7 @@ bool tu_edpt_stream_init(tu_edpt_stream_t* s, bool is_host, bool is_tx, bool ove
 
 bool tu_edpt_stream_deinit(tu_edpt_stream_t* s) {
   (void) s;
-  #if OSAL_MUTEX_REQUIRED
+  #if CFG_FIFO_MUTEX
   if (s->ff.mutex_wr) osal_mutex_delete(s->ff.mutex_wr);
   if (s->ff.mutex_rd) osal_mutex_delete(s->ff.mutex_rd);
   #endif
@@ -523,6 +680,55 @@ static void dump_str_line(uint8_t const* buf, uint16_t count) {
   tu_printf("|\r\n");
 }
 
+#if CFG_TUSB_DEBUG_TRACE
+#define TRACE_DEPTH   (CFG_TUSB_DEBUG_TRACE_BUFSIZE / 4)
+TU_VERIFY_STATIC((TRACE_DEPTH & (TRACE_DEPTH - 1)) == 0, "CFG_TUSB_DEBUG_TRACE_BUFSIZE must be power of 2");
+TU_VERIFY_STATIC(CFG_TUSB_DEBUG_TRACE_MEM_MAX <= 1000, "record length must fit in header");
+
+static uint32_t _trace_buf[TRACE_DEPTH];
+static tu_ring_t _trace = { .buf = _trace_buf, .depth = TRACE_DEPTH };
+
+static void trace_write(uint32_t const* words, uint8_t count, void const* data, uint16_t datalen) {
+  uint32_t const timestamp = CFG_TUSB_DEBUG_TRACE_TIMESTAMP();
+  tu_ring_wr_t w;
+  TU_VERIFY(tu_ring_reserve(&_trace, (uint8_t) (1u + count + (datalen + 3u) / 4u), &w),);
+
+  tu_ring_put(&_trace, &w, timestamp);
+  for (uint8_t i = 0; i < count; i++) {
+    tu_ring_put(&_trace, &w, words[i]);
+  }
+  tu_ring_put_bytes(&_trace, &w, data, datalen);
+  tu_ring_commit(&_trace, &w);
+}
+
+void tu_trace_log(uint8_t count, uint32_t const* words) {
+  trace_write(words, count, NULL, 0);
+}
+
+static void trace_mem(uint32_t fmt, void const* buf, uint32_t count, uint8_t indent) {
+  // format address has the same width as in tu_trace()
+  uint32_t const words[TU_TRACE_ARG_WORDS + 1] = { fmt, [TU_TRACE_ARG_WORDS] = (count & 0xFFFFu) | ((uint32_t) indent << 16) };
+  uint16_t const datalen = (uint16_t) (buf ? tu_min32(count, CFG_TUSB_DEBUG_TRACE_MEM_MAX) : 0);
+  trace_write(words, TU_TRACE_ARG_WORDS + 1, buf, datalen);
+}
+
+void tu_trace_mem(void const* buf, uint32_t count, uint8_t indent) {
+  trace_mem(TU_TRACE_FMT_MEM, buf, count, indent);
+}
+
+void tu_trace_buf(void const* buf, uint32_t count) {
+  trace_mem(TU_TRACE_FMT_BUF, buf, count, 0);
+}
+
+uint32_t tu_trace_read(void* buffer, uint32_t bufsize) {
+  return tu_ring_read(&_trace, buffer, bufsize);
+}
+
+uint32_t tu_trace_dropped(void) {
+  return atomic_load_explicit(&_trace.dropped, memory_order_relaxed);
+}
+#endif
+
 /* Print out memory contents
  *  - buf   : buffer
  *  - count : number of item
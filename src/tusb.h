@@ -158,6 +158,19 @@ bool tusb_inited(void);
 // Called to handle usb interrupt/event. tusb_init(rhport, role) must be called before
 void tusb_int_handler(uint8_t rhport, bool in_isr);
 
+#if CFG_TUSB_CAPTURE
+// Read captured traffic as pcapng stream (Linux usbmon link type). Section and interface headers are emitted by
+// the first read (or after tusb_capture_restart()), followed by complete packet blocks that fit in buffer.
+// Should be called from a single non-ISR context. Return number of bytes written
+uint32_t tusb_capture_read(void* buffer, uint32_t bufsize);
+
+// Emit pcapng headers again with next read e.g when a new capture file/connection is started
+void tusb_capture_restart(void);
+
+// Number of packets lost since capture buffer is full
+uint32_t tusb_capture_dropped(void);
+#endif
+
 // TODO
 // bool tusb_teardown(void);
 
@@ -199,6 +199,10 @@
 #define OPT_MCU_MAX32650         2402  ///< ADI MAX32650/1/2
 #define OPT_MCU_MAX78002         2403  ///< ADI MAX78002
 
+// Simulation
+#define OPT_MCU_SIM              2500  ///< Linux loopback simulation of device & host controller
+#define OPT_MCU_USBIP            2501  ///< Linux USB/IP server exporting device stack over TCP
+
 // Check if configured MCU is one of listed
 // Apply _TU_CHECK_MCU with || as separator to list of input
 #define _TU_CHECK_MCU(_m)    (CFG_TUSB_MCU == _m)
@@ -428,6 +432,82 @@
   #define CFG_TUSB_OS_INC_PATH  CFG_TUSB_OS_INC_PATH_DEFAULT
 #endif
 
+// Lock-free single-producer single-consumer fifo: indices are published with acquire/release ordering
+// instead of mutexes. Every tu_fifo must have at most one writer and one reader context (possibly on
+// different cores). Overwritable fifo still takes its mutexes, since its writer can overwrite data being
+// read: without RTOS or multiple core MCU there is none, it must then not be read and written concurrently.
+// Requires C11 <stdatomic.h>
+#ifndef CFG_TUSB_FIFO_SPSC
+  #define CFG_TUSB_FIFO_SPSC      0
+#endif
+
+// memcpy used by tu_fifo to copy between application and fifo buffer. Port/application can redirect
+// it to a DMA assisted or otherwise optimized copy with the same signature as memcpy()
+#ifndef CFG_TUSB_FIFO_MEMCPY
+  #define CFG_TUSB_FIFO_MEMCPY    memcpy
+#endif
+
+// Per-endpoint transfer statistics: bytes, transfers, short packets, stalls, submit-to-complete latency histogram
+// and time spent in class driver xfer_cb(), readable with tud_stats_get() / tuh_stats_get()
+#ifndef CFG_TUSB_STATS
+  #define CFG_TUSB_STATS          0
+#endif
+
+// Number of log2 latency histogram buckets: [0] = 0 tick, [n] = [2^(n-1), 2^n) ticks, last bucket includes all above
+#ifndef CFG_TUSB_STATS_HIST_BUCKETS
+  #define CFG_TUSB_STATS_HIST_BUCKETS  16
+#endif
+
+// Free-running 32-bit tick used for latency and callback timing. Default is millisecond, which is too coarse for
+// most transfers: application should redirect it to a cycle/us counter e.g DWT->CYCCNT on Cortex-M
+#ifndef CFG_TUSB_STATS_TIMESTAMP
+  #define CFG_TUSB_STATS_TIMESTAMP()  tusb_time_millis_api()
+#endif
+
+// Binary trace: TU_LOG() stores compact records (format string address, timestamp and raw 32-bit arguments) into a
+// ring buffer instead of formatting with printf. Records are drained by application with tu_trace_read() e.g to
+// SEGGER RTT, then decoded to log text on host by tools/decode_trace.py using the firmware ELF. Format strings and
+// %s arguments must be in read-only memory. Requires C11 <stdatomic.h>
+#ifndef CFG_TUSB_DEBUG_TRACE
+  #define CFG_TUSB_DEBUG_TRACE  0
+#endif
+
+// Size of trace ring buffer in bytes, must be power of 2
+#ifndef CFG_TUSB_DEBUG_TRACE_BUFSIZE
+  #define CFG_TUSB_DEBUG_TRACE_BUFSIZE  2048
+#endif
+
+// Maximum bytes of TU_LOG_MEM()/TU_LOG_BUF() dump stored in a record, the rest is truncated
+#ifndef CFG_TUSB_DEBUG_TRACE_MEM_MAX
+  #define CFG_TUSB_DEBUG_TRACE_MEM_MAX  64
+#endif
+
+#ifndef CFG_TUSB_DEBUG_TRACE_TIMESTAMP
+  #define CFG_TUSB_DEBUG_TRACE_TIMESTAMP()  CFG_TUSB_STATS_TIMESTAMP()
+#endif
+
+// Capture SETUP and endpoint transfers of device and host stack (timestamp, truncated payload) into a RAM ring.
+// Application streams it out as pcapng with Linux usbmon link type using tusb_capture_read() e.g to a file or UART,
+// then open it with Wireshark. Requires C11 <stdatomic.h>
+#ifndef CFG_TUSB_CAPTURE
+  #define CFG_TUSB_CAPTURE  0
+#endif
+
+// Size of capture ring buffer in bytes, must be power of 2
+#ifndef CFG_TUSB_CAPTURE_BUFSIZE
+  #define CFG_TUSB_CAPTURE_BUFSIZE  4096
+#endif
+
+// Maximum payload bytes captured per transfer (snap length)
+#ifndef CFG_TUSB_CAPTURE_PAYLOAD_MAX
+  #define CFG_TUSB_CAPTURE_PAYLOAD_MAX  64
+#endif
+
+// Timestamp of captured packets in microseconds, default is derived from tusb_time_millis_api()
+#ifndef CFG_TUSB_CAPTURE_TIMESTAMP_US
+  #define CFG_TUSB_CAPTURE_TIMESTAMP_US()  (tusb_time_millis_api() * 1000u)
+#endif
+
 //--------------------------------------------------------------------
 // Device Options (Default)
 //--------------------------------------------------------------------
@@ -458,6 +538,14 @@
   #define CFG_TUD_ENDPOINT0_SIZE  64
 #endif
 
+// Transfer the whole control data stage with a single dcd_edpt_xfer() directly from/to the buffer passed to
+// tud_control_xfer() instead of copying it packet by packet via internal EP0 buffer. Requires port support
+// (TUP_DCD_EDPT0_MULTI_PACKET) and that buffer is accessible by USB DMA. With CFG_TUD_MEM_DCACHE_ENABLE only IN
+// data stage is direct, OUT data stage is still copied via the cache line aligned EP0 buffer.
+#ifndef CFG_TUD_EDPT0_MULTI_PACKET
+  #define CFG_TUD_EDPT0_MULTI_PACKET  0
+#endif
+
 #ifndef CFG_TUD_INTERFACE_MAX
   #define CFG_TUD_INTERFACE_MAX   16
 #endif
@@ -549,6 +637,19 @@
   #ifndef CFG_TUH_ENUMERATION_BUFSIZE
     #define CFG_TUH_ENUMERATION_BUFSIZE 256
   #endif
+
+  // Number of devices that can be enumerated concurrently after SET_ADDRESS e.g behind hubs (address 0 phase is
+  // always serialized). Each additional device requires its own CFG_TUH_ENUMERATION_BUFSIZE buffer
+  #ifndef CFG_TUH_ENUMERATION_CONCURRENT
+    #define CFG_TUH_ENUMERATION_CONCURRENT 1
+  #endif
+
+  // Number of devices whose selected configuration descriptor is cached, keyed by device descriptor and serial number.
+  // Re-attached device that matches skips string and configuration descriptor requests i.e goes from device descriptor
+  // straight to SET_CONFIGURATION. Each entry takes about CFG_TUH_ENUMERATION_BUFSIZE bytes
+  #ifndef CFG_TUH_ENUMERATION_CACHE
+    #define CFG_TUH_ENUMERATION_CACHE 0
+  #endif
 #endif // CFG_TUH_ENABLED
 
 // Attribute to place data in accessible RAM for host controller (default: CFG_TUSB_MEM_SECTION)
@@ -644,6 +745,11 @@
   #define CFG_TUH_API_EDPT_XFER 0
 #endif
 
+// Enable scatter-gather endpoint transfer with 32-bit length usbh_edpt_xfer_sg()
+#ifndef CFG_TUH_API_EDPT_XFER_SG
+  #define CFG_TUH_API_EDPT_XFER_SG 0
+#endif
+
 //--------------------------------------------------------------------+
 // TypeC Options (Default)
 //--------------------------------------------------------------------+
@@ -661,6 +767,10 @@
   #error Control Endpoint Max Packet Size cannot be larger than 64
 #endif
 
+#if CFG_TUD_EDPT0_MULTI_PACKET && !defined(TUP_DCD_EDPT0_MULTI_PACKET)
+  #error CFG_TUD_EDPT0_MULTI_PACKET is not supported by this port
+#endif
+
 // To avoid GCC compiler warnings when -pedantic option is used (strict ISO C)
 typedef int make_iso_compilers_happy;
 
@@ -23,6 +23,7 @@
  *
  */
 #include "device/dcd.h"
+#include "tusb.h"
 #include "fuzz/fuzz_private.h"
 #include <assert.h>
 #include <cstdint>
@@ -37,9 +38,10 @@ struct State {
   bool interrupts_enabled;
   bool sof_enabled;
   uint8_t address;
+  uint32_t frame_count;
 };
 
-tu_static State state = {false, 0, 0};
+tu_static State state = {false, 0, 0, 0};
 
 //--------------------------------------------------------------------+
 // Controller API
@@ -86,6 +88,33 @@ void dcd_int_handler(uint8_t rhport) {
                              // syncrhonous call depending on fuzz data.
                              _fuzz_data_provider->ConsumeBool());
   }
+
+  // Flood of SOF events: usbd coalesces them, so at most one SOF is queued
+  // for the whole burst.
+  if (_fuzz_data_provider->ConsumeBool()) {
+    bool const sof_cb_en = _fuzz_data_provider->ConsumeBool();
+    tud_sof_cb_enable(sof_cb_en);
+
+    tusb_queue_stats_t before;
+    tud_queue_stats_get(&before);
+
+    uint8_t const count = _fuzz_data_provider->ConsumeIntegral<uint8_t>();
+    for (uint16_t i = 0; i < count; i++) {
+      dcd_event_sof(rhport, state.frame_count++, true);
+    }
+
+    tusb_queue_stats_t after;
+    tud_queue_stats_get(&after);
+
+    // one SOF plus one RESUME if device was suspended
+    assert(after.queued - before.queued <= 2);
+    if (sof_cb_en && count > 0) {
+      // all but one SOF are coalesced, unless queue is full and they are lost
+      uint32_t const skipped = (after.coalesced - before.coalesced) +
+                               (after.overflow - before.overflow);
+      assert(skipped + 1 >= count);
+    }
+  }
 }
 
 void dcd_int_enable(uint8_t rhport) {
@@ -0,0 +1,1039 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025, Ha Thach (tinyusb.org)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * This file is part of the TinyUSB stack.
+ */
+
+/* Loopback benchmark: device stack (CDC + MSC) on rhport 0 is enumerated and driven by host stack on rhport 1
+ * through the simulated controllers in src/portable/sim. Time is simulated, results are reproducible and can be
+ * used as regression gate: exit code is non-zero if data is corrupted or throughput drops below the minimum
+ * percentage of bulk bus capacity.
+ *
+ * Usage: sim_bench [-s full|high] [-n bytes] [-f frame_bytes] [-o packet_overhead] [-t trace_file] [-c pcapng_file]
+ *
+ * With CFG_TUSB_DEBUG_TRACE, binary trace is drained to trace_file for tools/decode_trace.py (make trace).
+ * With CFG_TUSB_CAPTURE, traffic of both stacks is written to pcapng_file (make capture).
+ * With CFG_TUSB_STATS, endpoint statistics of both stacks are checked against the traffic of each throughput test.
+ * With CFG_TUD_AUDIO, host application streams the UAC2 speaker of device with endpoint API (make AUDIO=1).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "tusb.h"
+#include "portable/sim/sim_usb.h"
+
+#define DISK_BLOCK_NUM    256
+#define DISK_BLOCK_SIZE   512
+#define MSC_CMD_BLOCKS    32
+#define TIMEOUT_US        (60u * 1000 * 1000)
+
+// endpoints of usb_descriptors.c
+#define EPNUM_CDC_OUT     0x02
+#define EPNUM_CDC_IN      0x82
+#define EPNUM_MSC_OUT     0x03
+#define EPNUM_MSC_IN      0x83
+
+static uint8_t msc_disk[DISK_BLOCK_NUM][DISK_BLOCK_SIZE];
+static uint8_t host_buf[MSC_CMD_BLOCKS * DISK_BLOCK_SIZE];
+
+static uint32_t total_bytes = 256 * 1024;
+static volatile uint8_t cdc_idx = TUSB_INDEX_INVALID_8;
+static volatile uint8_t msc_daddr = 0;
+static bool data_error = false;
+
+TU_ATTR_ALWAYS_INLINE static inline uint8_t pattern(uint32_t i) {
+  return (uint8_t) (i * 7 + (i >> 8));
+}
+
+#if CFG_TUSB_DEBUG_TRACE
+static FILE* trace_file = NULL;
+
+static void trace_drain(void) {
+  uint8_t buf[256];
+  uint32_t count;
+  while ((count = tu_trace_read(buf, sizeof(buf))) > 0) {
+    if (trace_file) {
+      fwrite(buf, 1, count, trace_file);
+    }
+  }
+}
+#endif
+
+#if CFG_TUSB_CAPTURE
+static FILE* capture_file = NULL;
+
+static void capture_drain(void) {
+  static uint8_t buf[4096];
+  uint32_t count;
+  while ((count = tusb_capture_read(buf, sizeof(buf))) > 0) {
+    if (capture_file) {
+      fwrite(buf, 1, count, capture_file);
+    }
+  }
+}
+#endif
+
+static void run_tasks(void) {
+  tud_task();
+  tuh_task();
+  sim_usb_step();
+#if CFG_TUSB_DEBUG_TRACE
+  trace_drain();
+#endif
+#if CFG_TUSB_CAPTURE
+  capture_drain();
+#endif
+}
+
+//--------------------------------------------------------------------+
+// Benchmarks
+//--------------------------------------------------------------------+
+
+typedef struct {
+  char const* name;
+  bool (*func)(void);
+  uint8_t min_percent; // minimum throughput in percent of bulk bus capacity, 0 for no data
+} bench_t;
+
+static bool bench_enumerate(void) {
+  while (cdc_idx == TUSB_INDEX_INVALID_8 || msc_daddr == 0 || !tud_mounted()) {
+    run_tasks();
+    if (sim_usb_time_us() > TIMEOUT_US) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// device -> host
+static bool bench_cdc_in(void) {
+  uint32_t sent = 0, received = 0;
+  uint64_t const timeout = sim_usb_time_us() + TIMEOUT_US;
+
+  while (received < total_bytes && !data_error) {
+    uint8_t chunk[512];
+    uint32_t n = tu_min32(tud_cdc_write_available(), tu_min32(sizeof(chunk), total_bytes - sent));
+    for (uint32_t i = 0; i < n; i++) {
+      chunk[i] = pattern(sent + i);
+    }
+    sent += tud_cdc_write(chunk, n);
+    tud_cdc_write_flush();
+
+    n = tuh_cdc_read(cdc_idx, chunk, sizeof(chunk));
+    for (uint32_t i = 0; i < n; i++) {
+      data_error |= (chunk[i] != pattern(received + i));
+    }
+    received += n;
+
+    run_tasks();
+    TU_VERIFY(sim_usb_time_us() < timeout);
+  }
+
+  return !data_error;
+}
+
+// host -> device
+static bool bench_cdc_out(void) {
+  uint32_t sent = 0, received = 0;
+  uint64_t const timeout = sim_usb_time_us() + TIMEOUT_US;
+
+  while (received < total_bytes && !data_error) {
+    uint8_t chunk[512];
+    uint32_t n = tu_min32(tuh_cdc_write_available(cdc_idx), tu_min32(sizeof(chunk), total_bytes - sent));
+    for (uint32_t i = 0; i < n; i++) {
+      chunk[i] = pattern(sent + i);
+    }
+    sent += tuh_cdc_write(cdc_idx, chunk, n);
+    tuh_cdc_write_flush(cdc_idx);
+
+    n = tud_cdc_read(chunk, sizeof(chunk));
+    for (uint32_t i = 0; i < n; i++) {
+      data_error |= (chunk[i] != pattern(received + i));
+    }
+    received += n;
+
+    run_tasks();
+    TU_VERIFY(sim_usb_time_us() < timeout);
+  }
+
+  return !data_error;
+}
+
+static volatile bool msc_busy;
+
+static bool msc_complete_cb(uint8_t dev_addr, tuh_msc_complete_data_t const* cb_data) {
+  (void) dev_addr;
+  data_error |= (cb_data->csw->status != MSC_CSW_STATUS_PASSED);
+  msc_busy = false;
+  return true;
+}
+
+static bool bench_msc(bool is_read) {
+  uint32_t const cmd_bytes = MSC_CMD_BLOCKS * DISK_BLOCK_SIZE;
+  uint64_t const timeout = sim_usb_time_us() + TIMEOUT_US;
+  uint32_t lba = 0;
+
+  for (uint32_t done = 0; done < total_bytes && !data_error; done += cmd_bytes) {
+    msc_busy = true;
+    if (is_read) {
+      TU_VERIFY(tuh_msc_read10(msc_daddr, 0, host_buf, lba, MSC_CMD_BLOCKS, msc_complete_cb, 0));
+    } else {
+      for (uint32_t i = 0; i < cmd_bytes; i++) {
+        host_buf[i] = pattern(done + i);
+      }
+      TU_VERIFY(tuh_msc_write10(msc_daddr, 0, host_buf, lba, MSC_CMD_BLOCKS, msc_complete_cb, 0));
+    }
+
+    while (msc_busy) {
+      run_tasks();
+      TU_VERIFY(sim_usb_time_us() < timeout);
+    }
+
+    // read data or written disk must match
+    data_error |= (0 != memcmp(msc_disk[lba], host_buf, cmd_bytes));
+
+    lba = (lba + MSC_CMD_BLOCKS) % DISK_BLOCK_NUM;
+  }
+
+  return !data_error;
+}
+
+static bool bench_msc_read(void) {
+  return bench_msc(true);
+}
+
+static bool bench_msc_write(void) {
+  return bench_msc(false);
+}
+
+static volatile bool desc_done;
+static uint16_t desc_len;
+
+static void desc_complete_cb(tuh_xfer_t* xfer) {
+  data_error |= (xfer->result != XFER_RESULT_SUCCESS);
+  desc_len = (uint16_t) xfer->actual_len;
+  desc_done = true;
+}
+
+#if CFG_TUD_AUDIO || CFG_TUD_VIDEO
+// Run control transfer completed with desc_complete_cb()
+static bool control_wait(void) {
+  uint64_t const timeout = sim_usb_time_us() + TIMEOUT_US;
+  while (!desc_done) {
+    run_tasks();
+    TU_VERIFY(sim_usb_time_us() < timeout);
+  }
+  return !data_error;
+}
+#endif
+
+// configuration descriptor is longer than endpoint 0 size: its data stage takes several packets, or a single
+// transfer with CFG_TUD_EDPT0_MULTI_PACKET
+static bool bench_desc_long(void) {
+  static uint8_t desc_buf[512];
+  uint8_t const* desc = tud_descriptor_configuration_cb(0);
+  uint16_t const total_len = tu_le16toh(((tusb_desc_configuration_t const*) desc)->wTotalLength);
+  TU_VERIFY(total_len > CFG_TUD_ENDPOINT0_SIZE && total_len <= sizeof(desc_buf));
+
+  desc_done = false;
+  TU_VERIFY(tuh_descriptor_get_configuration(msc_daddr, 0, desc_buf, total_len, desc_complete_cb, 0));
+  while (!desc_done) {
+    run_tasks();
+    if (sim_usb_time_us() > TIMEOUT_US) {
+      return false;
+    }
+  }
+
+  return !data_error && desc_len == total_len && 0 == memcmp(desc_buf, desc, total_len);
+}
+
+// unplug and plug device again: enumerated with cached configuration (CFG_TUH_ENUMERATION_CACHE), following tests
+// run with drivers opened from cached descriptor
+static bool bench_reattach(void) {
+  tud_disconnect();
+  while (cdc_idx != TUSB_INDEX_INVALID_8 || msc_daddr != 0) {
+    run_tasks();
+    if (sim_usb_time_us() > TIMEOUT_US) {
+      return false;
+    }
+  }
+
+  tud_connect();
+  return bench_enumerate();
+}
+
+#if CFG_TUD_AUDIO
+//--------------------------------------------------------------------+
+// Audio: host application streams 48 kHz mono 16-bit to the speaker of device with endpoint API, packet size follows
+// feedback of device. Samples are a running counter so that device can check them. With make AUDIO_BULK=n the
+// speaker has a bulk AS endpoint without feedback instead, data is sent as fast as possible.
+//--------------------------------------------------------------------+
+
+#define AUDIO_SAMPLE_RATE  48000
+#define AUDIO_PREFILL      4 // packets received before device plays
+
+static struct {
+  uint8_t itf;
+  uint8_t ep_out;
+  uint8_t ep_fb;
+  bool follow_fb;          // packet size follows feedback, otherwise nominal
+  volatile bool out_busy;
+  volatile bool fb_busy;
+  uint32_t packet_limit;   // streaming stops after this number of packets
+  uint32_t packets;        // sent packets
+  uint32_t sent;           // sent samples
+  uint32_t fb_nominal;     // nominal samples per (micro)frame in 16.16 format
+  uint32_t fb_value;       // last received feedback in 16.16 format
+  uint32_t fb_count;       // received feedback values
+  uint32_t fb_acc;         // fraction of sample not yet sent
+  int16_t out_buf[64];
+  uint8_t fb_buf[4];
+} audio_host;
+
+// Open endpoints of streaming interface from configuration descriptor and select its alternate setting 1
+static bool audio_open(void) {
+  static uint8_t desc_buf[512];
+  uint8_t const* desc = tud_descriptor_configuration_cb(0);
+  uint16_t const total_len = tu_le16toh(((tusb_desc_configuration_t const*) desc)->wTotalLength);
+  TU_VERIFY(total_len <= sizeof(desc_buf));
+
+  desc_done = false;
+  TU_VERIFY(tuh_descriptor_get_configuration(msc_daddr, 0, desc_buf, total_len, desc_complete_cb, 0));
+  TU_VERIFY(control_wait());
+
+  tu_memclr(&audio_host, sizeof(audio_host));
+  bool is_stream = false;
+  for (uint8_t const* p = desc_buf; p < desc_buf + total_len; p = tu_desc_next(p)) {
+    if (tu_desc_type(p) == TUSB_DESC_INTERFACE) {
+      tusb_desc_interface_t const* desc_itf = (tusb_desc_interface_t const*) p;
+      is_stream = (desc_itf->bInterfaceClass == TUSB_CLASS_AUDIO &&
+                   desc_itf->bInterfaceSubClass == AUDIO_SUBCLASS_STREAMING && desc_itf->bAlternateSetting == 1);
+      if (is_stream) {
+        audio_host.itf = desc_itf->bInterfaceNumber;
+      }
+    } else if (is_stream && tu_desc_type(p) == TUSB_DESC_ENDPOINT) {
+      tusb_desc_endpoint_t const* desc_ep = (tusb_desc_endpoint_t const*) p;
+      TU_VERIFY(tuh_edpt_open(msc_daddr, desc_ep));
+      if (tu_edpt_dir(desc_ep->bEndpointAddress) == TUSB_DIR_OUT) {
+        audio_host.ep_out = desc_ep->bEndpointAddress;
+      } else {
+        audio_host.ep_fb = desc_ep->bEndpointAddress;
+      }
+    }
+  }
+  TU_VERIFY(audio_host.ep_out && (audio_host.ep_fb || AUDIO_BULK));
+
+  uint32_t const frames_per_sec = (tuh_speed_get(msc_daddr) == TUSB_SPEED_HIGH) ? 8000 : 1000;
+  audio_host.fb_nominal = (AUDIO_SAMPLE_RATE / frames_per_sec) << 16;
+  audio_host.fb_value = audio_host.fb_nominal;
+
+  desc_done = false;
+  TU_VERIFY(tuh_interface_set(msc_daddr, audio_host.itf, 1, desc_complete_cb, 0));
+  return control_wait();
+}
+
+#if AUDIO_BULK
+//------------- Bulk AS endpoint -------------//
+// Host sends full packets, device receives CFG_TUD_AUDIO_XFER_BATCH of them per transfer and decodes them into support
+// FIFO, which is drained and checked here.
+#define AUDIO_BULK_BYTES   65536
+
+static int16_t audio_bulk_buf[2048];
+
+static void audio_bulk_cb(tuh_xfer_t* xfer) {
+  data_error |= (xfer->result != XFER_RESULT_SUCCESS || xfer->actual_len != sizeof(audio_bulk_buf));
+  audio_host.out_busy = false;
+}
+
+static bool audio_check_bulk(void) {
+  uint16_t const ep_size = (tuh_speed_get(msc_daddr) == TUSB_SPEED_HIGH) ? 512 : 64;
+  uint64_t const timeout = sim_usb_time_us() + TIMEOUT_US;
+  uint32_t received = 0;
+
+  TU_VERIFY(tud_audio_telemetry_clear());
+  while (received < AUDIO_BULK_BYTES / 2) {
+    if (!audio_host.out_busy && audio_host.sent < AUDIO_BULK_BYTES / 2) {
+      for (uint16_t i = 0; i < TU_ARRAY_SIZE(audio_bulk_buf); i++) {
+        audio_bulk_buf[i] = (int16_t) (audio_host.sent + i);
+      }
+      audio_host.sent += TU_ARRAY_SIZE(audio_bulk_buf);
+
+      tuh_xfer_t xfer = {
+        .daddr = msc_daddr,
+        .ep_addr = audio_host.ep_out,
+        .buflen = sizeof(audio_bulk_buf),
+        .buffer = (uint8_t*) audio_bulk_buf,
+        .complete_cb = audio_bulk_cb,
+      };
+      audio_host.out_busy = tuh_edpt_xfer(&xfer);
+      TU_VERIFY(audio_host.out_busy);
+    }
+
+    run_tasks();
+
+    int16_t sample;
+    while (tud_audio_read_support_ff(0, &sample, sizeof(sample)) == sizeof(sample)) {
+      TU_VERIFY(sample == (int16_t) received);
+      received++;
+    }
+    TU_VERIFY(sim_usb_time_us() < timeout && !data_error);
+  }
+
+  // one completion per batch of packets
+  audio_telemetry_t tele;
+  TU_VERIFY(tud_audio_telemetry_get(&tele));
+  TU_VERIFY(tele.rx.xfers == AUDIO_BULK_BYTES / (ep_size * CFG_TUD_AUDIO_XFER_BATCH) && tele.rx.overruns == 0);
+  return true;
+}
+
+#else
+//------------- Isochronous AS endpoint with feedback -------------//
+static audio_telemetry_t audio_host_telemetry;
+
+static void audio_out_submit(void);
+static void audio_fb_submit(void);
+
+static void audio_out_cb(tuh_xfer_t* xfer) {
+  data_error |= (xfer->result != XFER_RESULT_SUCCESS);
+  audio_host.out_busy = false;
+  audio_host.packets++;
+  audio_out_submit();
+}
+
+static void audio_fb_cb(tuh_xfer_t* xfer) {
+  audio_host.fb_busy = false;
+  // zero-length packet is sent while device has no feedback queued
+  if (xfer->result == XFER_RESULT_SUCCESS && xfer->actual_len == 4) {
+    audio_host.fb_value = tu_le32toh(tu_unaligned_read32(audio_host.fb_buf));
+    audio_host.fb_count++;
+  }
+  audio_fb_submit();
+}
+
+static void audio_out_submit(void) {
+  if (audio_host.packets >= audio_host.packet_limit) {
+    return;
+  }
+
+  audio_host.fb_acc += audio_host.follow_fb ? audio_host.fb_value : audio_host.fb_nominal;
+  uint16_t const n = (uint16_t) tu_min32(audio_host.fb_acc >> 16, TU_ARRAY_SIZE(audio_host.out_buf));
+  audio_host.fb_acc &= 0xFFFFu;
+
+  for (uint16_t i = 0; i < n; i++) {
+    audio_host.out_buf[i] = (int16_t) (audio_host.sent + i);
+  }
+  audio_host.sent += n;
+
+  tuh_xfer_t xfer = {
+    .daddr = msc_daddr,
+    .ep_addr = audio_host.ep_out,
+    .buflen = n * 2u,
+    .buffer = (uint8_t*) audio_host.out_buf,
+    .complete_cb = audio_out_cb,
+  };
+  audio_host.out_busy = tuh_edpt_xfer(&xfer);
+  data_error |= !audio_host.out_busy;
+}
+
+static void audio_fb_submit(void) {
+  if (audio_host.packets >= audio_host.packet_limit) {
+    return;
+  }
+
+  tuh_xfer_t xfer = {
+    .daddr = msc_daddr,
+    .ep_addr = audio_host.ep_fb,
+    .buflen = sizeof(audio_host.fb_buf),
+    .buffer = audio_host.fb_buf,
+    .complete_cb = audio_fb_cb,
+  };
+  audio_host.fb_busy = tuh_edpt_xfer(&xfer);
+  data_error |= !audio_host.fb_busy;
+}
+
+static void audio_stream_begin(uint32_t packets, bool follow_fb) {
+  audio_host.packet_limit = audio_host.packets + packets;
+  audio_host.follow_fb = follow_fb;
+  audio_out_submit();
+  audio_fb_submit();
+}
+
+// Stream a number of packets, then wait until device has handled them
+static bool audio_stream(uint32_t packets, bool follow_fb) {
+  uint64_t const timeout = sim_usb_time_us() + TIMEOUT_US;
+  audio_stream_begin(packets, follow_fb);
+
+  while (audio_host.out_busy || audio_host.fb_busy) {
+    run_tasks();
+    TU_VERIFY(sim_usb_time_us() < timeout);
+  }
+
+  // device handles last completions and re-queues feedback
+  for (uint8_t i = 0; i < 8; i++) {
+    run_tasks();
+  }
+  return !data_error;
+}
+
+// Read telemetry of device with vendor request, optionally clear it
+static bool audio_telemetry_request(bool clear) {
+  tusb_control_request_t const request = {
+    .bmRequestType_bit = {
+      .recipient = TUSB_REQ_RCPT_DEVICE,
+      .type = TUSB_REQ_TYPE_VENDOR,
+      .direction = TUSB_DIR_IN
+    },
+    .bRequest = CFG_TUD_AUDIO_TELEMETRY_REQUEST,
+    .wValue = tu_htole16(clear ? 1 : 0),
+    .wIndex = 0,
+    .wLength = tu_htole16(sizeof(audio_telemetry_t))
+  };
+  tuh_xfer_t xfer = {
+    .daddr = msc_daddr,
+    .ep_addr = 0,
+    .setup = &request,
+    .buffer = (uint8_t*) &audio_host_telemetry,
+    .complete_cb = desc_complete_cb,
+  };
+
+  desc_done = false;
+  TU_VERIFY(tuh_control_xfer(&xfer));
+  return control_wait() && desc_len == sizeof(audio_telemetry_t);
+}
+
+// Known packet sequence is checked against telemetry: nominal packets are received while device does not play, the
+// first one finds FIFO empty and level grows by a packet each time. Device queues a feedback value after first packet
+// and after each one is sent, the last one is still queued when host stops.
+static bool audio_check_telemetry(void) {
+  uint16_t const packet_bytes = (uint16_t) ((audio_host.fb_nominal >> 16) * 2);
+  audio_telemetry_t tele;
+
+  TU_VERIFY(tud_audio_telemetry_clear());
+  TU_VERIFY(audio_stream(AUDIO_PREFILL, false));
+  TU_VERIFY(tud_audio_telemetry_get(&tele));
+
+  TU_VERIFY(tele.rx.xfers == AUDIO_PREFILL && tele.rx.underruns == 1 && tele.rx.overruns == 0);
+#if !CFG_TUD_AUDIO_ENABLE_SRC
+  TU_VERIFY(tele.rx.fill_min == packet_bytes && tele.rx.fill_max == AUDIO_PREFILL * packet_bytes);
+#else
+  (void) packet_bytes; // converter already adjusts number of samples
+#endif
+  TU_VERIFY(tele.rx.depth == CFG_TUD_AUDIO_FUNC_1_RX_SUPP_SW_FIFO_SZ);
+#if !CFG_TUD_AUDIO_ENABLE_SRC
+  // next feedback is queued after each one received by host
+  TU_VERIFY(audio_host.fb_count > 0 && tele.fb_count == audio_host.fb_count + 1);
+#else
+  // first feedback is queued by set interface, before telemetry was cleared
+  TU_VERIFY(audio_host.fb_count > 0 && tele.fb_count == audio_host.fb_count);
+#endif
+  TU_VERIFY(tele.fb_trace[(tele.fb_count - 2) % CFG_TUD_AUDIO_TELEMETRY_FB_TRACE] == audio_host.fb_value);
+
+  // host reads the same values, then they are cleared
+  TU_VERIFY(audio_telemetry_request(true));
+  TU_VERIFY(0 == memcmp(&audio_host_telemetry, &tele, sizeof(tele)));
+  TU_VERIFY(tud_audio_telemetry_get(&tele));
+  TU_VERIFY(tele.rx.xfers == 0 && tele.fb_count == 0);
+
+  // received samples are intact
+#if !CFG_TUD_AUDIO_ENABLE_SRC
+  for (uint32_t i = 0; i < audio_host.sent; i++) {
+    int16_t sample;
+    TU_VERIFY(tud_audio_read_support_ff(0, &sample, sizeof(sample)) == sizeof(sample) && sample == (int16_t) i);
+  }
+#endif
+  TU_VERIFY(tud_audio_clear_rx_support_ff(0));
+  return true;
+}
+
+// Device plays at codec clock which is off by AUDIO_CODEC_PPM from nominal rate: host follows it with feedback, or
+// with CFG_TUD_AUDIO_ENABLE_SRC device converts while feedback stays at nominal value. Playback starts when FIFO
+// is half filled.
+#define AUDIO_CODEC_PPM    500
+#define AUDIO_SETTLE_SEC   4 // converter time constant is about 1.4s
+#define AUDIO_MEASURE_SEC  2
+
+static struct {
+  bool playing;
+  uint64_t start_us;
+  uint32_t played;   // samples played since start
+  uint32_t starved;  // samples not available when needed
+  uint32_t next;     // expected value of next sample
+} audio_codec;
+
+static void audio_play(void) {
+  uint16_t const half = CFG_TUD_AUDIO_FUNC_1_RX_SUPP_SW_FIFO_SZ / 2;
+  if (!audio_codec.playing) {
+    audio_codec.playing = (tud_audio_available_support_ff(0) >= half);
+    audio_codec.start_us = sim_usb_time_us();
+    return;
+  }
+
+  uint64_t const elapsed_us = sim_usb_time_us() - audio_codec.start_us;
+  uint32_t const target = (uint32_t) (elapsed_us * AUDIO_SAMPLE_RATE * (1000000 + AUDIO_CODEC_PPM) / 1000000000000ull);
+  while (audio_codec.played < target) {
+    int16_t sample;
+    if (tud_audio_read_support_ff(0, &sample, sizeof(sample)) != sizeof(sample)) {
+      audio_codec.starved += target - audio_codec.played;
+      audio_codec.played = target;
+      break;
+    }
+#if !CFG_TUD_AUDIO_ENABLE_SRC
+    data_error |= (sample != (int16_t) audio_codec.next);
+#endif
+    audio_codec.next++;
+    audio_codec.played++;
+  }
+}
+
+static bool audio_check_closed_loop(void) {
+  uint32_t const packets_per_sec = AUDIO_SAMPLE_RATE / (audio_host.fb_nominal >> 16);
+  uint32_t const measure_start = audio_host.packets + AUDIO_SETTLE_SEC * packets_per_sec;
+  uint64_t const timeout = sim_usb_time_us() + TIMEOUT_US;
+  bool measuring = false;
+  uint32_t fb_min = UINT32_MAX, fb_max = 0;
+
+  tu_memclr(&audio_codec, sizeof(audio_codec));
+  audio_codec.next = audio_host.sent;
+  audio_stream_begin((AUDIO_SETTLE_SEC + AUDIO_MEASURE_SEC) * packets_per_sec, true);
+
+  while (audio_host.out_busy || audio_host.fb_busy) {
+    run_tasks();
+    audio_play();
+    TU_VERIFY(sim_usb_time_us() < timeout && !data_error);
+
+    if (!measuring && audio_host.packets >= measure_start) {
+      measuring = true;
+      audio_codec.starved = 0;
+      TU_VERIFY(tud_audio_telemetry_clear());
+    }
+    if (measuring) {
+      fb_min = tu_min32(fb_min, audio_host.fb_value);
+      fb_max = tu_max32(fb_max, audio_host.fb_value);
+    }
+  }
+
+  audio_telemetry_t tele;
+  TU_VERIFY(tud_audio_telemetry_get(&tele));
+  TU_VERIFY(audio_codec.playing && audio_codec.starved == 0 && tele.rx.underruns == 0 && tele.rx.overruns == 0);
+
+#if CFG_TUD_AUDIO_ENABLE_SRC
+  TU_VERIFY(fb_min == audio_host.fb_nominal && fb_max == audio_host.fb_nominal);
+#else
+  // codec is faster than nominal rate
+  TU_VERIFY(fb_min > audio_host.fb_nominal && fb_max <= audio_host.fb_nominal + (1u << 16));
+#endif
+  return true;
+}
+#endif
+
+static bool bench_audio(void) {
+#if AUDIO_BULK
+  return audio_open() && audio_check_bulk();
+#else
+  return audio_open() && audio_check_telemetry() && audio_check_closed_loop();
+#endif
+}
+#endif
+
+#if CFG_TUD_VIDEO
+//--------------------------------------------------------------------+
+// Video: host commits the only format of the bulk camera and reads payloads with endpoint API. Each frame is one
+// payload sent from the frame buffer (CFG_TUD_VIDEO_STREAMING_BULK_ZERO_COPY), the rest after first packet is copied
+// through endpoint buffer when its address is not aligned to CFG_TUD_VIDEO_STREAMING_ZERO_COPY_ALIGN.
+//--------------------------------------------------------------------+
+
+// streaming interface, endpoint and YUY2 frame of usb_descriptors.c
+#define ITF_NUM_VIDEO_STREAMING  4
+#define EPNUM_VIDEO_IN           0x85
+#define VIDEO_FRAME_SIZE         (32 * 16 * 2)
+
+static TU_ATTR_ALIGNED(4) uint8_t video_frame_buf[VIDEO_FRAME_SIZE + 2];
+static uint8_t video_rx_buf[VIDEO_FRAME_SIZE + 2];
+static video_probe_and_commit_control_t video_commit;
+static volatile bool video_rx_done;
+static volatile bool video_frame_done;
+static uint32_t video_rx_len;
+
+static void video_rx_cb(tuh_xfer_t* xfer) {
+  data_error |= (xfer->result != XFER_RESULT_SUCCESS);
+  video_rx_len = xfer->actual_len;
+  video_rx_done = true;
+}
+
+static bool video_commit_request(uint8_t request, uint8_t direction) {
+  tusb_control_request_t const req = {
+    .bmRequestType_bit = {
+      .recipient = TUSB_REQ_RCPT_INTERFACE,
+      .type = TUSB_REQ_TYPE_CLASS,
+      .direction = direction
+    },
+    .bRequest = request,
+    .wValue = tu_htole16(VIDEO_VS_CTL_COMMIT << 8),
+    .wIndex = tu_htole16(ITF_NUM_VIDEO_STREAMING),
+    .wLength = tu_htole16(sizeof(video_commit))
+  };
+  tuh_xfer_t xfer = {
+    .daddr = msc_daddr,
+    .ep_addr = 0,
+    .setup = &req,
+    .buffer = (uint8_t*) &video_commit,
+    .complete_cb = desc_complete_cb,
+  };
+
+  desc_done = false;
+  TU_VERIFY(tuh_control_xfer(&xfer));
+  return control_wait() && desc_len == sizeof(video_commit);
+}
+
+// Send a frame of given size and receive it as one payload
+static bool video_frame_check(uint8_t* video_frame, uint32_t size, uint8_t frame_id) {
+  uint64_t const timeout = sim_usb_time_us() + TIMEOUT_US;
+  for (uint32_t i = 0; i < size; i++) {
+    video_frame[i] = (uint8_t) (i * 7 + size);
+  }
+
+  tuh_xfer_t xfer = {
+    .daddr = msc_daddr,
+    .ep_addr = EPNUM_VIDEO_IN,
+    .buflen = video_commit.dwMaxPayloadTransferSize,
+    .buffer = video_rx_buf,
+    .complete_cb = video_rx_cb,
+  };
+  video_rx_done = false;
+  video_frame_done = false;
+  TU_VERIFY(tuh_edpt_xfer(&xfer));
+  TU_VERIFY(tud_video_n_frame_xfer(0, 0, video_frame, size));
+
+  while (!video_rx_done || !video_frame_done) {
+    run_tasks();
+    TU_VERIFY(sim_usb_time_us() < timeout && !data_error);
+  }
+
+  // payload is header and the whole frame: ended by a short packet, a ZLP or its negotiated size
+  tusb_video_payload_header_t const* hdr = (tusb_video_payload_header_t const*) video_rx_buf;
+  TU_VERIFY(video_rx_len == size + sizeof(*hdr) && hdr->bHeaderLength == sizeof(*hdr));
+  TU_VERIFY(hdr->EndOfFrame && hdr->FrameID == frame_id);
+  return 0 == memcmp(video_rx_buf + sizeof(*hdr), video_frame, size);
+}
+
+static bool bench_video(void) {
+  tusb_desc_endpoint_t const desc_ep = {
+    .bLength = sizeof(tusb_desc_endpoint_t),
+    .bDescriptorType = TUSB_DESC_ENDPOINT,
+    .bEndpointAddress = EPNUM_VIDEO_IN,
+    .bmAttributes = { .xfer = TUSB_XFER_BULK },
+    .wMaxPacketSize = tu_htole16(tuh_speed_get(msc_daddr) == TUSB_SPEED_HIGH ? 512 : 64),
+  };
+  TU_VERIFY(tuh_edpt_open(msc_daddr, &desc_ep));
+
+  // device fills in all parameters of the only format and frame
+  tu_memclr(&video_commit, sizeof(video_commit));
+  TU_VERIFY(video_commit_request(VIDEO_REQUEST_SET_CUR, TUSB_DIR_OUT));
+  TU_VERIFY(video_commit_request(VIDEO_REQUEST_GET_CUR, TUSB_DIR_IN));
+  TU_VERIFY(video_commit.dwMaxPayloadTransferSize == VIDEO_FRAME_SIZE + 2);
+
+  uint8_t* const aligned = video_frame_buf;
+  uint8_t* const past_hdr = video_frame_buf + 2; // rest of payload after first packet is aligned
+
+  return video_frame_check(aligned, VIDEO_FRAME_SIZE, 1) &&     // negotiated size, several packets
+         video_frame_check(aligned, VIDEO_FRAME_SIZE - 2, 0) && // multiple of packet size, ended by ZLP
+         video_frame_check(aligned, VIDEO_FRAME_SIZE - 3, 1) && // ended by short packet
+         video_frame_check(aligned, 30, 0) &&                   // single packet
+         video_frame_check(past_hdr, VIDEO_FRAME_SIZE, 1);
+}
+#endif
+
+#if CFG_TUSB_STATS
+// Device and host must count every transfer of the endpoint exactly once
+static bool stats_check_edpt(uint8_t ep_addr, uint32_t bytes, uint32_t dev_xfers, uint32_t host_xfers) {
+  tusb_edpt_stats_t dev, host;
+  TU_VERIFY(tud_stats_get(ep_addr, &dev) && tuh_stats_get(msc_daddr, ep_addr, &host));
+
+  bool const ok = dev.bytes == bytes && host.bytes == bytes && dev.failed == 0 && host.failed == 0 &&
+                  dev.xfers == dev_xfers && host.xfers == host_xfers;
+  if (!ok) {
+    printf("EP %02X stats: bytes %lu/%lu xfers %lu/%lu failed %lu/%lu (device/host), expected bytes %lu xfers %lu/%lu\n",
+           ep_addr, (unsigned long) dev.bytes, (unsigned long) host.bytes, (unsigned long) dev.xfers,
+           (unsigned long) host.xfers, (unsigned long) dev.failed, (unsigned long) host.failed, (unsigned long) bytes,
+           (unsigned long) dev_xfers, (unsigned long) host_xfers);
+  }
+  return ok;
+}
+
+// CDC data is sent in CFG_TUD_CDC_EP_BUFSIZE transfers, plus a possible zero-length packet. MSC command is CBW,
+// data stage and CSW: data stage is one transfer on host and CFG_TUD_MSC_EP_BUFSIZE transfers on device.
+static bool stats_check(bench_t const* b) {
+  uint32_t const n_cmd = total_bytes / (MSC_CMD_BLOCKS * DISK_BLOCK_SIZE);
+  uint32_t const n_dev_data = n_cmd * ((MSC_CMD_BLOCKS * DISK_BLOCK_SIZE) / CFG_TUD_MSC_EP_BUFSIZE);
+
+  if (b->func == bench_cdc_in || b->func == bench_cdc_out) {
+    uint8_t const ep_addr = (b->func == bench_cdc_in) ? EPNUM_CDC_IN : EPNUM_CDC_OUT;
+    uint32_t const n_xfer = total_bytes / CFG_TUD_CDC_EP_BUFSIZE;
+    tusb_edpt_stats_t dev;
+    TU_VERIFY(tud_stats_get(ep_addr, &dev));
+    TU_VERIFY(dev.xfers == n_xfer || dev.xfers == n_xfer + 1); // zero-length packet ends data of full packets
+    return stats_check_edpt(ep_addr, total_bytes, dev.xfers, dev.xfers);
+  } else if (b->func == bench_msc_read) {
+    return stats_check_edpt(EPNUM_MSC_OUT, n_cmd * sizeof(msc_cbw_t), n_cmd, n_cmd) &&
+           stats_check_edpt(EPNUM_MSC_IN, total_bytes + n_cmd * sizeof(msc_csw_t), n_dev_data + n_cmd, 2 * n_cmd);
+  } else if (b->func == bench_msc_write) {
+    return stats_check_edpt(EPNUM_MSC_OUT, total_bytes + n_cmd * sizeof(msc_cbw_t), n_dev_data + n_cmd, 2 * n_cmd) &&
+           stats_check_edpt(EPNUM_MSC_IN, n_cmd * sizeof(msc_csw_t), n_cmd, n_cmd);
+  }
+  return true;
+}
+#endif
+
+static bench_t const bench_list[] = {
+  { "enumerate", bench_enumerate,   0 },
+  { "reattach",  bench_reattach,    0 },
+  { "desc_long", bench_desc_long,   0 },
+  { "cdc_in",    bench_cdc_in,     50 },
+  { "cdc_out",   bench_cdc_out,    50 },
+  { "msc_read",  bench_msc_read,   50 },
+  { "msc_write", bench_msc_write,  50 },
+#if CFG_TUD_AUDIO
+  { "audio",     bench_audio,       0 },
+#endif
+#if CFG_TUD_VIDEO
+  { "video",     bench_video,       0 },
+#endif
+};
+
+int main(int argc, char* argv[]) {
+  sim_usb_config_t cfg = { .speed = TUSB_SPEED_FULL };
+  int opt;
+  while ((opt = getopt(argc, argv, "s:n:f:o:t:c:")) != -1) {
+    switch (opt) {
+      case 's': cfg.speed = (0 == strcmp(optarg, "high")) ? TUSB_SPEED_HIGH : TUSB_SPEED_FULL; break;
+      case 'n': total_bytes = (uint32_t) strtoul(optarg, NULL, 0); break;
+      case 'f': cfg.frame_bytes = (uint16_t) strtoul(optarg, NULL, 0); break;
+      case 'o': cfg.packet_overhead = (uint16_t) strtoul(optarg, NULL, 0); break;
+#if CFG_TUSB_DEBUG_TRACE
+      case 't':
+        trace_file = fopen(optarg, "wb");
+        if (!trace_file) {
+          perror(optarg);
+          return 2;
+        }
+        break;
+#endif
+#if CFG_TUSB_CAPTURE
+      case 'c':
+        capture_file = fopen(optarg, "wb");
+        if (!capture_file) {
+          perror(optarg);
+          return 2;
+        }
+        break;
+#endif
+      default:
+        fprintf(stderr, "Usage: %s [-s full|high] [-n bytes] [-f frame_bytes] [-o packet_overhead] [-t trace_file] "
+                "[-c pcapng_file]\n", argv[0]);
+        return 2;
+    }
+  }
+
+#if CFG_TUSB_DEBUG_TRACE
+  // known records checked after decoding by make trace
+  static char const trace_mem[] = "TinyUSB trace round trip";
+  TU_LOG1("Trace: %d %u 0x%lX %s %c\r\n", -2, 42u, 0xCAFEul, "sim", 'T');
+  TU_LOG1_MEM(trace_mem, sizeof(trace_mem) - 1, 2);
+#endif
+
+  // MSC transfers whole commands
+  total_bytes = tu_max32(MSC_CMD_BLOCKS * DISK_BLOCK_SIZE, total_bytes - total_bytes % (MSC_CMD_BLOCKS * DISK_BLOCK_SIZE));
+
+  for (uint32_t i = 0; i < sizeof(msc_disk); i++) {
+    msc_disk[i / DISK_BLOCK_SIZE][i % DISK_BLOCK_SIZE] = pattern(i * 3);
+  }
+
+  sim_usb_configure(&cfg);
+
+  tusb_rhport_init_t const dev_init = { .role = TUSB_ROLE_DEVICE, .speed = TUSB_SPEED_AUTO };
+  tusb_init(BOARD_TUD_RHPORT, &dev_init);
+
+  tusb_rhport_init_t const host_init = { .role = TUSB_ROLE_HOST, .speed = TUSB_SPEED_AUTO };
+  tusb_init(BOARD_TUH_RHPORT, &host_init);
+
+  // bulk capacity of the link with configured bandwidth and overhead
+  bool const is_hs = (cfg.speed == TUSB_SPEED_HIGH);
+  uint32_t const mps = is_hs ? 512 : 64;
+  uint32_t const frame_bytes = cfg.frame_bytes ? cfg.frame_bytes : (is_hs ? 7500 : 1500);
+  uint32_t const overhead = cfg.packet_overhead ? cfg.packet_overhead : (is_hs ? 55 : 13);
+  uint32_t const capacity = (frame_bytes / (mps + overhead)) * mps * (is_hs ? 8000 : 1000);
+
+  printf("Link: %s speed, bulk capacity %lu KB/s, %lu bytes per test\n", is_hs ? "high" : "full",
+         (unsigned long) (capacity / 1000), (unsigned long) total_bytes);
+  printf("%-10s %10s %10s %6s  %s\n", "test", "time (us)", "KB/s", "bus %", "result");
+
+  int failed = 0;
+  for (size_t i = 0; i < TU_ARRAY_SIZE(bench_list); i++) {
+    bench_t const* b = &bench_list[i];
+#if CFG_TUSB_STATS
+    if (b->min_percent) {
+      tud_stats_clear();
+      tuh_stats_clear(msc_daddr);
+    }
+#endif
+    uint64_t const start = sim_usb_time_us();
+    bool pass = b->func();
+    uint64_t const elapsed = sim_usb_time_us() - start;
+
+    if (b->min_percent) {
+      uint64_t const rate = elapsed ? ((uint64_t) total_bytes * 1000000u / elapsed) : 0;
+      uint32_t const percent = (uint32_t) (rate * 100 / capacity);
+      pass = pass && (percent >= b->min_percent);
+#if CFG_TUSB_STATS
+      pass = pass && stats_check(b);
+#endif
+      printf("%-10s %10lu %10lu %5lu%%  %s\n", b->name, (unsigned long) elapsed, (unsigned long) (rate / 1000),
+             (unsigned long) percent, pass ? "PASS" : "FAIL");
+    } else {
+      printf("%-10s %10lu %10s %6s  %s\n", b->name, (unsigned long) elapsed, "-", "-", pass ? "PASS" : "FAIL");
+    }
+
+    if (!pass) {
+      failed++;
+      if (i == 0) {
+        break; // nothing else can run without enumeration
+      }
+    }
+  }
+
+#if CFG_TUSB_DEBUG_TRACE
+  trace_drain();
+  if (trace_file) {
+    fclose(trace_file);
+  }
+#endif
+#if CFG_TUSB_CAPTURE
+  capture_drain();
+  if (capture_file) {
+    fclose(capture_file);
+  }
+#endif
+
+  return failed ? 1 : 0;
+}
+
+//--------------------------------------------------------------------+
+// Host callbacks
+//--------------------------------------------------------------------+
+
+void tuh_cdc_mount_cb(uint8_t idx) {
+  // DTR/RTS is asserted by the stack during enumeration (CFG_TUH_CDC_LINE_CONTROL_ON_ENUM)
+  cdc_idx = idx;
+}
+
+void tuh_cdc_umount_cb(uint8_t idx) {
+  (void) idx;
+  cdc_idx = TUSB_INDEX_INVALID_8;
+}
+
+void tuh_msc_mount_cb(uint8_t dev_addr) {
+  msc_daddr = dev_addr;
+}
+
+void tuh_msc_umount_cb(uint8_t dev_addr) {
+  (void) dev_addr;
+  msc_daddr = 0;
+}
+
+//--------------------------------------------------------------------+
+// Device MSC callbacks: RAM disk
+//--------------------------------------------------------------------+
+
+void tud_msc_inquiry_cb(uint8_t lun, uint8_t vendor_id[8], uint8_t product_id[16], uint8_t product_rev[4]) {
+  (void) lun;
+  memcpy(vendor_id, "TinyUSB ", 8);
+  memcpy(product_id, "Sim RAM Disk    ", 16);
+  memcpy(product_rev, "1.0 ", 4);
+}
+
+bool tud_msc_test_unit_ready_cb(uint8_t lun) {
+  (void) lun;
+  return true;
+}
+
+void tud_msc_capacity_cb(uint8_t lun, uint32_t* block_count, uint16_t* block_size) {
+  (void) lun;
+  *block_count = DISK_BLOCK_NUM;
+  *block_size = DISK_BLOCK_SIZE;
+}
+
+int32_t tud_msc_read10_cb(uint8_t lun, uint32_t lba, uint32_t offset, void* buffer, uint32_t bufsize) {
+  (void) lun;
+  TU_VERIFY(lba < DISK_BLOCK_NUM && offset + bufsize <= DISK_BLOCK_SIZE * (DISK_BLOCK_NUM - lba), -1);
+  memcpy(buffer, msc_disk[lba] + offset, bufsize);
+  return (int32_t) bufsize;
+}
+
+int32_t tud_msc_write10_cb(uint8_t lun, uint32_t lba, uint32_t offset, uint8_t* buffer, uint32_t bufsize) {
+  (void) lun;
+  TU_VERIFY(lba < DISK_BLOCK_NUM && offset + bufsize <= DISK_BLOCK_SIZE * (DISK_BLOCK_NUM - lba), -1);
+  memcpy(msc_disk[lba] + offset, buffer, bufsize);
+  return (int32_t) bufsize;
+}
+
+int32_t tud_msc_scsi_cb(uint8_t lun, uint8_t const scsi_cmd[16], void* buffer, uint16_t bufsize) {
+  (void) buffer;
+  (void) bufsize;
+  tud_msc_set_sense(lun, SCSI_SENSE_ILLEGAL_REQUEST, 0x20, 0x00);
+  (void) scsi_cmd;
+  return -1;
+}
+
+#if CFG_TUD_AUDIO
+//--------------------------------------------------------------------+
+// Device Audio callbacks
+//--------------------------------------------------------------------+
+
+#if CFG_TUD_AUDIO_ENABLE_FEEDBACK_EP
+void tud_audio_feedback_params_cb(uint8_t func_id, uint8_t alt_itf, audio_feedback_params_t* feedback_param) {
+  (void) func_id;
+  (void) alt_itf;
+  feedback_param->method = AUDIO_FEEDBACK_METHOD_FIFO_COUNT;
+  feedback_param->sample_freq = AUDIO_SAMPLE_RATE;
+}
+#endif
+
+bool tud_vendor_control_xfer_cb(uint8_t rhport, uint8_t stage, tusb_control_request_t const* request) {
+  return tud_audio_telemetry_control_xfer_cb(rhport, stage, request);
+}
+#endif
+
+#if CFG_TUD_VIDEO
+//--------------------------------------------------------------------+
+// Device Video callbacks
+//--------------------------------------------------------------------+
+
+void tud_video_frame_xfer_complete_cb(uint_fast8_t ctl_idx, uint_fast8_t stm_idx) {
+  (void) ctl_idx;
+  (void) stm_idx;
+  video_frame_done = true;
+}
+#endif
@@ -0,0 +1,161 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025, Ha Thach (tinyusb.org)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * This file is part of the TinyUSB stack.
+ */
+
+#ifndef TUSB_CONFIG_H_
+#define TUSB_CONFIG_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+//--------------------------------------------------------------------
+// COMMON CONFIGURATION
+//--------------------------------------------------------------------
+
+#define CFG_TUSB_MCU              OPT_MCU_SIM
+#define CFG_TUSB_OS               OPT_OS_NONE
+
+#ifndef CFG_TUSB_DEBUG
+#define CFG_TUSB_DEBUG            0
+#endif
+
+// device on rhport 0 is wired to host on rhport 1
+#define BOARD_TUD_RHPORT          0
+#define BOARD_TUH_RHPORT          1
+
+#define CFG_TUD_ENABLED           1
+#define CFG_TUD_MAX_SPEED         OPT_MODE_HIGH_SPEED
+
+#define CFG_TUH_ENABLED           1
+#define CFG_TUH_MAX_SPEED         OPT_MODE_HIGH_SPEED
+
+//--------------------------------------------------------------------
+// DEVICE CONFIGURATION
+//--------------------------------------------------------------------
+
+#define CFG_TUD_ENDPOINT0_SIZE    64
+
+#define CFG_TUD_CDC               1
+#define CFG_TUD_MSC               1
+
+#define CFG_TUD_CDC_RX_BUFSIZE    4096
+#define CFG_TUD_CDC_TX_BUFSIZE    4096
+#define CFG_TUD_CDC_EP_BUFSIZE    512
+
+#define CFG_TUD_MSC_EP_BUFSIZE    4096
+
+// UAC2 mono speaker with feedback EP, enabled with make AUDIO=1
+#ifndef CFG_TUD_AUDIO
+#define CFG_TUD_AUDIO             0
+#endif
+
+// Speaker has a bulk AS EP without feedback instead, make AUDIO_BULK=n receives n packets per transfer
+#ifndef AUDIO_BULK
+#define AUDIO_BULK                0
+#endif
+
+#if CFG_TUD_AUDIO
+#define CFG_TUD_AUDIO_FUNC_1_N_AS_INT               1
+#define CFG_TUD_AUDIO_FUNC_1_CTRL_BUF_SZ            64
+
+#define CFG_TUD_AUDIO_ENABLE_EP_OUT                 1
+#define CFG_TUD_AUDIO_FUNC_1_N_CHANNELS_RX          1
+#define CFG_TUD_AUDIO_FUNC_1_N_BYTES_PER_SAMPLE_RX  2
+
+#define CFG_TUD_AUDIO_ENABLE_DECODING               1
+#define CFG_TUD_AUDIO_ENABLE_TYPE_I_DECODING        1
+#define CFG_TUD_AUDIO_FUNC_1_CHANNEL_PER_FIFO_RX    1
+#define CFG_TUD_AUDIO_FUNC_1_N_RX_SUPP_SW_FIFO      1
+
+#if AUDIO_BULK
+#define CFG_TUD_AUDIO_FUNC_1_DESC_LEN               (TUD_AUDIO_SPEAKER_MONO_FB_DESC_LEN - TUD_AUDIO_DESC_CS_AS_ISO_EP_LEN - TUD_AUDIO_DESC_STD_AS_ISO_FB_EP_LEN)
+#define CFG_TUD_AUDIO_ENABLE_FEEDBACK_EP            0
+#define CFG_TUD_AUDIO_XFER_BATCH                    AUDIO_BULK
+
+#define CFG_TUD_AUDIO_FUNC_1_EP_OUT_SZ_MAX          512
+#define CFG_TUD_AUDIO_FUNC_1_EP_OUT_SW_BUF_SZ       (CFG_TUD_AUDIO_XFER_BATCH * CFG_TUD_AUDIO_FUNC_1_EP_OUT_SZ_MAX)
+
+// test drains support FIFO after each step of simulation
+#define CFG_TUD_AUDIO_FUNC_1_RX_SUPP_SW_FIFO_SZ     (4 * CFG_TUD_AUDIO_FUNC_1_EP_OUT_SW_BUF_SZ)
+#else
+#define CFG_TUD_AUDIO_FUNC_1_DESC_LEN               TUD_AUDIO_SPEAKER_MONO_FB_DESC_LEN
+#define CFG_TUD_AUDIO_ENABLE_FEEDBACK_EP            1
+
+// 48 kHz with one spare sample per frame: 49 samples at full speed, 7 at high speed
+#define CFG_TUD_AUDIO_FUNC_1_EP_OUT_SZ_MAX          (49 * 2)
+#define CFG_TUD_AUDIO_FUNC_1_EP_OUT_SW_BUF_SZ       (4 * CFG_TUD_AUDIO_FUNC_1_EP_OUT_SZ_MAX)
+
+// samples are played from support FIFO of 16 ms
+#define CFG_TUD_AUDIO_FUNC_1_RX_SUPP_SW_FIFO_SZ     (16 * 48 * 2)
+#endif
+
+#define CFG_TUD_AUDIO_ENABLE_TELEMETRY              1
+#endif
+
+// UVC camera with bulk streaming EP sending frames from frame buffer, enabled with make VIDEO=1
+#ifndef CFG_TUD_VIDEO
+#define CFG_TUD_VIDEO             0
+#endif
+
+#if CFG_TUD_VIDEO
+#define CFG_TUD_VIDEO_STREAMING                 1
+#define CFG_TUD_VIDEO_STREAMING_EP_BUFSIZE      1024
+#define CFG_TUD_VIDEO_STREAMING_BULK_ZERO_COPY  1
+#endif
+
+//--------------------------------------------------------------------
+// HOST CONFIGURATION
+//--------------------------------------------------------------------
+
+#define CFG_TUH_ENUMERATION_BUFSIZE 512
+
+// remember configuration of the device so that re-attach skips string/configuration descriptors
+#define CFG_TUH_ENUMERATION_CACHE   1
+
+#define CFG_TUH_HUB               0
+#define CFG_TUH_DEVICE_MAX        1
+
+#define CFG_TUH_CDC               1
+#define CFG_TUH_MSC               1
+
+#define CFG_TUH_CDC_RX_BUFSIZE    4096
+#define CFG_TUH_CDC_TX_BUFSIZE    4096
+#define CFG_TUH_CDC_RX_EPSIZE     512
+#define CFG_TUH_CDC_TX_EPSIZE     512
+
+// assert DTR (bit 0) and RTS (bit 1) when enumerated so that device considers the port connected
+#define CFG_TUH_CDC_LINE_CONTROL_ON_ENUM  0x03
+
+// audio and video streams are driven by application with endpoint API, there is no host audio or video driver
+#if CFG_TUD_AUDIO || CFG_TUD_VIDEO
+#define CFG_TUH_API_EDPT_XFER     1
+#endif
+
+#ifdef __cplusplus
+ }
+#endif
+
+#endif
@@ -0,0 +1,219 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025, Ha Thach (tinyusb.org)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * This file is part of the TinyUSB stack.
+ */
+
+#include "tusb.h"
+
+#define USB_VID   0xCafe
+#define USB_PID   0x4003
+#define USB_BCD   0x0200
+
+//--------------------------------------------------------------------+
+// Device Descriptors
+//--------------------------------------------------------------------+
+tusb_desc_device_t const desc_device = {
+  .bLength            = sizeof(tusb_desc_device_t),
+  .bDescriptorType    = TUSB_DESC_DEVICE,
+  .bcdUSB             = USB_BCD,
+
+  // Use Interface Association Descriptor (IAD) for CDC
+  .bDeviceClass       = TUSB_CLASS_MISC,
+  .bDeviceSubClass    = MISC_SUBCLASS_COMMON,
+  .bDeviceProtocol    = MISC_PROTOCOL_IAD,
+
+  .bMaxPacketSize0    = CFG_TUD_ENDPOINT0_SIZE,
+
+  .idVendor           = USB_VID,
+  .idProduct          = USB_PID,
+  .bcdDevice          = 0x0100,
+
+  .iManufacturer      = 0x01,
+  .iProduct           = 0x02,
+  .iSerialNumber      = 0x03,
+
+  .bNumConfigurations = 0x01
+};
+
+uint8_t const* tud_descriptor_device_cb(void) {
+  return (uint8_t const*) &desc_device;
+}
+
+//--------------------------------------------------------------------+
+// Configuration Descriptor
+//--------------------------------------------------------------------+
+
+enum {
+  ITF_NUM_CDC = 0,
+  ITF_NUM_CDC_DATA,
+  ITF_NUM_MSC,
+#if CFG_TUD_VIDEO
+  ITF_NUM_VIDEO_CONTROL,
+  ITF_NUM_VIDEO_STREAMING,
+#endif
+#if CFG_TUD_AUDIO
+  ITF_NUM_AUDIO_CONTROL,
+  ITF_NUM_AUDIO_STREAMING,
+#endif
+  ITF_NUM_TOTAL
+};
+
+#define EPNUM_CDC_NOTIF   0x81
+#define EPNUM_CDC_OUT     0x02
+#define EPNUM_CDC_IN      0x82
+#define EPNUM_MSC_OUT     0x03
+#define EPNUM_MSC_IN      0x83
+#define EPNUM_AUDIO_OUT   0x04
+#define EPNUM_AUDIO_FB    0x84
+#define EPNUM_VIDEO_IN    0x85
+
+#if CFG_TUD_AUDIO && AUDIO_BULK
+  #define AUDIO_DESC_LEN  CFG_TUD_AUDIO_FUNC_1_DESC_LEN
+  // Mono 16-bit speaker as TUD_AUDIO_SPEAKER_MONO_FB_DESCRIPTOR(), but streaming interface has a single bulk EP
+  #define AUDIO_BULK_DESCRIPTOR(_epsize) \
+    TUD_AUDIO_DESC_IAD(ITF_NUM_AUDIO_CONTROL, 0x02, 0x00), \
+    TUD_AUDIO_DESC_STD_AC(ITF_NUM_AUDIO_CONTROL, 0x00, 6), \
+    TUD_AUDIO_DESC_CS_AC(0x0200, AUDIO_FUNC_DESKTOP_SPEAKER, TUD_AUDIO_DESC_CLK_SRC_LEN + TUD_AUDIO_DESC_INPUT_TERM_LEN + TUD_AUDIO_DESC_OUTPUT_TERM_LEN + TUD_AUDIO_DESC_FEATURE_UNIT_ONE_CHANNEL_LEN, AUDIO_CS_AS_INTERFACE_CTRL_LATENCY_POS), \
+    TUD_AUDIO_DESC_CLK_SRC(0x04, AUDIO_CLOCK_SOURCE_ATT_INT_FIX_CLK, (AUDIO_CTRL_R << AUDIO_CLOCK_SOURCE_CTRL_CLK_FRQ_POS), 0x01, 0x00), \
+    TUD_AUDIO_DESC_INPUT_TERM(0x01, AUDIO_TERM_TYPE_USB_STREAMING, 0x00, 0x04, 0x01, AUDIO_CHANNEL_CONFIG_NON_PREDEFINED, 0x00, 0, 0x00), \
+    TUD_AUDIO_DESC_OUTPUT_TERM(0x03, AUDIO_TERM_TYPE_OUT_DESKTOP_SPEAKER, 0x01, 0x02, 0x04, 0x0000, 0x00), \
+    TUD_AUDIO_DESC_FEATURE_UNIT_ONE_CHANNEL(0x02, 0x01, AUDIO_CTRL_RW << AUDIO_FEATURE_UNIT_CTRL_MUTE_POS, AUDIO_CTRL_RW << AUDIO_FEATURE_UNIT_CTRL_MUTE_POS, 0x00), \
+    TUD_AUDIO_DESC_STD_AS_INT(ITF_NUM_AUDIO_STREAMING, 0x00, 0x00, 0x00), \
+    TUD_AUDIO_DESC_STD_AS_INT(ITF_NUM_AUDIO_STREAMING, 0x01, 0x01, 0x00), \
+    TUD_AUDIO_DESC_CS_AS_INT(0x01, AUDIO_CTRL_NONE, AUDIO_FORMAT_TYPE_I, AUDIO_DATA_FORMAT_TYPE_I_PCM, 0x01, AUDIO_CHANNEL_CONFIG_NON_PREDEFINED, 0x00), \
+    TUD_AUDIO_DESC_TYPE_I_FORMAT(2, 16), \
+    TUD_AUDIO_DESC_STD_AS_ISO_EP(EPNUM_AUDIO_OUT, TUSB_XFER_BULK, _epsize, 0x00),
+  #define AUDIO_FS_DESCRIPTOR  AUDIO_BULK_DESCRIPTOR(64)
+  #define AUDIO_HS_DESCRIPTOR  AUDIO_BULK_DESCRIPTOR(512)
+#elif CFG_TUD_AUDIO
+  #define AUDIO_DESC_LEN  TUD_AUDIO_SPEAKER_MONO_FB_DESC_LEN
+  // 48 kHz mono 16-bit with one spare sample per (micro)frame, feedback is 16.16 format at both speeds
+  #define AUDIO_FS_DESCRIPTOR \
+    TUD_AUDIO_SPEAKER_MONO_FB_DESCRIPTOR(ITF_NUM_AUDIO_CONTROL, 6, 2, 16, EPNUM_AUDIO_OUT, 49 * 2, EPNUM_AUDIO_FB, 4),
+  #define AUDIO_HS_DESCRIPTOR \
+    TUD_AUDIO_SPEAKER_MONO_FB_DESCRIPTOR(ITF_NUM_AUDIO_CONTROL, 6, 2, 16, EPNUM_AUDIO_OUT, 7 * 2, EPNUM_AUDIO_FB, 4),
+#else
+  #define AUDIO_DESC_LEN  0
+  #define AUDIO_FS_DESCRIPTOR
+  #define AUDIO_HS_DESCRIPTOR
+#endif
+
+#if CFG_TUD_VIDEO
+  #define VIDEO_DESC_LEN (TUD_VIDEO_DESC_IAD_LEN + TUD_VIDEO_DESC_STD_VC_LEN + (TUD_VIDEO_DESC_CS_VC_LEN + 1) + \
+                          TUD_VIDEO_DESC_CAMERA_TERM_LEN + TUD_VIDEO_DESC_OUTPUT_TERM_LEN + TUD_VIDEO_DESC_STD_VS_LEN + \
+                          (TUD_VIDEO_DESC_CS_VS_IN_LEN + 1) + VIDEO_FMT_FRM_LEN + 7)
+  #define VIDEO_FMT_FRM_LEN (TUD_VIDEO_DESC_CS_VS_FMT_UNCOMPR_LEN + TUD_VIDEO_DESC_CS_VS_FRM_UNCOMPR_CONT_LEN + \
+                             TUD_VIDEO_DESC_CS_VS_COLOR_MATCHING_LEN)
+  // YUY2 camera of 32x16 at 10 fps, streaming interface alt 0 has the bulk EP
+  #define VIDEO_DESCRIPTOR(_epsize) \
+    TUD_VIDEO_DESC_IAD(ITF_NUM_VIDEO_CONTROL, 0x02, 7), \
+    TUD_VIDEO_DESC_STD_VC(ITF_NUM_VIDEO_CONTROL, 0, 7), \
+    TUD_VIDEO_DESC_CS_VC(0x0150, TUD_VIDEO_DESC_CAMERA_TERM_LEN + TUD_VIDEO_DESC_OUTPUT_TERM_LEN, 27000000, ITF_NUM_VIDEO_STREAMING), \
+    TUD_VIDEO_DESC_CAMERA_TERM(0x01, 0, 0, 0, 0, 0, 0), \
+    TUD_VIDEO_DESC_OUTPUT_TERM(0x02, VIDEO_TT_STREAMING, 0, 1, 0), \
+    TUD_VIDEO_DESC_STD_VS(ITF_NUM_VIDEO_STREAMING, 0, 1, 7), \
+    TUD_VIDEO_DESC_CS_VS_INPUT(1, VIDEO_FMT_FRM_LEN, EPNUM_VIDEO_IN, 0, 0x02, 0, 0, 0, 0), \
+    TUD_VIDEO_DESC_CS_VS_FMT_UNCOMPR(1, 1, TUD_VIDEO_GUID_YUY2, 16, 1, 0, 0, 0, 0), \
+    TUD_VIDEO_DESC_CS_VS_FRM_UNCOMPR_CONT(1, 0, 32, 16, 32 * 16 * 16, 32 * 16 * 16 * 10, 32 * 16 * 2, \
+                                          1000000, 1000000, 1000000, 1000000), \
+    TUD_VIDEO_DESC_CS_VS_COLOR_MATCHING(VIDEO_COLOR_PRIMARIES_BT709, VIDEO_COLOR_XFER_CH_BT709, VIDEO_COLOR_COEF_SMPTE170M), \
+    TUD_VIDEO_DESC_EP_BULK(EPNUM_VIDEO_IN, _epsize, 1),
+  #define VIDEO_FS_DESCRIPTOR  VIDEO_DESCRIPTOR(64)
+  #define VIDEO_HS_DESCRIPTOR  VIDEO_DESCRIPTOR(512)
+#else
+  #define VIDEO_DESC_LEN  0
+  #define VIDEO_FS_DESCRIPTOR
+  #define VIDEO_HS_DESCRIPTOR
+#endif
+
+#define CONFIG_TOTAL_LEN  (TUD_CONFIG_DESC_LEN + TUD_CDC_DESC_LEN + TUD_MSC_DESC_LEN + VIDEO_DESC_LEN + AUDIO_DESC_LEN)
+
+uint8_t const desc_fs_configuration[] = {
+  TUD_CONFIG_DESCRIPTOR(1, ITF_NUM_TOTAL, 0, CONFIG_TOTAL_LEN, 0x00, 100),
+  TUD_CDC_DESCRIPTOR(ITF_NUM_CDC, 4, EPNUM_CDC_NOTIF, 8, EPNUM_CDC_OUT, EPNUM_CDC_IN, 64),
+  TUD_MSC_DESCRIPTOR(ITF_NUM_MSC, 5, EPNUM_MSC_OUT, EPNUM_MSC_IN, 64),
+  VIDEO_FS_DESCRIPTOR
+  AUDIO_FS_DESCRIPTOR
+};
+
+uint8_t const desc_hs_configuration[] = {
+  TUD_CONFIG_DESCRIPTOR(1, ITF_NUM_TOTAL, 0, CONFIG_TOTAL_LEN, 0x00, 100),
+  TUD_CDC_DESCRIPTOR(ITF_NUM_CDC, 4, EPNUM_CDC_NOTIF, 8, EPNUM_CDC_OUT, EPNUM_CDC_IN, 512),
+  TUD_MSC_DESCRIPTOR(ITF_NUM_MSC, 5, EPNUM_MSC_OUT, EPNUM_MSC_IN, 512),
+  VIDEO_HS_DESCRIPTOR
+  AUDIO_HS_DESCRIPTOR
+};
+
+// link speed is chosen by the simulation, configuration follows the enumerated speed
+uint8_t const* tud_descriptor_configuration_cb(uint8_t index) {
+  (void) index;
+  return (tud_speed_get() == TUSB_SPEED_HIGH) ? desc_hs_configuration : desc_fs_configuration;
+}
+
+//--------------------------------------------------------------------+
+// String Descriptors
+//--------------------------------------------------------------------+
+
+char const* string_desc_arr[] = {
+  (const char[]) { 0x09, 0x04 }, // 0: is supported language is English (0x0409)
+  "TinyUSB",                     // 1: Manufacturer
+  "TinyUSB Sim Device",          // 2: Product
+  "123456",                      // 3: Serials
+  "TinyUSB CDC",                 // 4: CDC Interface
+  "TinyUSB MSC",                 // 5: MSC Interface
+  "TinyUSB Speaker",             // 6: Audio Interface
+  "TinyUSB Camera",              // 7: Video Interface
+};
+
+static uint16_t _desc_str[32 + 1];
+
+uint16_t const* tud_descriptor_string_cb(uint8_t index, uint16_t langid) {
+  (void) langid;
+  size_t chr_count;
+
+  if (index == 0) {
+    memcpy(&_desc_str[1], string_desc_arr[0], 2);
+    chr_count = 1;
+  } else {
+    if (index >= sizeof(string_desc_arr) / sizeof(string_desc_arr[0])) {
+      return NULL;
+    }
+
+    const char* str = string_desc_arr[index];
+    chr_count = strlen(str);
+    size_t const max_count = sizeof(_desc_str) / sizeof(_desc_str[0]) - 1;
+    if (chr_count > max_count) {
+      chr_count = max_count;
+    }
+
+    for (size_t i = 0; i < chr_count; i++) {
+      _desc_str[1 + i] = str[i];
+    }
+  }
+
+  // first byte is length (including header), second byte is string type
+  _desc_str[0] = (uint16_t) ((TUSB_DESC_STRING << 8) | (2 * chr_count + 2));
+
+  return _desc_str;
+}
@@ -0,0 +1,285 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Ha Thach (tinyusb.org)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * This file is part of the TinyUSB stack.
+ */
+
+// Micro benchmark of Type I PCM (de)interleave kernels used by audio device encoding/decoding, result is printed
+// only. Each case compares against the previous generic word loop, and verifies the result with a byte by byte
+// copy as described by the spec so that it is still a meaningful test.
+// By default each kernel only runs once so that test:all stays fast, define BENCH_ROUNDS e.g 20000 to measure.
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "unity.h"
+
+#include "audio_pcm.h"
+
+#define BENCH_FRAMES      192 // 1ms of 192 kHz
+#ifndef BENCH_ROUNDS
+#define BENCH_ROUNDS      1
+#endif
+#define CHANNEL_PER_FIFO  2
+
+// stream has up to 8 channels x 4 bytes
+TU_ATTR_ALIGNED(4) static uint8_t stream_buf[BENCH_FRAMES * 8 * 4];
+TU_ATTR_ALIGNED(4) static uint8_t ff_buf[BENCH_FRAMES * 8 * 4];
+TU_ATTR_ALIGNED(4) static uint8_t ref_buf[BENCH_FRAMES * 8 * 4];
+
+static volatile uint32_t sink; // prevent optimizing away
+
+void setUp(void) {
+  for (uint32_t i = 0; i < sizeof(stream_buf); i++) {
+    stream_buf[i] = (uint8_t) (i * 7 + 1);
+  }
+  memset(ff_buf, 0, sizeof(ff_buf));
+  memset(ref_buf, 0, sizeof(ref_buf));
+}
+
+void tearDown(void) {
+}
+
+// Reference: previous driver helpers, fixed 2 channels per FIFO, word copy with run-time sample size
+static void* ref_decode(uint16_t const nBytesPerSample, void* dst, const void* dst_end, void* src, uint8_t const n_ff_used) {
+  uint16_t* dst16 = dst;
+  uint16_t* src16 = src;
+  const uint16_t* dst_end16 = dst_end;
+  uint32_t* dst32 = dst;
+  uint32_t* src32 = src;
+  const uint32_t* dst_end32 = dst_end;
+
+  if (nBytesPerSample == 1) {
+    while (dst16 < dst_end16) {
+      *dst16++ = *src16++;
+      src16 += n_ff_used - 1;
+    }
+    return src16;
+  } else if (nBytesPerSample == 2) {
+    while (dst32 < dst_end32) {
+      *dst32++ = *src32++;
+      src32 += n_ff_used - 1;
+    }
+    return src32;
+  } else if (nBytesPerSample == 3) {
+    while (dst16 < dst_end16) {
+      *dst16++ = *src16++;
+      *dst16++ = *src16++;
+      *dst16++ = *src16++;
+      src16 += 3 * (n_ff_used - 1);
+    }
+    return src16;
+  } else {
+    while (dst32 < dst_end32) {
+      *dst32++ = *src32++;
+      *dst32++ = *src32++;
+      src32 += 2 * (n_ff_used - 1);
+    }
+    return src32;
+  }
+}
+
+static void* ref_encode(uint16_t const nBytesPerSample, void* src, const void* src_end, void* dst, uint8_t const n_ff_used) {
+  uint16_t* dst16 = dst;
+  uint16_t* src16 = src;
+  const uint16_t* src_end16 = src_end;
+  uint32_t* dst32 = dst;
+  uint32_t* src32 = src;
+  const uint32_t* src_end32 = src_end;
+
+  if (nBytesPerSample == 1) {
+    while (src16 < src_end16) {
+      *dst16++ = *src16++;
+      dst16 += n_ff_used - 1;
+    }
+    return dst16;
+  } else if (nBytesPerSample == 2) {
+    while (src32 < src_end32) {
+      *dst32++ = *src32++;
+      dst32 += n_ff_used - 1;
+    }
+    return dst32;
+  } else if (nBytesPerSample == 3) {
+    while (src16 < src_end16) {
+      *dst16++ = *src16++;
+      *dst16++ = *src16++;
+      *dst16++ = *src16++;
+      dst16 += 3 * (n_ff_used - 1);
+    }
+    return dst16;
+  } else {
+    while (src32 < src_end32) {
+      *dst32++ = *src32++;
+      *dst32++ = *src32++;
+      dst32 += 2 * (n_ff_used - 1);
+    }
+    return dst32;
+  }
+}
+
+// Byte by byte copy of each sample as described by the spec, used to verify both implementations
+static void spec_deinterleave(uint8_t* ff, uint8_t const* src, uint16_t n_frames, uint8_t n_bytes, uint8_t n_channels) {
+  for (uint16_t f = 0; f < n_frames; f++) {
+    for (uint8_t ch = 0; ch < n_channels; ch++) {
+      uint8_t* dst = ff + (ch / CHANNEL_PER_FIFO) * n_frames * CHANNEL_PER_FIFO * n_bytes +
+                     (f * CHANNEL_PER_FIFO + ch % CHANNEL_PER_FIFO) * n_bytes;
+      for (uint8_t b = 0; b < n_bytes; b++) {
+        *dst++ = *src++;
+      }
+    }
+  }
+}
+
+static double msample_per_sec(clock_t start, uint8_t n_channels) {
+  double const sec = (double) (clock() - start) / CLOCKS_PER_SEC;
+  return ((double) BENCH_ROUNDS * BENCH_FRAMES * n_channels) / sec / 1e6;
+}
+
+static void bench_decode(uint8_t n_bytes, uint8_t n_channels) {
+  uint8_t const n_ff = n_channels / CHANNEL_PER_FIFO;
+  uint8_t const slot_size = CHANNEL_PER_FIFO * n_bytes;
+  uint16_t const ff_len = BENCH_FRAMES * slot_size;
+  void const* end[8 / CHANNEL_PER_FIFO];
+  clock_t start;
+
+  start = clock();
+  for (uint32_t r = 0; r < BENCH_ROUNDS; r++) {
+    for (uint8_t i = 0; i < n_ff; i++) {
+      uint8_t* ff = ref_buf + i * ff_len;
+      ref_decode(n_bytes, ff, ff + ff_len, stream_buf + i * slot_size, n_ff);
+    }
+    sink += ref_buf[r % sizeof(ref_buf)];
+  }
+  double const ref_rate = msample_per_sec(start, n_channels);
+
+  start = clock();
+  for (uint32_t r = 0; r < BENCH_ROUNDS; r++) {
+    for (uint8_t i = 0; i < n_ff; i++) {
+      uint8_t* ff = ff_buf + i * ff_len;
+      end[i] = audio_pcm_deinterleave(ff, ff + ff_len, stream_buf + i * slot_size, slot_size, n_ff);
+    }
+    sink += ff_buf[r % sizeof(ff_buf)];
+  }
+  double const rate = msample_per_sec(start, n_channels);
+
+  for (uint8_t i = 0; i < n_ff; i++) {
+    TEST_ASSERT_EQUAL_PTR(stream_buf + BENCH_FRAMES * n_channels * n_bytes + i * slot_size, end[i]);
+  }
+
+  if (BENCH_ROUNDS > 1) {
+    printf("decode %u-byte x %u ch: previous %7.1f, kernel %7.1f Msample/s (x%.2f)\n", n_bytes, n_channels, ref_rate,
+           rate, rate / ref_rate);
+  }
+
+  TEST_ASSERT_EQUAL_MEMORY(ref_buf, ff_buf, n_ff * ff_len);
+  spec_deinterleave(ref_buf, stream_buf, BENCH_FRAMES, n_bytes, n_channels);
+  TEST_ASSERT_EQUAL_MEMORY(ref_buf, ff_buf, n_ff * ff_len);
+}
+
+static void bench_encode(uint8_t n_bytes, uint8_t n_channels) {
+  uint8_t const n_ff = n_channels / CHANNEL_PER_FIFO;
+  uint8_t const slot_size = CHANNEL_PER_FIFO * n_bytes;
+  uint16_t const ff_len = BENCH_FRAMES * slot_size;
+  uint16_t const stream_len = BENCH_FRAMES * n_channels * n_bytes;
+  void* end[8 / CHANNEL_PER_FIFO];
+  clock_t start;
+
+  // stream_buf is used as fifo content here
+  start = clock();
+  for (uint32_t r = 0; r < BENCH_ROUNDS; r++) {
+    for (uint8_t i = 0; i < n_ff; i++) {
+      uint8_t* ff = stream_buf + i * ff_len;
+      ref_encode(n_bytes, ff, ff + ff_len, ref_buf + i * slot_size, n_ff);
+    }
+    sink += ref_buf[r % stream_len];
+  }
+  double const ref_rate = msample_per_sec(start, n_channels);
+
+  start = clock();
+  for (uint32_t r = 0; r < BENCH_ROUNDS; r++) {
+    for (uint8_t i = 0; i < n_ff; i++) {
+      uint8_t const* ff = stream_buf + i * ff_len;
+      uint8_t* dst = ff_buf + i * slot_size;
+      end[i] = audio_pcm_interleave(ff, ff + ff_len, dst, slot_size, n_ff);
+    }
+    sink += ff_buf[r % stream_len];
+  }
+  double const rate = msample_per_sec(start, n_channels);
+
+  for (uint8_t i = 0; i < n_ff; i++) {
+    TEST_ASSERT_EQUAL_PTR(ff_buf + i * slot_size + stream_len, end[i]);
+  }
+
+  if (BENCH_ROUNDS > 1) {
+    printf("encode %u-byte x %u ch: previous %7.1f, kernel %7.1f Msample/s (x%.2f)\n", n_bytes, n_channels, ref_rate,
+           rate, rate / ref_rate);
+  }
+  TEST_ASSERT_EQUAL_MEMORY(ref_buf, ff_buf, stream_len);
+
+  // decode of encoded stream gives back fifo content
+  spec_deinterleave(ref_buf, ff_buf, BENCH_FRAMES, n_bytes, n_channels);
+  TEST_ASSERT_EQUAL_MEMORY(stream_buf, ref_buf, n_ff * ff_len);
+}
+
+//--------------------------------------------------------------------+
+// Decode: stream -> support FIFOs
+//--------------------------------------------------------------------+
+void test_bench_decode(void) {
+  uint8_t const n_channels[] = {2, 4, 8};
+  for (uint8_t b = 1; b <= 4; b++) {
+    for (uint8_t c = 0; c < TU_ARRAY_SIZE(n_channels); c++) {
+      bench_decode(b, n_channels[c]);
+    }
+  }
+}
+
+//--------------------------------------------------------------------+
+// Encode: support FIFOs -> stream
+//--------------------------------------------------------------------+
+void test_bench_encode(void) {
+  uint8_t const n_channels[] = {2, 4, 8};
+  for (uint8_t b = 1; b <= 4; b++) {
+    for (uint8_t c = 0; c < TU_ARRAY_SIZE(n_channels); c++) {
+      bench_encode(b, n_channels[c]);
+    }
+  }
+}
+
+// Partial slot count e.g FIFO wrap in the middle of a packet, and returned position
+void test_deinterleave_partial(void) {
+  uint8_t const slot_size = 4;
+  uint8_t const n_ff = 2;
+  uint8_t ref[4 * 5];
+
+  for (uint8_t i = 0; i < 5; i++) {
+    memcpy(ref + i * slot_size, stream_buf + slot_size + i * slot_size * n_ff, slot_size);
+  }
+
+  void const* next = audio_pcm_deinterleave(ff_buf, ff_buf + 3 * slot_size, stream_buf + slot_size, slot_size, n_ff);
+  TEST_ASSERT_EQUAL_PTR(stream_buf + slot_size + 3 * slot_size * n_ff, next);
+  next = audio_pcm_deinterleave(ff_buf + 3 * slot_size, ff_buf + 5 * slot_size, next, slot_size, n_ff);
+  TEST_ASSERT_EQUAL_PTR(stream_buf + slot_size + 5 * slot_size * n_ff, next);
+
+  TEST_ASSERT_EQUAL_MEMORY(ref, ff_buf, sizeof(ref));
+  TEST_ASSERT_EQUAL(0, ff_buf[sizeof(ref)]);
+}
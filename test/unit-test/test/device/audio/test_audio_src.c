@@ -0,0 +1,223 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Ha Thach (tinyusb.org)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * This file is part of the TinyUSB stack.
+ */
+
+#include <string.h>
+#include "unity.h"
+
+#include "audio_src.h"
+
+#define BLOCK_FRAMES  48 // 1ms of 48 kHz
+#define FIFO_FRAMES   384
+
+static audio_src_t src;
+
+void setUp(void) {
+  audio_src_init(&src);
+}
+
+void tearDown(void) {
+}
+
+//--------------------------------------------------------------------+
+// Conversion
+//--------------------------------------------------------------------+
+
+// Nominal ratio: output is input delayed by one frame
+void test_src_unity_ratio(void) {
+  int16_t in[BLOCK_FRAMES * 2];
+  int16_t out[BLOCK_FRAMES * 2 + 4];
+  int16_t expected_prev[2] = {0, 0};
+
+  for (int blk = 0; blk < 3; blk++) {
+    for (int i = 0; i < BLOCK_FRAMES; i++) {
+      in[2 * i] = (int16_t) (blk * 1000 + i);
+      in[2 * i + 1] = (int16_t) -(blk * 1000 + i);
+    }
+
+    audio_src_buf_t const in_buf = {.ptr = {(uint8_t*) in, NULL}, .n_lin = BLOCK_FRAMES, .stride = 4};
+    audio_src_buf_t const out_buf = {.ptr = {(uint8_t*) out, NULL}, .n_lin = BLOCK_FRAMES + 2, .stride = 4};
+
+    uint16_t const n_out = audio_src_out_count(&src, BLOCK_FRAMES);
+    TEST_ASSERT_EQUAL(BLOCK_FRAMES, n_out);
+
+    audio_src_process(&src, 0, 2, 2, &in_buf, BLOCK_FRAMES, &out_buf, n_out);
+    audio_src_advance(&src, BLOCK_FRAMES, n_out);
+
+    TEST_ASSERT_EQUAL(expected_prev[0], out[0]);
+    TEST_ASSERT_EQUAL(expected_prev[1], out[1]);
+    TEST_ASSERT_EQUAL_MEMORY(in, out + 2, (BLOCK_FRAMES - 1) * 4);
+
+    expected_prev[0] = in[2 * (BLOCK_FRAMES - 1)];
+    expected_prev[1] = in[2 * (BLOCK_FRAMES - 1) + 1];
+  }
+}
+
+// Fixed ratio with a ramp: output follows ramp at its position, across blocks and sample sizes
+static void fixed_ratio_ramp(uint8_t n_bytes, int32_t ppm) {
+  uint8_t in[BLOCK_FRAMES * 4];
+  uint8_t out[(BLOCK_FRAMES + 2) * 4];
+  int32_t const slope = (n_bytes == 1) ? 1 : (n_bytes == 2) ? 10 : 100;
+  uint32_t total_in = 0, total_out = 0;
+  int32_t last = 0;
+  uint64_t const step = (1ull << 32) + (uint64_t) ((int64_t) ppm * 4295);
+
+  audio_src_init(&src);
+  src.delta = ppm * 4295;
+
+  // keep ramp within sample range
+  uint16_t const n_blocks = (n_bytes == 1) ? 2 : 100;
+  int32_t const base = (n_bytes == 1) ? -100 : -(int32_t) (n_blocks * BLOCK_FRAMES * slope / 2);
+
+  for (uint16_t blk = 0; blk < n_blocks; blk++) {
+    for (uint16_t i = 0; i < BLOCK_FRAMES; i++) {
+      audio_src_store(in + i * n_bytes, n_bytes, base + (int32_t) (total_in + i) * slope);
+    }
+
+    audio_src_buf_t const in_buf = {.ptr = {in, NULL}, .n_lin = BLOCK_FRAMES, .stride = n_bytes};
+    audio_src_buf_t const out_buf = {.ptr = {out, NULL}, .n_lin = BLOCK_FRAMES + 2, .stride = n_bytes};
+    uint16_t const n_out = audio_src_out_count(&src, BLOCK_FRAMES);
+    audio_src_process(&src, 0, 1, n_bytes, &in_buf, BLOCK_FRAMES, &out_buf, n_out);
+    audio_src_advance(&src, BLOCK_FRAMES, n_out);
+
+    for (uint16_t k = 0; k < n_out; k++) {
+      int32_t const y = audio_src_load(out + k * n_bytes, n_bytes);
+      if (blk > 0 || k > 2) {
+        // consecutive outputs are one step apart on the ramp (first outputs are from zero history)
+        int32_t const diff = y - last;
+        int32_t const expected = (int32_t) ((step * (uint64_t) slope) >> 32);
+        TEST_ASSERT_GREATER_OR_EQUAL(expected - 1, diff);
+        TEST_ASSERT_LESS_OR_EQUAL(expected + 1, diff);
+      }
+      last = y;
+    }
+
+    total_in += BLOCK_FRAMES;
+    total_out += n_out;
+  }
+
+  // output count follows the ratio
+  int64_t const expected_out = (int64_t) total_in * 1000000 / (1000000 + ppm);
+  TEST_ASSERT_LESS_OR_EQUAL(1, (expected_out > total_out) ? expected_out - total_out : total_out - expected_out);
+}
+
+void test_src_fixed_ratio(void) {
+  for (uint8_t n_bytes = 1; n_bytes <= 4; n_bytes++) {
+    fixed_ratio_ramp(n_bytes, 1000);
+    fixed_ratio_ramp(n_bytes, -1000);
+  }
+}
+
+// Output can be split into linear and wrapped part of a FIFO
+void test_src_wrapped_output(void) {
+  int16_t in[BLOCK_FRAMES];
+  int16_t lin[20], wrap[BLOCK_FRAMES];
+
+  for (int i = 0; i < BLOCK_FRAMES; i++) {
+    in[i] = (int16_t) (i + 1);
+  }
+
+  audio_src_buf_t const in_buf = {.ptr = {(uint8_t*) in, NULL}, .n_lin = BLOCK_FRAMES, .stride = 2};
+  audio_src_buf_t const out_buf = {.ptr = {(uint8_t*) lin, (uint8_t*) wrap}, .n_lin = 20, .stride = 2};
+  audio_src_process(&src, 0, 1, 2, &in_buf, BLOCK_FRAMES, &out_buf, BLOCK_FRAMES);
+
+  TEST_ASSERT_EQUAL(0, lin[0]);
+  TEST_ASSERT_EQUAL(19, lin[19]);
+  TEST_ASSERT_EQUAL(20, wrap[0]);
+  TEST_ASSERT_EQUAL(BLOCK_FRAMES - 1, wrap[BLOCK_FRAMES - 21]);
+  TEST_ASSERT_EQUAL(BLOCK_FRAMES, src.hist[0]);
+}
+
+//--------------------------------------------------------------------+
+// Control loop with clock drift, 48 frames per 1ms USB frame
+//--------------------------------------------------------------------+
+
+// Host sends nominal rate, codec consumes faster: FIFO level is kept at half, ratio converges to drift
+void test_src_loop_decode(void) {
+  int32_t const drift_ppm = 250;
+  uint32_t codec_acc = 0;
+  int32_t fill = 0;
+
+  for (uint32_t ms = 0; ms < 120000; ms++) {
+    audio_src_update(&src, (uint16_t) fill, FIFO_FRAMES / 2, BLOCK_FRAMES);
+    uint16_t const n_out = audio_src_out_count(&src, BLOCK_FRAMES);
+    audio_src_advance(&src, BLOCK_FRAMES, n_out);
+    fill += n_out;
+    TEST_ASSERT_LESS_OR_EQUAL(FIFO_FRAMES, fill);
+
+    // codec reads 48 * (1 + drift) frames per ms
+    codec_acc += BLOCK_FRAMES * (1000000 + drift_ppm);
+    uint32_t const n_read = tu_min32(codec_acc / 1000000, (uint32_t) fill);
+    codec_acc -= n_read * 1000000;
+    fill -= (int32_t) n_read;
+
+    if (ms > 60000) {
+      TEST_ASSERT_GREATER_OR_EQUAL(FIFO_FRAMES / 2 - 8, fill);
+      TEST_ASSERT_LESS_OR_EQUAL(FIFO_FRAMES / 2 + 8, fill);
+    }
+  }
+
+  // step = 1 / (1 + drift)
+  TEST_ASSERT_GREATER_OR_EQUAL(-drift_ppm - 5, audio_src_ppm(&src));
+  TEST_ASSERT_LESS_OR_EQUAL(-drift_ppm + 5, audio_src_ppm(&src));
+}
+
+// Codec produces slower than nominal rate: packets still carry 48 frames without underflow once settled
+void test_src_loop_encode(void) {
+  int32_t const drift_ppm = -300;
+  uint32_t codec_acc = 0;
+  int32_t fill = FIFO_FRAMES / 4;
+
+  for (uint32_t ms = 0; ms < 120000; ms++) {
+    codec_acc += BLOCK_FRAMES * (1000000 + drift_ppm);
+    uint32_t const n_write = tu_min32(codec_acc / 1000000, (uint32_t) (FIFO_FRAMES - fill));
+    codec_acc -= n_write * 1000000;
+    fill += (int32_t) n_write;
+
+    audio_src_update(&src, (uint16_t) fill, FIFO_FRAMES / 2, BLOCK_FRAMES);
+    uint16_t const n_out = tu_min16(BLOCK_FRAMES, audio_src_out_count_max(&src, (uint16_t) fill));
+    uint16_t const n_in = audio_src_in_count(&src, n_out);
+
+    // input frames used for interpolation are available
+    if (n_out) {
+      uint64_t const last_pos = src.pos + (uint64_t) (n_out - 1) * audio_src_step(&src);
+      TEST_ASSERT_LESS_THAN(fill, (int32_t) (last_pos >> 32));
+    }
+    TEST_ASSERT_LESS_OR_EQUAL(fill, n_in);
+
+    // level seen by converter is regulated
+    if (ms > 60000) {
+      TEST_ASSERT_EQUAL(BLOCK_FRAMES, n_out);
+      TEST_ASSERT_GREATER_OR_EQUAL(FIFO_FRAMES / 2 - 8, fill);
+      TEST_ASSERT_LESS_OR_EQUAL(FIFO_FRAMES / 2 + 8, fill);
+    }
+
+    audio_src_advance(&src, n_in, n_out);
+    fill -= n_in;
+  }
+
+  TEST_ASSERT_GREATER_OR_EQUAL(drift_ppm - 5, audio_src_ppm(&src));
+  TEST_ASSERT_LESS_OR_EQUAL(drift_ppm + 5, audio_src_ppm(&src));
+}
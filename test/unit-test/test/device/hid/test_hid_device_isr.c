@@ -0,0 +1,257 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Ha Thach (tinyusb.org)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * This file is part of the TinyUSB stack.
+ */
+
+
+// HID transfer complete handled in ISR context, built with CFG_TUD_HID_XFER_ISR = 1 and CFG_TUSB_STATS = 1
+// (see project.yml)
+
+#include "unity.h"
+
+// Files to test
+#include "osal/osal.h"
+#include "tusb_fifo.h"
+#include "tusb.h"
+#include "usbd.h"
+TEST_SOURCE_FILE("usbd_control.c")
+TEST_SOURCE_FILE("hid_device.c")
+
+// Mock File
+#include "mock_dcd.h"
+
+TU_VERIFY_STATIC(CFG_TUD_HID && CFG_TUD_HID_XFER_ISR, "test requires HID with ISR transfer complete");
+
+//--------------------------------------------------------------------+
+// MACRO TYPEDEF CONSTANT ENUM DECLARATION
+//--------------------------------------------------------------------+
+
+uint32_t tusb_time_millis_api(void) {
+  return 0;
+}
+
+enum {
+  EDPT_CTRL_OUT = 0x00,
+  EDPT_CTRL_IN  = 0x80,
+
+  EDPT_HID_OUT  = 0x01,
+  EDPT_HID_IN   = 0x81,
+};
+
+enum {
+  ITF_NUM_HID,
+  ITF_NUM_TOTAL
+};
+
+enum {
+  REPORT_SIZE = 8
+};
+
+uint8_t const rhport = 0;
+
+uint8_t const desc_hid_report[] = {
+  TUD_HID_REPORT_DESC_GENERIC_INOUT(REPORT_SIZE)
+};
+
+#define CONFIG_TOTAL_LEN    (TUD_CONFIG_DESC_LEN + TUD_HID_INOUT_DESC_LEN)
+
+uint8_t const desc_configuration[] = {
+  // Config number, interface count, string index, total length, attribute, power in mA
+  TUD_CONFIG_DESCRIPTOR(1, ITF_NUM_TOTAL, 0, CONFIG_TOTAL_LEN, 0, 100),
+
+  // Interface number, string index, protocol, report descriptor len, EP Out & In address, size & polling interval
+  TUD_HID_INOUT_DESCRIPTOR(ITF_NUM_HID, 0, HID_ITF_PROTOCOL_NONE, sizeof(desc_hid_report), EDPT_HID_OUT, EDPT_HID_IN, 64, 1),
+};
+
+tusb_control_request_t const request_set_configuration = {
+  .bmRequestType = 0x00,
+  .bRequest      = TUSB_REQ_SET_CONFIGURATION,
+  .wValue        = 1,
+  .wIndex        = 0,
+  .wLength       = 0
+};
+
+uint8_t report[REPORT_SIZE];
+uint32_t complete_count;
+uint32_t set_report_count;
+uint16_t set_report_len;
+bool report_in_complete_cb;
+
+//--------------------------------------------------------------------+
+// Callbacks
+//--------------------------------------------------------------------+
+uint8_t const * tud_descriptor_device_cb(void) {
+  return NULL;
+}
+
+uint8_t const * tud_descriptor_configuration_cb(uint8_t index) {
+  (void) index;
+  return desc_configuration;
+}
+
+uint16_t const* tud_descriptor_string_cb(uint8_t index, uint16_t langid) {
+  (void) index;
+  (void) langid;
+  return NULL;
+}
+
+uint8_t const * tud_hid_descriptor_report_cb(uint8_t instance) {
+  (void) instance;
+  return desc_hid_report;
+}
+
+uint16_t tud_hid_get_report_cb(uint8_t instance, uint8_t report_id, hid_report_type_t report_type, uint8_t* buffer, uint16_t reqlen) {
+  (void) instance;
+  (void) report_id;
+  (void) report_type;
+  (void) buffer;
+  (void) reqlen;
+  return 0;
+}
+
+void tud_hid_set_report_cb(uint8_t instance, uint8_t report_id, hid_report_type_t report_type, uint8_t const* buffer, uint16_t bufsize) {
+  (void) instance;
+  (void) report_id;
+  (void) buffer;
+  TEST_ASSERT_EQUAL(HID_REPORT_TYPE_OUTPUT, report_type);
+  set_report_count++;
+  set_report_len = bufsize;
+}
+
+void tud_hid_report_complete_cb(uint8_t instance, uint8_t const* buf, uint16_t len) {
+  (void) buf;
+  (void) len;
+  complete_count++;
+
+  // send next report right from ISR context
+  if (report_in_complete_cb) {
+    TEST_ASSERT_TRUE(tud_hid_n_ready(instance));
+    TEST_ASSERT_TRUE(tud_hid_n_report(instance, 0, report, REPORT_SIZE));
+  }
+}
+
+//--------------------------------------------------------------------+
+//
+//--------------------------------------------------------------------+
+void setUp(void) {
+  dcd_int_disable_Ignore();
+  dcd_int_enable_Ignore();
+
+  if ( !tud_inited() ) {
+    tusb_rhport_init_t dev_init = {
+      .role = TUSB_ROLE_DEVICE,
+      .speed = TUSB_SPEED_AUTO
+    };
+
+    dcd_init_ExpectAndReturn(0, &dev_init, true);
+    tusb_init(0, &dev_init);
+  }
+
+  dcd_event_bus_reset(rhport, TUSB_SPEED_FULL, false);
+  tud_task();
+  tud_stats_clear();
+
+  complete_count = 0;
+  set_report_count = 0;
+  set_report_len = 0;
+  report_in_complete_cb = false;
+
+  uint8_t const* desc_ep = tu_desc_next(tu_desc_next(tu_desc_next(desc_configuration)));
+
+  dcd_event_setup_received(rhport, (uint8_t const*) &request_set_configuration, false);
+
+  // open endpoints, then OUT endpoint is armed for output report
+  dcd_edpt_open_ExpectAndReturn(rhport, (tusb_desc_endpoint_t const *) desc_ep, true);
+  dcd_edpt_open_ExpectAndReturn(rhport, (tusb_desc_endpoint_t const *) tu_desc_next(desc_ep), true);
+  dcd_edpt_xfer_ExpectAndReturn(rhport, EDPT_HID_OUT, NULL, CFG_TUD_HID_EP_BUFSIZE, true);
+  dcd_edpt_xfer_IgnoreArg_buffer();
+
+  // control status
+  dcd_edpt_xfer_ExpectAndReturn(rhport, EDPT_CTRL_IN, NULL, 0, true);
+
+  tud_task();
+  TEST_ASSERT_TRUE(tud_mounted());
+}
+
+void tearDown(void) {
+}
+
+//--------------------------------------------------------------------+
+// Tests
+//--------------------------------------------------------------------+
+
+// Input report complete callback is invoked within dcd_event_xfer_complete() without running usbd task
+void test_hid_report_complete_in_isr(void) {
+  dcd_edpt_xfer_ExpectAndReturn(rhport, EDPT_HID_IN, NULL, REPORT_SIZE, true);
+  dcd_edpt_xfer_IgnoreArg_buffer();
+  TEST_ASSERT_TRUE(tud_hid_report(0, report, REPORT_SIZE));
+  TEST_ASSERT_FALSE(tud_hid_ready());
+
+  dcd_event_xfer_complete(rhport, EDPT_HID_IN, REPORT_SIZE, XFER_RESULT_SUCCESS, true);
+  TEST_ASSERT_EQUAL(1, complete_count);
+  TEST_ASSERT_TRUE(tud_hid_ready());
+
+  // nothing is queued for usbd task
+  tud_task();
+  TEST_ASSERT_EQUAL(1, complete_count);
+
+  // counted once by ISR completion
+  tusb_edpt_stats_t stats;
+  TEST_ASSERT_TRUE(tud_stats_get(EDPT_HID_IN, &stats));
+  TEST_ASSERT_EQUAL(1, stats.xfers);
+  TEST_ASSERT_EQUAL(REPORT_SIZE, stats.bytes);
+  TEST_ASSERT_EQUAL(0, stats.failed);
+}
+
+// Next report can be queued from complete callback in ISR context
+void test_hid_report_from_complete_cb(void) {
+  dcd_edpt_xfer_ExpectAndReturn(rhport, EDPT_HID_IN, NULL, REPORT_SIZE, true);
+  dcd_edpt_xfer_IgnoreArg_buffer();
+  TEST_ASSERT_TRUE(tud_hid_report(0, report, REPORT_SIZE));
+
+  report_in_complete_cb = true;
+  dcd_edpt_xfer_ExpectAndReturn(rhport, EDPT_HID_IN, NULL, REPORT_SIZE, true);
+  dcd_edpt_xfer_IgnoreArg_buffer();
+  dcd_event_xfer_complete(rhport, EDPT_HID_IN, REPORT_SIZE, XFER_RESULT_SUCCESS, true);
+
+  TEST_ASSERT_EQUAL(1, complete_count);
+  TEST_ASSERT_FALSE(tud_hid_ready());
+}
+
+// Output report is delivered and OUT endpoint re-armed in ISR context
+void test_hid_set_report_in_isr(void) {
+  dcd_edpt_xfer_ExpectAndReturn(rhport, EDPT_HID_OUT, NULL, CFG_TUD_HID_EP_BUFSIZE, true);
+  dcd_edpt_xfer_IgnoreArg_buffer();
+  dcd_event_xfer_complete(rhport, EDPT_HID_OUT, REPORT_SIZE, XFER_RESULT_SUCCESS, true);
+
+  TEST_ASSERT_EQUAL(1, set_report_count);
+  TEST_ASSERT_EQUAL(REPORT_SIZE, set_report_len);
+
+  // re-armed transfer is still pending
+  tusb_edpt_stats_t stats;
+  TEST_ASSERT_TRUE(tud_stats_get(EDPT_HID_OUT, &stats));
+  TEST_ASSERT_EQUAL(1, stats.xfers);
+  TEST_ASSERT_EQUAL(REPORT_SIZE, stats.bytes);
+  TEST_ASSERT_EQUAL(1, stats.short_xfers);
+}
@@ -38,191 +38,160 @@ TEST_SOURCE_FILE("msc_device.c")
 // Mock File
 #include "mock_dcd.h"
 
-//--------------------------------------------------------------------+
-// MACRO TYPEDEF CONSTANT ENUM DECLARATION
-//--------------------------------------------------------------------+
-
-uint32_t tusb_time_millis_api(void) {
-  return 0;
-}
-
-enum
-{
-  EDPT_CTRL_OUT = 0x00,
-  EDPT_CTRL_IN  = 0x80,
-
-  EDPT_MSC_OUT  = 0x01,
-  EDPT_MSC_IN   = 0x81,
-};
-
-uint8_t const rhport = 0;
-
-enum
-{
-  ITF_NUM_MSC,
-  ITF_NUM_TOTAL
-};
-
-#define CONFIG_TOTAL_LEN    (TUD_CONFIG_DESC_LEN + TUD_MSC_DESC_LEN)
+// Shared callbacks, descriptors and helpers
+#include "msc_device_fixture.h"
 
-uint8_t const data_desc_configuration[] =
-{
-  // Config number, interface count, string index, total length, attribute, power in mA
-  TUD_CONFIG_DESCRIPTOR(1, ITF_NUM_TOTAL, 0, CONFIG_TOTAL_LEN, TUSB_DESC_CONFIG_ATT_REMOTE_WAKEUP, 100),
-
-  // Interface number, string index, EP Out & EP In address, EP size
-  TUD_MSC_DESCRIPTOR(ITF_NUM_MSC, 0, EDPT_MSC_OUT, EDPT_MSC_IN, TUD_OPT_HIGH_SPEED ? 512 : 64),
-};
-
-tusb_control_request_t const request_set_configuration =
+void setUp(void)
 {
-  .bmRequestType = 0x00,
-  .bRequest      = TUSB_REQ_SET_CONFIGURATION,
-  .wValue        = 1,
-  .wIndex        = 0,
-  .wLength       = 0
-};
-
-uint8_t const* desc_configuration;
-
+  msc_fixture_reset();
+}
 
-enum
+void tearDown(void)
 {
-  DISK_BLOCK_NUM  = 16, // 8KB is the smallest size that windows allow to mount
-  DISK_BLOCK_SIZE = 512
-};
-
-uint8_t msc_disk[DISK_BLOCK_NUM][DISK_BLOCK_SIZE];
+}
 
-// Invoked when received SCSI_CMD_INQUIRY
-// Application fill vendor id, product id and revision with string up to 8, 16, 4 characters respectively
-void tud_msc_inquiry_cb(uint8_t lun, uint8_t vendor_id[8], uint8_t product_id[16], uint8_t product_rev[4])
+//--------------------------------------------------------------------+
+//
+//--------------------------------------------------------------------+
+void test_msc(void)
 {
-  (void) lun;
+  // Read 1 LBA = 0, Block count = 1
+  msc_cbw_t cbw_read10 =
+  {
+    .signature = MSC_CBW_SIGNATURE,
+    .tag = 0xCAFECAFE,
+    .total_bytes = 512,
+    .lun = 0,
+    .dir = TUSB_DIR_IN_MASK,
+    .cmd_len = sizeof(scsi_read10_t)
+  };
 
-  const char vid[] = "TinyUSB";
-  const char pid[] = "Mass Storage";
-  const char rev[] = "1.0";
+  scsi_read10_t cmd_read10 =
+  {
+      .cmd_code    = SCSI_CMD_READ_10,
+      .lba         = tu_htonl(0),
+      .block_count = tu_htons(1)
+  };
 
-  memcpy(vendor_id  , vid, strlen(vid));
-  memcpy(product_id , pid, strlen(pid));
-  memcpy(product_rev, rev, strlen(rev));
-}
+  memcpy(cbw_read10.command, &cmd_read10, cbw_read10.cmd_len);
+  receive_cbw(&cbw_read10);
 
-// Invoked when received Test Unit Ready command.
-// return true allowing host to read/write this LUN e.g SD card inserted
-bool tud_msc_test_unit_ready_cb(uint8_t lun)
-{
-  (void) lun;
+  // SCSI Data transfer
+  dcd_edpt_xfer_ExpectAndReturn(rhport, EDPT_MSC_IN, NULL, 512, true);
+  dcd_edpt_xfer_IgnoreArg_buffer();
+  dcd_event_xfer_complete(rhport, EDPT_MSC_IN, 512, 0, true); // complete
 
-  return true; // RAM disk is always ready
-}
+  // SCSI Status
+  dcd_edpt_xfer_ExpectAndReturn(rhport, EDPT_MSC_IN, NULL, 13, true);
+  dcd_edpt_xfer_IgnoreArg_buffer();
+  dcd_event_xfer_complete(rhport, EDPT_MSC_IN, 13, 0, true);
 
-// Invoked when received SCSI_CMD_READ_CAPACITY_10 and SCSI_CMD_READ_FORMAT_CAPACITY to determine the disk size
-// Application update block count and block size
-void tud_msc_capacity_cb(uint8_t lun, uint32_t* block_count, uint16_t* block_size)
-{
-  (void) lun;
+  // Prepare for next command
+  dcd_edpt_xfer_ExpectAndReturn(rhport, EDPT_MSC_OUT, NULL, sizeof(msc_cbw_t), true);
+  dcd_edpt_xfer_IgnoreArg_buffer();
 
-  *block_count = DISK_BLOCK_NUM;
-  *block_size  = DISK_BLOCK_SIZE;
+  tud_task();
 }
 
-// Invoked when received Start Stop Unit command
-// - Start = 0 : stopped power mode, if load_eject = 1 : unload disk storage
-// - Start = 1 : active mode, if load_eject = 1 : load disk storage
-bool tud_msc_start_stop_cb(uint8_t lun, uint8_t power_condition, bool start, bool load_eject)
+void test_msc_read10_single_buffer(void)
 {
-  (void) lun;
-  (void) power_condition;
-
-  return true;
-}
+  // Read 2 LBAs starting from 0
+  msc_cbw_t cbw_read10 =
+  {
+    .signature = MSC_CBW_SIGNATURE,
+    .tag = 0xCAFECAFE,
+    .total_bytes = 2*512,
+    .lun = 0,
+    .dir = TUSB_DIR_IN_MASK,
+    .cmd_len = sizeof(scsi_read10_t)
+  };
 
-// Callback invoked when received READ10 command.
-// Copy disk's data to buffer (up to bufsize) and return number of copied bytes.
-int32_t tud_msc_read10_cb(uint8_t lun, uint32_t lba, uint32_t offset, void* buffer, uint32_t bufsize)
-{
-  (void) lun;
+  scsi_read10_t cmd_read10 =
+  {
+      .cmd_code    = SCSI_CMD_READ_10,
+      .lba         = tu_htonl(0),
+      .block_count = tu_htons(2)
+  };
 
-  uint8_t const* addr = msc_disk[lba] + offset;
-  memcpy(buffer, addr, bufsize);
+  memcpy(cbw_read10.command, &cmd_read10, cbw_read10.cmd_len);
+  receive_cbw(&cbw_read10);
 
-  return bufsize;
-}
+  // First block is on the wire, the only buffer is in use
+  dcd_edpt_xfer_ExpectAndReturn(rhport, EDPT_MSC_IN, NULL, 512, true);
+  dcd_edpt_xfer_IgnoreArg_buffer();
 
-// Callback invoked when received WRITE10 command.
-// Process data in buffer to disk's storage and return number of written bytes
-int32_t tud_msc_write10_cb(uint8_t lun, uint32_t lba, uint32_t offset, uint8_t* buffer, uint32_t bufsize)
-{
-  (void) lun;
+  tud_task();
+  TEST_ASSERT_EQUAL(1, read10_count);
 
-  uint8_t* addr = msc_disk[lba] + offset;
-  memcpy(addr, buffer, bufsize);
+  // Second block is read once the first one complete
+  dcd_edpt_xfer_ExpectAndReturn(rhport, EDPT_MSC_IN, NULL, 512, true);
+  dcd_edpt_xfer_IgnoreArg_buffer();
+  dcd_event_xfer_complete(rhport, EDPT_MSC_IN, 512, 0, true);
 
-  return bufsize;
-}
+  tud_task();
+  TEST_ASSERT_EQUAL(2, read10_count);
 
-// Callback invoked when received an SCSI command not in built-in list below
-// - READ_CAPACITY10, READ_FORMAT_CAPACITY, INQUIRY, MODE_SENSE6, REQUEST_SENSE
-// - READ10 and WRITE10 has their own callbacks
-int32_t tud_msc_scsi_cb (uint8_t lun, uint8_t const scsi_cmd[16], void* buffer, uint16_t bufsize)
-{
-  // read10 & write10 has their own callback and MUST not be handled here
+  // SCSI Status
+  dcd_edpt_xfer_ExpectAndReturn(rhport, EDPT_MSC_IN, NULL, 13, true);
+  dcd_edpt_xfer_IgnoreArg_buffer();
+  dcd_event_xfer_complete(rhport, EDPT_MSC_IN, 512, 0, true);
+  dcd_event_xfer_complete(rhport, EDPT_MSC_IN, 13, 0, true);
 
-  void const* response = NULL;
-  uint16_t resplen = 0;
+  // Prepare for next command
+  dcd_edpt_xfer_ExpectAndReturn(rhport, EDPT_MSC_OUT, NULL, sizeof(msc_cbw_t), true);
+  dcd_edpt_xfer_IgnoreArg_buffer();
 
-  return resplen;
+  tud_task();
 }
 
-//--------------------------------------------------------------------+
-//
-//--------------------------------------------------------------------+
-uint8_t const * tud_descriptor_device_cb(void)
+void test_msc_read10_async(void)
 {
-  return NULL;
-}
+  // Read 1 LBA = 0, Block count = 1
+  msc_cbw_t cbw_read10 =
+  {
+    .signature = MSC_CBW_SIGNATURE,
+    .tag = 0xCAFECAFE,
+    .total_bytes = 512,
+    .lun = 0,
+    .dir = TUSB_DIR_IN_MASK,
+    .cmd_len = sizeof(scsi_read10_t)
+  };
 
-uint8_t const * tud_descriptor_configuration_cb(uint8_t index)
-{
-  return desc_configuration;
-}
+  scsi_read10_t cmd_read10 =
+  {
+      .cmd_code    = SCSI_CMD_READ_10,
+      .lba         = tu_htonl(0),
+      .block_count = tu_htons(1)
+  };
 
-uint16_t const* tud_descriptor_string_cb(uint8_t index, uint16_t langid)
-{
-  (void) langid;
+  memcpy(cbw_read10.command, &cmd_read10, cbw_read10.cmd_len);
+  receive_cbw(&cbw_read10);
 
-  return NULL;
-}
+  // read10 starts asynchronous I/O: nothing is queued until it is done
+  read10_async = true;
+  tud_task();
+  read10_async = false;
 
-void setUp(void)
-{
-  dcd_int_disable_Ignore();
-  dcd_int_enable_Ignore();
+  // SCSI Data transfer
+  dcd_edpt_xfer_ExpectAndReturn(rhport, EDPT_MSC_IN, NULL, 512, true);
+  dcd_edpt_xfer_IgnoreArg_buffer();
+  TEST_ASSERT_TRUE(tud_msc_async_io_done(0, 512, false));
+  tud_task();
 
-  if ( !tud_inited() ) {
-    tusb_rhport_init_t dev_init = {
-      .role = TUSB_ROLE_DEVICE,
-      .speed = TUSB_SPEED_AUTO
-    };
+  // SCSI Status
+  dcd_edpt_xfer_ExpectAndReturn(rhport, EDPT_MSC_IN, NULL, 13, true);
+  dcd_edpt_xfer_IgnoreArg_buffer();
+  dcd_event_xfer_complete(rhport, EDPT_MSC_IN, 512, 0, true);
+  dcd_event_xfer_complete(rhport, EDPT_MSC_IN, 13, 0, true);
 
-    dcd_init_ExpectAndReturn(0, &dev_init, true);
-    tusb_init(0, &dev_init);
-  }
+  // Prepare for next command
+  dcd_edpt_xfer_ExpectAndReturn(rhport, EDPT_MSC_OUT, NULL, sizeof(msc_cbw_t), true);
+  dcd_edpt_xfer_IgnoreArg_buffer();
 
-  dcd_event_bus_reset(rhport, TUSB_SPEED_HIGH, false);
   tud_task();
 }
 
-void tearDown(void)
-{
-}
-
-//--------------------------------------------------------------------+
-//
-//--------------------------------------------------------------------+
-void test_msc(void)
+void test_msc_read10_async_done_in_cb(void)
 {
   // Read 1 LBA = 0, Block count = 1
   msc_cbw_t cbw_read10 =
@@ -243,35 +212,64 @@ void test_msc(void)
   };
 
   memcpy(cbw_read10.command, &cmd_read10, cbw_read10.cmd_len);
+  receive_cbw(&cbw_read10);
 
-  desc_configuration = data_desc_configuration;
-  uint8_t const* desc_ep = tu_desc_next(tu_desc_next(desc_configuration));
+  // I/O is completed within read10 callback: data is still sent
+  dcd_edpt_xfer_ExpectAndReturn(rhport, EDPT_MSC_IN, NULL, 512, true);
+  dcd_edpt_xfer_IgnoreArg_buffer();
 
-  dcd_event_setup_received(rhport, (uint8_t*) &request_set_configuration, false);
+  read10_async_done_in_cb = true;
+  tud_task();
+  read10_async_done_in_cb = false;
 
-  // open endpoints
-  dcd_edpt_open_ExpectAndReturn(rhport, (tusb_desc_endpoint_t const *) desc_ep, true);
-  dcd_edpt_open_ExpectAndReturn(rhport, (tusb_desc_endpoint_t const *) tu_desc_next(desc_ep), true);
+  // SCSI Status
+  dcd_edpt_xfer_ExpectAndReturn(rhport, EDPT_MSC_IN, NULL, 13, true);
+  dcd_edpt_xfer_IgnoreArg_buffer();
+  dcd_event_xfer_complete(rhport, EDPT_MSC_IN, 512, 0, true);
+  dcd_event_xfer_complete(rhport, EDPT_MSC_IN, 13, 0, true);
 
-  // Prepare SCSI command
+  // Prepare for next command
   dcd_edpt_xfer_ExpectAndReturn(rhport, EDPT_MSC_OUT, NULL, sizeof(msc_cbw_t), true);
   dcd_edpt_xfer_IgnoreArg_buffer();
-  dcd_edpt_xfer_ReturnMemThruPtr_buffer( (uint8_t*) &cbw_read10, sizeof(msc_cbw_t));
 
-  // command received
-  dcd_event_xfer_complete(rhport, EDPT_MSC_OUT, sizeof(msc_cbw_t), 0, true);
+  tud_task();
+}
+
+void test_msc_read16(void)
+{
+  // Read 1 LBA = 2 with 16-byte CDB
+  msc_cbw_t cbw_read16 =
+  {
+    .signature = MSC_CBW_SIGNATURE,
+    .tag = 0xCAFECAFE,
+    .total_bytes = 512,
+    .lun = 0,
+    .dir = TUSB_DIR_IN_MASK,
+    .cmd_len = sizeof(scsi_read16_t)
+  };
+
+  scsi_read16_t cmd_read16 =
+  {
+      .cmd_code    = SCSI_CMD_READ_16,
+      .lba_hi      = tu_htonl(0),
+      .lba_lo      = tu_htonl(2),
+      .block_count = tu_htonl(1)
+  };
 
-  // control status
-  dcd_edpt_xfer_ExpectAndReturn(rhport, EDPT_CTRL_IN, NULL, 0, true);
+  memcpy(cbw_read16.command, &cmd_read16, cbw_read16.cmd_len);
+  receive_cbw(&cbw_read16);
 
-  // SCSI Data transfer
+  // SCSI Data transfer: without tud_msc_read16_cb(), 32-bit lba is served by tud_msc_read10_cb()
   dcd_edpt_xfer_ExpectAndReturn(rhport, EDPT_MSC_IN, NULL, 512, true);
   dcd_edpt_xfer_IgnoreArg_buffer();
-  dcd_event_xfer_complete(rhport, EDPT_MSC_IN, 512, 0, true); // complete
+
+  tud_task();
+  TEST_ASSERT_EQUAL(2, read10_lba);
 
   // SCSI Status
   dcd_edpt_xfer_ExpectAndReturn(rhport, EDPT_MSC_IN, NULL, 13, true);
   dcd_edpt_xfer_IgnoreArg_buffer();
+  dcd_event_xfer_complete(rhport, EDPT_MSC_IN, 512, 0, true);
   dcd_event_xfer_complete(rhport, EDPT_MSC_IN, 13, 0, true);
 
   // Prepare for next command
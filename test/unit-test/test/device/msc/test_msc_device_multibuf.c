@@ -0,0 +1,178 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Ha Thach (tinyusb.org)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * This file is part of the TinyUSB stack.
+ */
+
+// READ10/WRITE10 data stage with multiple endpoint buffers, built with CFG_TUD_MSC_EP_BUFNUM = 2 (see project.yml)
+
+#include "unity.h"
+
+// Files to test
+#include "osal/osal.h"
+#include "tusb_fifo.h"
+#include "tusb.h"
+#include "usbd.h"
+TEST_SOURCE_FILE("usbd_control.c")
+TEST_SOURCE_FILE("msc_device.c")
+
+// Mock File
+#include "mock_dcd.h"
+
+// Shared callbacks, descriptors and helpers
+#include "msc_device_fixture.h"
+
+//--------------------------------------------------------------------+
+// MACRO TYPEDEF CONSTANT ENUM DECLARATION
+//--------------------------------------------------------------------+
+TU_VERIFY_STATIC(CFG_TUD_MSC_EP_BUFNUM == 2, "test requires 2 endpoint buffers");
+
+void setUp(void)
+{
+  msc_fixture_reset();
+}
+
+void tearDown(void)
+{
+}
+
+//--------------------------------------------------------------------+
+//
+//--------------------------------------------------------------------+
+void test_msc_read10_read_ahead(void)
+{
+  // Read 2 LBAs starting from 0
+  msc_cbw_t cbw_read10 =
+  {
+    .signature = MSC_CBW_SIGNATURE,
+    .tag = 0xCAFECAFE,
+    .total_bytes = 2*512,
+    .lun = 0,
+    .dir = TUSB_DIR_IN_MASK,
+    .cmd_len = sizeof(scsi_read10_t)
+  };
+
+  scsi_read10_t cmd_read10 =
+  {
+      .cmd_code    = SCSI_CMD_READ_10,
+      .lba         = tu_htonl(0),
+      .block_count = tu_htons(2)
+  };
+
+  memcpy(cbw_read10.command, &cmd_read10, cbw_read10.cmd_len);
+  receive_cbw(&cbw_read10);
+
+  // First block is on the wire, second block is read into the other buffer meanwhile
+  dcd_edpt_xfer_ExpectAndReturn(rhport, EDPT_MSC_IN, NULL, 512, true);
+  dcd_edpt_xfer_IgnoreArg_buffer();
+
+  tud_task();
+  TEST_ASSERT_EQUAL(2, read10_count);
+
+  // Second block is queued as soon as the first one complete, without invoking read10 again
+  dcd_edpt_xfer_ExpectAndReturn(rhport, EDPT_MSC_IN, NULL, 512, true);
+  dcd_edpt_xfer_IgnoreArg_buffer();
+  dcd_event_xfer_complete(rhport, EDPT_MSC_IN, 512, 0, true);
+
+  tud_task();
+  TEST_ASSERT_EQUAL(2, read10_count);
+
+  // SCSI Status
+  dcd_edpt_xfer_ExpectAndReturn(rhport, EDPT_MSC_IN, NULL, 13, true);
+  dcd_edpt_xfer_IgnoreArg_buffer();
+  dcd_event_xfer_complete(rhport, EDPT_MSC_IN, 512, 0, true);
+  dcd_event_xfer_complete(rhport, EDPT_MSC_IN, 13, 0, true);
+
+  // Prepare for next command
+  dcd_edpt_xfer_ExpectAndReturn(rhport, EDPT_MSC_OUT, NULL, sizeof(msc_cbw_t), true);
+  dcd_edpt_xfer_IgnoreArg_buffer();
+
+  tud_task();
+}
+
+void test_msc_write10_pending(void)
+{
+  // Write 2 LBAs starting from 3
+  msc_cbw_t cbw_write10 =
+  {
+    .signature = MSC_CBW_SIGNATURE,
+    .tag = 0xCAFECAFE,
+    .total_bytes = 2*512,
+    .lun = 0,
+    .dir = 0,
+    .cmd_len = sizeof(scsi_write10_t)
+  };
+
+  scsi_write10_t cmd_write10 =
+  {
+      .cmd_code    = SCSI_CMD_WRITE_10,
+      .lba         = tu_htonl(3),
+      .block_count = tu_htons(2)
+  };
+
+  uint8_t data[2][512];
+  for (uint32_t i = 0; i < sizeof(data); i++) {
+    ((uint8_t*) data)[i] = (uint8_t) (i * 3 + 1);
+  }
+  memset(msc_disk, 0, sizeof(msc_disk));
+
+  memcpy(cbw_write10.command, &cmd_write10, cbw_write10.cmd_len);
+  receive_cbw(&cbw_write10);
+
+  // First chunk
+  dcd_edpt_xfer_ExpectAndReturn(rhport, EDPT_MSC_OUT, NULL, 512, true);
+  dcd_edpt_xfer_IgnoreArg_buffer();
+  dcd_edpt_xfer_ReturnMemThruPtr_buffer(data[0], 512);
+  tud_task();
+
+  // First chunk arrived: endpoint is re-armed for the second chunk before write10 is invoked, which stays pending
+  dcd_edpt_xfer_ExpectAndReturn(rhport, EDPT_MSC_OUT, NULL, 512, true);
+  dcd_edpt_xfer_IgnoreArg_buffer();
+  dcd_edpt_xfer_ReturnMemThruPtr_buffer(data[1], 512);
+  dcd_event_xfer_complete(rhport, EDPT_MSC_OUT, 512, 0, true);
+
+  write10_async = true;
+  tud_task();
+  write10_async = false;
+  TEST_ASSERT_EQUAL(1, write10_count);
+
+  // Host sends the second chunk while write10 is still pending: it is kept until application is done
+  dcd_event_xfer_complete(rhport, EDPT_MSC_OUT, 512, 0, true);
+  tud_task();
+  TEST_ASSERT_EQUAL(1, write10_count);
+
+  // First write done: second chunk is passed to application, then SCSI Status
+  dcd_edpt_xfer_ExpectAndReturn(rhport, EDPT_MSC_IN, NULL, 13, true);
+  dcd_edpt_xfer_IgnoreArg_buffer();
+  TEST_ASSERT_TRUE(tud_msc_async_io_done(0, 512, false));
+  tud_task();
+  TEST_ASSERT_EQUAL(2, write10_count);
+  TEST_ASSERT_EQUAL_MEMORY(data, msc_disk[3], sizeof(data));
+
+  // Prepare for next command
+  dcd_edpt_xfer_ExpectAndReturn(rhport, EDPT_MSC_OUT, NULL, sizeof(msc_cbw_t), true);
+  dcd_edpt_xfer_IgnoreArg_buffer();
+  dcd_event_xfer_complete(rhport, EDPT_MSC_IN, 13, 0, true);
+
+  tud_task();
+}
@@ -0,0 +1,282 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Ha Thach (tinyusb.org)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * This file is part of the TinyUSB stack.
+ */
+
+
+// Traffic capture as pcapng, built with CFG_TUSB_CAPTURE = 1 (see project.yml)
+
+#include "unity.h"
+
+// Files to test
+#include "osal/osal.h"
+#include "tusb_fifo.h"
+#include "tusb.h"
+#include "usbd.h"
+TEST_SOURCE_FILE("usbd_control.c")
+TEST_SOURCE_FILE("tusb_capture.c")
+
+// Mock File
+#include "mock_dcd.h"
+
+TU_VERIFY_STATIC(CFG_TUSB_CAPTURE, "test requires capture");
+
+//--------------------------------------------------------------------+
+// MACRO TYPEDEF CONSTANT ENUM DECLARATION
+//--------------------------------------------------------------------+
+uint32_t time_ms;
+
+uint32_t tusb_time_millis_api(void) {
+  return time_ms;
+}
+
+enum {
+  EDPT_CTRL_OUT = 0x00,
+  EDPT_CTRL_IN  = 0x80
+};
+
+enum {
+  SHB_LEN    = 28,
+  IDB_LEN    = 32,
+  EPB_LEN    = 32, // without packet data
+  USBMON_LEN = 64,
+};
+
+uint8_t const rhport = 0;
+
+tusb_desc_device_t const data_desc_device = {
+  .bLength            = sizeof(tusb_desc_device_t),
+  .bDescriptorType    = TUSB_DESC_DEVICE,
+  .bcdUSB             = 0x0200,
+  .bDeviceClass       = 0,
+  .bDeviceSubClass    = 0,
+  .bDeviceProtocol    = 0,
+  .bMaxPacketSize0    = CFG_TUD_ENDPOINT0_SIZE,
+  .idVendor           = 0xCafe,
+  .idProduct          = 0xCafe,
+  .bcdDevice          = 0x0100,
+  .iManufacturer      = 0x00,
+  .iProduct           = 0x00,
+  .iSerialNumber      = 0x00,
+  .bNumConfigurations = 0x01
+};
+
+tusb_control_request_t const req_get_desc_device = {
+  .bmRequestType = 0x80,
+  .bRequest = TUSB_REQ_GET_DESCRIPTOR,
+  .wValue = (TUSB_DESC_DEVICE << 8),
+  .wIndex = 0x0000,
+  .wLength = 64
+};
+
+uint8_t pcap[1024];
+
+//--------------------------------------------------------------------+
+//
+//--------------------------------------------------------------------+
+uint8_t const * tud_descriptor_device_cb(void) {
+  return (uint8_t const *) &data_desc_device;
+}
+
+uint8_t const * tud_descriptor_configuration_cb(uint8_t index) {
+  (void) index;
+  return NULL;
+}
+
+uint16_t const* tud_descriptor_string_cb(uint8_t index, uint16_t langid) {
+  (void) index;
+  (void) langid;
+  return NULL;
+}
+
+void setUp(void) {
+  dcd_int_disable_Ignore();
+  dcd_int_enable_Ignore();
+
+  if ( !tud_inited() ) {
+    tusb_rhport_init_t dev_init = {
+      .role = TUSB_ROLE_DEVICE,
+      .speed = TUSB_SPEED_AUTO
+    };
+
+    dcd_init_ExpectAndReturn(0, &dev_init, true);
+    tusb_init(0, &dev_init);
+  }
+
+  // drop anything left from previous test, next read starts with headers
+  while (tusb_capture_read(pcap, sizeof(pcap)) > SHB_LEN + IDB_LEN) {}
+  tusb_capture_restart();
+  memset(pcap, 0, sizeof(pcap));
+
+  // constant: capture reader extends 32-bit microsecond timestamp and would see a decrease as wrap-around
+  time_ms = 1500;
+}
+
+void tearDown(void) {
+}
+
+static uint32_t rd_u32(uint8_t const* p) {
+  uint32_t value;
+  memcpy(&value, p, 4);
+  return value;
+}
+
+// GET_DESCRIPTOR(device) with data and status stage
+static void control_get_device_descriptor(void) {
+  dcd_event_setup_received(rhport, (uint8_t const*) &req_get_desc_device, false);
+
+  // data
+  dcd_edpt_xfer_ExpectAndReturn(rhport, EDPT_CTRL_IN, (uint8_t*) &data_desc_device, sizeof(tusb_desc_device_t), true);
+  dcd_event_xfer_complete(rhport, EDPT_CTRL_IN, sizeof(tusb_desc_device_t), 0, false);
+
+  // status
+  dcd_edpt_xfer_ExpectAndReturn(rhport, EDPT_CTRL_OUT, NULL, 0, true);
+  dcd_event_xfer_complete(rhport, EDPT_CTRL_OUT, 0, 0, false);
+  dcd_edpt0_status_complete_ExpectWithArray(rhport, &req_get_desc_device, 1);
+
+  tud_task();
+}
+
+// Check an Enhanced Packet Block and its usbmon header, return pointer to next block
+static uint8_t const* check_epb(uint8_t const* p, uint8_t type, uint8_t ep_addr, bool has_setup, uint32_t length,
+                                void const* data, uint32_t datalen, int32_t status) {
+  uint32_t const pkt_len = USBMON_LEN + datalen;
+  uint32_t const block_len = EPB_LEN + ((pkt_len + 3) & ~3u);
+
+  TEST_ASSERT_EQUAL_HEX32(0x00000006, rd_u32(p));
+  TEST_ASSERT_EQUAL_UINT32(block_len, rd_u32(p + 4));
+  TEST_ASSERT_EQUAL_UINT32(block_len, rd_u32(p + block_len - 4));
+  TEST_ASSERT_EQUAL_UINT32(0, rd_u32(p + 8));  // interface id
+  TEST_ASSERT_EQUAL_UINT32(0, rd_u32(p + 12)); // timestamp high
+  TEST_ASSERT_EQUAL_UINT32(time_ms * 1000, rd_u32(p + 16));
+  TEST_ASSERT_EQUAL_UINT32(pkt_len, rd_u32(p + 20));
+  TEST_ASSERT_EQUAL_UINT32(USBMON_LEN + length, rd_u32(p + 24));
+
+  // struct usbmon_packet
+  uint8_t const* mon = p + 28;
+  TEST_ASSERT_EQUAL_HEX8(type, mon[8]);
+  TEST_ASSERT_EQUAL(2, mon[9]); // control
+  TEST_ASSERT_EQUAL_HEX8(ep_addr, mon[10]);
+  TEST_ASSERT_EQUAL(0, mon[11]); // devnum
+  TEST_ASSERT_EQUAL_HEX8(0x81, mon[12]); // busnum of device stack on rhport 0
+  TEST_ASSERT_EQUAL(0, mon[13]);
+  TEST_ASSERT_EQUAL(has_setup ? 0 : '-', mon[14]);
+  TEST_ASSERT_EQUAL(datalen ? 0 : (tu_edpt_dir(ep_addr) ? '<' : '>'), mon[15]);
+
+  int64_t ts_sec;
+  int32_t ts_usec, mon_status;
+  memcpy(&ts_sec, mon + 16, 8);
+  memcpy(&ts_usec, mon + 24, 4);
+  memcpy(&mon_status, mon + 28, 4);
+  TEST_ASSERT_EQUAL(time_ms / 1000, ts_sec);
+  TEST_ASSERT_EQUAL((time_ms % 1000) * 1000, ts_usec);
+  TEST_ASSERT_EQUAL_INT32(status, mon_status);
+  TEST_ASSERT_EQUAL_UINT32(length, rd_u32(mon + 32));
+  TEST_ASSERT_EQUAL_UINT32(datalen, rd_u32(mon + 36));
+  if (has_setup) {
+    TEST_ASSERT_EQUAL_MEMORY(&req_get_desc_device, mon + 40, 8);
+  }
+
+  // payload then zero padding to 32-bit boundary
+  uint8_t const* payload = mon + USBMON_LEN;
+  if (datalen) {
+    TEST_ASSERT_EQUAL_MEMORY(data, payload, datalen);
+  }
+  for (uint32_t i = datalen; i < ((datalen + 3) & ~3u); i++) {
+    TEST_ASSERT_EQUAL(0, payload[i]);
+  }
+
+  return p + block_len;
+}
+
+//--------------------------------------------------------------------+
+// Tests
+//--------------------------------------------------------------------+
+
+// Section and interface headers with if_tsresol option padded to 32-bit
+void test_capture_headers(void) {
+  TEST_ASSERT_EQUAL(SHB_LEN + IDB_LEN, tusb_capture_read(pcap, sizeof(pcap)));
+
+  // Section Header Block
+  TEST_ASSERT_EQUAL_HEX32(0x0A0D0D0A, rd_u32(pcap));
+  TEST_ASSERT_EQUAL_UINT32(SHB_LEN, rd_u32(pcap + 4));
+  TEST_ASSERT_EQUAL_HEX32(0x1A2B3C4D, rd_u32(pcap + 8));
+  TEST_ASSERT_EQUAL_HEX32(0x00000001, rd_u32(pcap + 12)); // major 1, minor 0
+  TEST_ASSERT_EQUAL_HEX32(UINT32_MAX, rd_u32(pcap + 16));
+  TEST_ASSERT_EQUAL_HEX32(UINT32_MAX, rd_u32(pcap + 20));
+  TEST_ASSERT_EQUAL_UINT32(SHB_LEN, rd_u32(pcap + SHB_LEN - 4));
+
+  // Interface Description Block
+  uint8_t const* idb = pcap + SHB_LEN;
+  TEST_ASSERT_EQUAL_HEX32(0x00000001, rd_u32(idb));
+  TEST_ASSERT_EQUAL_UINT32(IDB_LEN, rd_u32(idb + 4));
+  TEST_ASSERT_EQUAL_UINT32(220, rd_u32(idb + 8)); // LINKTYPE_USB_LINUX_MMAPPED, reserved
+  TEST_ASSERT_EQUAL_UINT32(USBMON_LEN + CFG_TUSB_CAPTURE_PAYLOAD_MAX, rd_u32(idb + 12));
+  TEST_ASSERT_EQUAL_HEX32(9 | (1u << 16), rd_u32(idb + 16)); // if_tsresol, length 1
+  TEST_ASSERT_EQUAL_HEX32(6, rd_u32(idb + 20));              // microsecond, 3 padding bytes
+  TEST_ASSERT_EQUAL_HEX32(0, rd_u32(idb + 24));              // opt_endofopt
+  TEST_ASSERT_EQUAL_UINT32(IDB_LEN, rd_u32(idb + IDB_LEN - 4));
+
+  // headers are only sent once until restart
+  TEST_ASSERT_EQUAL(0, tusb_capture_read(pcap, sizeof(pcap)));
+  tusb_capture_restart();
+  TEST_ASSERT_EQUAL(SHB_LEN + IDB_LEN, tusb_capture_read(pcap, sizeof(pcap)));
+}
+
+// Setup, data and status stage of a short control transfer
+void test_capture_control_in(void) {
+  control_get_device_descriptor();
+
+  uint32_t const count = tusb_capture_read(pcap, sizeof(pcap));
+  uint8_t const* p = pcap + SHB_LEN + IDB_LEN;
+
+  p = check_epb(p, 'S', EDPT_CTRL_IN, true, req_get_desc_device.wLength, NULL, 0, -115);
+  p = check_epb(p, 'S', EDPT_CTRL_IN, false, sizeof(tusb_desc_device_t), NULL, 0, -115);
+  p = check_epb(p, 'C', EDPT_CTRL_IN, false, sizeof(tusb_desc_device_t), &data_desc_device,
+                sizeof(tusb_desc_device_t), 0);
+  p = check_epb(p, 'S', EDPT_CTRL_OUT, false, 0, NULL, 0, -115);
+  p = check_epb(p, 'C', EDPT_CTRL_OUT, false, 0, NULL, 0, 0);
+
+  TEST_ASSERT_EQUAL(p - pcap, count);
+  TEST_ASSERT_EQUAL(0, tusb_capture_dropped());
+}
+
+// Only complete blocks are returned, the rest is kept for next read
+void test_capture_partial_read(void) {
+  control_get_device_descriptor();
+
+  uint32_t const setup_len = EPB_LEN + USBMON_LEN;
+  TEST_ASSERT_EQUAL(SHB_LEN + IDB_LEN, tusb_capture_read(pcap, SHB_LEN + IDB_LEN + setup_len - 1));
+  TEST_ASSERT_EQUAL(setup_len, tusb_capture_read(pcap, setup_len + 4 * 12));
+  check_epb(pcap, 'S', EDPT_CTRL_IN, true, req_get_desc_device.wLength, NULL, 0, -115);
+
+  uint32_t const count = tusb_capture_read(pcap, sizeof(pcap));
+  uint8_t const* p = pcap;
+  p = check_epb(p, 'S', EDPT_CTRL_IN, false, sizeof(tusb_desc_device_t), NULL, 0, -115);
+  p = check_epb(p, 'C', EDPT_CTRL_IN, false, sizeof(tusb_desc_device_t), &data_desc_device,
+                sizeof(tusb_desc_device_t), 0);
+  p = check_epb(p, 'S', EDPT_CTRL_OUT, false, 0, NULL, 0, -115);
+  p = check_epb(p, 'C', EDPT_CTRL_OUT, false, 0, NULL, 0, 0);
+  TEST_ASSERT_EQUAL(p - pcap, count);
+}
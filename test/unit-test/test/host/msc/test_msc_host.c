@@ -0,0 +1,324 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Ha Thach (tinyusb.org)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * This file is part of the TinyUSB stack.
+ */
+
+// MSC host command queue and data stage, built as host without scatter-gather transfer (see project.yml)
+
+#include "unity.h"
+
+// Files to test
+#include "tusb_option.h"
+#include "msc_host.h"
+
+// Mock File
+#include "mock_usbh.h"
+#include "mock_usbh_pvt.h"
+
+//--------------------------------------------------------------------+
+// MACRO TYPEDEF CONSTANT ENUM DECLARATION
+//--------------------------------------------------------------------+
+TU_VERIFY_STATIC(CFG_TUH_ENABLED && CFG_TUH_MSC, "test requires host MSC");
+TU_VERIFY_STATIC(CFG_TUH_API_EDPT_XFER_SG == 0, "test requires data stage without scatter-gather");
+
+enum {
+  DADDR = 1,
+  ITF_NUM_MSC = 0,
+  EDPT_MSC_OUT = 0x01,
+  EDPT_MSC_IN  = 0x81,
+  BLOCK_SIZE = 512,
+};
+
+// matches chunk size of msc_host.c
+#define DATA_CHUNK_MAX  0xFC00u
+
+uint8_t const desc_msc_itf[] = {
+  // Interface
+  9, TUSB_DESC_INTERFACE, ITF_NUM_MSC, 0, 2, TUSB_CLASS_MSC, MSC_SUBCLASS_SCSI, MSC_PROTOCOL_BOT, 0,
+  // Endpoint Out
+  7, TUSB_DESC_ENDPOINT, EDPT_MSC_OUT, TUSB_XFER_BULK, U16_TO_U8S_LE(512), 0,
+  // Endpoint In
+  7, TUSB_DESC_ENDPOINT, EDPT_MSC_IN, TUSB_XFER_BULK, U16_TO_U8S_LE(512), 0
+};
+
+static uint8_t enum_buf[64];
+static uint8_t data_buf[256 * BLOCK_SIZE];
+
+static uint32_t complete_count;
+static msc_csw_t complete_csw;
+static uintptr_t complete_arg;
+
+static msc_csw_t const csw_passed = {
+  .signature = MSC_CSW_SIGNATURE,
+  .tag = 0x54555342,
+  .data_residue = 0,
+  .status = MSC_CSW_STATUS_PASSED
+};
+
+static bool complete_cb(uint8_t dev_addr, tuh_msc_complete_data_t const* cb_data) {
+  TEST_ASSERT_EQUAL(DADDR, dev_addr);
+  complete_count++;
+  complete_csw = *cb_data->csw;
+  complete_arg = cb_data->user_arg;
+  return true;
+}
+
+//--------------------------------------------------------------------+
+// Setup/Teardown + helper declare
+//--------------------------------------------------------------------+
+void setUp(void) {
+  complete_count = 0;
+  tu_memclr(&complete_csw, sizeof(complete_csw));
+  complete_arg = 0;
+
+  msch_init();
+  tuh_edpt_open_IgnoreAndReturn(true);
+  TEST_ASSERT_TRUE(msch_open(0, DADDR, (tusb_desc_interface_t const*) desc_msc_itf, sizeof(desc_msc_itf)));
+
+  // GET_MAX_LUN never completes, tests drive the command queue directly
+  usbh_get_enum_buf_IgnoreAndReturn(enum_buf);
+  tuh_control_xfer_IgnoreAndReturn(true);
+  TEST_ASSERT_TRUE(msch_set_config(DADDR, ITF_NUM_MSC));
+}
+
+void tearDown(void) {
+  msch_close(DADDR);
+}
+
+static void expect_cbw(void) {
+  usbh_edpt_claim_ExpectAndReturn(DADDR, EDPT_MSC_OUT, true);
+  usbh_edpt_xfer_with_callback_ExpectAndReturn(DADDR, EDPT_MSC_OUT, NULL, sizeof(msc_cbw_t), NULL, 0, true);
+  usbh_edpt_xfer_with_callback_IgnoreArg_buffer();
+}
+
+static void expect_data(uint32_t offset, uint16_t len) {
+  usbh_edpt_xfer_with_callback_ExpectAndReturn(DADDR, EDPT_MSC_IN, data_buf + offset, len, NULL, 0, true);
+}
+
+static void expect_csw(msc_csw_t const* csw) {
+  usbh_edpt_xfer_with_callback_ExpectAndReturn(DADDR, EDPT_MSC_IN, NULL, sizeof(msc_csw_t), NULL, 0, true);
+  usbh_edpt_xfer_with_callback_IgnoreArg_buffer();
+  usbh_edpt_xfer_with_callback_ReturnMemThruPtr_buffer((uint8_t*) (uintptr_t) csw, sizeof(msc_csw_t));
+}
+
+//--------------------------------------------------------------------+
+// Data stage
+//--------------------------------------------------------------------+
+// READ16 with data stage of total_bytes, device is not mounted since enumeration is skipped
+static bool read16_submit(uint32_t total_bytes, uintptr_t arg) {
+  msc_cbw_t cbw;
+  tu_memclr(&cbw, sizeof(cbw));
+  cbw.signature = MSC_CBW_SIGNATURE;
+  cbw.tag = csw_passed.tag;
+  cbw.total_bytes = total_bytes;
+  cbw.dir = TUSB_DIR_IN_MASK;
+  cbw.cmd_len = sizeof(scsi_read16_t);
+  cbw.command[0] = SCSI_CMD_READ_16;
+
+  return tuh_msc_scsi_command(DADDR, &cbw, data_buf, complete_cb, arg);
+}
+
+// Data stage larger than 16-bit transfer length is split into chunks
+void test_msc_read16_split_data_stage(void) {
+  uint32_t const total = sizeof(data_buf);
+  uint32_t const last_len = total - 2 * DATA_CHUNK_MAX;
+
+  expect_cbw();
+  TEST_ASSERT_TRUE(read16_submit(total, 0x55));
+
+  expect_data(0, DATA_CHUNK_MAX);
+  msch_xfer_cb(DADDR, EDPT_MSC_OUT, XFER_RESULT_SUCCESS, sizeof(msc_cbw_t));
+
+  expect_data(DATA_CHUNK_MAX, DATA_CHUNK_MAX);
+  msch_xfer_cb(DADDR, EDPT_MSC_IN, XFER_RESULT_SUCCESS, DATA_CHUNK_MAX);
+
+  expect_data(2 * DATA_CHUNK_MAX, (uint16_t) last_len);
+  msch_xfer_cb(DADDR, EDPT_MSC_IN, XFER_RESULT_SUCCESS, DATA_CHUNK_MAX);
+
+  expect_csw(&csw_passed);
+  msch_xfer_cb(DADDR, EDPT_MSC_IN, XFER_RESULT_SUCCESS, last_len);
+  TEST_ASSERT_EQUAL(0, complete_count);
+
+  msch_xfer_cb(DADDR, EDPT_MSC_IN, XFER_RESULT_SUCCESS, sizeof(msc_csw_t));
+  TEST_ASSERT_EQUAL(1, complete_count);
+  TEST_ASSERT_EQUAL(MSC_CSW_STATUS_PASSED, complete_csw.status);
+  TEST_ASSERT_EQUAL(0x55, complete_arg);
+  TEST_ASSERT_EQUAL(0, tuh_msc_cmd_pending(DADDR));
+}
+
+// Short packet ends data stage without requesting remaining chunks
+void test_msc_read16_short_chunk(void) {
+  uint32_t const total = 2 * DATA_CHUNK_MAX;
+
+  expect_cbw();
+  TEST_ASSERT_TRUE(read16_submit(total, 0));
+
+  expect_data(0, DATA_CHUNK_MAX);
+  msch_xfer_cb(DADDR, EDPT_MSC_OUT, XFER_RESULT_SUCCESS, sizeof(msc_cbw_t));
+
+  msc_csw_t csw = csw_passed;
+  csw.data_residue = total - 100;
+  expect_csw(&csw);
+  msch_xfer_cb(DADDR, EDPT_MSC_IN, XFER_RESULT_SUCCESS, 100);
+
+  msch_xfer_cb(DADDR, EDPT_MSC_IN, XFER_RESULT_SUCCESS, sizeof(msc_csw_t));
+  TEST_ASSERT_EQUAL(1, complete_count);
+  TEST_ASSERT_EQUAL(total - 100, complete_csw.data_residue);
+}
+
+//--------------------------------------------------------------------+
+// Command queue
+//--------------------------------------------------------------------+
+
+// Completed command is reported before next queued command is sent
+static bool complete_check_order_cb(uint8_t dev_addr, tuh_msc_complete_data_t const* cb_data) {
+  // mocked call is strictly ordered against CBW of next command
+  (void) usbh_edpt_busy(dev_addr, EDPT_MSC_OUT);
+  return complete_cb(dev_addr, cb_data);
+}
+
+void test_msc_complete_before_next_start(void) {
+  expect_cbw();
+  TEST_ASSERT_TRUE(tuh_msc_test_unit_ready(DADDR, 0, complete_check_order_cb, 1));
+  TEST_ASSERT_TRUE(tuh_msc_test_unit_ready(DADDR, 0, complete_cb, 2));
+  TEST_ASSERT_EQUAL(2, tuh_msc_cmd_pending(DADDR));
+
+  expect_csw(&csw_passed);
+  msch_xfer_cb(DADDR, EDPT_MSC_OUT, XFER_RESULT_SUCCESS, sizeof(msc_cbw_t));
+
+  usbh_edpt_busy_ExpectAndReturn(DADDR, EDPT_MSC_OUT, false);
+  expect_cbw();
+  msch_xfer_cb(DADDR, EDPT_MSC_IN, XFER_RESULT_SUCCESS, sizeof(msc_csw_t));
+  TEST_ASSERT_EQUAL(1, complete_count);
+  TEST_ASSERT_EQUAL(1, complete_arg);
+}
+
+// Queued command that cannot be started is completed with failed status, and the one after it is started
+void test_msc_next_start_failed(void) {
+  expect_cbw();
+  TEST_ASSERT_TRUE(tuh_msc_test_unit_ready(DADDR, 0, complete_cb, 1));
+  TEST_ASSERT_TRUE(tuh_msc_test_unit_ready(DADDR, 0, complete_cb, 2));
+  TEST_ASSERT_TRUE(tuh_msc_test_unit_ready(DADDR, 0, complete_cb, 3));
+
+  expect_csw(&csw_passed);
+  msch_xfer_cb(DADDR, EDPT_MSC_OUT, XFER_RESULT_SUCCESS, sizeof(msc_cbw_t));
+
+  usbh_edpt_claim_ExpectAndReturn(DADDR, EDPT_MSC_OUT, false);
+  expect_cbw();
+  msch_xfer_cb(DADDR, EDPT_MSC_IN, XFER_RESULT_SUCCESS, sizeof(msc_csw_t));
+
+  TEST_ASSERT_EQUAL(2, complete_count);
+  TEST_ASSERT_EQUAL(2, complete_arg);
+  TEST_ASSERT_EQUAL(MSC_CSW_STATUS_FAILED, complete_csw.status);
+  TEST_ASSERT_EQUAL(1, tuh_msc_cmd_pending(DADDR));
+}
+
+// Closing device completes all queued commands with failed status
+void test_msc_close_fails_queued(void) {
+  expect_cbw();
+  TEST_ASSERT_TRUE(tuh_msc_test_unit_ready(DADDR, 0, complete_cb, 1));
+  TEST_ASSERT_TRUE(tuh_msc_test_unit_ready(DADDR, 0, complete_cb, 2));
+
+  msch_close(DADDR);
+  TEST_ASSERT_EQUAL(2, complete_count);
+  TEST_ASSERT_EQUAL(2, complete_arg);
+  TEST_ASSERT_EQUAL(MSC_CSW_STATUS_FAILED, complete_csw.status);
+  TEST_ASSERT_FALSE(tuh_msc_test_unit_ready(DADDR, 0, complete_cb, 3));
+}
+
+//--------------------------------------------------------------------+
+// Transfer failure
+//--------------------------------------------------------------------+
+
+// Failed CBW transfer completes the command with failed status and starts the next one
+void test_msc_cbw_failed(void) {
+  expect_cbw();
+  TEST_ASSERT_TRUE(tuh_msc_test_unit_ready(DADDR, 0, complete_cb, 1));
+  TEST_ASSERT_TRUE(tuh_msc_test_unit_ready(DADDR, 0, complete_cb, 2));
+
+  expect_cbw();
+  msch_xfer_cb(DADDR, EDPT_MSC_OUT, XFER_RESULT_FAILED, 0);
+  TEST_ASSERT_EQUAL(1, complete_count);
+  TEST_ASSERT_EQUAL(1, complete_arg);
+  TEST_ASSERT_EQUAL(MSC_CSW_STATUS_FAILED, complete_csw.status);
+  TEST_ASSERT_EQUAL(1, tuh_msc_cmd_pending(DADDR));
+
+  expect_csw(&csw_passed);
+  msch_xfer_cb(DADDR, EDPT_MSC_OUT, XFER_RESULT_SUCCESS, sizeof(msc_cbw_t));
+  msch_xfer_cb(DADDR, EDPT_MSC_IN, XFER_RESULT_SUCCESS, sizeof(msc_csw_t));
+  TEST_ASSERT_EQUAL(2, complete_count);
+  TEST_ASSERT_EQUAL(2, complete_arg);
+  TEST_ASSERT_EQUAL(MSC_CSW_STATUS_PASSED, complete_csw.status);
+  TEST_ASSERT_EQUAL(0, tuh_msc_cmd_pending(DADDR));
+}
+
+// Stalled data stage completes the command with failed status and full residue, next command is started
+void test_msc_data_stalled(void) {
+  uint32_t const total = 2 * DATA_CHUNK_MAX;
+
+  expect_cbw();
+  TEST_ASSERT_TRUE(read16_submit(total, 1));
+  TEST_ASSERT_TRUE(tuh_msc_test_unit_ready(DADDR, 0, complete_cb, 2));
+
+  expect_data(0, DATA_CHUNK_MAX);
+  msch_xfer_cb(DADDR, EDPT_MSC_OUT, XFER_RESULT_SUCCESS, sizeof(msc_cbw_t));
+
+  expect_cbw();
+  msch_xfer_cb(DADDR, EDPT_MSC_IN, XFER_RESULT_STALLED, 0);
+  TEST_ASSERT_EQUAL(1, complete_count);
+  TEST_ASSERT_EQUAL(1, complete_arg);
+  TEST_ASSERT_EQUAL(MSC_CSW_STATUS_FAILED, complete_csw.status);
+  TEST_ASSERT_EQUAL(total, complete_csw.data_residue);
+  TEST_ASSERT_EQUAL(1, tuh_msc_cmd_pending(DADDR));
+}
+
+// Data chunk that cannot be submitted fails the command instead of leaving the queue stuck
+void test_msc_data_submit_failed(void) {
+  uint32_t const total = 2 * DATA_CHUNK_MAX;
+
+  expect_cbw();
+  TEST_ASSERT_TRUE(read16_submit(total, 1));
+  TEST_ASSERT_TRUE(tuh_msc_test_unit_ready(DADDR, 0, complete_cb, 2));
+
+  usbh_edpt_xfer_with_callback_ExpectAndReturn(DADDR, EDPT_MSC_IN, data_buf, DATA_CHUNK_MAX, NULL, 0, false);
+  expect_cbw();
+  msch_xfer_cb(DADDR, EDPT_MSC_OUT, XFER_RESULT_SUCCESS, sizeof(msc_cbw_t));
+  TEST_ASSERT_EQUAL(1, complete_count);
+  TEST_ASSERT_EQUAL(MSC_CSW_STATUS_FAILED, complete_csw.status);
+  TEST_ASSERT_EQUAL(1, tuh_msc_cmd_pending(DADDR));
+}
+
+// Failed CSW transfer completes the last command with failed status, queue is empty afterward
+void test_msc_csw_failed(void) {
+  expect_cbw();
+  TEST_ASSERT_TRUE(tuh_msc_test_unit_ready(DADDR, 0, complete_cb, 1));
+
+  expect_csw(&csw_passed);
+  msch_xfer_cb(DADDR, EDPT_MSC_OUT, XFER_RESULT_SUCCESS, sizeof(msc_cbw_t));
+
+  msch_xfer_cb(DADDR, EDPT_MSC_IN, XFER_RESULT_STALLED, 0);
+  TEST_ASSERT_EQUAL(1, complete_count);
+  TEST_ASSERT_EQUAL(MSC_CSW_STATUS_FAILED, complete_csw.status);
+  TEST_ASSERT_EQUAL(0, tuh_msc_cmd_pending(DADDR));
+}
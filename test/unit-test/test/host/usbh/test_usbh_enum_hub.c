@@ -0,0 +1,573 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Ha Thach (tinyusb.org)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * This file is part of the TinyUSB stack.
+ */
+
+// Enumeration of two devices behind an emulated 2-port hub, built as host with hub and
+// CFG_TUH_ENUMERATION_CONCURRENT = 2 (see project.yml). Expected order also holds when built with a single slot.
+
+#include <string.h>
+#include "unity.h"
+
+// Files to test
+#include "osal/osal.h"
+#include "tusb_fifo.h"
+#include "tusb.h"
+#include "usbh.h"
+#include "hub.h"
+#include "hcd.h"
+
+TU_VERIFY_STATIC(CFG_TUH_ENABLED && CFG_TUH_HUB && CFG_TUH_DEVICE_MAX >= 2, "test requires host with hub");
+
+//--------------------------------------------------------------------+
+// MACRO TYPEDEF CONSTANT ENUM DECLARATION
+//--------------------------------------------------------------------+
+enum {
+  RHPORT = 0,
+  HUB_ADDR = CFG_TUH_DEVICE_MAX + 1,
+  HUB_EP_STATUS = 0x81,
+  HUB_PORT_COUNT = 2,
+  RUN_STEP_MAX = 1000,
+  HUB_POLL_MAX = 8, // status reports per run() without any control transfer in between
+  LOG_MAX = 128
+};
+
+uint8_t const desc_hub_device[] = {
+  18, TUSB_DESC_DEVICE, U16_TO_U8S_LE(0x0200), TUSB_CLASS_HUB, 0, 0, 64,
+  U16_TO_U8S_LE(0xCafe), U16_TO_U8S_LE(0x4000), U16_TO_U8S_LE(0x0100), 0, 0, 0, 1
+};
+
+uint8_t const desc_hub_config[] = {
+  9, TUSB_DESC_CONFIGURATION, U16_TO_U8S_LE(25), 1, 1, 0, 0xE0, 50,
+  9, TUSB_DESC_INTERFACE, 0, 0, 1, TUSB_CLASS_HUB, 0, 0, 0,
+  7, TUSB_DESC_ENDPOINT, HUB_EP_STATUS, TUSB_XFER_INTERRUPT, U16_TO_U8S_LE(1), 12
+};
+
+uint8_t const desc_hub_cs[] = {
+  9, 0x29, HUB_PORT_COUNT, U16_TO_U8S_LE(0), 50, 0, 0, 0xff
+};
+
+uint8_t const desc_vendor_device[] = {
+  18, TUSB_DESC_DEVICE, U16_TO_U8S_LE(0x0200), TUSB_CLASS_VENDOR_SPECIFIC, 0, 0, 64,
+  U16_TO_U8S_LE(0xCafe), U16_TO_U8S_LE(0x4001), U16_TO_U8S_LE(0x0100), 0, 0, 0, 1
+};
+
+uint8_t const desc_vendor_config[] = {
+  9, TUSB_DESC_CONFIGURATION, U16_TO_U8S_LE(18), 1, 1, 0, 0x80, 50,
+  9, TUSB_DESC_INTERFACE, 0, 0, 0, TUSB_CLASS_VENDOR_SPECIFIC, 0, 0, 0
+};
+
+uint8_t const desc_langid[] = { 4, TUSB_DESC_STRING, U16_TO_U8S_LE(0x0409) };
+
+// emulated device: hub on root port, vendor devices on hub port 1 and 2
+typedef struct {
+  uint8_t const* desc_device;
+  uint8_t const* desc_config;
+  uint8_t addr;
+  uint8_t new_addr;          // SET_ADDRESS takes effect after status stage
+  uint8_t unplug_desc_type;  // device is unplugged when GET_DESCRIPTOR of this type is requested
+  hub_port_status_response_t port; // status of hub port this device is attached to
+} fake_device_t;
+
+enum { DEV_HUB = 0, DEV_PORT1, DEV_PORT2, DEV_COUNT };
+static fake_device_t fake_dev[DEV_COUNT];
+static fake_device_t* dev0_target; // device responding to address 0
+
+// pending transfer completions, delivered one at a time by run()
+typedef struct {
+  uint8_t daddr;
+  uint8_t ep_addr;
+  uint16_t len;
+  xfer_result_t result;
+} fake_xfer_t;
+
+static fake_xfer_t xfer_q[16];
+static uint8_t xfer_q_count;
+
+// data stage of control request in progress of each address
+static struct {
+  uint8_t const* data;
+  uint16_t data_len;
+} ctrl[HUB_ADDR + 1];
+
+static uint8_t* hub_status_buf; // armed interrupt transfer of hub status endpoint
+
+// control requests seen by devices
+typedef struct {
+  uint8_t daddr;
+  uint8_t type;
+  uint8_t bRequest;
+  uint16_t wValue;
+  uint16_t wIndex;
+} setup_log_t;
+
+static setup_log_t setup_log[LOG_MAX];
+static uint8_t setup_log_count;
+
+static uint8_t mount_count;
+static uint8_t mount_addr[4];
+
+//--------------------------------------------------------------------+
+// Emulated host controller with hub
+//--------------------------------------------------------------------+
+uint32_t tusb_time_millis_api(void) {
+  static uint32_t ms;
+  return ms++; // every call advances time, delays complete immediately
+}
+
+static fake_device_t* fake_device_find(uint8_t daddr) {
+  if (daddr == 0) {
+    return dev0_target;
+  }
+  for (uint8_t i = 0; i < DEV_COUNT; i++) {
+    if (fake_dev[i].addr == daddr) {
+      return &fake_dev[i];
+    }
+  }
+  return NULL;
+}
+
+static void xfer_queue(uint8_t daddr, uint8_t ep_addr, uint16_t len, xfer_result_t result) {
+  TEST_ASSERT_LESS_THAN(TU_ARRAY_SIZE(xfer_q), xfer_q_count);
+  xfer_q[xfer_q_count++] = (fake_xfer_t) { .daddr = daddr, .ep_addr = ep_addr, .len = len, .result = result };
+}
+
+static void xfer_drop(uint8_t daddr, uint8_t ep_addr, bool all_ep) {
+  uint8_t count = 0;
+  for (uint8_t i = 0; i < xfer_q_count; i++) {
+    bool const match = xfer_q[i].daddr == daddr && (all_ep || tu_edpt_number(xfer_q[i].ep_addr) == tu_edpt_number(ep_addr));
+    if (!match) {
+      xfer_q[count++] = xfer_q[i];
+    }
+  }
+  xfer_q_count = count;
+}
+
+static uint8_t hub_status_change(void) {
+  uint8_t bitmap = 0;
+  for (uint8_t port = 1; port <= HUB_PORT_COUNT; port++) {
+    if (fake_dev[port].port.change.value) {
+      bitmap |= TU_BIT(port);
+    }
+  }
+  return bitmap;
+}
+
+// respond to hub class request, return false if not supported
+static bool hub_request(tusb_control_request_t const* request, uint8_t* data, uint16_t* data_len) {
+  if (request->bmRequestType_bit.recipient == TUSB_REQ_RCPT_DEVICE) {
+    switch (request->bRequest) {
+      case HUB_REQUEST_GET_DESCRIPTOR:
+        memcpy(data, desc_hub_cs, sizeof(desc_hub_cs));
+        *data_len = sizeof(desc_hub_cs);
+        return true;
+
+      case HUB_REQUEST_GET_STATUS:
+        memset(data, 0, 4);
+        *data_len = 4;
+        return true;
+
+      default: return false;
+    }
+  }
+
+  uint8_t const port = (uint8_t) request->wIndex;
+  TU_VERIFY(port >= 1 && port <= HUB_PORT_COUNT);
+  fake_device_t* dev = &fake_dev[port];
+
+  switch (request->bRequest) {
+    case HUB_REQUEST_GET_STATUS:
+      memcpy(data, &dev->port, sizeof(dev->port));
+      *data_len = sizeof(dev->port);
+      return true;
+
+    case HUB_REQUEST_SET_FEATURE:
+      if (request->wValue == HUB_FEATURE_PORT_POWER) {
+        dev->port.status.port_power = 1;
+      } else if (request->wValue == HUB_FEATURE_PORT_RESET && dev->port.status.connection) {
+        dev->port.status.port_enable = 1;
+        dev->port.change.reset = 1;
+        dev->addr = 0;
+        dev0_target = dev;
+      }
+      return true;
+
+    case HUB_REQUEST_CLEAR_FEATURE:
+      if (request->wValue == HUB_FEATURE_PORT_CONNECTION_CHANGE) {
+        dev->port.change.connection = 0;
+      } else if (request->wValue == HUB_FEATURE_PORT_RESET_CHANGE) {
+        dev->port.change.reset = 0;
+      } else if (request->wValue == HUB_FEATURE_PORT_ENABLE_CHANGE) {
+        dev->port.change.port_enable = 0;
+      }
+      return true;
+
+    default: return false;
+  }
+}
+
+bool hcd_init(uint8_t rhport, const tusb_rhport_init_t* rh_init) {
+  (void) rhport;
+  (void) rh_init;
+  return true;
+}
+
+bool hcd_deinit(uint8_t rhport) {
+  (void) rhport;
+  return true;
+}
+
+bool hcd_configure(uint8_t rhport, uint32_t cfg_id, const void* cfg_param) {
+  (void) rhport;
+  (void) cfg_id;
+  (void) cfg_param;
+  return false;
+}
+
+void hcd_int_handler(uint8_t rhport, bool in_isr) {
+  (void) rhport;
+  (void) in_isr;
+}
+
+void hcd_int_enable(uint8_t rhport) {
+  (void) rhport;
+}
+
+void hcd_int_disable(uint8_t rhport) {
+  (void) rhport;
+}
+
+uint32_t hcd_frame_number(uint8_t rhport) {
+  (void) rhport;
+  return tusb_time_millis_api();
+}
+
+bool hcd_port_connect_status(uint8_t rhport) {
+  (void) rhport;
+  return true;
+}
+
+void hcd_port_reset(uint8_t rhport) {
+  (void) rhport;
+  fake_dev[DEV_HUB].addr = 0;
+  dev0_target = &fake_dev[DEV_HUB];
+}
+
+void hcd_port_reset_end(uint8_t rhport) {
+  (void) rhport;
+}
+
+tusb_speed_t hcd_port_speed_get(uint8_t rhport) {
+  (void) rhport;
+  return TUSB_SPEED_FULL;
+}
+
+void hcd_device_close(uint8_t rhport, uint8_t dev_addr) {
+  (void) rhport;
+  xfer_drop(dev_addr, 0, true);
+  if (dev_addr == HUB_ADDR) {
+    hub_status_buf = NULL;
+  }
+}
+
+bool hcd_edpt_open(uint8_t rhport, uint8_t daddr, tusb_desc_endpoint_t const* ep_desc) {
+  (void) rhport;
+  (void) daddr;
+  (void) ep_desc;
+  return true;
+}
+
+bool hcd_edpt_close(uint8_t rhport, uint8_t daddr, uint8_t ep_addr) {
+  (void) rhport;
+  (void) daddr;
+  (void) ep_addr;
+  return true;
+}
+
+bool hcd_edpt_clear_stall(uint8_t rhport, uint8_t dev_addr, uint8_t ep_addr) {
+  (void) rhport;
+  (void) dev_addr;
+  (void) ep_addr;
+  return true;
+}
+
+bool hcd_edpt_abort_xfer(uint8_t rhport, uint8_t dev_addr, uint8_t ep_addr) {
+  (void) rhport;
+  xfer_drop(dev_addr, ep_addr, false);
+  if (dev_addr == HUB_ADDR && ep_addr == HUB_EP_STATUS) {
+    hub_status_buf = NULL;
+  }
+  return true;
+}
+
+bool hcd_setup_send(uint8_t rhport, uint8_t daddr, uint8_t const setup_packet[8]) {
+  (void) rhport;
+  static uint8_t data[64];
+
+  fake_device_t* dev = fake_device_find(daddr);
+  if (dev == NULL) {
+    xfer_queue(daddr, 0x00, 0, XFER_RESULT_FAILED); // no response
+    return true;
+  }
+
+  tusb_control_request_t const* request = (tusb_control_request_t const*) setup_packet;
+  ctrl[daddr].data = data;
+  ctrl[daddr].data_len = 0;
+
+  TEST_ASSERT_LESS_THAN(LOG_MAX, setup_log_count);
+  setup_log[setup_log_count++] = (setup_log_t) {
+    .daddr = daddr,
+    .type = request->bmRequestType_bit.type,
+    .bRequest = request->bRequest,
+    .wValue = request->wValue,
+    .wIndex = request->wIndex
+  };
+
+  if (request->bmRequestType_bit.type == TUSB_REQ_TYPE_CLASS) {
+    TEST_ASSERT_EQUAL_PTR(&fake_dev[DEV_HUB], dev);
+    TEST_ASSERT_TRUE(hub_request(request, data, &ctrl[daddr].data_len));
+  } else {
+    switch (request->bRequest) {
+      case TUSB_REQ_GET_DESCRIPTOR: {
+        uint8_t const desc_type = tu_u16_high(request->wValue);
+        if (desc_type == dev->unplug_desc_type) {
+          // hub reports disconnection, request is not answered
+          dev->port.status.connection = 0;
+          dev->port.status.port_enable = 0;
+          dev->port.change.connection = 1;
+          dev->addr = 0;
+          xfer_queue(daddr, 0x00, 0, XFER_RESULT_FAILED);
+          return true;
+        }
+
+        if (desc_type == TUSB_DESC_DEVICE) {
+          ctrl[daddr].data = dev->desc_device;
+          ctrl[daddr].data_len = 18;
+        } else if (desc_type == TUSB_DESC_CONFIGURATION) {
+          ctrl[daddr].data = dev->desc_config;
+          ctrl[daddr].data_len = tu_le16toh(tu_unaligned_read16(dev->desc_config + 2));
+        } else if (desc_type == TUSB_DESC_STRING) {
+          ctrl[daddr].data = desc_langid;
+          ctrl[daddr].data_len = sizeof(desc_langid);
+        } else {
+          TEST_FAIL_MESSAGE("unexpected descriptor request");
+        }
+        break;
+      }
+
+      case TUSB_REQ_SET_ADDRESS:
+        dev->new_addr = (uint8_t) request->wValue;
+        break;
+
+      case TUSB_REQ_SET_CONFIGURATION:
+        break;
+
+      default:
+        TEST_FAIL_MESSAGE("unexpected standard request");
+        break;
+    }
+  }
+
+  xfer_queue(daddr, 0x00, 8, XFER_RESULT_SUCCESS);
+  return true;
+}
+
+bool hcd_edpt_xfer(uint8_t rhport, uint8_t daddr, uint8_t ep_addr, uint8_t* buffer, uint16_t buflen) {
+  (void) rhport;
+
+  if (daddr == HUB_ADDR && ep_addr == HUB_EP_STATUS) {
+    TEST_ASSERT_NULL(hub_status_buf);
+    hub_status_buf = buffer;
+    return true;
+  }
+
+  TEST_ASSERT_EQUAL(0, tu_edpt_number(ep_addr));
+  fake_device_t* dev = fake_device_find(daddr);
+  if (dev == NULL) {
+    xfer_queue(daddr, ep_addr, 0, XFER_RESULT_FAILED); // no response
+    return true;
+  }
+
+  uint16_t len = buflen;
+  if (buflen == 0) {
+    // status stage
+    if (dev->new_addr) {
+      dev->addr = dev->new_addr;
+      dev->new_addr = 0;
+      dev0_target = NULL;
+    }
+  } else if (tu_edpt_dir(ep_addr) == TUSB_DIR_IN) {
+    len = tu_min16(buflen, ctrl[daddr].data_len);
+    memcpy(buffer, ctrl[daddr].data, len);
+  }
+
+  xfer_queue(daddr, ep_addr, len, XFER_RESULT_SUCCESS);
+  return true;
+}
+
+//--------------------------------------------------------------------+
+// Application callbacks
+//--------------------------------------------------------------------+
+void tuh_mount_cb(uint8_t daddr) {
+  TEST_ASSERT_LESS_THAN(TU_ARRAY_SIZE(mount_addr), mount_count);
+  mount_addr[mount_count++] = daddr;
+}
+
+//--------------------------------------------------------------------+
+// Setup/Teardown + helper declare
+//--------------------------------------------------------------------+
+
+// Run host stack until there is nothing left to do: transfers complete one at a time in the order they are submitted,
+// hub status change is reported as soon as its endpoint is polled.
+static void run(void) {
+  uint8_t hub_poll = 0;
+  for (uint16_t step = 0; step < RUN_STEP_MAX; step++) {
+    tuh_task();
+
+    if (hub_status_buf != NULL && hub_status_change() && hub_poll < HUB_POLL_MAX) {
+      hub_status_buf[0] = hub_status_change();
+      hub_status_buf = NULL;
+      hcd_event_xfer_complete(HUB_ADDR, HUB_EP_STATUS, 1, XFER_RESULT_SUCCESS, false);
+      hub_poll++;
+    } else if (xfer_q_count > 0) {
+      fake_xfer_t const xfer = xfer_q[0];
+      xfer_q_count--;
+      memmove(xfer_q, xfer_q + 1, xfer_q_count * sizeof(fake_xfer_t));
+      hcd_event_xfer_complete(xfer.daddr, xfer.ep_addr, xfer.len, xfer.result, false);
+      hub_poll = 0;
+    } else if (!tuh_task_event_ready()) {
+      return;
+    }
+  }
+  TEST_FAIL_MESSAGE("host stack does not settle");
+}
+
+static void plug(uint8_t port) {
+  fake_dev[port].port.status.connection = 1;
+  fake_dev[port].port.change.connection = 1;
+}
+
+// index of first logged request, LOG_MAX if not found
+static uint8_t log_find(uint8_t daddr, uint8_t type, uint8_t bRequest, uint16_t wValue, uint16_t wIndex) {
+  for (uint8_t i = 0; i < setup_log_count; i++) {
+    setup_log_t const* log = &setup_log[i];
+    if (log->daddr == daddr && log->type == type && log->bRequest == bRequest && log->wValue == wValue &&
+        log->wIndex == wIndex) {
+      return i;
+    }
+  }
+  return LOG_MAX;
+}
+
+static uint8_t log_set_address(uint8_t new_addr) {
+  return log_find(0, TUSB_REQ_TYPE_STANDARD, TUSB_REQ_SET_ADDRESS, new_addr, 0);
+}
+
+static uint8_t log_set_config(uint8_t daddr) {
+  return log_find(daddr, TUSB_REQ_TYPE_STANDARD, TUSB_REQ_SET_CONFIGURATION, 1, 0);
+}
+
+static uint8_t log_port_reset(uint8_t port) {
+  return log_find(HUB_ADDR, TUSB_REQ_TYPE_CLASS, HUB_REQUEST_SET_FEATURE, HUB_FEATURE_PORT_RESET, port);
+}
+
+void setUp(void) {
+  tu_memclr(fake_dev, sizeof(fake_dev));
+  fake_dev[DEV_HUB].desc_device = desc_hub_device;
+  fake_dev[DEV_HUB].desc_config = desc_hub_config;
+  for (uint8_t port = 1; port <= HUB_PORT_COUNT; port++) {
+    fake_dev[port].desc_device = desc_vendor_device;
+    fake_dev[port].desc_config = desc_vendor_config;
+  }
+  dev0_target = NULL;
+  xfer_q_count = 0;
+  hub_status_buf = NULL;
+  setup_log_count = 0;
+  mount_count = 0;
+
+  TEST_ASSERT_TRUE(tuh_init(RHPORT));
+
+  // hub is attached to root port, enumerated and polled for status change
+  hcd_event_device_attach(RHPORT, false);
+  run();
+  TEST_ASSERT_TRUE(tuh_mounted(HUB_ADDR));
+  TEST_ASSERT_NOT_NULL(hub_status_buf);
+  setup_log_count = 0;
+}
+
+void tearDown(void) {
+  tuh_deinit(RHPORT);
+}
+
+//--------------------------------------------------------------------+
+// Tests
+//--------------------------------------------------------------------+
+
+// Address 0 phase of second device (port reset) starts once first device is addressed with concurrent enumeration,
+// otherwise after first device is configured. Both are mounted.
+void test_enum_hub_two_devices(void) {
+  plug(1);
+  plug(2);
+  run();
+
+  TEST_ASSERT_EQUAL(2, mount_count);
+  TEST_ASSERT_TRUE(tuh_mounted(1));
+  TEST_ASSERT_TRUE(tuh_mounted(2));
+
+  uint8_t const addr1_set = log_set_address(1);
+  uint8_t const config1_set = log_set_config(1);
+  uint8_t const port2_reset = log_port_reset(2);
+  TEST_ASSERT_LESS_THAN(LOG_MAX, config1_set);
+  TEST_ASSERT_LESS_THAN(LOG_MAX, log_set_config(2));
+  TEST_ASSERT_LESS_THAN(port2_reset, addr1_set);
+  TEST_ASSERT_LESS_THAN(log_set_address(2), port2_reset);
+
+#if CFG_TUH_ENUMERATION_CONCURRENT > 1
+  TEST_ASSERT_LESS_THAN(config1_set, port2_reset);
+#else
+  TEST_ASSERT_GREATER_THAN(config1_set, port2_reset);
+#endif
+}
+// Device unplugged after SET_ADDRESS releases its slot: device on the other port is mounted, and so is the first one
+// when plugged again
+void test_enum_hub_unplug_addressed(void) {
+  fake_dev[DEV_PORT1].unplug_desc_type = TUSB_DESC_CONFIGURATION;
+  plug(1);
+  plug(2);
+  run();
+
+  TEST_ASSERT_EQUAL(1, mount_count);
+  TEST_ASSERT_EQUAL(0, fake_dev[DEV_PORT1].addr);
+  TEST_ASSERT_TRUE(tuh_mounted(fake_dev[DEV_PORT2].addr));
+  TEST_ASSERT_EQUAL(fake_dev[DEV_PORT2].addr, mount_addr[0]);
+
+  fake_dev[DEV_PORT1].unplug_desc_type = 0;
+  plug(1);
+  run();
+
+  TEST_ASSERT_EQUAL(2, mount_count);
+  TEST_ASSERT_TRUE(tuh_mounted(fake_dev[DEV_PORT1].addr));
+  TEST_ASSERT_EQUAL(fake_dev[DEV_PORT1].addr, mount_addr[1]);
+  TEST_ASSERT_TRUE(tuh_mounted(fake_dev[DEV_PORT2].addr));
+}
@@ -376,3 +376,168 @@ void test_rd_idx_wrap()
   TEST_ASSERT_EQUAL(n, 2);
   TEST_ASSERT_EQUAL(ff10.rd_idx, 6);
 }
+
+void test_pow2_idx_wrap()
+{
+  tu_fifo_t ff8;
+  uint8_t buf[8];
+  uint8_t dst[8];
+
+  tu_fifo_config(&ff8, buf, 8, 1, 1);
+  TEST_ASSERT_TRUE(ff8.pow2);
+  TEST_ASSERT_TRUE(tu_ff.pow2);
+
+  uint16_t n;
+
+  ff8.wr_idx = 4;
+  ff8.rd_idx = 13;
+  TEST_ASSERT_EQUAL(7, tu_fifo_count(&ff8));
+
+  n = tu_fifo_read_n(&ff8, dst, 4);
+  TEST_ASSERT_EQUAL(n, 4);
+  TEST_ASSERT_EQUAL(ff8.rd_idx, 1);
+  n = tu_fifo_read_n(&ff8, dst, 4);
+  TEST_ASSERT_EQUAL(n, 3);
+  TEST_ASSERT_EQUAL(ff8.rd_idx, 4);
+
+  // overflow: only the latest depth items are kept
+  for(uint8_t i=0; i < 12; i++) tu_fifo_write(&ff8, &test_data[i]);
+  TEST_ASSERT_TRUE(tu_fifo_overflowed(&ff8));
+
+  n = tu_fifo_read_n(&ff8, dst, 8);
+  TEST_ASSERT_EQUAL(n, 8);
+  TEST_ASSERT_EQUAL_MEMORY(test_data + 4, dst, 8);
+  TEST_ASSERT_TRUE(tu_fifo_empty(&ff8));
+
+  TEST_ASSERT_FALSE(TU_FIFO_DEPTH_IS_POW2(10));
+  TEST_ASSERT_FALSE(TU_FIFO_DEPTH_IS_POW2(0));
+}
+
+void test_write_reserve_commit(void)
+{
+  uint8_t ch = 1;
+
+  // write 6 items, read 2 items
+  for(uint8_t i=0; i < 6; i++) tu_fifo_write(ff, &ch);
+  tu_fifo_read(ff, &ch);
+  tu_fifo_read(ff, &ch);
+
+  uint16_t n = tu_fifo_write_reserve(ff, &info);
+
+  TEST_ASSERT_EQUAL(FIFO_SIZE-4, n);
+  TEST_ASSERT_EQUAL(FIFO_SIZE-6, info.len_lin);
+  TEST_ASSERT_EQUAL(2, info.len_wrap);
+  TEST_ASSERT_EQUAL_PTR(ff->buffer+6, info.ptr_lin);
+  TEST_ASSERT_EQUAL_PTR(ff->buffer, info.ptr_wrap);
+
+  // nothing is visible until committed
+  memcpy(info.ptr_lin, test_data, info.len_lin);
+  memcpy(info.ptr_wrap, test_data + info.len_lin, 1);
+  TEST_ASSERT_EQUAL(4, tu_fifo_count(ff));
+
+  tu_fifo_write_commit(ff, info.len_lin + 1);
+  TEST_ASSERT_EQUAL(FIFO_SIZE-1, tu_fifo_count(ff));
+
+  // commit is limited to free space
+  tu_fifo_write_commit(ff, 10);
+  TEST_ASSERT_TRUE(tu_fifo_full(ff));
+}
+
+void test_read_acquire_release(void)
+{
+  tu_fifo_write_n(ff, test_data, FIFO_SIZE);
+  tu_fifo_read_n(ff, rd_buf, 10);
+  tu_fifo_write_n(ff, test_data + FIFO_SIZE, 5);
+
+  uint16_t n = tu_fifo_read_acquire(ff, &info);
+
+  TEST_ASSERT_EQUAL(FIFO_SIZE-5, n);
+  TEST_ASSERT_EQUAL(FIFO_SIZE-10, info.len_lin);
+  TEST_ASSERT_EQUAL(5, info.len_wrap);
+  TEST_ASSERT_EQUAL_MEMORY(test_data + 10, info.ptr_lin, info.len_lin);
+  TEST_ASSERT_EQUAL_MEMORY(test_data + FIFO_SIZE, info.ptr_wrap, info.len_wrap);
+
+  tu_fifo_read_release(ff, info.len_lin);
+  TEST_ASSERT_EQUAL(5, tu_fifo_count(ff));
+
+  // release is limited to available data
+  tu_fifo_read_release(ff, 10);
+  TEST_ASSERT_TRUE(tu_fifo_empty(ff));
+
+  n = tu_fifo_read_acquire(ff, &info);
+  TEST_ASSERT_EQUAL(0, n);
+  TEST_ASSERT_NULL(info.ptr_lin);
+  TEST_ASSERT_NULL(info.ptr_wrap);
+}
+
+void test_reserve_acquire_item_size(void)
+{
+  uint8_t ff4_buf[FIFO_SIZE * sizeof(uint32_t)];
+  tu_fifo_t ff4 = TU_FIFO_INIT(ff4_buf, FIFO_SIZE, uint32_t, false);
+
+  uint32_t data4[FIFO_SIZE];
+  for(uint32_t i=0; i<FIFO_SIZE; i++) data4[i] = i;
+
+  tu_fifo_write_n(&ff4, data4, 3);
+  tu_fifo_read_n(&ff4, data4, 3);
+
+  // pointers are in bytes, lengths are in items
+  tu_fifo_write_reserve(&ff4, &info);
+  TEST_ASSERT_EQUAL(FIFO_SIZE-3, info.len_lin);
+  TEST_ASSERT_EQUAL(3, info.len_wrap);
+  TEST_ASSERT_EQUAL_PTR(ff4_buf + 3*sizeof(uint32_t), info.ptr_lin);
+
+  uint32_t const val = 0xCAFEBABE;
+  memcpy(info.ptr_lin, &val, sizeof(val));
+  tu_fifo_write_commit(&ff4, 1);
+
+  tu_fifo_read_acquire(&ff4, &info);
+  TEST_ASSERT_EQUAL(1, info.len_lin);
+  TEST_ASSERT_EQUAL_MEMORY(&val, info.ptr_lin, sizeof(val));
+}
+
+#ifdef TUP_MEM_CONST_ADDR
+void test_write_n_const_addr(void)
+{
+  volatile uint32_t reg = 0x44332211;
+  uint8_t const pattern[4] = { 0x11, 0x22, 0x33, 0x44 };
+  uint8_t ch = 0;
+
+  // word aligned, unaligned and wrapped start position
+  for(uint16_t offset = 0; offset < FIFO_SIZE; offset += 21)
+  {
+    tu_fifo_clear(ff);
+    for(uint16_t i=0; i < offset; i++) tu_fifo_write(ff, &ch);
+    for(uint16_t i=0; i < offset; i++) tu_fifo_read(ff, &ch);
+
+    TEST_ASSERT_EQUAL(37, tu_fifo_write_n_const_addr_full_words(ff, (void const*) &reg, 37));
+    TEST_ASSERT_EQUAL(37, tu_fifo_read_n(ff, rd_buf, 37));
+
+    for(uint16_t i=0; i < 37; i++) TEST_ASSERT_EQUAL(pattern[i & 3], rd_buf[i]);
+  }
+}
+
+void test_read_n_const_addr(void)
+{
+  volatile uint32_t reg = 0;
+  uint8_t ch = 0;
+
+  for(uint16_t offset = 0; offset < FIFO_SIZE; offset += 21)
+  {
+    tu_fifo_clear(ff);
+    for(uint16_t i=0; i < offset; i++) tu_fifo_write(ff, &ch);
+    for(uint16_t i=0; i < offset; i++) tu_fifo_read(ff, &ch);
+
+    // last register write is the last full word
+    tu_fifo_write_n(ff, test_data, 36);
+    TEST_ASSERT_EQUAL(36, tu_fifo_read_n_const_addr_full_words(ff, (void*) &reg, 36));
+    TEST_ASSERT_EQUAL(tu_unaligned_read32(test_data + 32), reg);
+
+    // remaining 1-3 bytes are padded with zero
+    tu_fifo_write_n(ff, test_data, 37);
+    TEST_ASSERT_EQUAL(37, tu_fifo_read_n_const_addr_full_words(ff, (void*) &reg, 37));
+    TEST_ASSERT_EQUAL(test_data[36], reg);
+    TEST_ASSERT_TRUE(tu_fifo_empty(ff));
+  }
+}
+#endif
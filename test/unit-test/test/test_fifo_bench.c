@@ -0,0 +1,281 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019 Ha Thach (tinyusb.org)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * This file is part of the TinyUSB stack.
+ */
+
+// Micro benchmark of fifo access, result is printed only. Each case also verifies data integrity
+// so that it is still a meaningful test.
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "unity.h"
+
+#include "osal/osal.h"
+#include "tusb_fifo.h"
+
+#define BENCH_FIFO_SIZE   2048
+#define BENCH_PACKET_SIZE 512
+#define BENCH_ROUNDS      50000
+
+TU_ATTR_ALIGNED(4) static uint8_t ff_buf[BENCH_FIFO_SIZE];
+static tu_fifo_t ff;
+
+// endpoint buffer used for staging, and application buffer
+static uint8_t ep_buf[BENCH_PACKET_SIZE];
+static uint8_t app_buf[BENCH_PACKET_SIZE];
+
+static volatile uint32_t sink; // prevent optimizing away
+
+// USB controller (DMA) transferring packet from/to the wire, called via volatile pointer so that it is not inlined
+static uint8_t wire[BENCH_PACKET_SIZE + 256];
+
+static void hw_write_impl(uint8_t* dst, uint16_t len, uint32_t seq) {
+  memcpy(dst, wire + (uint8_t) seq, len);
+}
+
+static uint32_t hw_read_impl(uint8_t const* src, uint16_t len) {
+  memcpy(wire, src, len);
+  return (uint32_t) wire[0] + wire[len - 1];
+}
+
+static void (* volatile hw_write)(uint8_t* dst, uint16_t len, uint32_t seq) = hw_write_impl;
+static uint32_t (* volatile hw_read)(uint8_t const* src, uint16_t len) = hw_read_impl;
+
+static double elapsed_ns(clock_t start, uint32_t rounds) {
+  return ((double) (clock() - start) * 1e9 / CLOCKS_PER_SEC) / rounds;
+}
+
+void setUp(void) {
+  tu_fifo_config(&ff, ff_buf, BENCH_FIFO_SIZE, 1, false);
+
+  for (uint16_t i = 0; i < sizeof(wire); i++) {
+    wire[i] = (uint8_t) i;
+  }
+}
+
+void tearDown(void) {
+}
+
+//--------------------------------------------------------------------+
+// Receive: packet is written into fifo then read by application
+//--------------------------------------------------------------------+
+
+// staging: controller writes into ep buffer, driver copies it into fifo
+void test_bench_rx_staged(void) {
+  clock_t const start = clock();
+
+  for (uint32_t r = 0; r < BENCH_ROUNDS; r++) {
+    hw_write(ep_buf, BENCH_PACKET_SIZE, r);
+    TEST_ASSERT_EQUAL(BENCH_PACKET_SIZE, tu_fifo_write_n(&ff, ep_buf, BENCH_PACKET_SIZE));
+
+    TEST_ASSERT_EQUAL(BENCH_PACKET_SIZE, tu_fifo_read_n(&ff, app_buf, BENCH_PACKET_SIZE));
+    sink += app_buf[BENCH_PACKET_SIZE - 1];
+  }
+
+  printf("rx staged    : %6.1f ns/packet\n", elapsed_ns(start, BENCH_ROUNDS));
+  TEST_ASSERT_EQUAL((uint8_t) (BENCH_ROUNDS - 1 + BENCH_PACKET_SIZE - 1), app_buf[BENCH_PACKET_SIZE - 1]);
+}
+
+// zero-copy: controller writes directly into reserved fifo space
+void test_bench_rx_zero_copy(void) {
+  tu_fifo_buffer_info_t info;
+  clock_t const start = clock();
+
+  for (uint32_t r = 0; r < BENCH_ROUNDS; r++) {
+    tu_fifo_write_reserve(&ff, &info);
+    uint16_t const lin = tu_min16(info.len_lin, BENCH_PACKET_SIZE);
+    hw_write((uint8_t*) info.ptr_lin, lin, r);
+    if (lin < BENCH_PACKET_SIZE) {
+      hw_write((uint8_t*) info.ptr_wrap, BENCH_PACKET_SIZE - lin, r + lin);
+    }
+    tu_fifo_write_commit(&ff, BENCH_PACKET_SIZE);
+
+    TEST_ASSERT_EQUAL(BENCH_PACKET_SIZE, tu_fifo_read_n(&ff, app_buf, BENCH_PACKET_SIZE));
+    sink += app_buf[BENCH_PACKET_SIZE - 1];
+  }
+
+  printf("rx zero-copy : %6.1f ns/packet\n", elapsed_ns(start, BENCH_ROUNDS));
+  TEST_ASSERT_EQUAL((uint8_t) (BENCH_ROUNDS - 1 + BENCH_PACKET_SIZE - 1), app_buf[BENCH_PACKET_SIZE - 1]);
+}
+
+//--------------------------------------------------------------------+
+// Transmit: application writes into fifo then packet is read out
+//--------------------------------------------------------------------+
+
+static uint32_t tx_expected_sum(void) {
+  // packet is filled with round number, first and last bytes are summed
+  uint32_t sum = 0;
+  for (uint32_t r = 0; r < BENCH_ROUNDS; r++) {
+    sum += 2 * (uint32_t) ((uint8_t) r);
+  }
+  return sum;
+}
+
+// staging: driver copies fifo into ep buffer, controller reads ep buffer
+void test_bench_tx_staged(void) {
+  uint32_t sum = 0;
+  clock_t const start = clock();
+
+  for (uint32_t r = 0; r < BENCH_ROUNDS; r++) {
+    memset(app_buf, (uint8_t) r, BENCH_PACKET_SIZE);
+    TEST_ASSERT_EQUAL(BENCH_PACKET_SIZE, tu_fifo_write_n(&ff, app_buf, BENCH_PACKET_SIZE));
+
+    TEST_ASSERT_EQUAL(BENCH_PACKET_SIZE, tu_fifo_read_n(&ff, ep_buf, BENCH_PACKET_SIZE));
+    sum += hw_read(ep_buf, BENCH_PACKET_SIZE);
+  }
+
+  printf("tx staged    : %6.1f ns/packet\n", elapsed_ns(start, BENCH_ROUNDS));
+  TEST_ASSERT_EQUAL(tx_expected_sum(), sum);
+}
+
+// zero-copy: controller reads directly from acquired fifo data
+void test_bench_tx_zero_copy(void) {
+  tu_fifo_buffer_info_t info;
+  uint32_t sum = 0;
+  clock_t const start = clock();
+
+  for (uint32_t r = 0; r < BENCH_ROUNDS; r++) {
+    memset(app_buf, (uint8_t) r, BENCH_PACKET_SIZE);
+    TEST_ASSERT_EQUAL(BENCH_PACKET_SIZE, tu_fifo_write_n(&ff, app_buf, BENCH_PACKET_SIZE));
+
+    TEST_ASSERT_EQUAL(BENCH_PACKET_SIZE, tu_fifo_read_acquire(&ff, &info));
+    sum += hw_read((uint8_t const*) info.ptr_lin, info.len_lin);
+    if (info.len_wrap) {
+      sum += hw_read((uint8_t const*) info.ptr_wrap, info.len_wrap);
+    }
+    tu_fifo_read_release(&ff, BENCH_PACKET_SIZE);
+  }
+
+  printf("tx zero-copy : %6.1f ns/packet\n", elapsed_ns(start, BENCH_ROUNDS));
+  TEST_ASSERT_EQUAL(tx_expected_sum(), sum);
+}
+
+//--------------------------------------------------------------------+
+// Index math: power-of-two depth (masks) vs arbitrary depth (compare & wrap)
+// Single byte and 4-byte (MIDI event) accesses, where index math dominates the copy
+//--------------------------------------------------------------------+
+
+static uint32_t bench_byte(tu_fifo_t* f) {
+  uint32_t sum = 0;
+  for (uint32_t r = 0; r < BENCH_ROUNDS * 8; r++) {
+    uint8_t const w = (uint8_t) r;
+    uint8_t c = 0;
+    tu_fifo_write(f, &w);
+    tu_fifo_read(f, &c);
+    sum += c;
+  }
+  return sum;
+}
+
+static uint32_t bench_midi(tu_fifo_t* f) {
+  uint32_t sum = 0;
+  for (uint32_t r = 0; r < BENCH_ROUNDS * 8; r++) {
+    uint8_t const w[4] = { 0x09, 0x90, (uint8_t) r, 0x7f };
+    uint8_t c[4];
+    tu_fifo_write_n(f, w, 4);
+    tu_fifo_read_n(f, c, 4);
+    sum += c[2];
+  }
+  return sum;
+}
+
+static uint32_t bench_expected_sum(void) {
+  uint32_t sum = 0;
+  for (uint32_t r = 0; r < BENCH_ROUNDS * 8; r++) {
+    sum += (uint8_t) r;
+  }
+  return sum;
+}
+
+void test_bench_index_pow2(void) {
+  TEST_ASSERT_TRUE(ff.pow2);
+
+  clock_t start = clock();
+  uint32_t sum = bench_byte(&ff);
+  printf("byte  pow2   : %6.1f ns/byte\n", elapsed_ns(start, BENCH_ROUNDS * 8));
+  TEST_ASSERT_EQUAL(bench_expected_sum(), sum);
+
+  start = clock();
+  sum = bench_midi(&ff);
+  printf("midi  pow2   : %6.1f ns/event\n", elapsed_ns(start, BENCH_ROUNDS * 8));
+  TEST_ASSERT_EQUAL(bench_expected_sum(), sum);
+}
+
+void test_bench_index_arbitrary(void) {
+  tu_fifo_config(&ff, ff_buf, BENCH_FIFO_SIZE - 1, 1, false);
+  TEST_ASSERT_FALSE(ff.pow2);
+
+  clock_t start = clock();
+  uint32_t sum = bench_byte(&ff);
+  printf("byte  npow2  : %6.1f ns/byte\n", elapsed_ns(start, BENCH_ROUNDS * 8));
+  TEST_ASSERT_EQUAL(bench_expected_sum(), sum);
+
+  start = clock();
+  sum = bench_midi(&ff);
+  printf("midi  npow2  : %6.1f ns/event\n", elapsed_ns(start, BENCH_ROUNDS * 8));
+  TEST_ASSERT_EQUAL(bench_expected_sum(), sum);
+}
+
+//--------------------------------------------------------------------+
+// Hardware fifo at constant address (e.g dwc2 slave mode): word aligned kernel vs unaligned fallback
+//--------------------------------------------------------------------+
+#ifdef TUP_MEM_CONST_ADDR
+
+static volatile uint32_t hw_fifo_reg;
+
+static void bench_const_addr(uint16_t offset, char const* name) {
+  // start position in fifo buffer: offset 0 is word aligned
+  tu_fifo_config(&ff, ff_buf, BENCH_FIFO_SIZE, 1, false);
+  tu_fifo_advance_write_pointer(&ff, offset);
+  tu_fifo_advance_read_pointer(&ff, offset);
+
+  hw_fifo_reg = 0x5a5a5a5a;
+  clock_t start = clock();
+  for (uint32_t r = 0; r < BENCH_ROUNDS; r++) {
+    tu_fifo_write_n_const_addr_full_words(&ff, (void const*) &hw_fifo_reg, BENCH_PACKET_SIZE);
+    tu_fifo_read_n(&ff, app_buf, BENCH_PACKET_SIZE);
+  }
+  printf("rx fifo %-9s: %6.1f ns/packet\n", name, elapsed_ns(start, BENCH_ROUNDS));
+  TEST_ASSERT_EACH_EQUAL_UINT8(0x5a, app_buf, BENCH_PACKET_SIZE);
+
+  memset(app_buf, 0xa5, BENCH_PACKET_SIZE);
+  start = clock();
+  for (uint32_t r = 0; r < BENCH_ROUNDS; r++) {
+    tu_fifo_write_n(&ff, app_buf, BENCH_PACKET_SIZE);
+    tu_fifo_read_n_const_addr_full_words(&ff, (void*) &hw_fifo_reg, BENCH_PACKET_SIZE);
+  }
+  printf("tx fifo %-9s: %6.1f ns/packet\n", name, elapsed_ns(start, BENCH_ROUNDS));
+  TEST_ASSERT_EQUAL_HEX32(0xa5a5a5a5, hw_fifo_reg);
+}
+
+void test_bench_const_addr_aligned(void) {
+  bench_const_addr(0, "aligned");
+}
+
+void test_bench_const_addr_unaligned(void) {
+  bench_const_addr(1, "unaligned");
+}
+
+#endif
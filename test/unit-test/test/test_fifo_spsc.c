@@ -0,0 +1,163 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025 Ha Thach (tinyusb.org)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * This file is part of the TinyUSB stack.
+ */
+
+// Lock-free fifo, built with CFG_TUSB_FIFO_SPSC = 1 and mutex enabled as multiple core MCU (see project.yml)
+
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include "unity.h"
+
+#include "osal/osal.h"
+#include "tusb_fifo.h"
+
+TU_VERIFY_STATIC(CFG_TUSB_FIFO_SPSC && CFG_FIFO_MUTEX, "test requires lock-free fifo with mutex");
+
+#define FIFO_SIZE   63 // not power of 2 to cover index wrap
+uint8_t tu_ff_buf[FIFO_SIZE * sizeof(uint8_t)];
+tu_fifo_t tu_ff = TU_FIFO_INIT(tu_ff_buf, FIFO_SIZE, uint8_t, false);
+
+tu_fifo_t* ff = &tu_ff;
+
+osal_mutex_def_t mutex_wr_def;
+osal_mutex_def_t mutex_rd_def;
+
+uint8_t test_data[4096];
+uint8_t rd_buf[FIFO_SIZE];
+
+void setUp(void)
+{
+  tu_fifo_config_mutex(ff, osal_mutex_create(&mutex_wr_def), osal_mutex_create(&mutex_rd_def));
+  tu_fifo_config(ff, tu_ff_buf, FIFO_SIZE, 1, false);
+
+  for(int i=0; i<sizeof(test_data); i++) test_data[i] = i;
+  memset(rd_buf, 0, sizeof(rd_buf));
+}
+
+void tearDown(void)
+{
+}
+
+//--------------------------------------------------------------------+
+// Tests
+//--------------------------------------------------------------------+
+
+// Reader and writer of a non-overwritable fifo never take mutex: both are held by someone else here
+void test_spsc_not_locked(void)
+{
+  mutex_wr_def.count = 0;
+  mutex_rd_def.count = 0;
+
+  TEST_ASSERT_EQUAL(10, tu_fifo_write_n(ff, test_data, 10));
+  TEST_ASSERT_EQUAL(10, tu_fifo_count(ff));
+
+  uint8_t c;
+  TEST_ASSERT_TRUE(tu_fifo_peek(ff, &c));
+  TEST_ASSERT_EQUAL(0, c);
+
+  TEST_ASSERT_EQUAL(10, tu_fifo_read_n(ff, rd_buf, FIFO_SIZE));
+  TEST_ASSERT_EQUAL_MEMORY(test_data, rd_buf, 10);
+  TEST_ASSERT_TRUE(tu_fifo_empty(ff));
+}
+
+// Overwritable fifo keeps locking, and every lock is released
+void test_spsc_overwritable_locked(void)
+{
+  tu_fifo_set_overwritable(ff, true);
+
+  uint8_t* buf = test_data;
+  buf += tu_fifo_write_n(ff, buf, FIFO_SIZE);
+  buf += tu_fifo_write_n(ff, buf, 8);
+  TEST_ASSERT_EQUAL(FIFO_SIZE, tu_fifo_count(ff));
+  TEST_ASSERT_EQUAL(1, mutex_wr_def.count);
+  TEST_ASSERT_EQUAL(1, mutex_rd_def.count);
+
+  // overflowed: read back the last FIFO_SIZE written
+  TEST_ASSERT_EQUAL(FIFO_SIZE, tu_fifo_read_n(ff, rd_buf, FIFO_SIZE));
+  TEST_ASSERT_EQUAL_MEMORY(buf - FIFO_SIZE, rd_buf, FIFO_SIZE);
+  TEST_ASSERT_EQUAL(1, mutex_wr_def.count);
+  TEST_ASSERT_EQUAL(1, mutex_rd_def.count);
+}
+
+// Lock is released when overwritable mode is switched off between operations
+void test_spsc_overwritable_switched(void)
+{
+  tu_fifo_set_overwritable(ff, true);
+  tu_fifo_write_n(ff, test_data, 4);
+
+  tu_fifo_set_overwritable(ff, false);
+  TEST_ASSERT_EQUAL(4, tu_fifo_read_n(ff, rd_buf, 4));
+  TEST_ASSERT_EQUAL_MEMORY(test_data, rd_buf, 4);
+  TEST_ASSERT_EQUAL(1, mutex_wr_def.count);
+  TEST_ASSERT_EQUAL(1, mutex_rd_def.count);
+}
+
+//--------------------------------------------------------------------+
+// One writer and one reader thread
+//--------------------------------------------------------------------+
+#define STREAM_BYTES  (256u * 1024u)
+
+static void* writer_thread(void* arg)
+{
+  (void) arg;
+  uint32_t sent = 0;
+  while (sent < STREAM_BYTES)
+  {
+    // vary chunk size so that both sides wrap at different positions
+    uint16_t const n = (uint16_t) tu_min32(1 + (sent % 37), STREAM_BYTES - sent);
+    uint8_t chunk[37];
+    for (uint16_t i = 0; i < n; i++) chunk[i] = (uint8_t) (sent + i);
+    uint16_t const count = tu_fifo_write_n(ff, chunk, n);
+    if (count == 0) sched_yield(); // full, let reader run on single core host
+    sent += count;
+  }
+  return NULL;
+}
+
+void test_spsc_threads(void)
+{
+  pthread_t writer;
+  TEST_ASSERT_EQUAL(0, pthread_create(&writer, NULL, writer_thread, NULL));
+
+  uint32_t received = 0;
+  uint32_t mismatch = 0;
+  while (received < STREAM_BYTES)
+  {
+    uint16_t const n = tu_fifo_read_n(ff, rd_buf, (uint16_t) (1 + (received % 29)));
+    if (n == 0) sched_yield(); // empty, let writer run on single core host
+    for (uint16_t i = 0; i < n; i++)
+    {
+      if (rd_buf[i] != (uint8_t) (received + i)) mismatch++;
+    }
+    received += n;
+  }
+
+  pthread_join(writer, NULL);
+
+  TEST_ASSERT_EQUAL(0, mismatch);
+  TEST_ASSERT_EQUAL(STREAM_BYTES, received);
+  TEST_ASSERT_TRUE(tu_fifo_empty(ff));
+}
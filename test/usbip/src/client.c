@@ -0,0 +1,552 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025, Ha Thach (tinyusb.org)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * This file is part of the TinyUSB stack.
+ */
+
+/* Minimal USB/IP client standing in for Linux vhci-hcd: lists and imports the device exported by usbip_device,
+ * enumerates it then checks stall/unlink handling and measures CDC echo and MSC read/write throughput with
+ * raw URBs. Exit code is non-zero on protocol error or data mismatch.
+ *
+ * Usage: usbip_client [-r host] [-p port] [-n bytes]
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+#define DISK_BYTES      (2048u * 512u)
+#define MSC_CMD_BYTES   (32u * 1024u)
+#define CDC_URB_BYTES   4096u
+#define CDC_URB_DEPTH   4
+#define PENDING_MAX     16
+
+#define EP_CDC_OUT      0x02
+#define EP_CDC_IN       0x82
+#define EP_MSC_OUT      0x03
+#define EP_MSC_IN       0x83
+#define ITF_CDC         0
+
+enum {
+  OP_REQ_DEVLIST = 0x8005,
+  OP_REQ_IMPORT  = 0x8003,
+  CMD_SUBMIT     = 1,
+  CMD_UNLINK     = 2,
+  RET_SUBMIT     = 3,
+  RET_UNLINK     = 4,
+};
+
+typedef struct __attribute__((packed)) {
+  uint32_t command;
+  uint32_t seqnum;
+  uint32_t devid;
+  uint32_t direction;
+  uint32_t ep;
+  uint32_t u[5];      // cmd_submit: flags, length, start_frame, number_of_packets, interval
+                      // ret_submit: status, actual_length, start_frame, number_of_packets, error_count
+                      // cmd_unlink: seqnum,  ret_unlink: status
+  uint8_t  setup[8];
+} usbip_header_t;
+
+typedef struct {
+  uint32_t seqnum;    // 0 if slot is free
+  uint8_t* buffer;
+  bool     in;
+  bool     done;
+  int32_t  status;
+  uint32_t actual_len;
+} pending_t;
+
+static int sock = -1;
+static uint32_t next_seqnum = 1;
+static pending_t pending[PENDING_MAX];
+static int32_t unlink_status;
+static bool unlink_done;
+
+//--------------------------------------------------------------------+
+// Socket
+//--------------------------------------------------------------------+
+
+static bool sock_read(void* buf, size_t len) {
+  uint8_t* p = (uint8_t*) buf;
+  while (len) {
+    ssize_t const n = recv(sock, p, len, 0);
+    if (n <= 0) {
+      return false;
+    }
+    p += n;
+    len -= (size_t) n;
+  }
+  return true;
+}
+
+static bool sock_write(void const* buf, size_t len) {
+  uint8_t const* p = (uint8_t const*) buf;
+  while (len) {
+    ssize_t const n = send(sock, p, len, MSG_NOSIGNAL);
+    if (n <= 0) {
+      return false;
+    }
+    p += n;
+    len -= (size_t) n;
+  }
+  return true;
+}
+
+// connect, retry for a while since server may be starting
+static bool sock_open(char const* host, uint16_t port) {
+  struct sockaddr_in addr = { .sin_family = AF_INET, .sin_port = htons(port) };
+  if (inet_pton(AF_INET, host, &addr.sin_addr) != 1) {
+    return false;
+  }
+
+  for (int retry = 0; retry < 50; retry++) {
+    sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (connect(sock, (struct sockaddr*) &addr, sizeof(addr)) == 0) {
+      int const one = 1;
+      setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+      return true;
+    }
+    close(sock);
+    sock = -1;
+    usleep(100 * 1000);
+  }
+  return false;
+}
+
+static double now_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double) ts.tv_sec * 1000.0 + (double) ts.tv_nsec / 1e6;
+}
+
+//--------------------------------------------------------------------+
+// Operations
+//--------------------------------------------------------------------+
+
+static bool op_request(uint16_t code) {
+  uint8_t const hdr[8] = { 0x01, 0x11, (uint8_t) (code >> 8), (uint8_t) code, 0, 0, 0, 0 };
+  return sock_write(hdr, sizeof(hdr));
+}
+
+static bool op_reply(uint32_t* status) {
+  uint8_t hdr[8];
+  if (!sock_read(hdr, sizeof(hdr))) {
+    return false;
+  }
+  *status = ntohl(*(uint32_t*) &hdr[4]);
+  return true;
+}
+
+static void print_device(uint8_t const dev[312]) {
+  uint32_t speed;
+  uint16_t vid, pid;
+  memcpy(&speed, dev + 296, 4);
+  memcpy(&vid, dev + 300, 2);
+  memcpy(&pid, dev + 302, 2);
+  printf("  %s: %04x:%04x speed %u, %u interface(s)\n", (char const*) dev + 256, ntohs(vid), ntohs(pid),
+         ntohl(speed), dev[311]);
+}
+
+static bool devlist(void) {
+  uint32_t status, ndev;
+  if (!op_request(OP_REQ_DEVLIST) || !op_reply(&status) || status || !sock_read(&ndev, 4)) {
+    return false;
+  }
+  ndev = ntohl(ndev);
+  printf("Exported devices: %u\n", ndev);
+
+  for (uint32_t i = 0; i < ndev; i++) {
+    uint8_t dev[312];
+    if (!sock_read(dev, sizeof(dev))) {
+      return false;
+    }
+    print_device(dev);
+    for (uint8_t itf = 0; itf < dev[311]; itf++) {
+      uint8_t itf_class[4];
+      if (!sock_read(itf_class, 4)) {
+        return false;
+      }
+    }
+  }
+  return ndev == 1;
+}
+
+static bool import(void) {
+  char busid[32] = "1-1";
+  uint32_t status;
+  uint8_t dev[312];
+  if (!op_request(OP_REQ_IMPORT) || !sock_write(busid, sizeof(busid)) || !op_reply(&status) || status ||
+      !sock_read(dev, sizeof(dev))) {
+    return false;
+  }
+  printf("Imported\n");
+  print_device(dev);
+  return true;
+}
+
+//--------------------------------------------------------------------+
+// URB
+//--------------------------------------------------------------------+
+
+static pending_t* urb_find(uint32_t seqnum) {
+  for (int i = 0; i < PENDING_MAX; i++) {
+    if (pending[i].seqnum == seqnum) {
+      return &pending[i];
+    }
+  }
+  return NULL;
+}
+
+static uint32_t urb_submit(uint8_t ep_addr, uint8_t const setup[8], void* buffer, uint32_t len) {
+  pending_t* p = urb_find(0);
+  if (p == NULL) {
+    return 0;
+  }
+
+  bool const in = (ep_addr & 0x80) != 0;
+  usbip_header_t hdr = {
+    .command   = htonl(CMD_SUBMIT),
+    .seqnum    = htonl(next_seqnum),
+    .devid     = htonl((1u << 16) | 2u),
+    .direction = htonl(in ? 1 : 0),
+    .ep        = htonl(ep_addr & 0x0f),
+    .u         = { 0, htonl(len), 0, htonl(0xffffffffu), 0 },
+  };
+  if (setup) {
+    memcpy(hdr.setup, setup, 8);
+  }
+
+  if (!sock_write(&hdr, sizeof(hdr)) || (!in && !sock_write(buffer, len))) {
+    return 0;
+  }
+
+  *p = (pending_t) { .seqnum = next_seqnum, .buffer = (uint8_t*) buffer, .in = in };
+  return next_seqnum++;
+}
+
+// read one reply from server
+static bool urb_receive(void) {
+  usbip_header_t hdr;
+  if (!sock_read(&hdr, sizeof(hdr))) {
+    return false;
+  }
+
+  if (ntohl(hdr.command) == RET_UNLINK) {
+    unlink_status = (int32_t) ntohl(hdr.u[0]);
+    unlink_done = true;
+    return true;
+  }
+
+  pending_t* p = urb_find(ntohl(hdr.seqnum));
+  if (ntohl(hdr.command) != RET_SUBMIT || p == NULL) {
+    return false;
+  }
+  p->status = (int32_t) ntohl(hdr.u[0]);
+  p->actual_len = ntohl(hdr.u[1]);
+  p->done = true;
+  return !p->in || sock_read(p->buffer, p->actual_len);
+}
+
+// wait for urb completion, return status and free its slot
+static bool urb_wait(uint32_t seqnum, int32_t* status, uint32_t* actual_len) {
+  pending_t* p = urb_find(seqnum);
+  if (seqnum == 0 || p == NULL) {
+    return false;
+  }
+  while (!p->done) {
+    if (!urb_receive()) {
+      return false;
+    }
+  }
+  *status = p->status;
+  if (actual_len) {
+    *actual_len = p->actual_len;
+  }
+  p->seqnum = 0;
+  return true;
+}
+
+static bool control(uint8_t bmRequestType, uint8_t bRequest, uint16_t wValue, uint16_t wIndex, void* buffer,
+                    uint16_t wLength, int32_t* status, uint32_t* actual_len) {
+  uint8_t const setup[8] = { bmRequestType, bRequest, (uint8_t) wValue, (uint8_t) (wValue >> 8),
+                             (uint8_t) wIndex, (uint8_t) (wIndex >> 8), (uint8_t) wLength, (uint8_t) (wLength >> 8) };
+  uint8_t const ep_addr = (bmRequestType & 0x80) ? 0x80 : 0x00;
+  return urb_wait(urb_submit(ep_addr, setup, buffer, wLength), status, actual_len);
+}
+
+// transfer and expect success
+static bool xfer(uint8_t ep_addr, void* buffer, uint32_t len, uint32_t* actual_len) {
+  int32_t status;
+  return urb_wait(urb_submit(ep_addr, NULL, buffer, len), &status, actual_len) && status == 0;
+}
+
+//--------------------------------------------------------------------+
+// Tests
+//--------------------------------------------------------------------+
+
+static bool enumerate(void) {
+  uint8_t desc[256];
+  int32_t status;
+  uint32_t len;
+
+  if (!control(0x80, 6, 0x0100, 0, desc, 18, &status, &len) || status || len != 18 || desc[1] != 1) {
+    return false;
+  }
+  if (!control(0x80, 6, 0x0200, 0, desc, 9, &status, &len) || status || len != 9) {
+    return false;
+  }
+  uint16_t const total_len = (uint16_t) (desc[2] | (desc[3] << 8));
+  if (total_len > sizeof(desc) || !control(0x80, 6, 0x0200, 0, desc, total_len, &status, &len) || status ||
+      len != total_len) {
+    return false;
+  }
+  return control(0x00, 9, 1, 0, NULL, 0, &status, NULL) && status == 0;
+}
+
+// unsupported request is stalled, next control transfer must work
+static bool stall(void) {
+  uint8_t buf[64];
+  int32_t status;
+  if (!control(0x80, 6, 0x037f, 0x0409, buf, sizeof(buf), &status, NULL) || status != -EPIPE) {
+    return false;
+  }
+  return control(0x80, 0, 0, 0, buf, 2, &status, NULL) && status == 0;
+}
+
+// pending IN urb (device has no data) is unlinked
+static bool unlink_urb(void) {
+  uint8_t buf[512];
+  uint32_t const seqnum = urb_submit(EP_CDC_IN, NULL, buf, sizeof(buf));
+  usbip_header_t hdr = {
+    .command = htonl(CMD_UNLINK),
+    .seqnum  = htonl(next_seqnum++),
+    .u       = { htonl(seqnum) },
+  };
+  if (seqnum == 0 || !sock_write(&hdr, sizeof(hdr))) {
+    return false;
+  }
+
+  unlink_done = false;
+  while (!unlink_done) {
+    if (!urb_receive()) {
+      return false;
+    }
+  }
+  urb_find(seqnum)->seqnum = 0;
+  return unlink_status == -ECONNRESET;
+}
+
+static inline uint8_t pattern(uint32_t i) {
+  return (uint8_t) (i * 7 + (i >> 8));
+}
+
+// device echoes data written to CDC, several urbs are kept in flight in both directions
+static bool cdc_echo(uint32_t total_bytes) {
+  static uint8_t tx_buf[CDC_URB_DEPTH][CDC_URB_BYTES];
+  static uint8_t rx_buf[CDC_URB_DEPTH][CDC_URB_BYTES];
+  uint32_t tx_seq[CDC_URB_DEPTH] = { 0 };
+  uint32_t rx_seq[CDC_URB_DEPTH] = { 0 };
+  uint32_t sent = 0, received = 0;
+  unsigned tx_head = 0, rx_head = 0; // oldest urb, completed in order
+
+  int32_t status;
+  // assert DTR
+  if (!control(0x21, 0x22, 0x0003, ITF_CDC, NULL, 0, &status, NULL) || status) {
+    return false;
+  }
+
+  for (unsigned i = 0; i < CDC_URB_DEPTH; i++) {
+    rx_seq[i] = urb_submit(EP_CDC_IN, NULL, rx_buf[i], CDC_URB_BYTES);
+  }
+
+  while (received < total_bytes) {
+    // keep OUT urbs queued
+    for (unsigned i = 0; i < CDC_URB_DEPTH && sent < total_bytes; i++) {
+      unsigned const slot = (tx_head + i) % CDC_URB_DEPTH;
+      if (tx_seq[slot] == 0) {
+        uint32_t const len = (total_bytes - sent < CDC_URB_BYTES) ? total_bytes - sent : CDC_URB_BYTES;
+        for (uint32_t k = 0; k < len; k++) {
+          tx_buf[slot][k] = pattern(sent + k);
+        }
+        tx_seq[slot] = urb_submit(EP_CDC_OUT, NULL, tx_buf[slot], len);
+        sent += len;
+      }
+    }
+
+    if (!urb_receive()) {
+      return false;
+    }
+
+    pending_t* p;
+    while (tx_seq[tx_head] && (p = urb_find(tx_seq[tx_head]))->done) {
+      if (p->status) {
+        return false;
+      }
+      p->seqnum = 0;
+      tx_seq[tx_head] = 0;
+      tx_head = (tx_head + 1) % CDC_URB_DEPTH;
+    }
+
+    while ((p = urb_find(rx_seq[rx_head]))->done) {
+      if (p->status) {
+        return false;
+      }
+      for (uint32_t k = 0; k < p->actual_len; k++) {
+        if (rx_buf[rx_head][k] != pattern(received + k)) {
+          return false;
+        }
+      }
+      received += p->actual_len;
+      p->seqnum = 0;
+      rx_seq[rx_head] = urb_submit(EP_CDC_IN, NULL, rx_buf[rx_head], CDC_URB_BYTES);
+      rx_head = (rx_head + 1) % CDC_URB_DEPTH;
+    }
+  }
+
+  // remaining IN urbs are dropped with connection
+  return received == total_bytes;
+}
+
+// Bulk-Only Transport SCSI READ10/WRITE10
+static bool msc_rw(bool is_read, uint32_t lba, uint8_t* buffer, uint32_t len) {
+  static uint32_t tag = 0;
+  uint16_t const blocks = (uint16_t) (len / 512);
+  uint8_t cbw[31] = { 'U', 'S', 'B', 'C' };
+  uint8_t csw[13];
+
+  tag++;
+  memcpy(cbw + 4, &tag, 4);
+  memcpy(cbw + 8, &len, 4); // little endian host
+  cbw[12] = is_read ? 0x80 : 0x00;
+  cbw[14] = 10;
+  cbw[15] = is_read ? 0x28 : 0x2a;
+  cbw[17] = (uint8_t) (lba >> 24);
+  cbw[18] = (uint8_t) (lba >> 16);
+  cbw[19] = (uint8_t) (lba >> 8);
+  cbw[20] = (uint8_t) lba;
+  cbw[22] = (uint8_t) (blocks >> 8);
+  cbw[23] = (uint8_t) blocks;
+
+  uint32_t actual_len;
+  if (!xfer(EP_MSC_OUT, cbw, sizeof(cbw), NULL) ||
+      !xfer(is_read ? EP_MSC_IN : EP_MSC_OUT, buffer, len, &actual_len) || actual_len != len ||
+      !xfer(EP_MSC_IN, csw, sizeof(csw), &actual_len) || actual_len != sizeof(csw)) {
+    return false;
+  }
+  return memcmp(csw, "USBS", 4) == 0 && memcmp(csw + 4, &tag, 4) == 0 && csw[12] == 0;
+}
+
+static bool msc_disk(bool is_read) {
+  static uint8_t buf[MSC_CMD_BYTES];
+  for (uint32_t offset = 0; offset < DISK_BYTES; offset += MSC_CMD_BYTES) {
+    if (!is_read) {
+      for (uint32_t k = 0; k < MSC_CMD_BYTES; k++) {
+        buf[k] = pattern(offset + k);
+      }
+    }
+    if (!msc_rw(is_read, offset / 512, buf, MSC_CMD_BYTES)) {
+      return false;
+    }
+    if (is_read) {
+      for (uint32_t k = 0; k < MSC_CMD_BYTES; k++) {
+        if (buf[k] != pattern(offset + k)) {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+static bool report(char const* name, uint32_t bytes, double start_ms, bool pass) {
+  double const ms = now_ms() - start_ms;
+  if (bytes) {
+    printf("%-10s %10u %10.1f %10.0f  %s\n", name, bytes, ms, bytes / ms * 1000.0 / 1024.0, pass ? "PASS" : "FAIL");
+  } else {
+    printf("%-10s %10s %10.1f %10s  %s\n", name, "-", ms, "-", pass ? "PASS" : "FAIL");
+  }
+  return pass;
+}
+
+int main(int argc, char* argv[]) {
+  char const* host = "127.0.0.1";
+  uint16_t port = 3240;
+  uint32_t cdc_bytes = 1024 * 1024;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "r:p:n:")) != -1) {
+    switch (opt) {
+      case 'r': host = optarg; break;
+      case 'p': port = (uint16_t) atoi(optarg); break;
+      case 'n': cdc_bytes = (uint32_t) strtoul(optarg, NULL, 0); break;
+      default:
+        fprintf(stderr, "Usage: %s [-r host] [-p port] [-n bytes]\n", argv[0]);
+        return 2;
+    }
+  }
+
+  // device list is served on its own connection
+  if (!sock_open(host, port) || !devlist()) {
+    fprintf(stderr, "Failed to list devices of %s:%u\n", host, port);
+    return 1;
+  }
+  close(sock);
+
+  if (!sock_open(host, port) || !import()) {
+    fprintf(stderr, "Failed to import device\n");
+    return 1;
+  }
+
+  printf("test            bytes  time (ms)       KB/s  result\n");
+  bool pass = true;
+  double start = now_ms();
+  pass = report("enumerate", 0, start, enumerate()) && pass;
+
+  start = now_ms();
+  pass = report("stall", 0, start, stall()) && pass;
+
+  start = now_ms();
+  pass = report("unlink", 0, start, unlink_urb()) && pass;
+
+  start = now_ms();
+  pass = report("cdc_echo", cdc_bytes, start, cdc_echo(cdc_bytes)) && pass;
+
+  start = now_ms();
+  pass = report("msc_write", DISK_BYTES, start, msc_disk(false)) && pass;
+
+  start = now_ms();
+  pass = report("msc_read", DISK_BYTES, start, msc_disk(true)) && pass;
+
+  close(sock);
+  return pass ? 0 : 1;
+}
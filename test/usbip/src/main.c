@@ -0,0 +1,139 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2025, Ha Thach (tinyusb.org)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * This file is part of the TinyUSB stack.
+ */
+
+/* USB/IP device: CDC echo + MSC RAM disk exported by src/portable/usbip. It can be attached by Linux with
+ *   sudo modprobe vhci-hcd && usbip attach -r localhost -b 1-1
+ * or exercised by usbip_client of this directory.
+ *
+ * Usage: usbip_device [-1]
+ *   -1: exit once the first client is detached
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "tusb.h"
+
+#define DISK_BLOCK_NUM    2048
+#define DISK_BLOCK_SIZE   512
+
+static uint8_t msc_disk[DISK_BLOCK_NUM][DISK_BLOCK_SIZE];
+static bool was_mounted = false;
+
+uint32_t tusb_time_millis_api(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t) (ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+static void cdc_echo_task(void) {
+  uint8_t buf[512];
+  uint32_t const n = tu_min32(tud_cdc_available(), tu_min32(sizeof(buf), tud_cdc_write_available()));
+  if (n) {
+    tud_cdc_read(buf, n);
+    tud_cdc_write(buf, n);
+  }
+  tud_cdc_write_flush();
+}
+
+int main(int argc, char* argv[]) {
+  bool oneshot = false;
+  int opt;
+  while ((opt = getopt(argc, argv, "1")) != -1) {
+    if (opt == '1') {
+      oneshot = true;
+    } else {
+      fprintf(stderr, "Usage: %s [-1]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  tusb_rhport_init_t const dev_init = {
+    .role = TUSB_ROLE_DEVICE,
+    .speed = TUSB_SPEED_HIGH
+  };
+  if (!tusb_init(BOARD_TUD_RHPORT, &dev_init)) {
+    return 1;
+  }
+
+  while (!(oneshot && was_mounted && !tud_mounted())) {
+    tud_int_handler(BOARD_TUD_RHPORT);
+    tud_task();
+    cdc_echo_task();
+  }
+
+  return 0;
+}
+
+void tud_mount_cb(void) {
+  was_mounted = true;
+}
+
+//--------------------------------------------------------------------+
+// MSC callbacks: RAM disk
+//--------------------------------------------------------------------+
+
+void tud_msc_inquiry_cb(uint8_t lun, uint8_t vendor_id[8], uint8_t product_id[16], uint8_t product_rev[4]) {
+  (void) lun;
+  memcpy(vendor_id, "TinyUSB ", 8);
+  memcpy(product_id, "USBIP RAM Disk  ", 16);
+  memcpy(product_rev, "1.0 ", 4);
+}
+
+bool tud_msc_test_unit_ready_cb(uint8_t lun) {
+  (void) lun;
+  return true;
+}
+
+void tud_msc_capacity_cb(uint8_t lun, uint32_t* block_count, uint16_t* block_size) {
+  (void) lun;
+  *block_count = DISK_BLOCK_NUM;
+  *block_size = DISK_BLOCK_SIZE;
+}
+
+int32_t tud_msc_read10_cb(uint8_t lun, uint32_t lba, uint32_t offset, void* buffer, uint32_t bufsize) {
+  (void) lun;
+  TU_VERIFY(lba < DISK_BLOCK_NUM && offset + bufsize <= DISK_BLOCK_SIZE * (DISK_BLOCK_NUM - lba), -1);
+  memcpy(buffer, msc_disk[lba] + offset, bufsize);
+  return (int32_t) bufsize;
+}
+
+int32_t tud_msc_write10_cb(uint8_t lun, uint32_t lba, uint32_t offset, uint8_t* buffer, uint32_t bufsize) {
+  (void) lun;
+  TU_VERIFY(lba < DISK_BLOCK_NUM && offset + bufsize <= DISK_BLOCK_SIZE * (DISK_BLOCK_NUM - lba), -1);
+  memcpy(msc_disk[lba] + offset, buffer, bufsize);
+  return (int32_t) bufsize;
+}
+
+int32_t tud_msc_scsi_cb(uint8_t lun, uint8_t const scsi_cmd[16], void* buffer, uint16_t bufsize) {
+  (void) scsi_cmd;
+  (void) buffer;
+  (void) bufsize;
+  tud_msc_set_sense(lun, SCSI_SENSE_ILLEGAL_REQUEST, 0x20, 0x00);
+  return -1;
+}
@@ -0,0 +1,177 @@
+#!/usr/bin/env python3
+"""Decode TinyUSB binary trace (CFG_TUSB_DEBUG_TRACE) back to log text.
+
+Trace is the raw byte stream returned by tu_trace_read() e.g captured from SEGGER RTT channel or UART. Format strings
+and %s arguments are stored as addresses, which are resolved using the firmware ELF file.
+"""
+import argparse
+import re
+import struct
+import sys
+
+TRACE_MAGIC = 0xA5
+FMT_BUF = 0
+FMT_MEM = 1
+
+PRINTF_RE = re.compile(r'%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d+))?(hh|h|ll|l|j|z|t|L)?([diouxXcsp%])')
+
+
+class Elf:
+    """Minimal ELF reader: map address of allocated sections to their content"""
+
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            data = f.read()
+        if data[:4] != b'\x7fELF':
+            raise ValueError(f'{path} is not an ELF file')
+        is64 = data[4] == 2
+        self.is64 = is64
+        self.endian = '<' if data[5] == 1 else '>'
+        e = self.endian
+        if is64:
+            shoff, = struct.unpack_from(e + 'Q', data, 0x28)
+            shentsize, shnum = struct.unpack_from(e + 'HH', data, 0x3A)
+        else:
+            shoff, = struct.unpack_from(e + 'I', data, 0x20)
+            shentsize, shnum = struct.unpack_from(e + 'HH', data, 0x2E)
+
+        self.sections = []
+        for i in range(shnum):
+            off = shoff + i * shentsize
+            if is64:
+                _, sh_type, flags, addr, offset, size = struct.unpack_from(e + 'IIQQQQ', data, off)
+            else:
+                _, sh_type, flags, addr, offset, size = struct.unpack_from(e + 'IIIIII', data, off)
+            SHT_PROGBITS, SHF_ALLOC = 1, 0x2
+            if sh_type == SHT_PROGBITS and (flags & SHF_ALLOC) and size:
+                self.sections.append((addr, data[offset:offset + size]))
+
+    def string(self, addr):
+        for start, content in self.sections:
+            if start <= addr < start + len(content):
+                off = addr - start
+                end = content.find(b'\0', off)
+                return content[off:end if end >= 0 else len(content)].decode('utf-8', 'replace')
+        return None
+
+
+def format_printf(elf, fmt, args, long_bits=32):
+    args = list(args)
+
+    def next_arg():
+        return args.pop(0) if args else 0
+
+    def repl(m):
+        flags, width, prec, length, conv = m.groups()
+        if conv == '%':
+            return '%'
+        if width == '*':
+            width = str(next_arg())
+        if prec == '*':
+            prec = str(next_arg())
+        spec = '%' + flags + (width or '') + ('.' + prec if prec is not None else '')
+        value = next_arg()
+        if conv in 'diouxXc':
+            # integer argument is int unless length modifier says long (64-bit on 64-bit host)
+            bits = long_bits if length in ('l', 'll', 'j', 'z', 't') else 32
+            value &= (1 << bits) - 1
+            if conv in 'di' and value >> (bits - 1):
+                value -= 1 << bits
+        if conv in 'diu':
+            return (spec + 'd') % value
+        if conv in 'oxX':
+            return (spec + conv) % value
+        if conv == 'c':
+            return (spec + 'c') % chr(value & 0xFF)
+        if conv == 'p':
+            return (spec + 's') % f'0x{value:x}'
+        # %s: string must be in read-only memory
+        s = elf.string(value)
+        return (spec + 's') % (s if s is not None else f'<0x{value:08x}>')
+
+    return PRINTF_RE.sub(repl, fmt)
+
+
+def format_buf(data):
+    return ''.join(f'{b:02X} ' for b in data) + '\r\n'
+
+
+def format_mem(data, indent):
+    # same layout as tu_print_mem()
+    if not data:
+        return 'NULL\r\n'
+    out = ''
+    for line in range(0, len(data), 16):
+        chunk = data[line:line + 16]
+        out += ' ' * indent + f'{line:04X}: '
+        out += ''.join(f' {b:02X}' for b in chunk) + '   ' * (16 - len(chunk))
+        out += '  |' + ''.join(chr(b) if 0x20 <= b < 0x7F else '.' for b in chunk) + '|\r\n'
+    return out
+
+
+def decode(elf, trace, endian, timestamps):
+    nwords = len(trace) // 4
+    words = struct.unpack(f'{endian}{nwords}I', trace[:nwords * 4])
+    # format address and arguments are recorded as 2 words (low first) by 64-bit host
+    arg_words = 2 if elf.is64 else 1
+
+    def join(w):
+        return sum(v << (32 * k) for k, v in enumerate(w))
+    prev_seq = None
+    i = 0
+    while i < nwords:
+        header = words[i]
+        count = (header >> 16) & 0xFF
+        if (header >> 24) != TRACE_MAGIC or count < 1 + arg_words or i + 1 + count > nwords:
+            i += 1  # resync
+            continue
+
+        seq = header & 0xFFFF
+        if prev_seq is not None:
+            lost = (seq - prev_seq - 1) & 0xFFFF
+            if 0 < lost < 0x8000:
+                yield f'<{lost} records lost>\r\n'
+        prev_seq = seq
+
+        timestamp = words[i + 1]
+        fmt_addr = join(words[i + 2:i + 2 + arg_words])
+        payload = words[i + 2 + arg_words:i + 1 + count]
+        i += 1 + count
+
+        prefix = f'[{timestamp:10}] ' if timestamps else ''
+        if fmt_addr in (FMT_BUF, FMT_MEM) and payload:
+            data = struct.pack(f'{endian}{len(payload) - 1}I', *payload[1:])
+            data = data[:payload[0] & 0xFFFF]
+            if fmt_addr == FMT_BUF:
+                yield prefix + format_buf(data)
+            else:
+                yield prefix + format_mem(data, (payload[0] >> 16) & 0xFF)
+        else:
+            fmt = elf.string(fmt_addr)
+            if fmt is None:
+                yield prefix + f'<unknown format 0x{fmt_addr:08x}>\r\n'
+            else:
+                args = [join(payload[k:k + arg_words]) for k in range(0, len(payload), arg_words)]
+                yield prefix + format_printf(elf, fmt, args, 32 * arg_words)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('elf', help='firmware ELF file')
+    parser.add_argument('trace', nargs='?', help='binary trace file (default: stdin)')
+    parser.add_argument('-t', '--timestamps', action='store_true', help='prefix each record with its timestamp')
+    args = parser.parse_args()
+
+    elf = Elf(args.elf)
+    if args.trace:
+        with open(args.trace, 'rb') as f:
+            trace = f.read()
+    else:
+        trace = sys.stdin.buffer.read()
+
+    for text in decode(elf, trace, elf.endian, args.timestamps):
+        sys.stdout.write(text.replace('\r\n', '\n'))
+
+
+if __name__ == '__main__':
+    main()